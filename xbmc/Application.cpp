@@ -56,6 +56,7 @@
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUIColorManager.h"
 #include "guilib/GUITextLayout.h"
+#include "guilib/GUIWindowCache.h"
 #include "addons/Skin.h"
 #ifdef HAS_PYTHON
 #include "interfaces/python/XBPython.h"
@@ -206,6 +207,7 @@
 #include "music/dialogs/GUIDialogMusicOverlay.h"
 #include "video/dialogs/GUIDialogVideoOverlay.h"
 #include "video/VideoInfoScanner.h"
+#include "video/ThumbExtractionService.h"
 
 // Dialog includes
 #include "music/dialogs/GUIDialogMusicOSD.h"
@@ -1414,6 +1416,7 @@ bool CApplication::Initialize()
 
   if (!g_settings.UsingLoginScreen())
   {
+    CThumbExtractionService::Get().Start();
     UpdateLibraries();
 #ifdef HAS_PYTHON
     g_pythonParser.m_bLogin = true;
@@ -1911,7 +1914,10 @@ void CApplication::ReloadSkin()
   CGUIWindow* pWindow = g_windowManager.GetWindow(g_windowManager.GetActiveWindow());
   if (pWindow)
     iCtrlID = pWindow->GetFocusedControlID();
-  
+
+  // a reload follows a change of settings or of the skin files, resolve the windows again
+  CGUIWindowCache::Clear();
+
   g_application.LoadSkin(g_guiSettings.GetString("lookandfeel.skin"));
  
   if (iCtrlID != -1)
@@ -3506,6 +3512,8 @@ void CApplication::Stop(int exitCode)
     if (m_videoInfoScanner->IsScanning())
       m_videoInfoScanner->Stop();
 
+    CThumbExtractionService::Get().Stop();
+
     CApplicationMessenger::Get().Cleanup();
 
     StopPVRManager();
@@ -61,6 +61,7 @@
 #include "music/dialogs/GUIDialogMusicInfo.h"
 #include "storage/MediaManager.h"
 #include "utils/TimeUtils.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
@@ -78,6 +79,8 @@
 #include "cores/IPlayer.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
 
+#include <algorithm>
+
 #define SYSHEATUPDATEINTERVAL 60000
 
 using namespace std;
@@ -106,11 +109,18 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_frameCounter = 0;
   m_lastFPSTime = 0;
   m_updateTime = 1;
+  for (unsigned int i = 0; i < sizeof(m_sourceEpochs) / sizeof(m_sourceEpochs[0]); i++)
+    m_sourceEpochs[i] = 0;
+  m_boolRequests = 0;
+  m_boolUpdates = 0;
+  m_lastFrameBoolRequests = 0;
+  m_lastFrameBoolUpdates = 0;
   m_MusicBitrate = 0;
   m_playerShowTime = false;
   m_playerShowCodec = false;
   m_playerShowInfo = false;
   m_fps = 0.0f;
+  m_skinThemeVersion = -1;
   ResetLibraryBools();
 }
 
@@ -610,6 +620,65 @@ const infomap slideshow[] =      {{ "ispaused",         SLIDESHOW_ISPAUSED },
                                   { "isactive",         SLIDESHOW_ISACTIVE },
                                   { "israndom",         SLIDESHOW_ISRANDOM }};
 
+/*! \brief Sorted view of an infomap table, so that a name is found by binary
+ search rather than by comparing it against every entry of the table.
+ Names listed more than once keep their table order, so the first one wins.
+ */
+class CInfoMapIndex
+{
+public:
+  template<size_t N>
+  CInfoMapIndex(const infomap (&map)[N])
+  {
+    m_entries.reserve(N);
+    for (size_t i = 0; i < N; i++)
+      m_entries.push_back(&map[i]);
+    std::stable_sort(m_entries.begin(), m_entries.end(), Less);
+  }
+
+  /*! \brief Find the value of an entry
+   \param name the (lowercase) name of the entry
+   \return the value of the entry, 0 if there is no entry with this name
+   */
+  int Lookup(const CStdString &name) const
+  {
+    std::vector<const infomap*>::const_iterator it = std::lower_bound(m_entries.begin(), m_entries.end(), name.c_str(), LessName);
+    if (it != m_entries.end() && strcmp((*it)->str, name.c_str()) == 0)
+      return (*it)->val;
+    return 0;
+  }
+
+private:
+  static bool Less(const infomap *left, const infomap *right) { return strcmp(left->str, right->str) < 0; }
+  static bool LessName(const infomap *entry, const char *name) { return strcmp(entry->str, name) < 0; }
+
+  std::vector<const infomap*> m_entries;
+};
+
+const CInfoMapIndex player_labels_index  (player_labels);
+const CInfoMapIndex player_param_index   (player_param);
+const CInfoMapIndex player_times_index   (player_times);
+const CInfoMapIndex weather_index        (weather);
+const CInfoMapIndex system_labels_index  (system_labels);
+const CInfoMapIndex system_param_index   (system_param);
+const CInfoMapIndex network_labels_index (network_labels);
+const CInfoMapIndex musicpartymode_index (musicpartymode);
+const CInfoMapIndex musicplayer_index    (musicplayer);
+const CInfoMapIndex videoplayer_index    (videoplayer);
+const CInfoMapIndex mediacontainer_index (mediacontainer);
+const CInfoMapIndex container_bools_index(container_bools);
+const CInfoMapIndex container_ints_index (container_ints);
+const CInfoMapIndex container_str_index  (container_str);
+const CInfoMapIndex listitem_labels_index(listitem_labels);
+const CInfoMapIndex visualisation_index  (visualisation);
+const CInfoMapIndex fanart_labels_index  (fanart_labels);
+const CInfoMapIndex skin_labels_index    (skin_labels);
+const CInfoMapIndex window_bools_index   (window_bools);
+const CInfoMapIndex control_labels_index (control_labels);
+const CInfoMapIndex playlist_index       (playlist);
+const CInfoMapIndex pvr_index            (pvr);
+const CInfoMapIndex slideshow_index      (slideshow);
+
 const int picture_slide_map[]  = {/* LISTITEM_PICTURE_RESOLUTION => */ SLIDE_RESOLUTION,
                                   /* LISTITEM_PICTURE_DATE       => */ SLIDE_EXIF_DATE,
                                   /* LISTITEM_PICTURE_DATETIME   => */ SLIDE_EXIF_DATE_TIME,
@@ -629,14 +698,41 @@ const int picture_slide_map[]  = {/* LISTITEM_PICTURE_RESOLUTION => */ SLIDE_RES
                                   /* LISTITEM_PICTURE_GPS_LON    => */ SLIDE_EXIF_GPS_LONGITUDE,
                                   /* LISTITEM_PICTURE_GPS_ALT    => */ SLIDE_EXIF_GPS_ALTITUDE };
 
-CGUIInfoManager::Property::Property(const CStdString &property, const CStdString &parameters)
-: name(property)
+CGUIInfoManager::Property::Property()
+{
+  m_source = NULL;
+  m_start = 0;
+  m_length = 0;
+}
+
+void CGUIInfoManager::Property::set_params(const CStdString &parameters)
+{
+  m_source = NULL;
+  params.clear();
+  if (!parameters.IsEmpty())
+    CUtil::SplitParams(parameters, params);
+}
+
+void CGUIInfoManager::Property::set_params(const CStdString &source, size_t start, size_t length)
 {
-  CUtil::SplitParams(parameters, params);
+  params.clear();
+  m_source = length ? &source : NULL;
+  m_start = start;
+  m_length = length;
+}
+
+void CGUIInfoManager::Property::split_params() const
+{
+  if (m_source)
+  {
+    CUtil::SplitParams(m_source->substr(m_start, m_length), params);
+    m_source = NULL;
+  }
 }
 
 const CStdString &CGUIInfoManager::Property::param(unsigned int n /* = 0 */) const
 {
+  split_params();
   if (n < params.size())
     return params[n];
   return StringUtils::EmptyString;
@@ -644,67 +740,142 @@ const CStdString &CGUIInfoManager::Property::param(unsigned int n /* = 0 */) con
 
 unsigned int CGUIInfoManager::Property::num_params() const
 {
+  split_params();
   return params.size();
 }
 
-void CGUIInfoManager::SplitInfoString(const CStdString &infoString, vector<Property> &info)
+/*! \brief Split a property with its name around or between several parameter lists,
+ as the name outside and the parameters inside parentheses run together.
+ */
+static void SplitProperty(const CStdString &infoString, size_t start, size_t end, CStdString &name, CStdString &params)
+{
+  unsigned int parentheses = 0;
+  for (size_t i = start; i < end; ++i)
+  {
+    char c = infoString[i];
+    if (c == '(')
+    {
+      if (!parentheses++)
+        continue;
+    }
+    else if (c == ')' && parentheses)
+    {
+      if (!--parentheses)
+        continue;
+    }
+    if (parentheses)
+      params += c;
+    else
+      name += (char)tolower((unsigned char)c);
+  }
+}
+
+unsigned int CGUIInfoManager::SplitInfoString(const CStdString &infoString, Property *info, unsigned int size)
 {
   // our string is of the form:
   // category[(params)][.info(params).info2(params)] ...
-  // so we need to split on . while taking into account of () pairs
+  // so we need to split on . while taking into account of () pairs.
+  // Each property is found as offsets of its name and parameters in the string, and
+  // only copied out once found. Parameters are split only when asked for.
+  size_t start = infoString.find_first_not_of(" \t\r\n");
+  if (start == CStdString::npos)
+    return 0;
+  size_t end = infoString.find_last_not_of(" \t\r\n") + 1;
+
+  unsigned int count = 0;
   unsigned int parentheses = 0;
-  CStdString property;
-  CStdString param;
-  for (size_t i = 0; i < infoString.size(); ++i)
+  size_t nameStart = start;
+  size_t nameEnd = CStdString::npos;
+  size_t paramStart = CStdString::npos;
+  size_t paramEnd = CStdString::npos;
+  bool named = false;       // whether there is anything outside the parentheses
+  bool contiguous = true;   // whether that is a name followed by at most one parameter list
+  for (size_t i = start; i <= end; ++i)
   {
-    if (infoString[i] == '(')
+    if (i == end || (infoString[i] == '.' && !parentheses))
+    {
+      if (named)
+      { // add our property and parameters
+        if (count < size)
+        {
+          Property &property = info[count];
+          if (contiguous)
+          {
+            if (nameEnd == CStdString::npos)
+              nameEnd = i;
+            property.name.assign(infoString, nameStart, nameEnd - nameStart);
+            StringUtils::ToLower(property.name);
+            if (paramStart == CStdString::npos)
+              property.set_params(infoString, 0, 0);
+            else
+              property.set_params(infoString, paramStart, (paramEnd == CStdString::npos ? i : paramEnd) - paramStart);
+          }
+          else
+          {
+            CStdString params;
+            property.name.clear();
+            SplitProperty(infoString, nameStart, i, property.name, params);
+            property.set_params(params);
+          }
+        }
+        count++;
+      }
+      nameStart = i + 1;
+      nameEnd = paramStart = paramEnd = CStdString::npos;
+      named = false;
+      contiguous = true;
+      continue;
+    }
+    char c = infoString[i];
+    if (c == '(')
     {
       if (!parentheses++)
+      {
+        if (paramStart == CStdString::npos)
+        {
+          nameEnd = i;
+          paramStart = i + 1;
+        }
+        else
+          contiguous = false;
         continue;
+      }
     }
-    else if (infoString[i] == ')')
+    else if (c == ')')
     {
       if (!parentheses)
         CLog::Log(LOGERROR, "unmatched parentheses in %s", infoString.c_str());
       else if (!--parentheses)
+      {
+        paramEnd = i;
         continue;
+      }
     }
-    else if (infoString[i] == '.' && !parentheses)
+    if (!parentheses)
     {
-      if (!property.IsEmpty()) // add our property and parameters
-        info.push_back(Property(property.ToLower(), param));
-      property.clear();
-      param.clear();
-      continue;
+      named = true;
+      if (paramStart != CStdString::npos)
+        contiguous = false;
     }
-    if (parentheses)
-      param += infoString[i];
-    else
-      property += infoString[i];
   }
   if (parentheses)
     CLog::Log(LOGERROR, "unmatched parentheses in %s", infoString.c_str());
-  if (!property.IsEmpty())
-    info.push_back(Property(property.ToLower(), param));
+  return count;
 }
 
 /// \brief Translates a string as given by the skin into an int that we use for more
 /// efficient retrieval of data.
 int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
 {
-  // trim whitespaces
-  CStdString strTest = strCondition;
-  strTest.TrimLeft(" \t\r\n");
-  strTest.TrimRight(" \t\r\n");
+  // no info has more than 3 properties
+  Property info[3];
+  unsigned int count = SplitInfoString(strCondition, info, 3);
 
-  vector< Property> info;
-  SplitInfoString(strTest, info);
-
-  if (info.empty())
+  if (count == 0)
     return 0;
 
   const Property &cat = info[0];
-  if (info.size() == 1)
+  if (count == 1)
   { // single category
     if (cat.name == "false" || cat.name == "no" || cat.name == "off")
       return SYSTEM_ALWAYS_FALSE;
@@ -744,61 +915,36 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
       return AddMultiInfo(GUIInfo(STRING_STR, info, compareString));
     }
   }
-  else if (info.size() == 2)
+  else if (count == 2)
   {
     const Property &prop = info[1];
+    int ret;
     if (cat.name == "player")
     {
-      for (size_t i = 0; i < sizeof(player_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == player_labels[i].str)
-          return player_labels[i].val;
-      }
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++)
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      ret = player_labels_index.Lookup(prop.name);
+      if (ret)
+        return ret;
+      ret = player_times_index.Lookup(prop.name);
+      if (ret)
+        return AddMultiInfo(GUIInfo(ret, TranslateTimeFormat(prop.param())));
       if (prop.num_params() == 1)
       {
-        for (size_t i = 0; i < sizeof(player_param) / sizeof(infomap); i++)
-        {
-          if (prop.name == player_param[i].str)
-            return AddMultiInfo(GUIInfo(player_param[i].val, ConditionalStringParameter(prop.param())));
-        }
+        ret = player_param_index.Lookup(prop.name);
+        if (ret)
+          return AddMultiInfo(GUIInfo(ret, ConditionalStringParameter(prop.param())));
       }
     }
     else if (cat.name == "weather")
-    {
-      for (size_t i = 0; i < sizeof(weather) / sizeof(infomap); i++)
-      {
-        if (prop.name == weather[i].str)
-          return weather[i].val;
-      }
-    }
+      return weather_index.Lookup(prop.name);
     else if (cat.name == "network")
-    {
-      for (size_t i = 0; i < sizeof(network_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == network_labels[i].str)
-          return network_labels[i].val;
-      }
-    }
+      return network_labels_index.Lookup(prop.name);
     else if (cat.name == "musicpartymode")
-    {
-      for (size_t i = 0; i < sizeof(musicpartymode) / sizeof(infomap); i++)
-      {
-        if (prop.name == musicpartymode[i].str)
-          return musicpartymode[i].val;
-      }
-    }
+      return musicpartymode_index.Lookup(prop.name);
     else if (cat.name == "system")
     {
-      for (size_t i = 0; i < sizeof(system_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == system_labels[i].str)
-          return system_labels[i].val;
-      }
+      ret = system_labels_index.Lookup(prop.name);
+      if (ret)
+        return ret;
       if (prop.num_params() == 1)
       {
         const CStdString &param = prop.param();
@@ -808,11 +954,9 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
           StringUtils::ToLower(paramCopy);
           return AddMultiInfo(GUIInfo(SYSTEM_GET_BOOL, ConditionalStringParameter(paramCopy, true)));
         }
-        for (size_t i = 0; i < sizeof(system_param) / sizeof(infomap); i++)
-        {
-          if (prop.name == system_param[i].str)
-            return AddMultiInfo(GUIInfo(system_param[i].val, ConditionalStringParameter(param)));
-        }
+        ret = system_param_index.Lookup(prop.name);
+        if (ret)
+          return AddMultiInfo(GUIInfo(ret, ConditionalStringParameter(param)));
         if (prop.name == "memory")
         {
           if (param == "free") return SYSTEM_FREE_MEMORY;
@@ -889,11 +1033,9 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
     }
     else if (cat.name == "musicplayer")
     {
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++) // TODO: remove these, they're repeats
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      ret = player_times_index.Lookup(prop.name); // TODO: remove these, they're repeats
+      if (ret)
+        return AddMultiInfo(GUIInfo(ret, TranslateTimeFormat(prop.param())));
       if (prop.name == "property")
       {
         if (prop.param().Equals("fanart_image"))
@@ -904,51 +1046,37 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
     }
     else if (cat.name == "videoplayer")
     {
-      for (size_t i = 0; i < sizeof(player_times) / sizeof(infomap); i++) // TODO: remove these, they're repeats
-      {
-        if (prop.name == player_times[i].str)
-          return AddMultiInfo(GUIInfo(player_times[i].val, TranslateTimeFormat(prop.param())));
-      }
+      ret = player_times_index.Lookup(prop.name); // TODO: remove these, they're repeats
+      if (ret)
+        return AddMultiInfo(GUIInfo(ret, TranslateTimeFormat(prop.param())));
       if (prop.name == "content" && prop.num_params())
         return AddMultiInfo(GUIInfo(VIDEOPLAYER_CONTENT, ConditionalStringParameter(prop.param()), 0));
-      for (size_t i = 0; i < sizeof(videoplayer) / sizeof(infomap); i++)
-      {
-        if (prop.name == videoplayer[i].str)
-          return videoplayer[i].val;
-      }
+      ret = videoplayer_index.Lookup(prop.name);
+      if (ret)
+        return ret;
     }
     else if (cat.name == "slideshow")
     {
-      for (size_t i = 0; i < sizeof(slideshow) / sizeof(infomap); i++)
-      {
-        if (prop.name == slideshow[i].str)
-          return slideshow[i].val;
-      }
+      ret = slideshow_index.Lookup(prop.name);
+      if (ret)
+        return ret;
       return CPictureInfoTag::TranslateString(prop.name);
     }
     else if (cat.name == "container")
     {
-      for (size_t i = 0; i < sizeof(mediacontainer) / sizeof(infomap); i++) // these ones don't have or need an id
-      {
-        if (prop.name == mediacontainer[i].str)
-          return mediacontainer[i].val;
-      }
+      ret = mediacontainer_index.Lookup(prop.name); // these ones don't have or need an id
+      if (ret)
+        return ret;
       int id = atoi(cat.param().c_str());
-      for (size_t i = 0; i < sizeof(container_bools) / sizeof(infomap); i++) // these ones can have an id (but don't need to?)
-      {
-        if (prop.name == container_bools[i].str)
-          return id ? AddMultiInfo(GUIInfo(container_bools[i].val, id)) : container_bools[i].val;
-      }
-      for (size_t i = 0; i < sizeof(container_ints) / sizeof(infomap); i++) // these ones can have an int param on the property
-      {
-        if (prop.name == container_ints[i].str)
-          return AddMultiInfo(GUIInfo(container_ints[i].val, id, atoi(prop.param().c_str())));
-      }
-      for (size_t i = 0; i < sizeof(container_str) / sizeof(infomap); i++) // these ones have a string param on the property
-      {
-        if (prop.name == container_str[i].str)
-          return AddMultiInfo(GUIInfo(container_str[i].val, id, ConditionalStringParameter(prop.param())));
-      }
+      ret = container_bools_index.Lookup(prop.name); // these ones can have an id (but don't need to?)
+      if (ret)
+        return id ? AddMultiInfo(GUIInfo(ret, id)) : ret;
+      ret = container_ints_index.Lookup(prop.name); // these ones can have an int param on the property
+      if (ret)
+        return AddMultiInfo(GUIInfo(ret, id, atoi(prop.param().c_str())));
+      ret = container_str_index.Lookup(prop.name); // these ones have a string param on the property
+      if (ret)
+        return AddMultiInfo(GUIInfo(ret, id, ConditionalStringParameter(prop.param())));
       if (prop.name == "sortdirection")
       {
         SortOrder order = SortOrderNone;
@@ -969,7 +1097,7 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
     else if (cat.name == "listitem")
     {
       int offset = atoi(cat.param().c_str());
-      int ret = TranslateListItem(prop);
+      ret = TranslateListItem(prop);
       if (offset || ret == LISTITEM_ISSELECTED || ret == LISTITEM_ISPLAYING || ret == LISTITEM_IS_FOLDER)
         return AddMultiInfo(GUIInfo(ret, 0, offset, INFOFLAG_LISTITEM_WRAP));
       return ret;
@@ -977,7 +1105,7 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
     else if (cat.name == "listitemposition")
     {
       int offset = atoi(cat.param().c_str());
-      int ret = TranslateListItem(prop);
+      ret = TranslateListItem(prop);
       if (offset || ret == LISTITEM_ISSELECTED || ret == LISTITEM_ISPLAYING || ret == LISTITEM_IS_FOLDER)
         return AddMultiInfo(GUIInfo(ret, 0, offset, INFOFLAG_LISTITEM_POSITION));
       return ret;
@@ -985,34 +1113,20 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
     else if (cat.name == "listitemnowrap")
     {
       int offset = atoi(cat.param().c_str());
-      int ret = TranslateListItem(prop);
+      ret = TranslateListItem(prop);
       if (offset || ret == LISTITEM_ISSELECTED || ret == LISTITEM_ISPLAYING || ret == LISTITEM_IS_FOLDER)
         return AddMultiInfo(GUIInfo(ret, 0, offset));
       return ret;
     }
     else if (cat.name == "visualisation")
-    {
-      for (size_t i = 0; i < sizeof(visualisation) / sizeof(infomap); i++)
-      {
-        if (prop.name == visualisation[i].str)
-          return visualisation[i].val;
-      }
-    }
+      return visualisation_index.Lookup(prop.name);
     else if (cat.name == "fanart")
-    {
-      for (size_t i = 0; i < sizeof(fanart_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == fanart_labels[i].str)
-          return fanart_labels[i].val;
-      }
-    }
+      return fanart_labels_index.Lookup(prop.name);
     else if (cat.name == "skin")
     {
-      for (size_t i = 0; i < sizeof(skin_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == skin_labels[i].str)
-          return skin_labels[i].val;
-      }
+      ret = skin_labels_index.Lookup(prop.name);
+      if (ret)
+        return ret;
       if (prop.num_params())
       {
         if (prop.name == "string")
@@ -1036,30 +1150,26 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
         if (winID != WINDOW_INVALID)
           return AddMultiInfo(GUIInfo(WINDOW_PROPERTY, winID, ConditionalStringParameter(prop.param())));
       }
-      for (size_t i = 0; i < sizeof(window_bools) / sizeof(infomap); i++)
-      {
-        if (prop.name == window_bools[i].str)
-        { // TODO: The parameter for these should really be on the first not the second property
-          if (prop.param().Find("xml") >= 0)
-            return AddMultiInfo(GUIInfo(window_bools[i].val, 0, ConditionalStringParameter(prop.param())));
-          int winID = prop.param().IsEmpty() ? 0 : CButtonTranslator::TranslateWindow(prop.param());
-          if (winID != WINDOW_INVALID)
-            return AddMultiInfo(GUIInfo(window_bools[i].val, winID, 0));
-          return 0;
-        }
+      ret = window_bools_index.Lookup(prop.name);
+      if (ret)
+      { // TODO: The parameter for these should really be on the first not the second property
+        if (prop.param().Find("xml") >= 0)
+          return AddMultiInfo(GUIInfo(ret, 0, ConditionalStringParameter(prop.param())));
+        int winID = prop.param().IsEmpty() ? 0 : CButtonTranslator::TranslateWindow(prop.param());
+        if (winID != WINDOW_INVALID)
+          return AddMultiInfo(GUIInfo(ret, winID, 0));
+        return 0;
       }
     }
     else if (cat.name == "control")
     {
-      for (size_t i = 0; i < sizeof(control_labels) / sizeof(infomap); i++)
-      {
-        if (prop.name == control_labels[i].str)
-        { // TODO: The parameter for these should really be on the first not the second property
-          int controlID = atoi(prop.param().c_str());
-          if (controlID)
-            return AddMultiInfo(GUIInfo(control_labels[i].val, controlID, 0));
-          return 0;
-        }
+      ret = control_labels_index.Lookup(prop.name);
+      if (ret)
+      { // TODO: The parameter for these should really be on the first not the second property
+        int controlID = atoi(prop.param().c_str());
+        if (controlID)
+          return AddMultiInfo(GUIInfo(ret, controlID, 0));
+        return 0;
       }
     }
     else if (cat.name == "controlgroup" && prop.name == "hasfocus")
@@ -1069,23 +1179,11 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
         return AddMultiInfo(GUIInfo(CONTROL_GROUP_HAS_FOCUS, groupID, atoi(prop.param(0).c_str())));
     }
     else if (cat.name == "playlist")
-    {
-      for (size_t i = 0; i < sizeof(playlist) / sizeof(infomap); i++)
-      {
-        if (prop.name == playlist[i].str)
-          return playlist[i].val;
-      }
-    }
+      return playlist_index.Lookup(prop.name);
     else if (cat.name == "pvr")
-    {
-      for (size_t i = 0; i < sizeof(pvr) / sizeof(infomap); i++)
-      {
-        if (prop.name == pvr[i].str)
-          return pvr[i].val;
-      }
-    }
+      return pvr_index.Lookup(prop.name);
   }
-  else if (info.size() == 3)
+  else if (count == 3)
   {
     if (info[0].name == "system" && info[1].name == "platform")
     { // TODO: replace with a single system.platform
@@ -1131,11 +1229,9 @@ int CGUIInfoManager::TranslateSingleString(const CStdString &strCondition)
 
 int CGUIInfoManager::TranslateListItem(const Property &info)
 {
-  for (size_t i = 0; i < sizeof(listitem_labels) / sizeof(infomap); i++) // these ones don't have or need an id
-  {
-    if (info.name == listitem_labels[i].str)
-      return listitem_labels[i].val;
-  }
+  int ret = listitem_labels_index.Lookup(info.name); // these ones don't have or need an id
+  if (ret)
+    return ret;
   if (info.name == "property" && info.num_params() == 1)
   {
     if (info.param().Equals("fanart_image"))
@@ -1149,12 +1245,7 @@ int CGUIInfoManager::TranslateListItem(const Property &info)
 
 int CGUIInfoManager::TranslateMusicPlayerString(const CStdString &info) const
 {
-  for (size_t i = 0; i < sizeof(musicplayer) / sizeof(infomap); i++)
-  {
-    if (info == musicplayer[i].str)
-      return musicplayer[i].val;
-  }
-  return 0;
+  return musicplayer_index.Lookup(info);
 }
 
 TIME_FORMAT CGUIInfoManager::TranslateTimeFormat(const CStdString &format)
@@ -1930,20 +2021,23 @@ unsigned int CGUIInfoManager::Register(const CStdString &expression, int context
   if (condition.IsEmpty())
     return 0;
 
+  // expressions are matched case insensitively
+  CStdString key(condition);
+  key.ToLower();
+  std::pair<CStdString, int> index(key, context);
+
   CSingleLock lock(m_critInfo);
   // do we have the boolean expression already registered?
-  InfoBool test(condition, context);
-  for (unsigned int i = 0; i < m_bools.size(); ++i)
-  {
-    if (*m_bools[i] == test)
-      return i+1;
-  }
+  std::map<std::pair<CStdString, int>, unsigned int>::const_iterator it = m_boolIndex.find(index);
+  if (it != m_boolIndex.end())
+    return it->second;
 
   if (condition.find_first_of("|+[]!") != condition.npos)
     m_bools.push_back(new InfoExpression(condition, context));
   else
     m_bools.push_back(new InfoSingle(condition, context));
 
+  m_boolIndex.insert(std::make_pair(index, m_bools.size()));
   return m_bools.size();
 }
 
@@ -1977,10 +2071,99 @@ bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWind
 bool CGUIInfoManager::GetBoolValue(unsigned int expression, const CGUIListItem *item)
 {
   if (expression && --expression < m_bools.size())
-    return m_bools[expression]->Get(m_updateTime, item);
+  {
+    InfoBool *info = m_bools[expression];
+    unsigned int epoch = GetSourcesEpoch(info->GetSources());
+    m_boolRequests++;
+    if (item || info->IsDirty(m_updateTime, epoch))
+      m_boolUpdates++;
+    return info->Get(m_updateTime, epoch, item);
+  }
   return false;
 }
 
+void CGUIInfoManager::InvalidateSource(unsigned int source)
+{
+  for (unsigned int i = 0; i < sizeof(m_sourceEpochs) / sizeof(m_sourceEpochs[0]); i++)
+  {
+    if (source & (1 << i))
+      AtomicIncrement(&m_sourceEpochs[i]);
+  }
+}
+
+unsigned int CGUIInfoManager::GetSourcesEpoch(unsigned int sources) const
+{
+  unsigned int epoch = 0;
+  for (unsigned int i = 0; i < sizeof(m_sourceEpochs) / sizeof(m_sourceEpochs[0]); i++)
+  {
+    if (sources & (1 << i))
+      epoch += (unsigned int)m_sourceEpochs[i];
+  }
+  return epoch;
+}
+
+unsigned int CGUIInfoManager::GetInfoSources(int info) const
+{
+  int condition = abs(info);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    if (condition - MULTI_INFO_START < (int)m_multiInfo.size())
+    {
+      const GUIInfo &multiInfo = m_multiInfo[condition - MULTI_INFO_START];
+      switch (abs(multiInfo.m_info))
+      {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+        return INFO_SOURCE_SKIN;
+      case STRING_IS_EMPTY:
+      case STRING_STR:
+      case STRING_STR_LEFT:
+      case STRING_STR_RIGHT:
+      case INTEGER_GREATER_THAN:
+        // compared against a constant
+        return GetInfoSources(multiInfo.GetData1());
+      case STRING_COMPARE:
+        // compared against a constant, or another info label if negative
+        return GetInfoSources(multiInfo.GetData1()) |
+               (multiInfo.GetData2() < 0 ? GetInfoSources(-multiInfo.GetData2()) : INFO_SOURCE_CONSTANT);
+      }
+    }
+    return INFO_SOURCE_POLLED;
+  }
+  // the item's own data, only changing when the item is invalidated. Whether it's playing
+  // and the PVR infos depend on the player, timers and guide though
+  if ((condition >= LISTITEM_START && condition <= LISTITEM_DBID && condition != LISTITEM_ISPLAYING) ||
+      (condition >= LISTITEM_PROPERTY_START && condition < LISTITEM_PROPERTY_END))
+    return INFO_SOURCE_ITEM;
+  if (condition == 0 || condition == SYSTEM_ALWAYS_TRUE || condition == SYSTEM_ALWAYS_FALSE ||
+      condition == SYSTEM_ETHERNET_LINK_ACTIVE ||
+      (condition >= SYSTEM_PLATFORM_LINUX && condition <= SYSTEM_PLATFORM_ANDROID))
+    return INFO_SOURCE_CONSTANT;
+  if (condition >= LIBRARY_HAS_MUSIC && condition <= LIBRARY_HAS_MUSICVIDEOS)
+    return INFO_SOURCE_LIBRARY;
+  return INFO_SOURCE_POLLED;
+}
+
+unsigned int CGUIInfoManager::GetBoolSources(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetSources();
+  return INFO_SOURCE_CONSTANT;
+}
+
+CStdString CGUIInfoManager::GetBoolExpression(unsigned int expression) const
+{
+  if (expression && --expression < m_bools.size())
+    return m_bools[expression]->GetExpression();
+  return "";
+}
+
+void CGUIInfoManager::GetBoolCounters(unsigned int &requests, unsigned int &updates) const
+{
+  requests = m_lastFrameBoolRequests;
+  updates = m_lastFrameBoolUpdates;
+}
+
 // checks the condition and returns it as necessary.  Currently used
 // for toggle button controls and visibility of images.
 bool CGUIInfoManager::GetBool(int condition1, int contextWindow, const CGUIListItem *item)
@@ -2459,10 +2642,17 @@ bool CGUIInfoManager::GetMultiInfoBool(const GUIInfo &info, int contextWindow, c
         break;
       case SKIN_HAS_THEME:
         {
-          CStdString theme = g_guiSettings.GetString("lookandfeel.skintheme");
-          theme.ToLower();
-          URIUtils::RemoveExtension(theme);
-          bReturn = theme.Equals(m_stringParameters[info.GetData1()]);
+          // polled every frame, so the theme name is only worked out again after a settings change
+          CSingleLock lock(m_critInfo);
+          long version = g_guiSettings.GetVersion();
+          if (version != m_skinThemeVersion)
+          {
+            m_skinTheme = g_guiSettings.GetString("lookandfeel.skintheme");
+            m_skinTheme.ToLower();
+            URIUtils::RemoveExtension(m_skinTheme);
+            m_skinThemeVersion = version;
+          }
+          bReturn = m_skinTheme.Equals(m_stringParameters[info.GetData1()]);
         }
         break;
       case STRING_IS_EMPTY:
@@ -3985,12 +4175,18 @@ void CGUIInfoManager::Clear()
   for (unsigned int i = 0; i < m_bools.size(); ++i)
     delete m_bools[i];
   m_bools.clear();
+  m_boolIndex.clear();
 
   m_skinVariableStrings.clear();
 }
 
 void CGUIInfoManager::UpdateFPS()
 {
+  m_lastFrameBoolRequests = m_boolRequests;
+  m_lastFrameBoolUpdates = m_boolUpdates;
+  m_boolRequests = 0;
+  m_boolUpdates = 0;
+
   m_frameCounter++;
   unsigned int curTime = CTimeUtils::GetFrameTime();
 
@@ -5112,6 +5308,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  InvalidateSource(INFO_SOURCE_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -5121,6 +5318,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasTVShows = -1;
   m_libraryHasMusicVideos = -1;
   m_libraryHasMovieSets = -1;
+  InvalidateSource(INFO_SOURCE_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
@@ -5135,6 +5333,8 @@ bool CGUIInfoManager::GetLibraryBool(int condition)
         m_libraryHasMusic = (db.GetSongsCount() > 0) ? 1 : 0;
         db.Close();
       }
+      else
+        InvalidateSource(INFO_SOURCE_LIBRARY); // not cached, asked again next time
     }
     return m_libraryHasMusic > 0;
   }
@@ -5148,6 +5348,8 @@ bool CGUIInfoManager::GetLibraryBool(int condition)
         m_libraryHasMovies = db.HasContent(VIDEODB_CONTENT_MOVIES) ? 1 : 0;
         db.Close();
       }
+      else
+        InvalidateSource(INFO_SOURCE_LIBRARY); // not cached, asked again next time
     }
     return m_libraryHasMovies > 0;
   }
@@ -5161,6 +5363,8 @@ bool CGUIInfoManager::GetLibraryBool(int condition)
         m_libraryHasMovieSets = db.HasSets() ? 1 : 0;
         db.Close();
       }
+      else
+        InvalidateSource(INFO_SOURCE_LIBRARY); // not cached, asked again next time
     }
     return m_libraryHasMovieSets > 0;
   }
@@ -5174,6 +5378,8 @@ bool CGUIInfoManager::GetLibraryBool(int condition)
         m_libraryHasTVShows = db.HasContent(VIDEODB_CONTENT_TVSHOWS) ? 1 : 0;
         db.Close();
       }
+      else
+        InvalidateSource(INFO_SOURCE_LIBRARY); // not cached, asked again next time
     }
     return m_libraryHasTVShows > 0;
   }
@@ -5187,6 +5393,8 @@ bool CGUIInfoManager::GetLibraryBool(int condition)
         m_libraryHasMusicVideos = db.HasContent(VIDEODB_CONTENT_MUSICVIDEOS) ? 1 : 0;
         db.Close();
       }
+      else
+        InvalidateSource(INFO_SOURCE_LIBRARY); // not cached, asked again next time
     }
     return m_libraryHasMusicVideos > 0;
   }
@@ -687,6 +687,40 @@ public:
    */
   bool EvaluateBool(const CStdString &expression, int context = 0);
 
+  /*! \brief Notify that the data of a source changed
+   Registered boolean expressions depending on the source are re-evaluated the next time
+   their value is requested, those depending only on other sources keep their cached value.
+   \param source the INFO_SOURCE_* flag of the data that changed
+   */
+  void InvalidateSource(unsigned int source);
+
+  /*! \brief Get the change epoch of some sources, it changes whenever the data of one of them does
+   \param sources the INFO_SOURCE_* flags of the sources
+   \sa InvalidateSource
+   */
+  unsigned int GetSourcesEpoch(unsigned int sources) const;
+
+  /*! \brief Get the INFO_SOURCE_* flags of the data an info depends on
+   \param info the info as returned by TranslateSingleString
+   */
+  unsigned int GetInfoSources(int info) const;
+
+  /*! \brief Get the INFO_SOURCE_* flags of the data a registered boolean expression depends on
+   \sa Register
+   */
+  unsigned int GetBoolSources(unsigned int expression) const;
+
+  /*! \brief Get the expression a boolean expression was registered with
+   \sa Register
+   */
+  CStdString GetBoolExpression(unsigned int expression) const;
+
+  /*! \brief Get the boolean expression counters of the last frame, for profiling
+   \param requests number of times the value of a boolean expression was requested
+   \param updates number of those requests that had to evaluate the expression
+   */
+  void GetBoolCounters(unsigned int &requests, unsigned int &updates) const;
+
   int TranslateString(const CStdString &strCondition);
 
   /*! \brief Get integer value of info.
@@ -804,14 +838,27 @@ protected:
   class Property
   {
   public:
-    Property(const CStdString &property, const CStdString &parameters);
+    Property();
+
+    /*! \brief Set the parameters from a comma separated parameter list */
+    void set_params(const CStdString &parameters);
+
+    /*! \brief Set the parameters from a comma separated parameter list within a string.
+     The list is split only once a parameter is asked for, so the string must outlive the property.
+     */
+    void set_params(const CStdString &source, size_t start, size_t length);
 
     const CStdString &param(unsigned int n = 0) const;
     unsigned int num_params() const;
 
     CStdString name;
   private:
-    std::vector<CStdString> params;
+    void split_params() const;
+
+    mutable const CStdString *m_source; // string holding the parameters until they are split
+    size_t m_start;
+    size_t m_length;
+    mutable std::vector<CStdString> params;
   };
 
   bool GetMultiInfoBool(const GUIInfo &info, int contextWindow = 0, const CGUIListItem *item = NULL);
@@ -830,9 +877,11 @@ protected:
    where the parameters are an optional comma separated parameter list.
    
    \param infoString the original string
-   \param info the resulting pairs of info and parameters.
+   \param info array of empty properties receiving the pairs of info and parameters.
+   \param size the number of properties in the array.
+   \return the number of properties in the string, which may be larger than size.
    */
-  void SplitInfoString(const CStdString &infoString, std::vector<Property> &info);
+  unsigned int SplitInfoString(const CStdString &infoString, Property *info, unsigned int size);
 
   // Conditional string parameters for testing are stored in a vector for later retrieval.
   // The offset into the string parameters array is returned.
@@ -887,8 +936,17 @@ protected:
   int m_prevWindowID;
 
   std::vector<INFO::InfoBool*> m_bools;
+  // index into m_bools by lowercased expression and context, to find duplicates in Register()
+  std::map<std::pair<CStdString, int>, unsigned int> m_boolIndex;
   std::vector<INFO::CSkinVariableString> m_skinVariableStrings;
   unsigned int m_updateTime;
+  volatile long m_sourceEpochs[8];  // change epoch of each INFO_SOURCE_* flag, bumped from any thread
+
+  // boolean expression counters
+  unsigned int m_boolRequests;
+  unsigned int m_boolUpdates;
+  unsigned int m_lastFrameBoolRequests;
+  unsigned int m_lastFrameBoolUpdates;
 
   int m_libraryHasMusic;
   int m_libraryHasMovies;
@@ -896,6 +954,10 @@ protected:
   int m_libraryHasMusicVideos;
   int m_libraryHasMovieSets;
 
+  // the skin theme as Skin.HasTheme() compares it, worked out again once the settings version moves on
+  CStdString m_skinTheme;
+  long m_skinThemeVersion;
+
   CCriticalSection m_critInfo;
 };
 
@@ -31,7 +31,9 @@
 #include "dialogs/GUIDialogOK.h"
 #include "playlists/PlayList.h"
 #include "settings/Settings.h"
+#include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
+#include "utils/Variant.h"
 #include "utils/log.h"
 #include "Application.h"
 #include "interfaces/AnnouncementManager.h"
@@ -40,11 +42,14 @@ using namespace std;
 using namespace PLAYLIST;
 
 #define QUEUE_DEPTH       10
+// past this many changed songs they are fetched again as a whole rather than one by one
+#define MAX_CHANGED_SONGS 100
 
 CPartyModeManager::CPartyModeManager(void)
 {
   m_bIsVideo = false;
   m_bEnabled = false;
+  m_bRefresh = false;
   m_strCurrentFilterMusic.Empty();
   m_strCurrentFilterVideo.Empty();
   ClearState();
@@ -165,15 +170,6 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
     songIDs.insert(songIDs.end(),songIDs2.begin(),songIDs2.end());
   }
 
-  // calculate history size
-  if (m_iMatchingSongs < 50)
-    m_songsInHistory = 0;
-  else
-    m_songsInHistory = (int)(m_iMatchingSongs/2);
-  if (m_songsInHistory > 200)
-    m_songsInHistory = 200;
-
-  CLog::Log(LOGINFO,"PARTY MODE MANAGER: Matching songs = %i, History size = %i", m_iMatchingSongs, m_songsInHistory);
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode enabled!");
 
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
@@ -206,6 +202,8 @@ bool CPartyModeManager::Enable(PartyModeContext context /*= PARTYMODECONTEXT_MUS
   }
 
   // done
+  if (!m_bEnabled)
+    ANNOUNCEMENT::CAnnouncementManager::AddAnnouncer(this);
   m_bEnabled = true;
   Announce();
   return true;
@@ -216,6 +214,7 @@ void CPartyModeManager::Disable()
   if (!IsEnabled())
     return;
   m_bEnabled = false;
+  ANNOUNCEMENT::CAnnouncementManager::RemoveAnnouncer(this);
   Announce();
   CLog::Log(LOGINFO,"PARTY MODE MANAGER: Party mode disabled.");
 }
@@ -321,111 +320,223 @@ bool CPartyModeManager::AddRandomSongs(int iSongs /* = 0 */)
     }
     if (iSongs > 1) // grab 70 % songs, 30 % mvids
     {
-      iSongsToAdd = (int).7f*iSongs;
-      iVidsToAdd = (int).3f*iSongs;
+      iSongsToAdd = (int)(.7f*iSongs);
+      iVidsToAdd = (int)(.3f*iSongs);
       while (iSongsToAdd+iVidsToAdd < iSongs) // correct any rounding by adding songs
         iSongsToAdd++;
     }
   }
 
-  // add songs to fill queue
-  if (m_type.Equals("songs") || m_type.Equals("mixed"))
+  if (m_type.Equals("songs"))
+    iVidsToAdd = 0;
+  if (m_type.Equals("musicvideos"))
+    iSongsToAdd = 0;
+
+  // pick the songs from the matching songs not picked recently
+  if (!ApplyChanges())
+    return false;
+
+  if (m_songs.Size() == 0)
+  {
+    iVidsToAdd += iSongsToAdd;
+    iSongsToAdd = 0;
+  }
+  if (m_musicVideos.Size() == 0)
+  {
+    iSongsToAdd += iVidsToAdd;
+    iVidsToAdd = 0;
+  }
+
+  vector< pair<int,int> > songIDs;
+  int songID;
+  for (int i = 0; i < iSongsToAdd && m_songs.Draw(songID); i++)
+    songIDs.push_back(make_pair(1, songID));
+  for (int i = 0; i < iVidsToAdd && m_musicVideos.Draw(songID); i++)
+    songIDs.push_back(make_pair(2, songID));
+
+  if (songIDs.empty())
+  {
+    if (iSongsToAdd + iVidsToAdd <= 0)
+      return true;
+    OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
+    return false;
+  }
+  return AddSongs(songIDs);
+}
+
+bool CPartyModeManager::AddSongs(const vector< pair<int,int> > &songIDs)
+{
+  CStdString sqlWhereMusic = "songview.idSong IN (";
+  CStdString sqlWhereVideo = "idMVideo IN (";
+  unsigned int songs = 0;
+
+  for (vector< pair<int,int> >::const_iterator it = songIDs.begin(); it != songIDs.end(); it++)
   {
+    CStdString song;
+    song.Format("%i,", it->second);
+    if (it->first == 1)
+      sqlWhereMusic += song;
+    if (it->first == 2)
+      sqlWhereVideo += song;
+  }
+
+  CFileItemList items;
+  if (sqlWhereMusic.size() > 26)
+  {
+    sqlWhereMusic[sqlWhereMusic.size() - 1] = ')'; // replace the last comma with closing bracket
     CMusicDatabase database;
-    if (database.Open())
+    if (!database.Open())
     {
-      // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
-      bool error(false);
-      for (int i = 0; i < iSongsToAdd; i++)
-      {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomSong(item.get(), songID, whereClause.first))
-        { // success
-          Add(item);
-          AddToHistory(1,songID);
-        }
-        else
-        {
-          error = true;
-          break;
-        }
-      }
-
-      if (error)
-      {
-        database.Close();
-        OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
-        return false;
-      }
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
     }
-    else
+    database.GetSongsByWhere("musicdb://4/", sqlWhereMusic, items);
+  }
+  if (sqlWhereVideo.size() > 19)
+  {
+    sqlWhereVideo[sqlWhereVideo.size() - 1] = ')'; // replace the last comma with closing bracket
+    CVideoDatabase database;
+    if (!database.Open())
     {
       OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
       return false;
     }
-    database.Close();
+    database.GetMusicVideosByWhere("videodb://3/2/", sqlWhereVideo, items);
+  }
+
+  if (items.IsEmpty())
+  {
+    OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
+    return false;
+  }
+
+  // songs that were removed since the ids were fetched are missing, catch up with the library
+  if (items.Size() < (int)songIDs.size())
+  {
+    CSingleLock lock(m_changesSection);
+    m_bRefresh = true;
+  }
+
+  items.Randomize(); // they are in database order
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CFileItemPtr item(items[i]);
+    Add(item);
+    // TODO: Allow "relaxed restrictions" later?
+  }
+  return true;
+}
+
+bool CPartyModeManager::RefreshSongs()
+{
+  vector< pair<int,int> > songIDs;
+  if (m_type.Equals("songs") || m_type.Equals("mixed"))
+  {
+    CMusicDatabase database;
+    if (!database.Open())
+    {
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
+    }
+    database.GetSongIDs(m_strCurrentFilterMusic, songIDs);
   }
   if (m_type.Equals("musicvideos") || m_type.Equals("mixed"))
   {
     CVideoDatabase database;
-    if (database.Open())
+    if (!database.Open())
     {
-      // Method:
-      // 1. Grab a random entry from the database using a where clause
-      // 2. Iterate on iSongs.
-
-      // Note: At present, this method is faster than the alternative, which is to grab
-      // all valid songids, then select a random number of them (as done in AddInitialSongs()).
-      // The reason for this is simply the number of songs we are requesting - we generally
-      // only want one here.  Any more than about 3 songs and it is more efficient
-      // to use the technique in AddInitialSongs.  As it's unlikely that we'll require
-      // more than 1 song at a time here, this method is faster.
-      bool error(false);
-      for (int i = 0; i < iVidsToAdd; i++)
-      {
-        pair<CStdString,CStdString> whereClause = GetWhereClauseWithHistory();
-        CFileItemPtr item(new CFileItem);
-        int songID;
-        if (database.GetRandomMusicVideo(item.get(), songID, whereClause.second))
-        { // success
-          Add(item);
-          AddToHistory(2,songID);
-        }
-        else
-        {
-          error = true;
-          break;
-        }
-      }
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
+    }
+    database.GetMusicVideoIDs(m_strCurrentFilterVideo, songIDs);
+  }
 
-      if (error)
-      {
-        database.Close();
-        OnError(16034, (CStdString)"Cannot get songs from database. Aborting.");
-        return false;
-      }
+  vector<int> songs, musicVideos;
+  for (vector< pair<int,int> >::const_iterator it = songIDs.begin(); it != songIDs.end(); it++)
+    (it->first == 1 ? songs : musicVideos).push_back(it->second);
+  m_songs.Refresh(songs);
+  m_musicVideos.Refresh(musicVideos);
+  SetHistorySize();
+  return true;
+}
+
+bool CPartyModeManager::ApplyChanges()
+{
+  bool refresh;
+  set<int> songs, musicVideos;
+  {
+    CSingleLock lock(m_changesSection);
+    refresh = m_bRefresh;
+    m_bRefresh = false;
+    songs.swap(m_changedSongs);
+    musicVideos.swap(m_changedMusicVideos);
+  }
+  if (refresh)
+    return RefreshSongs();
+  if (songs.empty() && musicVideos.empty())
+    return true;
+
+  // each changed song is looked up on its own: it joins the picks if it matches the filter, else it leaves them
+  if (!songs.empty() && (m_type.Equals("songs") || m_type.Equals("mixed")))
+  {
+    CMusicDatabase database;
+    if (!database.Open())
+    {
+      OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
+      return false;
     }
-    else
+    for (set<int>::const_iterator it = songs.begin(); it != songs.end(); ++it)
+    {
+      CDatabase::Filter filter(m_strCurrentFilterMusic);
+      filter.AppendWhere(database.PrepareSQL("songview.idSong = %i", *it));
+      vector< pair<int,int> > songIDs;
+      if (database.GetSongIDs(filter, songIDs) > 0)
+        m_songs.Add(*it);
+      else
+        m_songs.Remove(*it);
+    }
+  }
+  if (!musicVideos.empty() && (m_type.Equals("musicvideos") || m_type.Equals("mixed")))
+  {
+    CVideoDatabase database;
+    if (!database.Open())
     {
       OnError(16033, (CStdString)"Party mode could not open database. Aborting.");
       return false;
     }
-    database.Close();
+    for (set<int>::const_iterator it = musicVideos.begin(); it != musicVideos.end(); ++it)
+    {
+      CStdString where = database.PrepareSQL("WHERE idMVideo = %i", *it);
+      if (!m_strCurrentFilterVideo.IsEmpty())
+        where += " AND (" + m_strCurrentFilterVideo + ")";
+      vector< pair<int,int> > songIDs;
+      if (database.GetMusicVideoIDs(where, songIDs) > 0)
+        m_musicVideos.Add(*it);
+      else
+        m_musicVideos.Remove(*it);
+    }
   }
+  SetHistorySize();
   return true;
 }
 
+void CPartyModeManager::SetHistorySize()
+{
+  m_iMatchingSongs = m_songs.Size() + m_musicVideos.Size();
+
+  // keep up to half of the matching songs out of the picks, but no more than the last 200
+  unsigned int songsInHistory = 0;
+  if (m_iMatchingSongs >= 50)
+    songsInHistory = min(m_iMatchingSongs / 2, 200);
+
+  // shared between songs and music videos in proportion to how many match
+  unsigned int songsHistory = m_iMatchingSongs > 0 ? (unsigned int)((uint64_t)songsInHistory * m_songs.Size() / m_iMatchingSongs) : 0;
+  m_songs.SetHistorySize(songsHistory);
+  m_musicVideos.SetHistorySize(songsInHistory - songsHistory);
+
+  CLog::Log(LOGINFO,"PARTY MODE MANAGER: Matching songs = %i, History size = %u", m_iMatchingSongs, songsInHistory);
+}
+
 void CPartyModeManager::Add(CFileItemPtr &pItem)
 {
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
@@ -508,6 +619,8 @@ void CPartyModeManager::OnError(int iError, const CStdString&  strLogMessage)
   // open error dialog
   CGUIDialogOK::ShowAndGetInput(257, 16030, iError, 0);
   CLog::Log(LOGERROR, "PARTY MODE MANAGER: %s", strLogMessage.c_str());
+  if (m_bEnabled)
+    ANNOUNCEMENT::CAnnouncementManager::RemoveAnnouncer(this);
   m_bEnabled = false;
   SendUpdateMessage();
 }
@@ -575,8 +688,13 @@ void CPartyModeManager::ClearState()
   m_iRelaxedSongs = 0;
   m_iRandomSongs = 0;
 
-  m_songsInHistory = 0;
-  m_history.clear();
+  m_songs.Reset(vector<int>());
+  m_musicVideos.Reset(vector<int>());
+
+  CSingleLock lock(m_changesSection);
+  m_changedSongs.clear();
+  m_changedMusicVideos.clear();
+  m_bRefresh = false;
 }
 
 void CPartyModeManager::UpdateStats()
@@ -590,105 +708,25 @@ bool CPartyModeManager::AddInitialSongs(vector<pair<int,int> > &songIDs)
 {
   int iPlaylist = m_bIsVideo ? PLAYLIST_VIDEO : PLAYLIST_MUSIC;
 
+  vector<int> songs, musicVideos;
+  for (vector< pair<int,int> >::const_iterator it = songIDs.begin(); it != songIDs.end(); it++)
+    (it->first == 1 ? songs : musicVideos).push_back(it->second);
+  m_songs.Reset(songs);
+  m_musicVideos.Reset(musicVideos);
+  SetHistorySize();
+
   CPlayList& playlist = g_playlistPlayer.GetPlaylist(iPlaylist);
   int iMissingSongs = QUEUE_DEPTH - playlist.size();
   if (iMissingSongs > 0)
   {
-    // generate iMissingSongs random ids from songIDs
-    if (iMissingSongs > (int)songIDs.size())
+    if (iMissingSongs > m_iMatchingSongs)
       return false; // can't do it if we have less songs than we need
 
-    vector<pair<int,int> > chosenSongIDs;
-    GetRandomSelection(songIDs, iMissingSongs, chosenSongIDs);
-    CStdString sqlWhereMusic = "songview.idSong IN (";
-    CStdString sqlWhereVideo = "idMVideo IN (";
-
-    for (vector< pair<int,int> >::iterator it = chosenSongIDs.begin(); it != chosenSongIDs.end(); it++)
-    {
-      CStdString song;
-      song.Format("%i,", it->second);
-      if (it->first == 1)
-        sqlWhereMusic += song;
-      if (it->first == 2)
-        sqlWhereVideo += song;
-    }
-    // add songs to fill queue
-    CFileItemList items;
-
-    if (sqlWhereMusic.size() > 26)
-    {
-      sqlWhereMusic[sqlWhereMusic.size() - 1] = ')'; // replace the last comma with closing bracket
-      CMusicDatabase database;
-      database.Open();
-      database.GetSongsByWhere("musicdb://4/", sqlWhereMusic, items);
-    }
-    if (sqlWhereVideo.size() > 19)
-    {
-      sqlWhereVideo[sqlWhereVideo.size() - 1] = ')'; // replace the last comma with closing bracket
-      CVideoDatabase database;
-      database.Open();
-      database.GetMusicVideosByWhere("videodb://3/2/", sqlWhereVideo, items);
-    }
-
-    m_history = chosenSongIDs;
-    items.Randomize(); //randomizing the initial list or they will be in database order
-    for (int i = 0; i < items.Size(); i++)
-    {
-      CFileItemPtr item(items[i]);
-      Add(item);
-      // TODO: Allow "relaxed restrictions" later?
-    }
+    return AddRandomSongs(iMissingSongs);
   }
   return true;
 }
 
-pair<CStdString,CStdString> CPartyModeManager::GetWhereClauseWithHistory() const
-{
-  CStdString historyWhereMusic;
-  CStdString historyWhereVideo;
-  // now add this on to the normal where clause
-  if (m_history.size())
-  {
-    if (m_strCurrentFilterMusic.IsEmpty())
-      historyWhereMusic = "songview.idSong not in (";
-    else
-      historyWhereMusic = m_strCurrentFilterMusic + " and songview.idSong not in (";
-    if (m_strCurrentFilterVideo.IsEmpty())
-      historyWhereVideo = "idMVideo not in (";
-    else
-      historyWhereVideo = m_strCurrentFilterVideo + " and idMVideo not in (";
-
-    for (unsigned int i = 0; i < m_history.size(); i++)
-    {
-      CStdString number;
-      number.Format("%i,", m_history[i].second);
-      if (m_history[i].first == 1)
-        historyWhereMusic += number;
-      if (m_history[i].first == 2)
-        historyWhereVideo += number;
-    }
-    historyWhereMusic.TrimRight(",");
-    historyWhereMusic += ")";
-    historyWhereVideo.TrimRight(",");
-    historyWhereVideo += ")";
-  }
-  return make_pair(historyWhereMusic,historyWhereVideo);
-}
-
-void CPartyModeManager::AddToHistory(int type, int songID)
-{
-  while (m_history.size() >= m_songsInHistory && m_songsInHistory)
-    m_history.erase(m_history.begin());
-  m_history.push_back(make_pair(type,songID));
-}
-
-void CPartyModeManager::GetRandomSelection(vector< pair<int,int> >& in, unsigned int number, vector< pair<int,int> >& out)
-{
-  number = min(number, (unsigned int)in.size());
-  random_shuffle(in.begin(), in.end());
-  out.assign(in.begin(), in.begin() + number);
-}
-
 bool CPartyModeManager::IsEnabled(PartyModeContext context /* = PARTYMODECONTEXT_UNKNOWN */) const
 {
   if (!m_bEnabled) return false;
@@ -699,6 +737,50 @@ bool CPartyModeManager::IsEnabled(PartyModeContext context /* = PARTYMODECONTEXT
   return true; // unknown, but we're enabled
 }
 
+void CPartyModeManager::Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data)
+{
+  if ((flag & (ANNOUNCEMENT::AudioLibrary | ANNOUNCEMENT::VideoLibrary)) == 0)
+    return;
+
+  CSingleLock lock(m_changesSection);
+
+  // a scan or clean has announced its songs one by one, fetch them all again instead
+  if (strcmp(message, "OnScanFinished") == 0 ||
+      strcmp(message, "OnCleanFinished") == 0)
+  {
+    m_bRefresh = true;
+    m_changedSongs.clear();
+    m_changedMusicVideos.clear();
+    return;
+  }
+  if (strcmp(message, "OnUpdate") != 0 && strcmp(message, "OnRemove") != 0)
+    return;
+
+  // a song being played changes only its playcount, which doesn't change what's picked
+  if (data.isMember("playcount"))
+    return;
+
+  // updates of an item carry the type and id under "item", the rest at the top
+  const CVariant &item = data.isMember("item") ? data["item"] : data;
+  if (!item.isMember("type") || !item.isMember("id"))
+    return;
+  CStdString type = item["type"].asString();
+  if (type.Equals("song"))
+    m_changedSongs.insert((int)item["id"].asInteger());
+  else if (type.Equals("musicvideo"))
+    m_changedMusicVideos.insert((int)item["id"].asInteger());
+  else
+    return;
+
+  // pick up the changed songs before the next pick
+  if (m_changedSongs.size() + m_changedMusicVideos.size() > MAX_CHANGED_SONGS)
+  {
+    m_bRefresh = true;
+    m_changedSongs.clear();
+    m_changedMusicVideos.clear();
+  }
+}
+
 void CPartyModeManager::Announce()
 {
   if (g_application.IsPlaying())
@@ -19,8 +19,13 @@
  *
  */
 
+#include "interfaces/IAnnouncer.h"
+#include "threads/CriticalSection.h"
+#include "utils/ShuffleSampler.h"
 #include "utils/StdString.h"
 
+#include <set>
+
 #include <boost/shared_ptr.hpp>
 
 class CFileItem; typedef boost::shared_ptr<CFileItem> CFileItemPtr;
@@ -37,7 +42,7 @@ typedef enum
   PARTYMODECONTEXT_VIDEO
 } PartyModeContext;
 
-class CPartyModeManager
+class CPartyModeManager : public ANNOUNCEMENT::IAnnouncer
 {
 public:
   CPartyModeManager(void);
@@ -58,10 +63,16 @@ public:
   int GetRandomSongs();
   PartyModeContext GetType() const;
 
+  virtual void Announce(ANNOUNCEMENT::AnnouncementFlag flag, const char *sender, const char *message, const CVariant &data);
+
 private:
   void Process();
   bool AddRandomSongs(int iSongs = 0);
   bool AddInitialSongs(std::vector< std::pair<int,int> > &songIDs);
+  bool AddSongs(const std::vector< std::pair<int,int> > &songIDs);
+  bool RefreshSongs();
+  bool ApplyChanges();
+  void SetHistorySize();
   void Add(CFileItemPtr &pItem);
   bool ReapSongs();
   bool MovePlaying();
@@ -69,9 +80,6 @@ private:
   void OnError(int iError, const CStdString& strLogMessage);
   void ClearState();
   void UpdateStats();
-  std::pair<CStdString,CStdString> GetWhereClauseWithHistory() const;
-  void AddToHistory(int type, int songID);
-  void GetRandomSelection(std::vector< std::pair<int,int> > &in, unsigned int number, std::vector< std::pair<int, int> > &out);
   void Announce();
 
   // state
@@ -90,9 +98,15 @@ private:
   int m_iRelaxedSongs;
   int m_iRandomSongs;
 
-  // history
-  unsigned int m_songsInHistory;
-  std::vector< std::pair<int,int> > m_history;
+  // matching songs and music videos to pick from, keeping the history out of the picks
+  CShuffleSampler m_songs;
+  CShuffleSampler m_musicVideos;
+
+  // library changes announced since the last pick, they come in on the announcer's thread
+  CCriticalSection m_changesSection;
+  std::set<int> m_changedSongs;
+  std::set<int> m_changedMusicVideos;
+  bool m_bRefresh;
 };
 
 extern CPartyModeManager g_partyModeManager;
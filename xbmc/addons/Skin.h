@@ -109,6 +109,15 @@ public:
 //  static bool Check(const CStdString& strSkinDir); // checks if everything is present and accounted for without loading the skin
   static double GetMinVersion();
   void LoadIncludes();
+
+  /*! \brief Load an additional include file, as a window referencing it would
+   \param file full path of the include file
+   \return true if the file is loaded
+   */
+  bool LoadIncludeFile(const CStdString &file) { return m_includes.LoadIncludes(file); }
+
+  /*! \brief The include files loaded so far, in the order they were loaded */
+  const std::vector<CStdString> &GetIncludeFiles() const { return m_includes.GetFiles(); }
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 protected:
   /*! \brief Given a resolution, retrieve the corresponding directory name
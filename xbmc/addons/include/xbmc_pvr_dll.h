@@ -258,6 +258,15 @@ extern "C"
    */
   PVR_ERROR GetRecordings(ADDON_HANDLE handle);
 
+  /*!
+   * Get a token that changes whenever the recordings on the backend change, such as a revision number or the
+   * time of the last change. XBMC keeps the recordings it has while the token stays the same, instead of
+   * calling GetRecordings() again.
+   * @return The token, or an empty string if the add-on can't tell whether the recordings changed.
+   * @remarks Optional, and only used if bSupportsRecordings is set to true. Return an empty string if this add-on won't provide this function.
+   */
+  const char* GetRecordingsChangeToken(void);
+
   /*!
    * Delete a recording on the backend.
    * @param recording The recording to delete.
@@ -332,6 +341,15 @@ extern "C"
    */
   PVR_ERROR GetTimers(ADDON_HANDLE handle);
 
+  /*!
+   * Get a token that changes whenever the timers on the backend change, such as a revision number or the
+   * time of the last change. XBMC keeps the timers it has while the token stays the same, instead of
+   * calling GetTimers() again.
+   * @return The token, or an empty string if the add-on can't tell whether the timers changed.
+   * @remarks Optional, and only used if bSupportsTimers is set to true. Return an empty string if this add-on won't provide this function.
+   */
+  const char* GetTimersChangeToken(void);
+
   /*!
    * Add a timer on the backend.
    * @param timer The timer to add.
@@ -650,6 +668,9 @@ extern "C"
     pClient->DemuxAbort                     = DemuxAbort;
     pClient->DemuxFlush                     = DemuxFlush;
     pClient->DemuxRead                      = DemuxRead;
+
+    pClient->GetRecordingsChangeToken       = GetRecordingsChangeToken;
+    pClient->GetTimersChangeToken           = GetTimersChangeToken;
   };
 };
 
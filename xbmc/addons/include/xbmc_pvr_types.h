@@ -74,7 +74,7 @@ struct DemuxPacket;
 #define PVR_STREAM_MAX_STREAMS 20
 
 /* current PVR API version */
-#define XBMC_PVR_API_VERSION "1.7.0"
+#define XBMC_PVR_API_VERSION "1.8.0"
 
 /* min. PVR API version */
 #define XBMC_PVR_MIN_API_VERSION "1.7.0"
@@ -376,6 +376,9 @@ extern "C" {
     bool         (__cdecl* CanSeekStream)(void);
     bool         (__cdecl* SeekTime)(int, bool, double*);
     void         (__cdecl* SetSpeed)(int);
+    /* added in 1.8.0, left NULL by older add-ons */
+    const char*  (__cdecl* GetRecordingsChangeToken)(void);
+    const char*  (__cdecl* GetTimersChangeToken)(void);
   } PVRClient;
 
 #ifdef __cplusplus
@@ -42,6 +42,15 @@
 
 using namespace std;
 
+static CSettingHandle settingStereoUpmix("audiooutput.stereoupmix");
+static CSettingHandle settingChannels("audiooutput.channels");
+static CSettingHandle settingAudioMode("audiooutput.mode");
+static CSettingHandle settingAudioDevice("audiooutput.audiodevice");
+static CSettingHandle settingPassthroughDevice("audiooutput.passthroughdevice");
+static CSettingHandle settingAC3Passthrough("audiooutput.ac3passthrough");
+static CSettingHandle settingDTSPassthrough("audiooutput.dtspassthrough");
+static CSettingHandle settingMultichannelLPCM("audiooutput.multichannellpcm");
+
 /* Define idle wait time based on platform in milliseconds */
 /* Higher wait times reduce thread CPU overhead when in    */
 /* idle or Suspend() modes                                 */
@@ -552,13 +561,13 @@ void CSoftAE::LoadSettings()
   if (m_audiophile)
     CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Audiophile switch enabled");
 
-  m_stereoUpmix = g_guiSettings.GetBool("audiooutput.stereoupmix");
+  m_stereoUpmix = g_guiSettings.GetBool(settingStereoUpmix);
   if (m_stereoUpmix)
     CLog::Log(LOGINFO, "CSoftAE::LoadSettings - Stereo upmix is enabled");
 
   /* load the configuration */
   m_stdChLayout = AE_CH_LAYOUT_2_0;
-  switch (g_guiSettings.GetInt("audiooutput.channels"))
+  switch (g_guiSettings.GetInt(settingChannels))
   {
     default:
     case  0: m_stdChLayout = AE_CH_LAYOUT_2_0; break; /* dont alow 1_0 output */
@@ -575,21 +584,21 @@ void CSoftAE::LoadSettings()
   }
 
   // force optical/coax to 2.0 output channels
-  if (!m_rawPassthrough && g_guiSettings.GetInt("audiooutput.mode") == AUDIO_IEC958)
+  if (!m_rawPassthrough && g_guiSettings.GetInt(settingAudioMode) == AUDIO_IEC958)
     m_stdChLayout = AE_CH_LAYOUT_2_0;
 
   /* get the output devices and ensure they exist */
-  m_device            = g_guiSettings.GetString("audiooutput.audiodevice");
-  m_passthroughDevice = g_guiSettings.GetString("audiooutput.passthroughdevice");
+  m_device            = g_guiSettings.GetString(settingAudioDevice);
+  m_passthroughDevice = g_guiSettings.GetString(settingPassthroughDevice);
   VerifySoundDevice(m_device           , false);
   VerifySoundDevice(m_passthroughDevice, true );
 
   m_transcode = (
-    g_guiSettings.GetBool("audiooutput.ac3passthrough") /*||
-    g_guiSettings.GetBool("audiooutput.dtspassthrough") */
+    g_guiSettings.GetBool(settingAC3Passthrough) /*||
+    g_guiSettings.GetBool(settingDTSPassthrough) */
   ) && (
-      (g_guiSettings.GetInt("audiooutput.mode") == AUDIO_IEC958) ||
-      (g_guiSettings.GetInt("audiooutput.mode") == AUDIO_HDMI && !g_guiSettings.GetBool("audiooutput.multichannellpcm"))
+      (g_guiSettings.GetInt(settingAudioMode) == AUDIO_IEC958) ||
+      (g_guiSettings.GetInt(settingAudioMode) == AUDIO_HDMI && !g_guiSettings.GetBool(settingMultichannelLPCM))
   );
 }
 
@@ -28,6 +28,9 @@
 
 using namespace std;
 
+static CSettingHandle settingStereoUpmix("audiooutput.stereoupmix");
+static CSettingHandle settingNormalizeLevels("audiooutput.normalizelevels");
+
 CAERemap::CAERemap() : m_inChannels(0), m_outChannels(0) 
 {
   memset(m_mixInfo, 0, sizeof(m_mixInfo));
@@ -184,7 +187,7 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
 
   #undef RM
 
-  if (g_guiSettings.GetBool("audiooutput.stereoupmix"))
+  if (g_guiSettings.GetBool(settingStereoUpmix))
     BuildUpmixMatrix(input, output);
 
   /* normalize the values */
@@ -194,7 +197,7 @@ bool CAERemap::Initialize(CAEChannelInfo input, CAEChannelInfo output, bool fina
   else
   {
     //FIXME: guisetting is reversed, change the setting name after frodo
-    normalize = !g_guiSettings.GetBool("audiooutput.normalizelevels");
+    normalize = !g_guiSettings.GetBool(settingNormalizeLevels);
     CLog::Log(LOGDEBUG, "AERemap: Downmix normalization is %s", (normalize ? "enabled" : "disabled"));
   }
 
@@ -82,6 +82,10 @@
 
 using namespace Shaders;
 
+static CSettingHandle settingUsePBO("videoplayer.usepbo");
+static CSettingHandle settingRenderMethod("videoplayer.rendermethod");
+static CSettingHandle settingLimitedRange("videoscreen.limitedrange");
+
 static const GLubyte stipple_weave[] = {
   0x00, 0x00, 0x00, 0x00,
   0xFF, 0xFF, 0xFF, 0xFF,
@@ -312,7 +316,7 @@ bool CLinuxRendererGL::Configure(unsigned int width, unsigned int height, unsign
   m_nonLinStretchGui = false;
   m_pixelRatio       = 1.0;
 
-  m_pboSupported = glewIsSupported("GL_ARB_pixel_buffer_object") && g_guiSettings.GetBool("videoplayer.usepbo");
+  m_pboSupported = glewIsSupported("GL_ARB_pixel_buffer_object") && g_guiSettings.GetBool(settingUsePBO);
 
   return true;
 }
@@ -968,7 +972,7 @@ void CLinuxRendererGL::LoadShaders(int field)
   }
   else
   {
-    int requestedMethod = g_guiSettings.GetInt("videoplayer.rendermethod");
+    int requestedMethod = g_guiSettings.GetInt(settingRenderMethod);
     CLog::Log(LOGDEBUG, "GL: Requested render method: %d", requestedMethod);
 
     if (m_pYUVShader)
@@ -3188,7 +3192,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
 {
   if(feature == RENDERFEATURE_BRIGHTNESS)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool(settingLimitedRange))
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
@@ -3201,7 +3205,7 @@ bool CLinuxRendererGL::Supports(ERENDERFEATURE feature)
   
   if(feature == RENDERFEATURE_CONTRAST)
   {
-    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool("videoscreen.limitedrange"))
+    if ((m_renderMethod & RENDER_VDPAU) && !g_guiSettings.GetBool(settingLimitedRange))
       return true;
 
     if (m_renderMethod & RENDER_VAAPI)
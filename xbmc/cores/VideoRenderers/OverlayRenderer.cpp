@@ -21,6 +21,7 @@
  */
 #include "system.h"
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlay.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
@@ -31,12 +32,15 @@
 #include "settings/Settings.h"
 #include "threads/SingleLock.h"
 #include "utils/MathUtils.h"
+#include "utils/log.h"
 #if defined(HAS_GL) || defined(HAS_GLES)
 #include "OverlayRendererGL.h"
 #elif defined(HAS_DX)
 #include "OverlayRendererDX.h"
 #endif
 
+#include <algorithm>
+
 
 using namespace OVERLAY;
 
@@ -90,12 +94,17 @@ CRenderer::CRenderer()
 {
   m_render = 0;
   m_decode = (m_render + 1) % 2;
+  m_atlas  = NULL;
+  m_atlas_flush = false;
 }
 
 CRenderer::~CRenderer()
 {
   for(int i = 0; i < 2; i++)
     Release(m_buffers[i]);
+
+  if(m_atlas)
+    m_atlas->Release();
 }
 
 void CRenderer::AddOverlay(CDVDOverlay* o, double pts)
@@ -155,6 +164,9 @@ void CRenderer::Flush()
     Release(m_buffers[i]);
 
   Release(m_cleanup);
+
+  // the atlas owns a texture, so it's released from Render()
+  m_atlas_flush = true;
 }
 
 void CRenderer::Flip()
@@ -173,6 +185,13 @@ void CRenderer::Render()
 
   Release(m_cleanup);
 
+  if(m_atlas_flush && m_atlas)
+  {
+    m_atlas->Release();
+    m_atlas = NULL;
+  }
+  m_atlas_flush = false;
+
   SElementV& list = m_buffers[m_render];
   for(SElementV::iterator it = list.begin(); it != list.end(); it++)
   {
@@ -299,10 +318,33 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
       return o->m_overlay->Acquire();
   }
 
+  SQuads quads;
+  if(!m_atlas || !m_atlas->Convert(images, changes, quads))
+  {
+    // start over with an empty atlas, overlays still showing keep the old one
+    if(m_atlas)
+      m_atlas->Release();
+    m_atlas = NULL;
+
+    int limit = std::min((int)g_Windowing.GetMaxTextureSize(), 2048);
+    int size  = 256;
+    while(size < std::max(width, height) && size < limit)
+      size <<= 1;
+#if defined(HAS_GL) || defined(HAS_GLES)
+    m_atlas = new CGlyphAtlasGL(size);
+#elif defined(HAS_DX)
+    m_atlas = new CGlyphAtlasDX(size);
+#endif
+    if(m_atlas && !m_atlas->Convert(images, 2, quads))
+      CLog::Log(LOGWARNING, "%s - not all subtitle bitmaps fit a %dx%d texture", __FUNCTION__, size, size);
+  }
+
 #if defined(HAS_GL) || defined(HAS_GLES)
-  return new COverlayGlyphGL(images, width, height);
+  if(m_atlas)
+    return new COverlayGlyphGL((CGlyphAtlasGL*)m_atlas, quads, width, height);
 #elif defined(HAS_DX)
-  return new COverlayQuadsDX(images, width, height);
+  if(m_atlas)
+    return new COverlayQuadsDX((CGlyphAtlasDX*)m_atlas, quads, width, height);
 #endif
   return NULL;
 }
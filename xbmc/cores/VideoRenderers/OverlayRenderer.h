@@ -33,6 +33,8 @@ class CDVDOverlaySSA;
 
 namespace OVERLAY {
 
+  class CGlyphAtlas;
+
   struct SRenderState
   {
     float x;
@@ -129,5 +131,8 @@ namespace OVERLAY {
     int              m_render;
 
     COverlayV        m_cleanup;
+
+    CGlyphAtlas*     m_atlas;       /* bitmaps of the ssa overlays rendered so far */
+    bool             m_atlas_flush; /* let go of the atlas on the next render */
   };
 }
@@ -159,7 +159,74 @@ static bool LoadTexture(int width, int height, int stride
   return true;
 }
 
-COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
+CGlyphAtlasDX::CGlyphAtlasDX(int size)
+  : CGlyphAtlas(size)
+{
+  m_u = 0.0f;
+  m_v = 0.0f;
+}
+
+CGlyphAtlasDX::~CGlyphAtlasDX()
+{
+  m_texture.Release();
+}
+
+bool CGlyphAtlasDX::Upload()
+{
+  if(!m_texture.Get())
+  {
+    m_dirty_y1 = 0;
+    m_dirty_y2 = 0;
+    return LoadTexture(m_size, m_size, m_size
+                     , D3DFMT_A8
+                     , m_data
+                     , &m_u, &m_v
+                     , &m_texture);
+  }
+
+  if(m_dirty_y2 <= m_dirty_y1)
+    return true;
+
+  D3DSURFACE_DESC desc;
+  if(!m_texture.GetLevelDesc(0, &desc))
+  {
+    CLog::Log(LOGERROR, __FUNCTION__" - failed to get level description");
+    return false;
+  }
+
+  RECT rect = { 0, m_dirty_y1, m_size, m_dirty_y2 };
+  D3DLOCKED_RECT lr;
+  if (!m_texture.LockRect(0, &lr, &rect, 0))
+  {
+    CLog::Log(LOGERROR, __FUNCTION__" - failed to lock texture");
+    return false;
+  }
+
+  uint8_t* src = m_data + m_size * m_dirty_y1;
+  uint8_t* dst = (uint8_t*)lr.pBits;
+
+  // Some old hardware doesn't have D3DFMT_A8 and returns D3DFMT_A8R8G8B8 textures instead
+  for (int y = m_dirty_y1; y < m_dirty_y2; y++)
+  {
+    if (desc.Format == D3DFMT_A8)
+      memcpy(dst, src, m_size);
+    else
+    {
+      for (int x = 0; x < m_size; x++)
+        dst[x*4 + ALPHA_CHANNEL_OFFSET] = src[x];
+    }
+    src += m_size;
+    dst += lr.Pitch;
+  }
+
+  m_texture.UnlockRect(0);
+
+  m_dirty_y1 = 0;
+  m_dirty_y2 = 0;
+  return true;
+}
+
+COverlayQuadsDX::COverlayQuadsDX(CGlyphAtlasDX* atlas, SQuads& quads, int width, int height)
 {
   m_width  = 1.0;
   m_height = 1.0;
@@ -169,27 +236,17 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   m_y      = 0.0f;
   m_count  = 0;
   m_fvf    = D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1;
+  m_atlas  = (CGlyphAtlasDX*)atlas->Acquire();
 
-  SQuads quads;
-  if(!convert_quad(images, quads))
+  if(quads.count == 0)
     return;
-  
-  float u, v;
-  if(!LoadTexture(quads.size_x
-                , quads.size_y
-                , quads.size_x
-                , D3DFMT_A8
-                , quads.data
-                , &u, &v
-                , &m_texture))
-  {
+
+  if(!m_atlas->Upload())
     return;
-  }
 
   if (!m_vertex.Create(sizeof(VERTEX) * 6 * quads.count, D3DUSAGE_WRITEONLY, m_fvf, g_Windowing.DefaultD3DPool()))
   {
     CLog::Log(LOGERROR, "%s - failed to create vertex buffer", __FUNCTION__);
-    m_texture.Release();
     return;
   }
 
@@ -199,12 +256,11 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   if (!m_vertex.Lock(0, 0, (void**)&vt, 0))
   {
     CLog::Log(LOGERROR, "%s - failed to lock vertex buffer", __FUNCTION__);
-    m_texture.Release();
     return;
   }
 
-  float scale_u = u    / quads.size_x;
-  float scale_v = v    / quads.size_y;
+  float scale_u = m_atlas->m_u / quads.size_x;
+  float scale_v = m_atlas->m_v / quads.size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
@@ -255,6 +311,7 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
 
 COverlayQuadsDX::~COverlayQuadsDX()
 {
+  m_atlas->Release();
 }
 
 void COverlayQuadsDX::Render(SRenderState &state)
@@ -282,7 +339,7 @@ void COverlayQuadsDX::Render(SRenderState &state)
 
   device->SetTransform(D3DTS_WORLD, &world);
 
-  device->SetTexture( 0, m_texture.Get() );
+  device->SetTexture( 0, m_atlas->m_texture.Get() );
   device->SetSamplerState(0, D3DSAMP_MAGFILTER, D3DTEXF_LINEAR);
   device->SetSamplerState(0, D3DSAMP_MINFILTER, D3DTEXF_LINEAR);
   device->SetSamplerState(0, D3DSAMP_ADDRESSU , D3DTADDRESS_CLAMP);
@@ -23,6 +23,7 @@
 #include "OverlayRendererUtil.h"
 #include "rendering/dx/RenderSystemDX.h"
 #include "guilib/D3DResource.h"
+#include "OverlayRendererUtil.h"
 
 #ifdef HAS_DX
 
@@ -34,11 +35,26 @@ typedef struct ass_image ASS_Image;
 
 namespace OVERLAY {
 
+  class CGlyphAtlasDX
+    : public CGlyphAtlas
+  {
+  public:
+             CGlyphAtlasDX(int size);
+    virtual ~CGlyphAtlasDX();
+
+    /* copies the rows written since the last upload into the texture */
+    bool Upload();
+
+    CD3DTexture                  m_texture;
+    float                        m_u;
+    float                        m_v;
+  };
+
   class COverlayQuadsDX
     : public COverlayMainThread
   {
   public:
-    COverlayQuadsDX(ASS_Image* images, int width, int height);
+    COverlayQuadsDX(CGlyphAtlasDX* atlas, SQuads& quads, int width, int height);
     virtual ~COverlayQuadsDX();
 
     void Render(SRenderState& state);
@@ -51,7 +67,7 @@ namespace OVERLAY {
 
     int                          m_count;
     DWORD                        m_fvf;
-    CD3DTexture                  m_texture;
+    CGlyphAtlasDX*               m_atlas;
     CD3DVertexBuffer             m_vertex;
   };
 
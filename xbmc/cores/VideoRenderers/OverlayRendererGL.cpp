@@ -260,37 +260,69 @@ COverlayTextureGL::COverlayTextureGL(CDVDOverlaySpu* o)
   m_pma    = !!USE_PREMULTIPLIED_ALPHA;
 }
 
-COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
+CGlyphAtlasGL::CGlyphAtlasGL(int size)
+  : CGlyphAtlas(size)
+{
+  m_texture = 0;
+}
+
+CGlyphAtlasGL::~CGlyphAtlasGL()
+{
+  glDeleteTextures(1, &m_texture);
+}
+
+void CGlyphAtlasGL::Upload()
+{
+  if(m_texture && m_dirty_y2 <= m_dirty_y1)
+    return;
+
+  glEnable(GL_TEXTURE_2D);
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+  if(!m_texture)
+  {
+    // the atlas is a power of two, so the whole of it is uploaded once
+    glGenTextures(1, &m_texture);
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_ALPHA
+               , m_size, m_size, 0
+               , GL_ALPHA, GL_UNSIGNED_BYTE, m_data);
+  }
+  else
+  {
+    glBindTexture(GL_TEXTURE_2D, m_texture);
+    glTexSubImage2D(GL_TEXTURE_2D, 0
+                  , 0, m_dirty_y1, m_size, m_dirty_y2 - m_dirty_y1
+                  , GL_ALPHA, GL_UNSIGNED_BYTE
+                  , m_data + m_size * m_dirty_y1);
+  }
+
+  m_dirty_y1 = 0;
+  m_dirty_y2 = 0;
+
+  glBindTexture(GL_TEXTURE_2D, 0);
+  glDisable(GL_TEXTURE_2D);
+}
+
+COverlayGlyphGL::COverlayGlyphGL(CGlyphAtlasGL* atlas, SQuads& quads, int width, int height)
 {
   m_vertex = NULL;
+  m_count  = 0;
   m_width  = 1.0;
   m_height = 1.0;
   m_align  = ALIGN_VIDEO;
   m_pos    = POSITION_RELATIVE;
   m_x      = 0.0f;
   m_y      = 0.0f;
-  m_texture = 0;
+  m_atlas  = (CGlyphAtlasGL*)atlas->Acquire();
 
-  SQuads quads;
-  if(!convert_quad(images, quads))
+  if(quads.count == 0)
     return;
 
-  glGenTextures(1, &m_texture);
-  glEnable(GL_TEXTURE_2D);
-  glBindTexture(GL_TEXTURE_2D, m_texture);
-
-  LoadTexture(GL_TEXTURE_2D
-            , quads.size_x
-            , quads.size_y
-            , quads.size_x
-            , &m_u, &m_v
-            , GL_ALPHA
-            , GL_ALPHA
-            , quads.data);
+  m_atlas->Upload();
 
-
-  float scale_u = m_u / quads.size_x;
-  float scale_v = m_v / quads.size_y;
+  float scale_u = 1.0f / quads.size_x;
+  float scale_v = 1.0f / quads.size_y;
 
   float scale_x = 1.0f / width;
   float scale_y = 1.0f / height;
@@ -361,26 +393,23 @@ COverlayGlyphGL::COverlayGlyphGL(ASS_Image* images, int width, int height)
     vs += 1;
     vt += 4;
   }
-
-  glBindTexture(GL_TEXTURE_2D, 0);
-  glDisable(GL_TEXTURE_2D);
 }
 
 COverlayGlyphGL::~COverlayGlyphGL()
 {
-  glDeleteTextures(1, &m_texture);
+  m_atlas->Release();
   free(m_vertex);
 }
 
 void COverlayGlyphGL::Render(SRenderState& state)
 {
-  if ((m_texture == 0) || (m_count == 0))
+  if ((m_atlas->m_texture == 0) || (m_count == 0))
     return;
 
   glEnable(GL_TEXTURE_2D);
   glEnable(GL_BLEND);
 
-  glBindTexture(GL_TEXTURE_2D, m_texture);
+  glBindTexture(GL_TEXTURE_2D, m_atlas->m_texture);
   glBlendFunc(GL_SRC_ALPHA,GL_ONE_MINUS_SRC_ALPHA);
 
   glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
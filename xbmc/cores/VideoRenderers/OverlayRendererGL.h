@@ -23,6 +23,7 @@
 #pragma once
 #include "system_gl.h"
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -50,11 +51,24 @@ namespace OVERLAY {
     bool   m_pma; /*< is alpha in texture premultipled in the values */
   };
 
+  class CGlyphAtlasGL
+     : public CGlyphAtlas
+  {
+  public:
+             CGlyphAtlasGL(int size);
+    virtual ~CGlyphAtlasGL();
+
+    /* copies the rows written since the last upload into the texture */
+    void Upload();
+
+    GLuint m_texture;
+  };
+
   class COverlayGlyphGL
      : public COverlayMainThread
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(CGlyphAtlasGL* atlas, SQuads& quads, int width, int height);
 
    virtual ~COverlayGlyphGL();
 
@@ -70,9 +84,7 @@ namespace OVERLAY {
    VERTEX* m_vertex;
    int     m_count;
 
-   GLuint m_texture;
-   float  m_u;
-   float  m_v;
+   CGlyphAtlasGL* m_atlas;
   };
 
 }
@@ -23,8 +23,12 @@
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
 #include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
+#include "threads/Atomics.h"
 #include "windowing/WindowingFactory.h"
 
+#include <algorithm>
+#include <string.h>
+
 namespace OVERLAY {
 
 static uint32_t build_rgba(int a, int r, int g, int b, bool mergealpha)
@@ -180,97 +184,189 @@ uint32_t* convert_rgba(CDVDOverlaySpu* o, bool mergealpha
   return rgba;
 }
 
-bool convert_quad(ASS_Image* images, SQuads& quads)
+CGlyphAtlas::CGlyphAtlas(int size)
 {
-  ASS_Image* img;
+  m_size       = size;
+  m_data       = (uint8_t*)calloc(size * size, 1);
+  m_dirty_y1   = 0;
+  m_dirty_y2   = 0;
+  m_copied     = 0;
+  m_shelf_x    = 0;
+  m_shelf_y    = 0;
+  m_shelf_h    = 0;
+  m_references = 1;
+}
 
-  if (!images)
-    return false;
+CGlyphAtlas::~CGlyphAtlas()
+{
+  free(m_data);
+}
 
-  // first calculate how many glyph we have and the total x length
+CGlyphAtlas* CGlyphAtlas::Acquire()
+{
+  AtomicIncrement(&m_references);
+  return this;
+}
 
-  for(img = images; img; img = img->next)
+long CGlyphAtlas::Release()
+{
+  long count = AtomicDecrement(&m_references);
+  if (count == 0)
+    delete this;
+
+  return count;
+}
+
+static uint32_t hash_bitmap(ASS_Image* img)
+{
+  // FNV-1a over the visible part of the rows
+  uint32_t hash = 2166136261u;
+  for(int y = 0; y < img->h; y++)
   {
-    // fully transparent or width or height is 0 -> not displayed
-    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
-      continue;
+    const unsigned char* row = img->bitmap + img->stride * y;
+    for(int x = 0; x < img->w; x++)
+      hash = (hash ^ row[x]) * 16777619u;
+  }
+  return hash;
+}
 
-    quads.size_x += img->w;
-    quads.count++;
+bool CGlyphAtlas::Find(ASS_Image* img, const SKey& key, SSlot& slot)
+{
+  std::pair<SlotMap::iterator, SlotMap::iterator> range = m_slots.equal_range(key);
+  for(SlotMap::iterator it = range.first; it != range.second; it++)
+  {
+    // compare the pixels, a hash match alone could be a collision
+    int y = 0;
+    for(; y < img->h; y++)
+    {
+      if(memcmp(m_data        + m_size      * (it->second.v + y) + it->second.u
+              , img->bitmap   + img->stride * y
+              , img->w) != 0)
+        break;
+    }
+
+    if(y == img->h)
+    {
+      slot = it->second;
+      return true;
+    }
+  }
+  return false;
+}
+
+bool CGlyphAtlas::Insert(ASS_Image* img, const SKey& key, SSlot& slot)
+{
+  // shelves are as high as their highest bitmap, bitmaps are one pixel apart
+  if(m_shelf_x + img->w > m_size)
+  {
+    m_shelf_y += m_shelf_h + 1;
+    m_shelf_x  = 0;
+    m_shelf_h  = 0;
   }
 
-  if (quads.count == 0)
+  if(img->w > m_size
+  || m_shelf_y + img->h > m_size)
     return false;
 
-  while(quads.size_x > (int)g_Windowing.GetMaxTextureSize())
-    quads.size_x /= 2;
+  slot.u = m_shelf_x;
+  slot.v = m_shelf_y;
 
-  int curr_x = 0;
-  int curr_y = 0;
+  for(int y = 0; y < img->h; y++)
+    memcpy(m_data      + m_size      * (slot.v + y) + slot.u
+         , img->bitmap + img->stride * y
+         , img->w);
 
-  // calculate the y size of the texture
+  m_copied += img->w * img->h;
 
-  for(img = images; img; img = img->next)
+  if(m_dirty_y2 <= m_dirty_y1)
   {
-    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
-      continue;
+    m_dirty_y1 = slot.v;
+    m_dirty_y2 = slot.v + img->h;
+  }
+  else
+  {
+    m_dirty_y1 = std::min(m_dirty_y1, slot.v);
+    m_dirty_y2 = std::max(m_dirty_y2, slot.v + img->h);
+  }
 
-    // check if we need to split to new line
-    if (curr_x + img->w >= quads.size_x)
-    {
-      quads.size_y += curr_y + 1;
-      curr_x = 0;
-      curr_y = 0;
-    }
+  m_shelf_x += img->w + 1;
+  m_shelf_h  = std::max(m_shelf_h, img->h);
 
-    curr_x += img->w + 1;
+  m_slots.insert(std::make_pair(key, slot));
+  return true;
+}
 
-    if (img->h > curr_y)
-      curr_y = img->h;
-  }
+bool CGlyphAtlas::Convert(ASS_Image* images, int changes, SQuads& quads)
+{
+  ASS_Image* img;
 
-  quads.size_y += curr_y + 1;
+  free(quads.quad);
+  quads.quad   = NULL;
+  quads.count  = 0;
+  quads.size_x = m_size;
+  quads.size_y = m_size;
+  m_copied     = 0;
 
-  // allocate space for the glyph positions and texturedata
+  int count = 0;
+  for(img = images; img; img = img->next)
+  {
+    // fully transparent or width or height is 0 -> not displayed
+    if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
+      continue;
+    count++;
+  }
 
-  quads.quad = (SQuad*)  calloc(quads.count, sizeof(SQuad));
-  quads.data = (uint8_t*)calloc(quads.size_x * quads.size_y, 1);
+  if(count == 0)
+  {
+    m_last.clear();
+    return true;
+  }
 
-  SQuad*   v    = quads.quad;
-  uint8_t* data = quads.data;
+  quads.quad = (SQuad*)calloc(count, sizeof(SQuad));
 
-  int y = 0;
+  // when only positions changed the bitmaps are the ones of the last call, in the same order
+  bool moved = changes == 1 && (int)m_last.size() == count;
+  if(!moved)
+    m_last.clear();
 
-  curr_x = 0;
-  curr_y = 0;
+  bool   fits = true;
+  SQuad* v    = quads.quad;
+  int    i    = 0;
 
   for(img = images; img; img = img->next)
   {
     if((img->color & 0xff) == 0xff || img->w == 0 || img->h == 0)
       continue;
 
-    unsigned int color = img->color;
-    unsigned int alpha = (color & 0xff);
-
-    if (curr_x + img->w >= quads.size_x)
+    SSlot slot;
+    if(moved)
+      slot = m_last[i++];
+    else
     {
-      curr_y += y + 1;
-      curr_x  = 0;
-      y       = 0;
-      data    = quads.data + curr_y * quads.size_x;
+      SKey key;
+      key.hash = hash_bitmap(img);
+      key.w    = img->w;
+      key.h    = img->h;
+
+      if(!Find(img, key, slot)
+      && !Insert(img, key, slot))
+      {
+        fits = false;
+        continue;
+      }
+      m_last.push_back(slot);
     }
 
-    unsigned int r = ((color >> 24) & 0xff);
-    unsigned int g = ((color >> 16) & 0xff);
-    unsigned int b = ((color >> 8 ) & 0xff);
+    unsigned int color = img->color;
+    unsigned int alpha = (color & 0xff);
 
     v->a = 255 - alpha;
-    v->r = r;
-    v->g = g;
-    v->b = b;
+    v->r = ((color >> 24) & 0xff);
+    v->g = ((color >> 16) & 0xff);
+    v->b = ((color >> 8 ) & 0xff);
 
-    v->u = curr_x;
-    v->v = curr_y;
+    v->u = slot.u;
+    v->v = slot.v;
 
     v->x = img->dst_x;
     v->y = img->dst_y;
@@ -279,19 +375,13 @@ bool convert_quad(ASS_Image* images, SQuads& quads)
     v->h = img->h;
 
     v++;
+    quads.count++;
+  }
 
-    for(int i=0; i<img->h; i++)
-      memcpy(data        + quads.size_x * i
-           , img->bitmap + img->stride  * i
-           , img->w);
-
-    if (img->h > y)
-      y = img->h;
+  if(!fits)
+    m_last.clear();
 
-    curr_x += img->w + 1;
-    data   += img->w + 1;
-  }
-  return true;
+  return fits;
 }
 
 }
@@ -19,7 +19,10 @@
  */
 #pragma once
 
+#include <stdint.h>
 #include <stdlib.h>
+#include <map>
+#include <vector>
 
 class CDVDOverlayImage;
 class CDVDOverlaySpu;
@@ -58,10 +61,67 @@ namespace OVERLAY {
     SQuad*   quad;
   };
 
+  /* Packs the bitmaps libass renders into one alpha texture that's kept
+   * between frames. Bitmaps are looked up by a hash of their pixels, so only
+   * bitmaps that weren't shown before are copied in. Space is never reused:
+   * once the atlas is full it's replaced, so overlays still holding the old
+   * one keep valid texture coordinates. */
+  class CGlyphAtlas
+  {
+  public:
+             CGlyphAtlas(int size);
+    virtual ~CGlyphAtlas();
+
+    CGlyphAtlas* Acquire();
+    long         Release();
+
+    /* fills quads with the visible images, packing the bitmaps that aren't in
+     * the atlas yet. changes is what libass reported for the images, 1 meaning
+     * only their positions changed. returns false if a bitmap didn't fit, the
+     * quads then hold the images that did */
+    bool Convert(ASS_Image* images, int changes, SQuads& quads);
+
+    int      m_size;
+    uint8_t* m_data;
+
+    int      m_dirty_y1; /* rows written since the last upload, none if m_dirty_y2 <= m_dirty_y1 */
+    int      m_dirty_y2;
+    int      m_copied;   /* bytes copied into the atlas by the last Convert() */
+
+  protected:
+    struct SKey
+    {
+      uint32_t hash;
+      int      w, h;
+      bool operator<(const SKey& right) const
+      {
+        if(hash != right.hash) return hash < right.hash;
+        if(w    != right.w)    return w    < right.w;
+        return h < right.h;
+      }
+    };
+
+    struct SSlot
+    {
+      int u, v;
+    };
+
+    typedef std::multimap<SKey, SSlot> SlotMap;
+
+    bool Insert(ASS_Image* img, const SKey& key, SSlot& slot);
+    bool Find(ASS_Image* img, const SKey& key, SSlot& slot);
+
+    SlotMap            m_slots;
+    std::vector<SSlot> m_last;    /* slots of the images converted last, in order */
+    int                m_shelf_x; /* the next free position on the current shelf */
+    int                m_shelf_y;
+    int                m_shelf_h;
+    long               m_references;
+  };
+
   uint32_t* convert_rgba(CDVDOverlayImage* o, bool mergealpha);
   uint32_t* convert_rgba(CDVDOverlaySpu*   o, bool mergealpha
                        , int& min_x, int& max_x
                        , int& min_y, int& max_y);
-  bool      convert_quad(ASS_Image* images, SQuads& quads);
 
 }
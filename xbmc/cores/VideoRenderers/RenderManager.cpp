@@ -634,9 +634,10 @@ RESOLUTION CXBMCRenderManager::GetResolution()
 
 float CXBMCRenderManager::GetMaximumFPS()
 {
+  static CSettingHandle settingVSync("videoscreen.vsync");
   float fps;
 
-  if (g_guiSettings.GetInt("videoscreen.vsync") != VSYNC_DISABLED)
+  if (g_guiSettings.GetInt(settingVSync) != VSYNC_DISABLED)
   {
     fps = (float)g_VideoReferenceClock.GetRefreshRate();
     if (fps <= 0) fps = g_graphicsContext.GetFPS();
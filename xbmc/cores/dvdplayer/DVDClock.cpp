@@ -22,6 +22,7 @@
 #include "video/VideoReferenceClock.h"
 #include <math.h>
 #include "utils/MathUtils.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/log.h"
 
@@ -36,15 +37,16 @@ CDVDClock::CDVDClock()
   CSingleLock lock(m_systemsection);
   CheckSystemClock();
 
-  m_systemUsed = m_systemFrequency;
-  m_pauseClock = 0;
-  m_bReset = true;
-  m_iDisc = 0;
+  m_sequence = 0;
+  m_state.systemUsed = m_systemFrequency;
+  m_state.pauseClock = 0;
+  m_state.bReset = true;
+  m_state.iDisc = 0;
   m_maxspeedadjust = 0.0;
   m_speedadjust = false;
 
   m_ismasterclock = true;
-  m_startClock = 0;
+  m_state.startClock = 0;
 }
 
 CDVDClock::~CDVDClock()
@@ -90,34 +92,63 @@ double CDVDClock::WaitAbsoluteClock(double target)
   return (double)systemtarget / freq * DVD_TIME_BASE;
 }
 
+CDVDClock::SState CDVDClock::ReadState()
+{
+  SState state;
+  long sequence;
+  for(;;)
+  {
+    sequence = m_sequence;
+    if(sequence & 1)
+    {
+      // a writer is halfway, wait for it rather than spin
+      CSingleLock lock(m_critSection);
+      continue;
+    }
+
+    AtomicFence();
+    state = m_state;
+    AtomicFence();
+
+    if(sequence == m_sequence)
+      return state;
+  }
+}
+
+void CDVDClock::WriteState(const SState& state)
+{
+  // caller holds m_critSection
+  AtomicIncrement(&m_sequence);
+  m_state = state;
+  AtomicIncrement(&m_sequence);
+}
+
 double CDVDClock::GetClock(bool interpolated /*= true*/)
 {
-  CSharedLock lock(m_critSection);
   return SystemToPlaying(g_VideoReferenceClock.GetTime(interpolated));
 }
 
 double CDVDClock::GetClock(double& absolute, bool interpolated /*= true*/)
 {
+  // the system clock was set up when this clock was constructed
   int64_t current = g_VideoReferenceClock.GetTime(interpolated);
-  {
-    CSingleLock lock(m_systemsection);
-    CheckSystemClock();
-    absolute = SystemToAbsolute(current);
-  }
-
-  CSharedLock lock(m_critSection);
+  absolute = SystemToAbsolute(current);
   return SystemToPlaying(current);
 }
 
 void CDVDClock::SetSpeed(int iSpeed)
 {
   // this will sometimes be a little bit of due to rounding errors, ie clock might jump abit when changing speed
-  CExclusiveLock lock(m_critSection);
+  CSingleLock lock(m_critSection);
+  SState state = m_state;
 
   if(iSpeed == DVD_PLAYSPEED_PAUSE)
   {
-    if(!m_pauseClock)
-      m_pauseClock = g_VideoReferenceClock.GetTime();
+    if(!state.pauseClock)
+    {
+      state.pauseClock = g_VideoReferenceClock.GetTime();
+      WriteState(state);
+    }
     return;
   }
 
@@ -125,43 +156,60 @@ void CDVDClock::SetSpeed(int iSpeed)
   int64_t newfreq = m_systemFrequency * DVD_PLAYSPEED_NORMAL / iSpeed;
 
   current = g_VideoReferenceClock.GetTime();
-  if( m_pauseClock )
+  if( state.pauseClock )
   {
-    m_startClock += current - m_pauseClock;
-    m_pauseClock = 0;
+    state.startClock += current - state.pauseClock;
+    state.pauseClock = 0;
   }
 
-  m_startClock = current - (int64_t)((double)(current - m_startClock) * newfreq / m_systemUsed);
-  m_systemUsed = newfreq;
+  state.startClock = current - (int64_t)((double)(current - state.startClock) * newfreq / state.systemUsed);
+  state.systemUsed = newfreq;
+  WriteState(state);
 }
 
 void CDVDClock::Discontinuity(double currentPts)
 {
-  CExclusiveLock lock(m_critSection);
-  m_startClock = g_VideoReferenceClock.GetTime();
-  if(m_pauseClock)
-    m_pauseClock = m_startClock;
-  m_iDisc = currentPts;
-  m_bReset = false;
+  CSingleLock lock(m_critSection);
+  SState state = m_state;
+  state.startClock = g_VideoReferenceClock.GetTime();
+  if(state.pauseClock)
+    state.pauseClock = state.startClock;
+  state.iDisc = currentPts;
+  state.bReset = false;
+  WriteState(state);
+}
+
+void CDVDClock::Reset()
+{
+  CSingleLock lock(m_critSection);
+  SState state = m_state;
+  state.bReset = true;
+  WriteState(state);
 }
 
 void CDVDClock::Pause()
 {
-  CExclusiveLock lock(m_critSection);
-  if(!m_pauseClock)
-    m_pauseClock = g_VideoReferenceClock.GetTime();
+  CSingleLock lock(m_critSection);
+  if(!m_state.pauseClock)
+  {
+    SState state = m_state;
+    state.pauseClock = g_VideoReferenceClock.GetTime();
+    WriteState(state);
+  }
 }
 
 void CDVDClock::Resume()
 {
-  CExclusiveLock lock(m_critSection);
-  if( m_pauseClock )
+  CSingleLock lock(m_critSection);
+  if( m_state.pauseClock )
   {
+    SState state = m_state;
     int64_t current;
     current = g_VideoReferenceClock.GetTime();
 
-    m_startClock += current - m_pauseClock;
-    m_pauseClock = 0;
+    state.startClock += current - state.pauseClock;
+    state.pauseClock = 0;
+    WriteState(state);
   }
 }
 
@@ -228,21 +276,28 @@ double CDVDClock::SystemToAbsolute(int64_t system)
 double CDVDClock::SystemToPlaying(int64_t system)
 {
   int64_t current;
+  SState state = ReadState();
 
-  if (m_bReset)
+  if (state.bReset)
   {
-    m_startClock = system;
-    m_systemUsed = m_systemFrequency;
-    m_pauseClock = 0;
-    m_iDisc = 0;
-    m_bReset = false;
+    // the first read after a reset restarts the clock
+    CSingleLock lock(m_critSection);
+    state = m_state;
+    if (state.bReset)
+    {
+      state.startClock = system;
+      state.systemUsed = m_systemFrequency;
+      state.pauseClock = 0;
+      state.iDisc = 0;
+      state.bReset = false;
+      WriteState(state);
+    }
   }
-  
-  if (m_pauseClock)
-    current = m_pauseClock;
+
+  if (state.pauseClock)
+    current = state.pauseClock;
   else
     current = system;
 
-  return DVD_TIME_BASE * (double)(current - m_startClock) / m_systemUsed + m_iDisc;
+  return DVD_TIME_BASE * (double)(current - state.startClock) / state.systemUsed + state.iDisc;
 }
-
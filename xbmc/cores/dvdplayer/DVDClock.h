@@ -21,7 +21,6 @@
  */
 
 #include "system.h"
-#include "threads/SharedSection.h"
 #include "threads/CriticalSection.h"
 
 #define DVD_TIME_BASE 1000000
@@ -46,7 +45,7 @@ public:
 
   void Discontinuity(double currentPts = 0LL);
 
-  void Reset() { m_bReset = true; }
+  void Reset();
   void Pause();
   void Resume();
   void SetSpeed(int iSpeed);
@@ -72,12 +71,23 @@ protected:
   static double SystemToAbsolute(int64_t system);
   double        SystemToPlaying(int64_t system);
 
-  CSharedSection m_critSection;
-  int64_t m_systemUsed;
-  int64_t m_startClock;
-  int64_t m_pauseClock;
-  double m_iDisc;
-  bool m_bReset;
+  /* the state of the clock is published through a sequence lock: readers  *
+   * copy it without locking and retry if a writer changed it meanwhile    */
+  struct SState
+  {
+    int64_t systemUsed;
+    int64_t startClock;
+    int64_t pauseClock;
+    double  iDisc;
+    bool    bReset;
+  };
+
+  SState ReadState();
+  void   WriteState(const SState& state);
+
+  CCriticalSection m_critSection; // serializes writers
+  volatile long    m_sequence;    // odd while m_state is being written
+  SState           m_state;
 
   static int64_t m_systemFrequency;
   static int64_t m_systemOffset;
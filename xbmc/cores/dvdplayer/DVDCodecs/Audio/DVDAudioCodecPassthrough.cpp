@@ -27,6 +27,12 @@
 
 #include "cores/AudioEngine/AEFactory.h"
 
+static CSettingHandle settingAudioMode("audiooutput.mode");
+static CSettingHandle settingAC3Passthrough("audiooutput.ac3passthrough");
+static CSettingHandle settingDTSPassthrough("audiooutput.dtspassthrough");
+static CSettingHandle settingTrueHDPassthrough("audiooutput.truehdpassthrough");
+static CSettingHandle settingDTSHDPassthrough("audiooutput.dtshdpassthrough");
+
 CDVDAudioCodecPassthrough::CDVDAudioCodecPassthrough(void) :
   m_buffer    (NULL),
   m_bufferSize(0)
@@ -49,17 +55,17 @@ bool CDVDAudioCodecPassthrough::Open(CDVDStreamInfo &hints, CDVDCodecOptions &op
   bool bSupportsTrueHDOut = false;
   bool bSupportsDTSHDOut  = false;
 
-  int audioMode = g_guiSettings.GetInt("audiooutput.mode");
+  int audioMode = g_guiSettings.GetInt(settingAudioMode);
   if (AUDIO_IS_BITSTREAM(audioMode))
   {
-    bSupportsAC3Out = g_guiSettings.GetBool("audiooutput.ac3passthrough");
-    bSupportsDTSOut = g_guiSettings.GetBool("audiooutput.dtspassthrough");
+    bSupportsAC3Out = g_guiSettings.GetBool(settingAC3Passthrough);
+    bSupportsDTSOut = g_guiSettings.GetBool(settingDTSPassthrough);
   }
 
   if (audioMode == AUDIO_HDMI)
   {
-    bSupportsTrueHDOut = g_guiSettings.GetBool("audiooutput.truehdpassthrough");
-    bSupportsDTSHDOut  = g_guiSettings.GetBool("audiooutput.dtshdpassthrough" ) && bSupportsDTSOut;
+    bSupportsTrueHDOut = g_guiSettings.GetBool(settingTrueHDPassthrough);
+    bSupportsDTSHDOut  = g_guiSettings.GetBool(settingDTSHDPassthrough) && bSupportsDTSOut;
   }
 
   /* only get the dts core from the parser if we don't support dtsHD */
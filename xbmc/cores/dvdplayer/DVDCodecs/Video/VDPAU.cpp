@@ -36,6 +36,8 @@
 
 #define ARSIZE(x) (sizeof(x) / sizeof((x)[0]))
 
+static CSettingHandle settingLimitedRange("videoscreen.limitedrange");
+
 CVDPAU::Desc decoder_profiles[] = {
 {"MPEG1",        VDP_DECODER_PROFILE_MPEG1},
 {"MPEG2_SIMPLE", VDP_DECODER_PROFILE_MPEG2_SIMPLE},
@@ -591,7 +593,7 @@ void CVDPAU::SetColor()
     vdp_st = vdp_generate_csc_matrix(&m_Procamp, VDP_COLOR_STANDARD_ITUR_BT_601, &m_CSCMatrix);
 
   VdpVideoMixerAttribute attributes[] = { VDP_VIDEO_MIXER_ATTRIBUTE_CSC_MATRIX };
-  if (g_guiSettings.GetBool("videoscreen.limitedrange"))
+  if (g_guiSettings.GetBool(settingLimitedRange))
   {
     void const * pm_CSCMatix[] = { &studioCSC };
     vdp_st = vdp_video_mixer_set_attribute_values(videoMixer, ARSIZE(attributes), attributes, pm_CSCMatix);
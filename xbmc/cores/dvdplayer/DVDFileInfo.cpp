@@ -31,6 +31,7 @@
 
 #include "DVDClock.h"
 #include "DVDStreamInfo.h"
+#include "DVDThumbContext.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #ifdef HAVE_LIBBLURAY
 #include "DVDInputStreams/DVDInputStreamBluray.h"
@@ -89,8 +90,15 @@ int DegreeToOrientation(int degrees)
   }
 }
 
-bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails)
+bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails, CDVDThumbContext *context /* = NULL */)
 {
+  std::auto_ptr<CDVDThumbContext> localContext;
+  if (!context)
+  {
+    localContext.reset(new CDVDThumbContext());
+    context = localContext.get();
+  }
+
   unsigned int nTime = XbmcThreads::SystemClockMillis();
   CDVDInputStream *pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, strPath, "");
   if (!pInputStream)
@@ -157,24 +165,13 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
-
+    CDVDVideoCodec *pVideoCodec = context->AcquireCodec(hint);
     if (pVideoCodec)
     {
+      bool codecFailed = false;
       int nTotalLen = pDemuxer->GetStreamLength();
       int nSeekTo = nTotalLen / 3;
 
@@ -220,6 +217,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
           }
 
         } while (abort_index--);
+        codecFailed = (iDecoderState & VC_ERROR) != 0;
 
         if (iDecoderState & VC_PICTURE && !(picture.iFlags & DVP_FLAG_DROPPED))
         {
@@ -230,31 +228,23 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
               aspect = hint.aspect;
             unsigned int nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
 
-            DllSwScale dllSwScale;
-            dllSwScale.Load();
-
-            BYTE *pOutBuf = new BYTE[nWidth * nHeight * 4];
-            struct SwsContext *context = dllSwScale.sws_getContext(picture.iWidth, picture.iHeight,
-                  PIX_FMT_YUV420P, nWidth, nHeight, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+            BYTE *pOutBuf = context->GetBuffer(nWidth * nHeight * 4);
+            struct SwsContext *scaler = context->GetScaler(picture.iWidth, picture.iHeight, nWidth, nHeight);
             uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
             int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
             uint8_t *dst[] = { pOutBuf, 0, 0, 0 };
             int     dstStride[] = { (int)nWidth*4, 0, 0, 0 };
 
-            if (context)
+            if (scaler)
             {
               int orientation = DegreeToOrientation(hint.orientation);
-              dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
-              dllSwScale.sws_freeContext(context);
+              context->GetSwScale().sws_scale(scaler, src, srcStride, 0, picture.iHeight, dst, dstStride);
 
               details.width = nWidth;
               details.height = nHeight;
               CPicture::CacheTexture(pOutBuf, nWidth, nHeight, nWidth * 4, orientation, nWidth, nHeight, CTextureCache::GetCachedPath(details.file));
               bOk = true;
             }
-
-            dllSwScale.Unload();
-            delete [] pOutBuf;
           }
         }
         else
@@ -262,7 +252,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, strPath.c_str(), packetsTried);
         }
       }
-      delete pVideoCodec;
+      context->ReleaseCodec(pVideoCodec, !codecFailed);
     }
   }
 
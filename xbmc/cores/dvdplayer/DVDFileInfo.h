@@ -26,12 +26,14 @@ class CDVDDemux;
 class CStreamDetails;
 class CDVDInputStream;
 class CTextureDetails;
+class CDVDThumbContext;
 
 class CDVDFileInfo
 {
 public:
-  // Extract a thumbnail immage from the media at strPath, optionally populating a streamdetails class with the data
-  static bool ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails);
+  // Extract a thumbnail immage from the media at strPath, optionally populating a streamdetails class with the data.
+  // Decoders and scalers are kept in the given context for the next extraction, if one is given.
+  static bool ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails, CDVDThumbContext *context = NULL);
 
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
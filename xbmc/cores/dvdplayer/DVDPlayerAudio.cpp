@@ -45,6 +45,11 @@
 
 using namespace std;
 
+static CSettingHandle settingAudioMode("audiooutput.mode");
+static CSettingHandle settingUseDisplayAsClock("videoplayer.usedisplayasclock");
+static CSettingHandle settingSyncType("videoplayer.synctype");
+static CSettingHandle settingMaxSpeedAdjust("videoplayer.maxspeedadjust");
+
 void CPTSInputQueue::Add(int64_t bytes, double pts)
 {
   CSingleLock lock(m_sync);
@@ -145,7 +150,7 @@ CDVDPlayerAudio::~CDVDPlayerAudio()
 
 bool CDVDPlayerAudio::OpenStream( CDVDStreamInfo &hints )
 {
-  bool passthrough = AUDIO_IS_BITSTREAM(g_guiSettings.GetInt("audiooutput.mode"));
+  bool passthrough = AUDIO_IS_BITSTREAM(g_guiSettings.GetInt(settingAudioMode));
 
   CLog::Log(LOGNOTICE, "Finding audio codec for: %i", hints.codec);
   CDVDAudioCodec* codec = CDVDFactoryCodec::CreateAudioCodec(hints, passthrough);
@@ -191,8 +196,8 @@ void CDVDPlayerAudio::OpenStream( CDVDStreamInfo &hints, CDVDAudioCodec* codec )
 
   m_synctype = SYNC_DISCON;
   m_setsynctype = SYNC_DISCON;
-  if (g_guiSettings.GetBool("videoplayer.usedisplayasclock"))
-    m_setsynctype = g_guiSettings.GetInt("videoplayer.synctype");
+  if (g_guiSettings.GetBool(settingUseDisplayAsClock))
+    m_setsynctype = g_guiSettings.GetInt(settingSyncType);
   m_prevsynctype = -1;
 
   m_error = 0;
@@ -205,7 +210,7 @@ void CDVDPlayerAudio::OpenStream( CDVDStreamInfo &hints, CDVDAudioCodec* codec )
   m_errortime = CurrentHostCounter();
   m_silence = false;
 
-  m_maxspeedadjust = g_guiSettings.GetFloat("videoplayer.maxspeedadjust");
+  m_maxspeedadjust = g_guiSettings.GetFloat(settingMaxSpeedAdjust);
 }
 
 void CDVDPlayerAudio::CloseStream(bool bWaitForBuffers)
@@ -840,7 +845,7 @@ void CDVDPlayerAudio::WaitForBuffers()
 bool CDVDPlayerAudio::SwitchCodecIfNeeded()
 {
   // check if passthrough is disabled
-  if (!AUDIO_IS_BITSTREAM(g_guiSettings.GetInt("audiooutput.mode")))
+  if (!AUDIO_IS_BITSTREAM(g_guiSettings.GetInt(settingAudioMode)))
     return false;
 
   CLog::Log(LOGDEBUG, "CDVDPlayerAudio: Sample rate changed, checking for passthrough");
@@ -160,7 +160,7 @@ bool CDVDPlayerSubtitle::OpenStream(CDVDStreamInfo &hints, string &filename)
       return false;
     }
 
-    if (!m_pSubtitleFileParser->Open(hints))
+    if (!m_pSubtitleFileParser->OpenInBackground(hints))
     {
       CLog::Log(LOGERROR, "%s - Unable to init subtitle parser", __FUNCTION__);
       CloseStream(false);
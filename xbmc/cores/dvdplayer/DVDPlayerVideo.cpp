@@ -47,6 +47,9 @@
 
 using namespace std;
 
+static CSettingHandle settingUseDisplayAsClock("videoplayer.usedisplayasclock");
+static CSettingHandle settingAdjustRefreshRate("videoplayer.adjustrefreshrate");
+
 class CPulldownCorrection
 {
 public:
@@ -203,7 +206,7 @@ bool CDVDPlayerVideo::OpenStream( CDVDStreamInfo &hint )
     return false;
   }
 
-  if(g_guiSettings.GetBool("videoplayer.usedisplayasclock") && !g_VideoReferenceClock.IsRunning())
+  if(g_guiSettings.GetBool(settingUseDisplayAsClock) && !g_VideoReferenceClock.IsRunning())
   {
     g_VideoReferenceClock.Create();
     //we have to wait for the clock to start otherwise alsa can cause trouble
@@ -233,8 +236,8 @@ void CDVDPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
 
   m_bFpsInvalid = (hint.fpsrate == 0 || hint.fpsscale == 0);
 
-  m_bCalcFrameRate = g_guiSettings.GetBool("videoplayer.usedisplayasclock") ||
-                     g_guiSettings.GetInt("videoplayer.adjustrefreshrate") != ADJUST_REFRESHRATE_OFF;
+  m_bCalcFrameRate = g_guiSettings.GetBool(settingUseDisplayAsClock) ||
+                     g_guiSettings.GetInt(settingAdjustRefreshRate) != ADJUST_REFRESHRATE_OFF;
   ResetFrameRateCalc();
 
   m_iDroppedRequest = 0;
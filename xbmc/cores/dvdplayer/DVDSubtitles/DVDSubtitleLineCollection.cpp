@@ -20,15 +20,26 @@
 
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
+#include "threads/SingleLock.h"
 
+#include <algorithm>
+#include <limits>
 
-CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+static bool StartsBefore(const CDVDOverlay* pOverlay1, const CDVDOverlay* pOverlay2)
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
+  return pOverlay1->iPTSStartTime < pOverlay2->iPTSStartTime;
+}
 
-  m_iSize = 0;
+static bool StartsAfter(double iPts, const CDVDOverlay* pOverlay)
+{
+  return iPts < pOverlay->iPTSStartTime;
+}
+
+CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
+{
+  m_iLeaves  = 0;
+  m_iCurrent = 0;
+  m_bSeek    = false;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +49,167 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
-
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
-
-  m_iSize++;
+  CSingleLock lock(m_critSection);
+  m_pending.push_back(pOverlay);
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
+  CSingleLock lock(m_critSection);
+  Merge();
+}
+
+void CDVDSubtitleLineCollection::Merge()
+{
+  if (m_pending.empty())
     return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+
+  // lines with the same start time keep the order they were added in
+  std::stable_sort(m_pending.begin(), m_pending.end(), StartsBefore);
+
+  if (m_lines.empty() || !StartsBefore(m_pending.front(), m_lines.back()))
+    m_lines.insert(m_lines.end(), m_pending.begin(), m_pending.end());
+  else
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
+    // keep the position of the next line to return; lines that sort before the lines
+    // already returned are skipped, as they would have been by a sequential read
+    std::vector<CDVDOverlay*> lines;
+    lines.reserve(m_lines.size() + m_pending.size());
+    unsigned int i = 0, j = 0;
+    int iCurrent = 0;
+    while (i < m_lines.size() || j < m_pending.size())
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
+      if (j == m_pending.size() || (i < m_lines.size() && !StartsBefore(m_pending[j], m_lines[i])))
       {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
+        lines.push_back(m_lines[i++]);
+        if ((int)i == m_iCurrent)
+          iCurrent = lines.size();
       }
+      else
+        lines.push_back(m_pending[j++]);
     }
+    m_lines.swap(lines);
+    m_iCurrent = iCurrent;
   }
+  m_pending.clear();
+
+  BuildIndex();
 }
 
-CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
+void CDVDSubtitleLineCollection::BuildIndex()
+{
+  m_iLeaves = 1;
+  while (m_iLeaves < (int)m_lines.size())
+    m_iLeaves <<= 1;
+
+  // leaves hold the stop times, each node the largest stop time below it
+  m_maxStop.assign(2 * m_iLeaves, -std::numeric_limits<double>::max());
+  for (unsigned int i = 0; i < m_lines.size(); i++)
+    m_maxStop[m_iLeaves + i] = m_lines[i]->iPTSStopTime;
+  for (int iNode = m_iLeaves - 1; iNode > 0; iNode--)
+    m_maxStop[iNode] = std::max(m_maxStop[2 * iNode], m_maxStop[2 * iNode + 1]);
+}
+
+int CDVDSubtitleLineCollection::FindFirst(double iPts, int iFrom)
 {
-  CDVDOverlay* pOverlay = NULL;
+  // the first line from iFrom on that stops at or after iPts
+  int iSize = (int)m_lines.size();
+  if (iFrom >= iSize)
+    return iSize;
 
-  if (m_pCurrent)
+  int iNode = m_iLeaves + iFrom;
+  if (m_maxStop[iNode] >= iPts)
+    return iFrom;
+
+  // climb until a right sibling holds a later stop time, then descend to its leftmost match
+  while (iNode > 1)
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
+    if ((iNode & 1) == 0 && m_maxStop[iNode + 1] >= iPts)
     {
-      m_pCurrent = m_pCurrent->pNext;
+      iNode++;
+      while (iNode < m_iLeaves)
+        iNode = m_maxStop[2 * iNode] >= iPts ? 2 * iNode : 2 * iNode + 1;
+      return std::min(iNode - m_iLeaves, iSize);
     }
+    iNode >>= 1;
+  }
+  return iSize;
+}
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+void CDVDSubtitleLineCollection::FindActive(int iNode, int iNodeStart, int iNodeSize, int iEnd, double iPts, std::vector<CDVDOverlay*>& overlays)
+{
+  if (iNodeStart >= iEnd || m_maxStop[iNode] < iPts)
+    return;
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
-    }
+  if (iNode >= m_iLeaves)
+  {
+    overlays.push_back(m_lines[iNodeStart]);
+    return;
   }
-  return pOverlay;
+
+  FindActive(2 * iNode, iNodeStart, iNodeSize / 2, iEnd, iPts, overlays);
+  FindActive(2 * iNode + 1, iNodeStart + iNodeSize / 2, iNodeSize / 2, iEnd, iPts, overlays);
 }
 
-void CDVDSubtitleLineCollection::Reset()
+CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  m_pCurrent = m_pHead;
+  CSingleLock lock(m_critSection);
+  Merge();
+
+  if (m_bSeek)
+  {
+    m_iCurrent = 0;
+    m_bSeek = false;
+  }
+
+  m_iCurrent = FindFirst(iPts, m_iCurrent);
+  if (m_iCurrent >= (int)m_lines.size())
+    return NULL;
+
+  // advance to the next overlay
+  return m_lines[m_iCurrent++];
 }
 
-void CDVDSubtitleLineCollection::Clear()
+int CDVDSubtitleLineCollection::GetActive(double iPts, std::vector<CDVDOverlay*>& overlays)
 {
-  ListElement* pElement = NULL;
+  CSingleLock lock(m_critSection);
+  Merge();
 
-  while (m_pHead)
-  {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+  int iInitialSize = overlays.size();
+  if (m_lines.empty())
+    return 0;
 
-    pElement->pOverlay->Release();
-    delete pElement;
-  }
+  // only lines that started already can show
+  int iEnd = std::upper_bound(m_lines.begin(), m_lines.end(), iPts, StartsAfter) - m_lines.begin();
+  FindActive(1, 0, m_iLeaves, iEnd, iPts, overlays);
+
+  return overlays.size() - iInitialSize;
+}
+
+void CDVDSubtitleLineCollection::Reset()
+{
+  CSingleLock lock(m_critSection);
+  m_bSeek = true;
+}
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+void CDVDSubtitleLineCollection::Clear()
+{
+  CSingleLock lock(m_critSection);
+  for (std::vector<CDVDOverlay*>::iterator it = m_lines.begin(); it != m_lines.end(); ++it)
+    (*it)->Release();
+  for (std::vector<CDVDOverlay*>::iterator it = m_pending.begin(); it != m_pending.end(); ++it)
+    (*it)->Release();
+
+  m_lines.clear();
+  m_pending.clear();
+  m_maxStop.clear();
+  m_iLeaves  = 0;
+  m_iCurrent = 0;
+  m_bSeek    = false;
+}
+
+int CDVDSubtitleLineCollection::GetSize()
+{
+  CSingleLock lock(m_critSection);
+  return m_lines.size() + m_pending.size();
 }
@@ -21,40 +21,51 @@
  */
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
+#include "threads/CriticalSection.h"
 
-typedef struct stListElement
-{
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
-
-} ListElement;
+#include <vector>
 
+/*
+ * The lines of a subtitle file, ordered by start time.
+ *
+ * Lines are kept in an array with a max tree of their stop times on top, so the
+ * first line still showing at a pts and all lines showing at a pts are found
+ * without walking the lines before them. Lines may be added by a parser thread
+ * while the player reads them; they show up once they've been merged in by Sort()
+ * or the next Get().
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
-
   void Add(CDVDOverlay* pSubtitle);
   void Sort();
 
   CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
 
+  // get all overlays showing at the given pts, in order of start time
+  int GetActive(double iPts, std::vector<CDVDOverlay*>& overlays);
+
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize();
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  void Merge();
+  void BuildIndex();
+  int FindFirst(double iPts, int iFrom);
+  void FindActive(int iNode, int iNodeStart, int iNodeSize, int iEnd, double iPts, std::vector<CDVDOverlay*>& overlays);
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  std::vector<CDVDOverlay*> m_lines;   // merged lines, by start time
+  std::vector<CDVDOverlay*> m_pending; // lines added since the last merge
+  std::vector<double> m_maxStop;       // max tree of the stop times of m_lines
+  int m_iLeaves;                       // the number of leaves in m_maxStop
 
+  int  m_iCurrent;                     // the next line Get() returns
+  bool m_bSeek;                        // look the next line up from the start on the next Get()
+
+  CCriticalSection m_critSection;
+};
@@ -21,18 +21,21 @@
  */
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
+#include "../DVDStreamInfo.h"
 #include "DVDSubtitleStream.h"
 #include "DVDSubtitleLineCollection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
 
 #include <string>
 
-class CDVDStreamInfo;
-
 class CDVDSubtitleParser
 {
 public:
   virtual ~CDVDSubtitleParser() {}
   virtual bool Open(CDVDStreamInfo &hints) = 0;
+  // open the file, and keep parsing it in the background where the parser can
+  virtual bool OpenInBackground(CDVDStreamInfo &hints) { return Open(hints); }
   virtual void Dispose() = 0;
   virtual void Reset() = 0;
   virtual CDVDOverlay* Parse(double iPts) = 0;
@@ -40,13 +43,17 @@ public:
 
 class CDVDSubtitleParserCollection
   : public CDVDSubtitleParser
+  , private CThread
 {
 public:
   CDVDSubtitleParserCollection(const std::string& strFile)
+    : CThread("SubtitleParser")
+    , m_parsed(true)
   {
     m_filename = strFile;
+    m_bOpened  = false;
   }
-  virtual ~CDVDSubtitleParserCollection() { }
+  virtual ~CDVDSubtitleParserCollection() { StopParsing(); }
   virtual CDVDOverlay* Parse(double iPts)
   {
     CDVDOverlay* o = m_collection.Get(iPts);
@@ -55,11 +62,44 @@ public:
     return o->Clone();
   }
   virtual void         Reset()            { m_collection.Reset(); }
-  virtual void         Dispose()          { m_collection.Clear(); }
+  virtual void         Dispose()          { StopParsing(); m_collection.Clear(); }
+
+  // parse on a thread of its own, returning once the first lines are available
+  virtual bool OpenInBackground(CDVDStreamInfo &hints)
+  {
+    m_hints = hints;
+    Create();
+    while (!m_parsed.WaitMSec(10))
+    {
+      if (m_collection.GetSize() > 0)
+        return true;
+    }
+    return m_bOpened;
+  }
+
+  bool IsParsing() { return IsRunning() && !m_parsed.WaitMSec(0); }
 
 protected:
+  // wait for the parser thread, to be called before anything it uses goes away
+  void StopParsing() { StopThread(true); }
+
+  // the parsers check this between lines, so stopping doesn't wait for the whole file
+  bool IsStopping() const { return m_bStop; }
+
   CDVDSubtitleLineCollection m_collection;
   std::string                m_filename;
+
+private:
+  virtual void Process()
+  {
+    m_bOpened = Open(m_hints);
+    m_collection.Sort();
+    m_parsed.Set();
+  }
+
+  CDVDStreamInfo             m_hints;
+  bool                       m_bOpened;
+  CEvent                     m_parsed;
 };
 
 class CDVDSubtitleParserText
@@ -74,6 +114,7 @@ public:
 
   virtual ~CDVDSubtitleParserText()
   {
+    StopParsing();
     if(m_pStream)
       delete m_pStream;
   }
@@ -54,7 +54,7 @@ bool CDVDSubtitleParserMPL2::Open(CDVDStreamInfo &hints)
     return false;
   CDVDSubtitleTagMicroDVD TagConv;
 
-  while (m_pStream->ReadLine(line, sizeof(line)))
+  while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
       line[strlen(line) - 1] = 0;
@@ -61,7 +61,7 @@ bool CDVDSubtitleParserMicroDVD::Open(CDVDStreamInfo &hints)
     return false;
   CDVDSubtitleTagMicroDVD TagConv;
 
-  while (m_pStream->ReadLine(line, sizeof(line)))
+  while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
       line[strlen(line) - 1] = 0;
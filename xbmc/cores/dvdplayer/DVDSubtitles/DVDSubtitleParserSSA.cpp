@@ -48,7 +48,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   ASS_Event* assEvent = m_libass->GetEvents();
   int numEvents = m_libass->GetNrOfEvents();
 
-  for(int i=0; i < numEvents; i++)
+  for(int i=0; i < numEvents && !IsStopping(); i++)
   {
     ASS_Event* curEvent =  (assEvent+i);
     if (curEvent)
@@ -69,6 +69,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
 
 void CDVDSubtitleParserSSA::Dispose()
 {
+  StopParsing();
   if(m_libass)
   {
     SAFE_RELEASE(m_libass);
@@ -75,7 +75,7 @@ bool CDVDSubtitleParserSami::Open(CDVDStreamInfo &hints)
     lang = strClassID.c_str();
 
   CDVDOverlayText* pOverlay = NULL;
-  while (m_pStream->ReadLine(line, sizeof(line)))
+  while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
   {
     if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
       line[strlen(line) - 1] = 0;
@@ -48,7 +48,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   char line[1024];
   CStdString strLine;
 
-  while (m_pStream->ReadLine(line, sizeof(line)))
+  while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
   {
     strLine = line;
     strLine.Trim();
@@ -73,7 +73,7 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
         pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
         pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
 
-        while (m_pStream->ReadLine(line, sizeof(line)))
+        while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
         {
           strLine = line;
           strLine.Trim();
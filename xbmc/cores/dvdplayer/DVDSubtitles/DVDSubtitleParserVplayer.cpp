@@ -57,7 +57,7 @@ bool CDVDSubtitleParserVplayer::Open(CDVDStreamInfo &hints)
 
   CDVDOverlayText* pPrevOverlay = NULL;
 
-  while (m_pStream->ReadLine(line, sizeof(line)))
+  while (!IsStopping() && m_pStream->ReadLine(line, sizeof(line)))
   {
     if (reg.RegFind(line) > -1)
     {
@@ -0,0 +1,168 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDThumbContext.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "utils/log.h"
+
+CDVDThumbContext::Geometry::Geometry(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+  m_srcWidth = srcWidth;
+  m_srcHeight = srcHeight;
+  m_dstWidth = dstWidth;
+  m_dstHeight = dstHeight;
+}
+
+bool CDVDThumbContext::Geometry::operator<(const Geometry &right) const
+{
+  if (m_srcWidth != right.m_srcWidth)
+    return m_srcWidth < right.m_srcWidth;
+  if (m_srcHeight != right.m_srcHeight)
+    return m_srcHeight < right.m_srcHeight;
+  if (m_dstWidth != right.m_dstWidth)
+    return m_dstWidth < right.m_dstWidth;
+  return m_dstHeight < right.m_dstHeight;
+}
+
+CDVDThumbContext::CDVDThumbContext()
+{
+  m_uses = 0;
+  m_codecsOpened = 0;
+  m_codecsReused = 0;
+  m_scalersCreated = 0;
+  m_dllSwScale.Load();
+}
+
+CDVDThumbContext::~CDVDThumbContext()
+{
+  for (std::vector<Codec>::iterator i = m_codecs.begin(); i != m_codecs.end(); ++i)
+    delete i->codec;
+  for (ScalerMap::iterator i = m_scalers.begin(); i != m_scalers.end(); ++i)
+    m_dllSwScale.sws_freeContext(i->second);
+  m_dllSwScale.Unload();
+}
+
+CDVDVideoCodec *CDVDThumbContext::AcquireCodec(CDVDStreamInfo &hint)
+{
+  m_uses++;
+  for (std::vector<Codec>::iterator i = m_codecs.begin(); i != m_codecs.end(); ++i)
+  {
+    if (!i->inUse && i->hint.Equal(hint, true))
+    {
+      i->codec->Reset();
+      i->inUse = true;
+      i->lastUse = m_uses;
+      m_codecsReused++;
+      return i->codec;
+    }
+  }
+
+  CDVDVideoCodec *codec;
+  if (hint.codec == CODEC_ID_MPEG2VIDEO || hint.codec == CODEC_ID_MPEG1VIDEO)
+  {
+    // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
+    CDVDCodecOptions dvdOptions;
+    codec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
+  }
+  else
+    codec = CDVDFactoryCodec::CreateVideoCodec(hint);
+
+  if (!codec)
+    return NULL;
+  m_codecsOpened++;
+
+  // close the least recently used decoder that is free to make room
+  if (m_codecs.size() >= THUMB_CONTEXT_MAX_CODECS)
+  {
+    std::vector<Codec>::iterator oldest = m_codecs.end();
+    for (std::vector<Codec>::iterator i = m_codecs.begin(); i != m_codecs.end(); ++i)
+    {
+      if (!i->inUse && (oldest == m_codecs.end() || i->lastUse < oldest->lastUse))
+        oldest = i;
+    }
+    if (oldest != m_codecs.end())
+    {
+      delete oldest->codec;
+      m_codecs.erase(oldest);
+    }
+  }
+
+  Codec entry;
+  entry.hint = hint;
+  entry.codec = codec;
+  entry.inUse = true;
+  entry.lastUse = m_uses;
+  m_codecs.push_back(entry);
+  return codec;
+}
+
+void CDVDThumbContext::ReleaseCodec(CDVDVideoCodec *codec, bool reusable)
+{
+  for (std::vector<Codec>::iterator i = m_codecs.begin(); i != m_codecs.end(); ++i)
+  {
+    if (i->codec == codec)
+    {
+      if (reusable)
+        i->inUse = false;
+      else
+      {
+        delete i->codec;
+        m_codecs.erase(i);
+      }
+      return;
+    }
+  }
+  CLog::Log(LOGERROR, "%s - releasing a decoder not opened by this context", __FUNCTION__);
+}
+
+struct SwsContext *CDVDThumbContext::GetScaler(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+  Geometry geometry(srcWidth, srcHeight, dstWidth, dstHeight);
+  ScalerMap::iterator i = m_scalers.find(geometry);
+  if (i != m_scalers.end())
+    return i->second;
+
+  struct SwsContext *context = m_dllSwScale.sws_getContext(srcWidth, srcHeight, PIX_FMT_YUV420P,
+                                                           dstWidth, dstHeight, PIX_FMT_BGRA,
+                                                           SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
+  if (!context)
+    return NULL;
+  m_scalersCreated++;
+
+  // libraries are mostly a handful of resolutions, so starting over is rare
+  if (m_scalers.size() >= THUMB_CONTEXT_MAX_SCALERS)
+  {
+    for (i = m_scalers.begin(); i != m_scalers.end(); ++i)
+      m_dllSwScale.sws_freeContext(i->second);
+    m_scalers.clear();
+  }
+  m_scalers.insert(std::make_pair(geometry, context));
+  return context;
+}
+
+uint8_t *CDVDThumbContext::GetBuffer(unsigned int size)
+{
+  if (m_buffer.size() < size)
+    m_buffer.resize(size);
+  return &m_buffer[0];
+}
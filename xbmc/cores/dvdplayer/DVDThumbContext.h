@@ -0,0 +1,109 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDStreamInfo.h"
+#include "DllSwScale.h"
+
+#include <map>
+#include <vector>
+
+#define THUMB_CONTEXT_MAX_CODECS  4
+#define THUMB_CONTEXT_MAX_SCALERS 8
+
+class CDVDVideoCodec;
+
+/*!
+ \brief State kept between thumb extractions on one thread
+
+ Opening a decoder and setting up a scaler cost more than decoding the single frame a thumb
+ needs, so a context keeps the decoders of the last few streams and the scalers of the last
+ few geometries around. A decoder is only reused for a stream identical to the one it was
+ opened for, and is reset before it decodes the next file. A context must only be used by
+ one thread at a time.
+ */
+class CDVDThumbContext
+{
+public:
+  CDVDThumbContext();
+  ~CDVDThumbContext();
+
+  /*! \brief Fetch a software decoder for the given stream
+   \param hint stream to decode
+   \return the decoder, owned by the context, or NULL if none could be opened
+   \sa ReleaseCodec
+   */
+  CDVDVideoCodec *AcquireCodec(CDVDStreamInfo &hint);
+
+  /*! \brief Hand back a decoder from AcquireCodec
+   \param codec the decoder
+   \param reusable false if the decoder failed and should be closed
+   */
+  void ReleaseCodec(CDVDVideoCodec *codec, bool reusable);
+
+  /*! \brief Fetch a scaler from YUV420P at the source size to BGRA at the destination size */
+  struct SwsContext *GetScaler(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+  /*! \brief Fetch a buffer of at least the given size, valid until the next call */
+  uint8_t *GetBuffer(unsigned int size);
+
+  DllSwScale &GetSwScale() { return m_dllSwScale; }
+
+  unsigned int GetNumCodecsOpened() const { return m_codecsOpened; }
+  unsigned int GetNumCodecsReused() const { return m_codecsReused; }
+  unsigned int GetNumScalersCreated() const { return m_scalersCreated; }
+
+private:
+  CDVDThumbContext(const CDVDThumbContext&);
+  CDVDThumbContext const& operator=(CDVDThumbContext const&);
+
+  class Codec
+  {
+  public:
+    CDVDStreamInfo hint;
+    CDVDVideoCodec *codec;
+    bool inUse;
+    unsigned int lastUse;
+  };
+
+  class Geometry
+  {
+  public:
+    Geometry(int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+    bool operator<(const Geometry &right) const;
+
+    int m_srcWidth;
+    int m_srcHeight;
+    int m_dstWidth;
+    int m_dstHeight;
+  };
+
+  typedef std::map<Geometry, struct SwsContext *> ScalerMap;
+
+  std::vector<Codec> m_codecs;
+  ScalerMap m_scalers;
+  std::vector<uint8_t> m_buffer;
+  DllSwScale m_dllSwScale;
+  unsigned int m_uses;
+  unsigned int m_codecsOpened;
+  unsigned int m_codecsReused;
+  unsigned int m_scalersCreated;
+};
@@ -448,7 +448,11 @@ CDateTime CEpg::GetLastScanTime(void)
 
 bool CEpg::Update(const time_t start, const time_t end, int iUpdateTime, bool bForceUpdate /* = false */)
 {
-  bool bGrabSuccess(true);
+  return UpdateFromClients(start, end, PrepareUpdate(iUpdateTime, bForceUpdate));
+}
+
+bool CEpg::PrepareUpdate(int iUpdateTime, bool bForceUpdate /* = false */)
+{
   bool bUpdate(false);
 
   /* load the entries from the db first */
@@ -478,6 +482,13 @@ bool CEpg::Update(const time_t start, const time_t end, int iUpdateTime, bool bF
   else
     bUpdate = true;
 
+  return bUpdate;
+}
+
+bool CEpg::UpdateFromClients(const time_t start, const time_t end, bool bUpdate)
+{
+  bool bGrabSuccess(true);
+
   if (bUpdate)
     bGrabSuccess = LoadFromClients(start, end);
 
@@ -528,7 +539,7 @@ int CEpg::Get(CFileItemList &results, const EpgSearchFilter &filter) const
   return results.Size() - iInitialSize;
 }
 
-bool CEpg::Persist(void)
+bool CEpg::Persist(bool bCommit /* = true */)
 {
   if (g_guiSettings.GetBool("epg.ignoredbforclient") || !NeedsSave())
     return true;
@@ -569,7 +580,7 @@ bool CEpg::Persist(void)
     m_bUpdateLastScanTime = false;
   }
 
-  return database->CommitInsertQueries();
+  return bCommit ? database->CommitInsertQueries() : true;
 }
 
 CDateTime CEpg::GetFirstDate(void) const
@@ -221,6 +221,23 @@ namespace EPG
      */
     bool Update(const time_t start, const time_t end, int iUpdateTime, bool bForceUpdate = false);
 
+    /*!
+     * @brief The first part of Update(): load the table from the database and check whether it has to be updated.
+     * @param iUpdateTime Update the table after the given amount of time has passed.
+     * @param bForceUpdate Force update from client even if it's not the time to
+     * @return True if the table has to be updated from the clients, false otherwise.
+     */
+    bool PrepareUpdate(int iUpdateTime, bool bForceUpdate = false);
+
+    /*!
+     * @brief The second part of Update(): update the table from the clients. Doesn't access the database, so tables can be updated at once.
+     * @param start The start time.
+     * @param end The end time.
+     * @param bUpdate True to update the table from the clients, false to only mark it as updated.
+     * @return True if the update was successful, false otherwise.
+     */
+    bool UpdateFromClients(const time_t start, const time_t end, bool bUpdate);
+
     /*!
      * @brief Get all EPG entries.
      * @param results The file list to store the results in.
@@ -238,9 +255,10 @@ namespace EPG
 
     /*!
      * @brief Persist this table in the database.
+     * @param bCommit True to write the changes, false to queue them for CEpgDatabase::CommitInsertQueries().
      * @return True if the table was persisted, false otherwise.
      */
-    bool Persist(void);
+    bool Persist(bool bCommit = true);
 
     /*!
      * @brief Get the start time of the first entry in this table.
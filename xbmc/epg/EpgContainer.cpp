@@ -206,19 +206,46 @@ bool CEpgContainer::PersistTables(void)
 
 bool CEpgContainer::PersistAll(void)
 {
-  bool bReturn(true);
-  CSingleLock lock(m_critSection);
-  for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end() && !m_bStop; it++)
+  vector<CEpg *> tables;
   {
-    CEpg *epg = it->second;
-    if (epg && epg->NeedsSave())
+    CSingleLock lock(m_critSection);
+    for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
     {
-      lock.Leave();
-      bReturn &= epg->Persist();
-      lock.Enter();
+      CEpg *epg = it->second;
+      if (epg && epg->NeedsSave())
+        tables.push_back(epg);
     }
   }
 
+  return Persist(tables);
+}
+
+bool CEpgContainer::Persist(const vector<CEpg *> &tables)
+{
+  if (m_bIgnoreDbForClient || tables.empty())
+    return true;
+
+  if (!m_database.IsOpen())
+  {
+    CLog::Log(LOGERROR, "EpgContainer - %s - could not open the database", __FUNCTION__);
+    return false;
+  }
+
+  /* queue the changes of all tables and write them at once */
+  bool bReturn(true);
+  m_database.BeginTransaction();
+  for (vector<CEpg *>::const_iterator it = tables.begin(); it != tables.end() && !m_bStop; it++)
+    bReturn &= (*it)->Persist(false);
+
+  if (m_database.CommitInsertQueries() && bReturn)
+    bReturn = m_database.CommitTransaction();
+  else
+  {
+    CLog::Log(LOGERROR, "EpgContainer - %s - failed to persist %u tables", __FUNCTION__, (unsigned int)tables.size());
+    m_database.RollbackTransaction();
+    bReturn = false;
+  }
+
   return bReturn;
 }
 
@@ -507,10 +534,13 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   }
 
   vector<CEpg*> invalidTables;
+  vector<CEpg*> updatedTables;
 
-  /* load or update all EPG tables */
+  /* load all EPG tables from the database and queue the ones that have to be updated */
+  CEpgUpdateQueue queue(*this, start, end, g_advancedSettings.m_iEpgUpdateThreads, g_advancedSettings.m_iEpgClientUpdateThreads);
   CEpg *epg;
   unsigned int iCounter(0);
+  unsigned int iQueued(0);
   for (map<unsigned int, CEpg *>::iterator it = m_epgs.begin(); it != m_epgs.end(); it++)
   {
     if (InterruptUpdate())
@@ -524,7 +554,7 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
       continue;
 
     if (bShowProgress && !bOnlyPending)
-      UpdateProgressDialog(++iCounter, m_epgs.size(), epg->Name());
+      UpdateProgressDialog(++iCounter, m_epgs.size() * 2, epg->Name());
 
     // we currently only support update via pvr add-ons. skip update when the pvr manager isn't started
     if (!g_PVRManager.IsStarted())
@@ -538,12 +568,54 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
         epg->SetChannel(channel);
     }
 
-    if ((!bOnlyPending || epg->UpdatePending()) && epg->Update(start, end, m_iUpdateTime, bOnlyPending))
-      iUpdatedTables++;
-    else if (!epg->IsValid())
-      invalidTables.push_back(epg);
+    if (bOnlyPending && !epg->UpdatePending())
+    {
+      if (!epg->IsValid())
+        invalidTables.push_back(epg);
+    }
+    else if (epg->PrepareUpdate(m_iUpdateTime, bOnlyPending))
+    {
+      queue.Add(epg);
+      iQueued++;
+    }
+    else if (epg->UpdateFromClients(start, end, false))
+      updatedTables.push_back(epg);
   }
 
+  /* fetch the queued tables from the clients, a number of tables at once */
+  if (!bInterrupted && iQueued > 0)
+  {
+    CStdString strLastTable;
+    queue.Start();
+    while (!queue.Wait(500))
+    {
+      if (!bInterrupted && InterruptUpdate())
+      {
+        bInterrupted = true;
+        queue.Cancel();
+      }
+
+      if (bShowProgress && !bOnlyPending)
+      {
+        unsigned int iDone = queue.GetProgress(strLastTable);
+        UpdateProgressDialog(m_epgs.size() + iDone * m_epgs.size() / iQueued, m_epgs.size() * 2, strLastTable);
+      }
+    }
+
+    vector<CEpg*> failedTables;
+    queue.GetResults(updatedTables, failedTables);
+    CLog::Log(LOGDEBUG, "EpgContainer - %s - fetched %u of %u tables, at most %u at once", __FUNCTION__,
+        (unsigned int)(updatedTables.size() + failedTables.size()), iQueued, queue.GetMaxConcurrentFetches());
+
+    for (vector<CEpg*>::iterator it = failedTables.begin(); it != failedTables.end(); it++)
+      if (!(*it)->IsValid())
+        invalidTables.push_back(*it);
+  }
+
+  /* write the changes of all updated tables in one go */
+  Persist(updatedTables);
+  iUpdatedTables = updatedTables.size();
+
   for (vector<CEpg*>::iterator it = invalidTables.begin(); it != invalidTables.end(); it++)
     DeleteEpg(**it, true);
 
@@ -578,6 +650,17 @@ bool CEpgContainer::UpdateEPG(bool bOnlyPending /* = false */)
   return !bInterrupted;
 }
 
+int CEpgContainer::GetEpgClientID(const CEpg &epg) const
+{
+  CPVRChannelPtr channel = epg.Channel();
+  return channel ? channel->ClientID() : -1;
+}
+
+bool CEpgContainer::FetchEpg(CEpg &epg, time_t start, time_t end)
+{
+  return epg.UpdateFromClients(start, end, true);
+}
+
 int CEpgContainer::GetEPGAll(CFileItemList &results)
 {
   int iInitialSize = results.Size();
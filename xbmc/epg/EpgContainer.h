@@ -27,6 +27,7 @@
 
 #include "Epg.h"
 #include "EpgDatabase.h"
+#include "EpgUpdateQueue.h"
 
 #include <map>
 
@@ -39,7 +40,8 @@ namespace EPG
 
   class CEpgContainer : public Observer,
     public Observable,
-    private CThread
+    private CThread,
+    private IEpgSource
   {
     friend class CEpgDatabase;
 
@@ -237,6 +239,16 @@ namespace EPG
      */
     virtual bool UpdateEPG(bool bOnlyPending = false);
 
+    /*!
+     * @brief Persist the given tables in one transaction.
+     * @param tables The tables to persist.
+     * @return True when they all were persisted, false otherwise.
+     */
+    bool Persist(const std::vector<CEpg *> &tables);
+
+    virtual int GetEpgClientID(const CEpg &epg) const;
+    virtual bool FetchEpg(CEpg &epg, time_t start, time_t end);
+
     /*!
      * @return True if a running update should be interrupted, false otherwise.
      */
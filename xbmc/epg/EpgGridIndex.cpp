@@ -0,0 +1,263 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <algorithm>
+#include "FileItem.h"
+#include "utils/Variant.h"
+#include "EpgInfoTag.h"
+#include "EpgGridIndex.h"
+
+using namespace EPG;
+using namespace std;
+
+static bool BlockBeforeSpan(int block, const GridItemsPtr &span)
+{
+  return block < span.start;
+}
+
+/* the guide hands in new copies of the programmes on every refresh, so they're compared by what they are */
+static bool SameProgramme(const CGUIListItemPtr &left, const CGUIListItemPtr &right)
+{
+  if (left == right)
+    return true;
+
+  const CFileItem *leftItem = (const CFileItem *)left.get();
+  const CFileItem *rightItem = (const CFileItem *)right.get();
+  if (!leftItem->HasEPGInfoTag() || !rightItem->HasEPGInfoTag())
+    return leftItem->HasEPGInfoTag() == rightItem->HasEPGInfoTag();
+
+  const CEpgInfoTag *leftTag = leftItem->GetEPGInfoTag();
+  const CEpgInfoTag *rightTag = rightItem->GetEPGInfoTag();
+  return leftTag->EpgID() == rightTag->EpgID() &&
+         leftTag->UniqueBroadcastID() == rightTag->UniqueBroadcastID() &&
+         leftTag->StartAsUTC() == rightTag->StartAsUTC() &&
+         leftTag->EndAsUTC() == rightTag->EndAsUTC();
+}
+
+CEpgGridIndex::CEpgGridIndex(void) :
+    m_rowsBuilt(0),
+    m_gridStart(0),
+    m_gridEnd(0),
+    m_blocks(0),
+    m_blockSize(0),
+    m_rowSize(0),
+    m_vertical(true)
+{
+  m_noItem.width  = 0;
+  m_noItem.height = 0;
+  m_noItem.start  = 0;
+  m_noItem.end    = 0;
+}
+
+unsigned int CEpgGridIndex::Update(const vector<CGUIListItemPtr> &items, const vector<pair<unsigned long, unsigned long> > &ranges,
+                                   const CDateTime &gridStart, const CDateTime &gridEnd, int blocks, float blockSize, float rowSize, bool vertical)
+{
+  time_t start, end;
+  gridStart.GetAsTime(start);
+  gridEnd.GetAsTime(end);
+  bool bSameGrid = start == m_gridStart && end == m_gridEnd && blocks == m_blocks &&
+                   blockSize == m_blockSize && rowSize == m_rowSize && vertical == m_vertical;
+
+  vector<GridRow> rows(ranges.size());
+  unsigned int iRebuild = 0;
+  for (unsigned int i = 0; i < ranges.size(); i++)
+  {
+    GridRow &row = rows[i];
+    row.first = ranges[i].first;
+    row.last  = ranges[i].second;
+    row.built = false;
+
+    /* keep the spans of a row that holds the same programmes, pointing them at the new items */
+    if (bSameGrid && i < m_rows.size() && m_rows[i].built &&
+        m_rows[i].last - m_rows[i].first == row.last - row.first)
+    {
+      bool bSame = true;
+      for (unsigned long j = 0; bSame && j <= row.last - row.first; j++)
+        bSame = SameProgramme(m_items[m_rows[i].first + j], items[row.first + j]);
+
+      if (bSame)
+      {
+        row.spans.swap(m_rows[i].spans);
+        row.built = true;
+        m_rows[i].built = false;
+
+        vector<GridItemsPtr>::iterator span = row.spans.begin();
+        for (unsigned long j = 0; span != row.spans.end() && j <= row.last - row.first; j++)
+        {
+          if (span->item != m_items[m_rows[i].first + j])
+            continue;
+
+          CFileItem *item = (CFileItem *)items[row.first + j].get();
+          if (span->item != items[row.first + j])
+          {
+            item->SetProperty("GenreType", item->GetEPGInfoTag()->GenreType());
+            span->item = items[row.first + j];
+          }
+          ++span;
+        }
+        continue;
+      }
+    }
+    iRebuild++;
+  }
+
+  /* the programmes of the rows that go lose the properties set on them, as they did with a full rebuild */
+  for (unsigned int i = 0; i < m_rows.size(); i++)
+    ClearRow(m_rows[i]);
+
+  m_rows.swap(rows);
+  m_items      = items;
+  m_gridStart  = start;
+  m_gridEnd    = end;
+  m_blocks     = blocks;
+  m_blockSize  = blockSize;
+  m_rowSize    = rowSize;
+  m_vertical   = vertical;
+
+  return iRebuild;
+}
+
+void CEpgGridIndex::Clear(void)
+{
+  for (unsigned int i = 0; i < m_rows.size(); i++)
+    ClearRow(m_rows[i]);
+  m_rows.clear();
+  m_items.clear();
+  m_blocks = 0;
+}
+
+void CEpgGridIndex::ClearRow(GridRow &row) const
+{
+  if (row.built)
+  {
+    for (vector<GridItemsPtr>::iterator it = row.spans.begin(); it != row.spans.end(); ++it)
+      it->item->ClearProperties();
+  }
+  row.spans.clear();
+  row.built = false;
+}
+
+void CEpgGridIndex::BuildRow(GridRow &row) const
+{
+  const time_t blockSeconds = MINSPERBLOCK * 60;
+
+  row.spans.clear();
+  row.built = true;
+  m_rowsBuilt++;
+  if (row.first > row.last || row.last >= m_items.size())
+    return;
+
+  CFileItem *firstItem = (CFileItem *)m_items[row.first].get();
+  if (!firstItem->HasEPGInfoTag())
+    return;
+  int iEpgId = firstItem->GetEPGInfoTag()->EpgID();
+
+  int block = 0;
+  for (unsigned long i = row.first; i <= row.last && block < m_blocks; i++)
+  {
+    CFileItem *item = (CFileItem *)m_items[i].get();
+    if (!item->HasEPGInfoTag())
+      continue;
+
+    const CEpgInfoTag *tag = item->GetEPGInfoTag();
+    if (tag->EpgID() != iEpgId)
+      break;
+
+    time_t start, end;
+    tag->StartAsUTC().GetAsTime(start);
+    tag->EndAsUTC().GetAsTime(end);
+    if (m_gridEnd <= start)
+      break;
+
+    /* a programme takes the blocks that start before it ends and that the programmes before it left over */
+    int endBlock = end > m_gridStart ? (int)((end - m_gridStart + blockSeconds - 1) / blockSeconds) : 0;
+    if (endBlock > m_blocks)
+      endBlock = m_blocks;
+    if (endBlock <= block)
+      continue;
+
+    GridItemsPtr span;
+    span.item   = m_items[i];
+    span.start  = block;
+    span.end    = endBlock;
+    span.width  = m_vertical ? (endBlock - block) * m_blockSize : m_rowSize;
+    span.height = m_vertical ? m_rowSize : (endBlock - block) * m_blockSize;
+    item->SetProperty("GenreType", tag->GenreType());
+    row.spans.push_back(span);
+
+    block = endBlock;
+  }
+}
+
+const vector<GridItemsPtr> &CEpgGridIndex::GetRow(int row) const
+{
+  static const vector<GridItemsPtr> noRow;
+  if (row < 0 || row >= (int)m_rows.size())
+    return noRow;
+
+  if (!m_rows[row].built)
+    BuildRow(m_rows[row]);
+  return m_rows[row].spans;
+}
+
+GridItemsPtr *CEpgGridIndex::GetItem(int row, int block) const
+{
+  const vector<GridItemsPtr> &spans = GetRow(row);
+  vector<GridItemsPtr>::const_iterator it = upper_bound(spans.begin(), spans.end(), block, BlockBeforeSpan);
+  if (it == spans.begin() || block >= (it - 1)->end)
+    return &m_noItem;
+
+  return const_cast<GridItemsPtr *>(&*(it - 1));
+}
+
+int CEpgGridIndex::GetBlock(int row, const CGUIListItemPtr &item) const
+{
+  const vector<GridItemsPtr> &spans = GetRow(row);
+  if (!item)
+    return spans.empty() ? 0 : spans.back().end;
+
+  for (vector<GridItemsPtr>::const_iterator it = spans.begin(); it != spans.end(); ++it)
+  {
+    if (it->item == item)
+      return it->start;
+  }
+  return m_blocks;
+}
+
+void CEpgGridIndex::FreeRows(int keepStart, int keepEnd)
+{
+  for (int i = 0; i < (int)m_rows.size(); i++)
+  {
+    if ((i < keepStart || i > keepEnd) && m_rows[i].built)
+    {
+      /* the spans are built again from the same items, so their properties stay */
+      vector<GridItemsPtr>().swap(m_rows[i].spans);
+      m_rows[i].built = false;
+    }
+  }
+}
+
+size_t CEpgGridIndex::GetMemoryUsage(void) const
+{
+  size_t size = m_rows.capacity() * sizeof(GridRow);
+  for (unsigned int i = 0; i < m_rows.size(); i++)
+    size += m_rows[i].spans.capacity() * sizeof(GridItemsPtr);
+  return size;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <time.h>
+#include <vector>
+#include "XBDateTime.h"
+#include "guilib/GUIMessage.h"
+
+namespace EPG
+{
+  #define MINSPERBLOCK 5 /// would be nice to offer zooming of busy schedules /// performance cost to increase resolution 5 fold?
+
+  struct GridItemsPtr
+  {
+    CGUIListItemPtr item;
+    float width;
+    float height;
+    int start;  //! first block of the programme
+    int end;    //! block after the last block of the programme
+  };
+
+  /*!
+   * @brief The programmes of the EPG grid, as one row of block spans per channel.
+   *
+   * Each row holds the programmes of a channel as sorted, back to back spans of blocks, so the
+   * programme at a block is found with a binary search. Rows are only built once they are looked
+   * at, rows away from the viewport can be freed again, and a row whose programmes are the same
+   * as before (by EPG, broadcast id and times) keeps its spans when the grid is updated.
+   */
+  class CEpgGridIndex
+  {
+  public:
+    CEpgGridIndex(void);
+
+    /*!
+     * @brief Update the grid, rebuilding the rows whose programmes or dimensions changed.
+     * @param items The programmes of all channels, each channel's in order of start time.
+     * @param ranges The first and last index in items for each channel.
+     * @param gridStart The start of the first block.
+     * @param gridEnd The end of the grid.
+     * @param blocks The number of blocks in the grid.
+     * @param blockSize The size of a block in pixels.
+     * @param rowSize The size of a channel row in pixels.
+     * @param vertical True when the blocks run from left to right.
+     * @return The number of rows that have to be rebuilt.
+     */
+    unsigned int Update(const std::vector<CGUIListItemPtr> &items, const std::vector<std::pair<unsigned long, unsigned long> > &ranges,
+                        const CDateTime &gridStart, const CDateTime &gridEnd, int blocks, float blockSize, float rowSize, bool vertical);
+
+    /*!
+     * @brief Clear the grid, and the properties set on the programmes in it.
+     */
+    void Clear(void);
+
+    /*!
+     * @brief Get the programme at a block.
+     * @return The programme, or an empty item if there is none at this block.
+     */
+    GridItemsPtr *GetItem(int row, int block) const;
+
+    /*!
+     * @brief Get the block the given programme starts at.
+     * @return The first block of the programme, or the first block without a programme for an empty item.
+     */
+    int GetBlock(int row, const CGUIListItemPtr &item) const;
+
+    /*!
+     * @brief Get the programmes of a row, building it if needed.
+     */
+    const std::vector<GridItemsPtr> &GetRow(int row) const;
+
+    /*!
+     * @brief Free the rows outside the given range. They are built again when needed.
+     */
+    void FreeRows(int keepStart, int keepEnd);
+
+    int GetNumRows(void) const { return (int)m_rows.size(); }
+    unsigned int GetNumRowsBuilt(void) const { return m_rowsBuilt; }
+
+    /*!
+     * @return The memory used by the spans of the rows that are built, in bytes.
+     */
+    size_t GetMemoryUsage(void) const;
+
+  private:
+    struct GridRow
+    {
+      unsigned long first;
+      unsigned long last;
+      bool built;
+      std::vector<GridItemsPtr> spans;
+    };
+
+    void BuildRow(GridRow &row) const;
+    void ClearRow(GridRow &row) const;
+
+    std::vector<CGUIListItemPtr> m_items;
+    mutable std::vector<GridRow> m_rows;  //! built when first looked at
+    mutable unsigned int m_rowsBuilt;
+    mutable GridItemsPtr m_noItem;
+
+    time_t m_gridStart;
+    time_t m_gridEnd;
+    int m_blocks;
+    float m_blockSize;
+    float m_rowSize;
+    bool m_vertical;
+  };
+}
@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EpgUpdateQueue.h"
+#include "Epg.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+
+using namespace EPG;
+using namespace std;
+
+CEpgUpdateQueue::CEpgUpdateQueue(IEpgSource &source, time_t start, time_t end, unsigned int iThreads, unsigned int iClientThreads) :
+    m_source(source),
+    m_start(start),
+    m_end(end),
+    m_iThreads(iThreads > 0 ? iThreads : 1),
+    m_iClientThreads(iClientThreads > 0 ? iClientThreads : 1),
+    m_iActive(0),
+    m_iMaxActive(0)
+{
+}
+
+CEpgUpdateQueue::~CEpgUpdateQueue(void)
+{
+  Cancel();
+
+  /* the threads finish the tables they're fetching and stop */
+  for (vector<CThread *>::iterator it = m_threads.begin(); it != m_threads.end(); it++)
+    delete *it;
+}
+
+void CEpgUpdateQueue::Add(CEpg *epg)
+{
+  int iClientId = m_source.GetEpgClientID(*epg);
+
+  CSingleLock lock(m_critSection);
+  m_pending.push_back(make_pair(epg, iClientId));
+}
+
+void CEpgUpdateQueue::Start(void)
+{
+  unsigned int iThreads;
+  {
+    CSingleLock lock(m_critSection);
+    iThreads = std::min(m_iThreads, (unsigned int) m_pending.size());
+  }
+
+  for (unsigned int iThread = 0; iThread < iThreads; iThread++)
+  {
+    CThread *thread = new CThread(this, "EpgUpdateQueue");
+    m_threads.push_back(thread);
+    thread->Create();
+  }
+}
+
+bool CEpgUpdateQueue::Wait(unsigned int iTimeoutMs)
+{
+  XbmcThreads::EndTime timeout(iTimeoutMs);
+
+  CSingleLock lock(m_critSection);
+  while (!m_pending.empty() || m_iActive > 0)
+  {
+    if (timeout.IsTimePast())
+      return false;
+    m_condition.wait(lock, timeout.MillisLeft());
+  }
+
+  return true;
+}
+
+void CEpgUpdateQueue::Cancel(void)
+{
+  CSingleLock lock(m_critSection);
+  m_pending.clear();
+  m_condition.notifyAll();
+}
+
+unsigned int CEpgUpdateQueue::GetProgress(CStdString &strLastTable) const
+{
+  CSingleLock lock(m_critSection);
+  strLastTable = m_strLastTable;
+  return m_updated.size() + m_failed.size();
+}
+
+void CEpgUpdateQueue::GetResults(vector<CEpg *> &updated, vector<CEpg *> &failed) const
+{
+  CSingleLock lock(m_critSection);
+  updated = m_updated;
+  failed  = m_failed;
+}
+
+void CEpgUpdateQueue::Run(void)
+{
+  CEpg *epg;
+  int iClientId;
+  while (Next(epg, iClientId))
+    Done(epg, iClientId, m_source.FetchEpg(*epg, m_start, m_end));
+}
+
+bool CEpgUpdateQueue::Next(CEpg *&epg, int &iClientId)
+{
+  CSingleLock lock(m_critSection);
+  while (!m_pending.empty())
+  {
+    /* take the first table of a client that isn't fetching as many tables as it allows */
+    for (deque<pair<CEpg *, int> >::iterator it = m_pending.begin(); it != m_pending.end(); it++)
+    {
+      unsigned int &iClientActive = m_clientsActive[it->second];
+      if (iClientActive < m_iClientThreads)
+      {
+        epg       = it->first;
+        iClientId = it->second;
+        m_pending.erase(it);
+
+        iClientActive++;
+        if (++m_iActive > m_iMaxActive)
+          m_iMaxActive = m_iActive;
+        return true;
+      }
+    }
+
+    m_condition.wait(lock);
+  }
+
+  return false;
+}
+
+void CEpgUpdateQueue::Done(CEpg *epg, int iClientId, bool bSuccess)
+{
+  CStdString strName = epg->Name();
+
+  CSingleLock lock(m_critSection);
+  m_clientsActive[iClientId]--;
+  m_iActive--;
+  if (bSuccess)
+    m_updated.push_back(epg);
+  else
+    m_failed.push_back(epg);
+  m_strLastTable = strName;
+
+  m_condition.notifyAll();
+}
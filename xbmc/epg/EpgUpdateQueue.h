@@ -0,0 +1,140 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2012-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <map>
+#include <vector>
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+#include "threads/Thread.h"
+#include "utils/StdString.h"
+
+namespace EPG
+{
+  class CEpg;
+
+  /*!
+   * @brief The source the entries of the EPG tables are fetched from.
+   */
+  class IEpgSource
+  {
+  public:
+    virtual ~IEpgSource(void) {}
+
+    /*!
+     * @brief The client a table is fetched from. Tables of the same client share its limit of concurrent fetches.
+     * @param epg The table.
+     * @return The id of the client.
+     */
+    virtual int GetEpgClientID(const CEpg &epg) const = 0;
+
+    /*!
+     * @brief Fetch the entries of a table and merge them into it. Called from several threads at once for different tables.
+     * @param epg The table.
+     * @param start Fetch entries after this time.
+     * @param end Fetch entries before this time.
+     * @return True if the table was fetched, false otherwise.
+     */
+    virtual bool FetchEpg(CEpg &epg, time_t start, time_t end) = 0;
+  };
+
+  /*!
+   * @brief Fetches EPG tables on a number of threads, without fetching more tables of one client at once than that client allows.
+   */
+  class CEpgUpdateQueue : private IRunnable
+  {
+  public:
+    /*!
+     * @param source The source to fetch the tables from.
+     * @param start Fetch entries after this time.
+     * @param end Fetch entries before this time.
+     * @param iThreads The number of tables fetched at once.
+     * @param iClientThreads The number of tables of one client fetched at once.
+     */
+    CEpgUpdateQueue(IEpgSource &source, time_t start, time_t end, unsigned int iThreads, unsigned int iClientThreads);
+    virtual ~CEpgUpdateQueue(void);
+
+    /*!
+     * @brief Queue a table. Tables are fetched in the order they are added.
+     */
+    void Add(CEpg *epg);
+
+    /*!
+     * @brief Start fetching the queued tables.
+     */
+    void Start(void);
+
+    /*!
+     * @brief Wait for the queued tables to be fetched.
+     * @param iTimeoutMs The time to wait in milliseconds.
+     * @return True if all tables have been fetched or cancelled, false if the timeout expired.
+     */
+    bool Wait(unsigned int iTimeoutMs);
+
+    /*!
+     * @brief Drop the tables that are not being fetched yet. The tables being fetched are finished.
+     */
+    void Cancel(void);
+
+    /*!
+     * @brief The number of tables that have been fetched so far.
+     * @param strLastTable The name of the table that was fetched last.
+     * @return The number of tables.
+     */
+    unsigned int GetProgress(CStdString &strLastTable) const;
+
+    /*!
+     * @brief The tables that have been fetched, after Wait() returned true.
+     * @param updated The tables that were fetched.
+     * @param failed The tables that couldn't be fetched.
+     */
+    void GetResults(std::vector<CEpg *> &updated, std::vector<CEpg *> &failed) const;
+
+    /*!
+     * @return The highest number of tables that were fetched at once.
+     */
+    unsigned int GetMaxConcurrentFetches(void) const { return m_iMaxActive; }
+
+  private:
+    virtual void Run(void);
+    bool Next(CEpg *&epg, int &iClientId);
+    void Done(CEpg *epg, int iClientId, bool bSuccess);
+
+    IEpgSource &               m_source;
+    time_t                     m_start;
+    time_t                     m_end;
+    unsigned int               m_iThreads;
+    unsigned int               m_iClientThreads;
+    std::vector<CThread *>     m_threads;
+
+    std::deque<std::pair<CEpg *, int> > m_pending;   /*!< the tables to fetch and their clients */
+    std::map<int, unsigned int> m_clientsActive;      /*!< the number of tables being fetched per client */
+    unsigned int               m_iActive;
+    unsigned int               m_iMaxActive;
+    std::vector<CEpg *>        m_updated;
+    std::vector<CEpg *>        m_failed;
+    CStdString                 m_strLastTable;
+
+    mutable CCriticalSection       m_critSection;
+    XbmcThreads::ConditionVariable m_condition;
+  };
+}
@@ -40,7 +40,6 @@ using namespace EPG;
 using namespace std;
 
 #define SHORTGAP     5 // how many blocks is considered a short-gap in nav logic
-#define MINSPERBLOCK 5 /// would be nice to offer zooming of busy schedules /// performance cost to increase resolution 5 fold?
 #define BLOCKJUMP    4 // how many blocks are jumped with each analogue scroll action
 
 CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float posX, float posY, float width,
@@ -89,11 +88,11 @@ CGUIEPGGridContainer::CGUIEPGGridContainer(int parentID, int controlID, float po
   m_cacheChannelItems     = preloadItems;
   m_cacheRulerItems       = preloadItems;
   m_cacheProgrammeItems   = preloadItems;
-  m_gridIndex             = NULL;
 }
 
 CGUIEPGGridContainer::~CGUIEPGGridContainer(void)
 {
+  ClearGridIndex();
   Reset();
 }
 
@@ -304,6 +303,11 @@ void CGUIEPGGridContainer::Render()
 
   int channel = chanOffset;
 
+  // only the rows around the viewport are kept
+  m_gridIndex.FreeRows(std::min(chanOffset, m_channelOffset + m_channelCursor) - m_channelsPerPage,
+                      std::max(chanOffset, m_channelOffset + m_channelCursor) + 2 * m_channelsPerPage);
+  CGUIListItemPtr focusedProgramme = m_gridIndex.GetItem(m_channelOffset + m_channelCursor, m_blockOffset + m_blockCursor)->item;
+
   float focusedPosX = 0;
   float focusedPosY = 0;
   float focusedwidth = 0;
@@ -313,29 +317,23 @@ void CGUIEPGGridContainer::Render()
     if (channel >= (int)m_channelItems.size())
       break;
 
-    int block = blockOffset;
     float posA2 = posA;
 
-    CGUIListItemPtr item = m_gridIndex[channel][block].item;
-    if (blockOffset > 0 && item == m_gridIndex[channel][blockOffset-1].item)
-    {
-      /* first program starts before current view */
-      int startBlock = blockOffset - 1;
-      while (startBlock >= 0 && m_gridIndex[channel][startBlock].item == item)
-        startBlock--;
-
-      block = startBlock + 1;
-      int missingSection = blockOffset - block;
-      posA2 -= missingSection * m_blockSize;
-    }
+    /* first program may start before current view */
+    const vector<GridItemsPtr> &row = m_gridIndex.GetRow(channel);
+    vector<GridItemsPtr>::const_iterator span = row.begin();
+    while (span != row.end() && span->end <= blockOffset)
+      ++span;
+    if (span != row.end() && span->start < blockOffset)
+      posA2 -= (blockOffset - span->start) * m_blockSize;
 
-    while (posA2 < endA && m_programmeItems.size())   // FOR EACH ITEM ///////////////
+    for (; posA2 < endA && span != row.end(); ++span)   // FOR EACH ITEM ///////////////
     {
-      item = m_gridIndex[channel][block].item;
+      CGUIListItemPtr item = span->item;
       if (!item || !item.get()->IsFileItem())
         break;
 
-      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == m_gridIndex[m_channelOffset + m_channelCursor][m_blockOffset + m_blockCursor].item);
+      bool focused = (channel == m_channelOffset + m_channelCursor) && (item == focusedProgramme);
 
       // render our item
       if (focused)
@@ -351,28 +349,22 @@ void CGUIEPGGridContainer::Render()
           focusedPosY = posA2;
         }
         focusedItem = item;
-        focusedwidth = m_gridIndex[channel][block].width;
-        focusedheight = m_gridIndex[channel][block].height;
+        focusedwidth = span->width;
+        focusedheight = span->height;
       }
       else
       {
         if (m_orientation == VERTICAL)
-          RenderProgrammeItem(posA2, posB, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posA2, posB, span->width, span->height, item.get(), focused);
         else
-          RenderProgrammeItem(posB, posA2, m_gridIndex[channel][block].width, m_gridIndex[channel][block].height, item.get(), focused);
+          RenderProgrammeItem(posB, posA2, span->width, span->height, item.get(), focused);
       }
 
       // increment our X position
       if (m_orientation == VERTICAL)
-      {
-        posA2 += m_gridIndex[channel][block].width; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].width / m_blockSize);
-      }
+        posA2 += span->width; // assumes focused & unfocused layouts have equal length
       else
-      {
-        posA2 += m_gridIndex[channel][block].height; // assumes focused & unfocused layouts have equal length
-        block += (int)(m_gridIndex[channel][block].height / m_blockSize);
-      }
+        posA2 += span->height; // assumes focused & unfocused layouts have equal length
     }
 
     // increment our Y position
@@ -708,16 +700,6 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
       for (int i = 0; i < items->Size(); i++)
         m_programmeItems.push_back(items->Get(i));
 
-      ClearGridIndex();
-      m_gridIndex = (struct GridItemsPtr **) calloc(1,m_channelItems.size()*sizeof(struct GridItemsPtr*));
-      if (m_gridIndex != NULL)
-      {
-        for (unsigned int i = 0; i < m_channelItems.size(); i++)
-        {
-          m_gridIndex[i] = (struct GridItemsPtr*) calloc(1,MAXBLOCKS*sizeof(struct GridItemsPtr));
-        }
-      }
-
       UpdateLayout(true); // true to refresh all items
 
       /* Create Ruler items */
@@ -755,12 +737,13 @@ bool CGUIEPGGridContainer::OnMessage(CGUIMessage& message)
 
 void CGUIEPGGridContainer::UpdateItems()
 {
-  CDateTimeSpan blockDuration, gridDuration;
+  CDateTimeSpan gridDuration;
 
   /* check for invalid start and end time */
   if (m_gridStart >= m_gridEnd)
   {
     CLog::Log(LOGERROR, "CGUIEPGGridContainer - %s - invalid start and end time set", __FUNCTION__);
+    ClearGridIndex();
     CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), GetParentID()); // message the window
     SendWindowMessage(msg);
     return;
@@ -776,104 +759,27 @@ void CGUIEPGGridContainer::UpdateItems()
   if (m_blocks < m_blocksPerPage)
   {
     CLog::Log(LOGERROR, "(%s) - Less than one page of data available.", __FUNCTION__);
+    ClearGridIndex();
     CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), GetParentID()); // message the window
     SendWindowMessage(msg);
     return;
   }
 
-  blockDuration.SetDateTimeSpan(0, 0, MINSPERBLOCK, 0);
-
   long tick(XbmcThreads::SystemClockMillis());
 
-  for (unsigned int row = 0; row < m_channelItems.size(); ++row)
-  {
-    CDateTime gridCursor  = m_gridStart; //reset cursor for new channel
-    unsigned long progIdx = m_epgItemsPtr[row].start;
-    unsigned long lastIdx = m_epgItemsPtr[row].stop;
-    int iEpgId            = ((CFileItem *)m_programmeItems[progIdx].get())->GetEPGInfoTag()->EpgID();
-
-    /** FOR EACH BLOCK **********************************************************************/
+  /* the rows are built when they're first rendered, rows holding the same programmes as before are kept */
+  vector<pair<unsigned long, unsigned long> > ranges;
+  ranges.reserve(m_epgItemsPtr.size());
+  for (unsigned int row = 0; row < m_epgItemsPtr.size(); ++row)
+    ranges.push_back(make_pair(m_epgItemsPtr[row].start, m_epgItemsPtr[row].stop));
 
-    for (int block = 0; block < m_blocks; block++)
-    {
-      while (progIdx <= lastIdx)
-      {
-        CGUIListItemPtr item = m_programmeItems[progIdx];
-        const CEpgInfoTag* tag = ((CFileItem *)item.get())->GetEPGInfoTag();
-        if (tag == NULL)
-          progIdx++;
-
-        if (tag->EpgID() != iEpgId)
-          break;
-
-        if (m_gridEnd <= tag->StartAsUTC())
-        {
-          break;
-        }
-        else if (gridCursor >= tag->EndAsUTC())
-        {
-          progIdx++;
-        }
-        else if (gridCursor < tag->EndAsUTC())
-        {
-          m_gridIndex[row][block].item = item;
-          break;
-        }
-        else
-        {
-          progIdx++;
-        }
-      }
-
-      gridCursor += blockDuration;
-    }
-
-    /** FOR EACH BLOCK **********************************************************************/
-    int itemSize = 1; // size of the programme in blocks
-    int savedBlock = 0;
-
-    for (int block = 0; block < m_blocks; block++)
-    {
-      if (m_gridIndex[row][block].item != m_gridIndex[row][block+1].item)
-      {
-        if (!m_gridIndex[row][block].item)
-        {
-          CEpgInfoTag broadcast;
-          CFileItemPtr unknown(new CFileItem(broadcast));
-          for (int i = block ; i > block - itemSize; i--)
-          {
-            m_gridIndex[row][i].item = unknown;
-          }
-        }
-
-        CGUIListItemPtr item = m_gridIndex[row][block].item;
-        CFileItem *fileItem = (CFileItem *)item.get();
-
-        m_gridIndex[row][savedBlock].item->SetProperty("GenreType", fileItem->GetEPGInfoTag()->GenreType());
-        if (m_orientation == VERTICAL)
-        {
-          m_gridIndex[row][savedBlock].width   = itemSize*m_blockSize;
-          m_gridIndex[row][savedBlock].height  = m_channelHeight;
-        }
-        else
-        {
-          m_gridIndex[row][savedBlock].width   = m_channelWidth;
-          m_gridIndex[row][savedBlock].height  = itemSize*m_blockSize;
-        }
-
-        itemSize = 1;
-        savedBlock = block+1;
-      }
-      else
-      {
-        itemSize++;
-      }
-    }
-  }
+  unsigned int iRebuild = m_gridIndex.Update(m_programmeItems, ranges, m_gridStart, m_gridEnd, m_blocks, m_blockSize,
+                                             m_orientation == VERTICAL ? m_channelHeight : m_channelWidth, m_orientation == VERTICAL);
 
   /******************************************* END ******************************************/
 
-  CLog::Log(LOGDEBUG, "%s completed successfully in %u ms", __FUNCTION__, (unsigned int)(XbmcThreads::SystemClockMillis()-tick));
+  CLog::Log(LOGDEBUG, "%s completed successfully in %u ms, %u of %u channels changed", __FUNCTION__,
+            (unsigned int)(XbmcThreads::SystemClockMillis()-tick), iRebuild, (unsigned int)ranges.size());
 
   m_channels = (int)m_epgItemsPtr.size();
   m_item = GetItem(m_channelCursor);
@@ -957,7 +863,7 @@ bool CGUIEPGGridContainer::MoveChannel(bool direction, bool wrapAround)
 
 bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
 {
-  if (!m_gridIndex || !m_item)
+  if (!m_item)
     return false;
 
   if (direction)
@@ -965,7 +871,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
     if (m_channelCursor + m_channelOffset < 0 || m_blockOffset < 0)
       return false;
 
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blockOffset].item)
+    if (m_item->item != m_gridIndex.GetItem(m_channelCursor + m_channelOffset, m_blockOffset)->item)
     {
       // this is not first item on page
       m_item = GetPrevItem(m_channelCursor);
@@ -1014,7 +920,7 @@ bool CGUIEPGGridContainer::MoveProgrammes(bool direction)
   }
   else
   {
-    if (m_item->item != m_gridIndex[m_channelCursor + m_channelOffset][m_blocksPerPage + m_blockOffset - 1].item)
+    if (m_item->item != m_gridIndex.GetItem(m_channelCursor + m_channelOffset, m_blocksPerPage + m_blockOffset - 1)->item)
     {
       // this is not last item on page
       m_item = GetNextItem(m_channelCursor);
@@ -1304,13 +1210,12 @@ bool CGUIEPGGridContainer::OnMouseWheel(char wheel, const CPoint &point)
 
 int CGUIEPGGridContainer::GetSelectedItem() const
 {
-  if (!m_gridIndex ||
-      !m_epgItemsPtr.size() ||
+  if (!m_epgItemsPtr.size() ||
       m_channelCursor + m_channelOffset >= (int)m_channelItems.size() ||
       m_blockCursor + m_blockOffset >= (int)m_programmeItems.size())
     return 0;
 
-  CGUIListItemPtr currentItem = m_gridIndex[m_channelCursor + m_channelOffset][m_blockCursor + m_blockOffset].item;
+  CGUIListItemPtr currentItem = m_gridIndex.GetItem(m_channelCursor + m_channelOffset, m_blockCursor + m_blockOffset)->item;
   if (!currentItem)
     return 0;
 
@@ -1397,9 +1302,9 @@ GridItemsPtr *CGUIEPGGridContainer::GetClosestItem(const int &channel)
   }
 
   if (right <= SHORTGAP && right <= left && m_blockCursor + right < m_blocksPerPage)
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + right + m_blockOffset];
+    return m_gridIndex.GetItem(channel + m_channelOffset, m_blockCursor + right + m_blockOffset);
 
-  return &m_gridIndex[channel + m_channelOffset][m_blockCursor - left  + m_blockOffset];
+  return m_gridIndex.GetItem(channel + m_channelOffset, m_blockCursor - left  + m_blockOffset);
 }
 
 int CGUIEPGGridContainer::GetItemSize(GridItemsPtr *item)
@@ -1420,40 +1325,35 @@ int CGUIEPGGridContainer::GetBlock(const CGUIListItemPtr &item, const int &chann
 
 int CGUIEPGGridContainer::GetRealBlock(const CGUIListItemPtr &item, const int &channel)
 {
-  int block = 0;
-
-  while (m_gridIndex[channel + m_channelOffset][block].item != item && block < m_blocks)
-    block++;
-
-  return block;
+  return m_gridIndex.GetBlock(channel + m_channelOffset, item);
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetNextItem(const int &channel)
 {
-  int i = m_blockCursor;
+  GridItemsPtr *current = m_gridIndex.GetItem(channel + m_channelOffset, m_blockCursor + m_blockOffset);
+  int block = m_blockOffset + m_blocksPerPage;
+  if (current->item && current->end < block)
+    block = current->end;
 
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i < m_blocksPerPage)
-    i++;
-
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  return m_gridIndex.GetItem(channel + m_channelOffset, block);
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetPrevItem(const int &channel)
 {
-  int i = m_blockCursor;
-
-  while (m_gridIndex[channel + m_channelOffset][i + m_blockOffset].item == m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset].item && i > 0)
-    i--;
-
-  return &m_gridIndex[channel + m_channelOffset][i + m_blockOffset];
+  GridItemsPtr *current = m_gridIndex.GetItem(channel + m_channelOffset, m_blockCursor + m_blockOffset);
+  int block = current->item ? current->start : m_gridIndex.GetBlock(channel + m_channelOffset, current->item);
+  if (block - 1 > m_blockOffset)
+    block = block - 1;
+  else
+    block = m_blockOffset;
 
-//  return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset - 1];
+  return m_gridIndex.GetItem(channel + m_channelOffset, block);
 }
 
 GridItemsPtr *CGUIEPGGridContainer::GetItem(const int &channel)
 {
   if ( (channel >= 0) && (channel < m_channels) )
-    return &m_gridIndex[channel + m_channelOffset][m_blockCursor + m_blockOffset];
+    return m_gridIndex.GetItem(channel + m_channelOffset, m_blockCursor + m_blockOffset);
   else
     return NULL;
 }
@@ -1634,25 +1534,12 @@ CStdString CGUIEPGGridContainer::GetDescription() const
 
 void CGUIEPGGridContainer::ClearGridIndex(void)
 {
-  if (m_gridIndex)
-  {
-    for (unsigned int i = 0; i < m_channelItems.size(); i++)
-    {
-      for (int block = 0; block < m_blocks; block++)
-      {
-        if (m_gridIndex[i][block].item)
-          m_gridIndex[i][block].item.get()->ClearProperties();
-      }
-      free(m_gridIndex[i]);
-    }
-    free(m_gridIndex);
-  }
+  m_gridIndex.Clear();
 }
 
 void CGUIEPGGridContainer::Reset()
 {
-  ClearGridIndex();
-
+  /* the grid index is kept, so rows holding the same programmes survive binding the items again */
   m_wasReset = true;
   m_channelItems.clear();
   m_programmeItems.clear();
@@ -1661,7 +1548,7 @@ void CGUIEPGGridContainer::Reset()
 
   m_lastItem    = NULL;
   m_lastChannel = NULL;
-  m_gridIndex   = NULL;
+  m_item        = NULL;
 }
 
 void CGUIEPGGridContainer::GoToBegin()
@@ -1675,13 +1562,11 @@ void CGUIEPGGridContainer::GoToEnd()
   int blocksEnd = 0;   // the end block of the last epg element for the selected channel
   int blocksStart = 0; // the start block of the last epg element for the selected channel
   int blockOffset = 0; // the block offset to scroll to
-  for (int blockIndex = m_blocks; blockIndex >= 0 && (!blocksEnd || !blocksStart); blockIndex--)
+  const vector<GridItemsPtr> &row = m_gridIndex.GetRow(m_channelCursor + m_channelOffset);
+  if (!row.empty())
   {
-    if (!blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item != NULL)
-      blocksEnd = blockIndex;
-    if (blocksEnd && m_gridIndex[m_channelCursor + m_channelOffset][blocksEnd].item != 
-                     m_gridIndex[m_channelCursor + m_channelOffset][blockIndex].item)
-      blocksStart = blockIndex + 1;
+    blocksEnd = row.back().end - 1;
+    blocksStart = row.back().start;
   }
   if (blocksEnd - blocksStart > m_blocksPerPage)
     blockOffset = blocksStart;
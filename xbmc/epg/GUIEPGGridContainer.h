@@ -25,6 +25,7 @@
 #include "guilib/GUIControl.h"
 #include "guilib/GUIListItemLayout.h"
 #include "guilib/GUIBaseContainer.h"
+#include "EpgGridIndex.h"
 
 namespace PVR
 {
@@ -36,13 +37,6 @@ namespace EPG
   #define MAXCHANNELS 20
   #define MAXBLOCKS   2304 //! !!_EIGHT_!! days of 5 minute blocks
 
-  struct GridItemsPtr
-  {
-    CGUIListItemPtr item;
-    float width;
-    float height;
-  };
-
   class CGUIEPGGridContainer : public IGUIContainer
   {
   friend class PVR::CGUIWindowPVRGuide;
@@ -206,7 +200,7 @@ namespace EPG
     CDateTime m_gridStart;
     CDateTime m_gridEnd;
 
-    struct GridItemsPtr **m_gridIndex;
+    CEpgGridIndex m_gridIndex;
     GridItemsPtr *m_item;
     CGUIListItem *m_lastItem;
     CGUIListItem *m_lastChannel;
@@ -351,6 +351,262 @@ void CCurlFile::CReadState::Disconnect()
 }
 
 
+CCurlFile::CSegmentedReadState::CSegmentedReadState(CURLM* multiHandle, int64_t filePos, int64_t fileSize, unsigned int segmentSize)
+{
+  m_multiHandle = multiHandle;
+  m_filePos = filePos;
+  m_fileSize = fileSize;
+  m_nextStart = filePos;
+  m_segmentSize = segmentSize;
+  m_stillRunning = 0;
+  m_cancelled = false;
+  m_failed = false;
+}
+
+CCurlFile::CSegmentedReadState::~CSegmentedReadState()
+{
+  for (std::deque<SSegment>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+  {
+    it->state->Disconnect();
+    // the multi handle belongs to the main read state, only release our easy handle
+    it->state->m_multiHandle = NULL;
+    delete it->state;
+  }
+}
+
+void CCurlFile::CSegmentedReadState::AddSegment(CReadState* state)
+{
+  SSegment segment = {};
+  segment.state = state;
+  segment.state->m_multiHandle = m_multiHandle;
+  segment.state->m_buffer.Create(m_segmentSize);
+  m_segments.push_back(segment);
+}
+
+void CCurlFile::CSegmentedReadState::Start()
+{
+  m_nextStart = m_filePos;
+  for (std::deque<SSegment>::iterator it = m_segments.begin(); it != m_segments.end(); ++it)
+    Schedule(*it, m_nextStart);
+}
+
+void CCurlFile::CSegmentedReadState::Schedule(SSegment& segment, int64_t start)
+{
+  segment.state->Disconnect();
+  segment.active = false;
+  segment.done = false;
+  segment.verified = false;
+  segment.retries = 0;
+  segment.pos = start;
+  segment.end = start - 1;
+
+  if (start >= m_fileSize)
+    return;
+
+  segment.end = XMIN(start + m_segmentSize, m_fileSize) - 1;
+  m_nextStart = segment.end + 1;
+  Connect(segment, start);
+}
+
+void CCurlFile::CSegmentedReadState::Connect(SSegment& segment, int64_t from)
+{
+  char range[42];
+  sprintf(range, "%"PRId64"-%"PRId64, from, segment.end);
+  g_curlInterface.easy_setopt(segment.state->m_easyHandle, CURLOPT_RANGE, range);
+  g_curlInterface.multi_add_handle(m_multiHandle, segment.state->m_easyHandle);
+  segment.state->m_headerdone = false;
+  segment.active = true;
+  segment.done = false;
+}
+
+void CCurlFile::CSegmentedReadState::Rotate()
+{
+  SSegment segment = m_segments.front();
+  m_segments.pop_front();
+  Schedule(segment, m_nextStart);
+  m_segments.push_back(segment);
+  m_filePos = m_segments.front().pos;
+}
+
+bool CCurlFile::CSegmentedReadState::Seek(int64_t pos)
+{
+  if (m_failed)
+    return false;
+
+  if (pos == m_filePos)
+    return true;
+
+  // drop whole segments and skip inside the one holding pos when it is already
+  // part of the read-ahead window, anything else restarts the window at pos
+  if (pos > m_filePos && pos < m_nextStart)
+  {
+    while (pos > m_segments.front().end)
+      Rotate();
+
+    SSegment& head = m_segments.front();
+    unsigned int skip = (unsigned int)(pos - head.pos);
+    if (skip > 0)
+    {
+      if (!FillBuffer(head, skip) || head.state->m_buffer.getMaxReadSize() < skip)
+      {
+        m_failed = true;
+        return false;
+      }
+      head.state->m_buffer.SkipBytes(skip);
+      head.pos += skip;
+    }
+    m_filePos = pos;
+    return true;
+  }
+
+  m_filePos = pos;
+  Start();
+  return true;
+}
+
+unsigned int CCurlFile::CSegmentedReadState::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (m_failed || m_filePos >= m_fileSize)
+    return 0;
+
+  SSegment& head = m_segments.front();
+  if (!FillBuffer(head, 1))
+  {
+    m_failed = !m_cancelled;
+    return 0;
+  }
+
+  unsigned int want = (unsigned int)XMIN(head.state->m_buffer.getMaxReadSize(), uiBufSize);
+  if (!want || !head.state->m_buffer.ReadData((char *)lpBuf, want))
+  {
+    CLog::Log(LOGWARNING, "%s - Segment transfer ended before entire range was retrieved pos %"PRId64", end %"PRId64, __FUNCTION__, head.pos, head.end);
+    m_failed = true;
+    return 0;
+  }
+
+  head.pos += want;
+  m_filePos += want;
+  if (head.pos > head.end)
+    Rotate();
+
+  return want;
+}
+
+bool CCurlFile::CSegmentedReadState::HandleFinished()
+{
+  int msgs;
+  CURLMsg* msg;
+  while ((msg = g_curlInterface.multi_info_read(m_multiHandle, &msgs)))
+  {
+    if (msg->msg != CURLMSG_DONE)
+      continue;
+
+    std::deque<SSegment>::iterator it;
+    for (it = m_segments.begin(); it != m_segments.end(); ++it)
+    {
+      if (it->state->m_easyHandle == msg->easy_handle)
+        break;
+    }
+    if (it == m_segments.end())
+      continue;
+
+    SSegment& segment = *it;
+    g_curlInterface.multi_remove_handle(m_multiHandle, segment.state->m_easyHandle);
+    segment.active = false;
+
+    if (msg->data.result == CURLE_OK)
+    {
+      segment.done = true;
+      continue;
+    }
+
+    // resume after whatever already made it into the buffer
+    int64_t from = segment.pos + segment.state->m_buffer.getMaxReadSize();
+    if (++segment.retries > g_advancedSettings.m_curlretries || from > segment.end)
+    {
+      CLog::Log(LOGWARNING, "%s: curl failed with code %i for range %"PRId64"-%"PRId64, __FUNCTION__, msg->data.result, segment.pos, segment.end);
+      return false;
+    }
+
+    CLog::Log(LOGWARNING, "%s: Reconnect range %"PRId64"-%"PRId64", (re)try %i", __FUNCTION__, from, segment.end, segment.retries);
+    Connect(segment, from);
+  }
+  return true;
+}
+
+bool CCurlFile::CSegmentedReadState::FillBuffer(SSegment& segment, unsigned int want)
+{
+  fd_set fdread;
+  fd_set fdwrite;
+  fd_set fdexcep;
+
+  while (segment.state->m_buffer.getMaxReadSize() < want)
+  {
+    if (m_cancelled)
+      return false;
+
+    // everything left for this range has arrived, hand out what we have
+    if (segment.done)
+      return true;
+
+    if (!segment.active)
+      return false;
+
+    CURLMcode result = g_curlInterface.multi_perform(m_multiHandle, &m_stillRunning);
+    if (result != CURLM_OK && result != CURLM_CALL_MULTI_PERFORM)
+    {
+      CLog::Log(LOGERROR, "%s - curl multi perform failed with code %d, aborting", __FUNCTION__, result);
+      return false;
+    }
+
+    if (!HandleFinished())
+      return false;
+
+    // a server that ignores the range request would hand us the whole file
+    if (!segment.verified && (segment.state->m_buffer.getMaxReadSize() > 0 || segment.done))
+    {
+      long response = 0;
+      g_curlInterface.easy_getinfo(segment.state->m_easyHandle, CURLINFO_RESPONSE_CODE, &response);
+      if (response != 206)
+      {
+        CLog::Log(LOGWARNING, "%s - server answered range request with %ld", __FUNCTION__, response);
+        return false;
+      }
+      segment.verified = true;
+    }
+
+    if (segment.state->m_overflowSize)
+    {
+      CLog::Log(LOGWARNING, "%s - server sent more data than requested for range %"PRId64"-%"PRId64, __FUNCTION__, segment.pos, segment.end);
+      return false;
+    }
+
+    if (result == CURLM_CALL_MULTI_PERFORM || segment.done)
+      continue;
+
+    int maxfd = -1;
+    FD_ZERO(&fdread);
+    FD_ZERO(&fdwrite);
+    FD_ZERO(&fdexcep);
+
+    // get file descriptors from the transfers
+    g_curlInterface.multi_fdset(m_multiHandle, &fdread, &fdwrite, &fdexcep, &maxfd);
+
+    long timeout = 0;
+    if (CURLM_OK != g_curlInterface.multi_timeout(m_multiHandle, &timeout) || timeout == -1)
+      timeout = 200;
+
+    struct timeval t = { timeout / 1000, (timeout % 1000) * 1000 };
+
+    if (SOCKET_ERROR == dllselect(maxfd + 1, &fdread, &fdwrite, &fdexcep, &t))
+    {
+      CLog::Log(LOGERROR, "%s - curl failed with socket error", __FUNCTION__);
+      return false;
+    }
+  }
+  return true;
+}
+
 CCurlFile::~CCurlFile()
 {
   Close();
@@ -383,6 +639,7 @@ CCurlFile::CCurlFile()
   m_httpauth = "";
   m_proxytype = PROXY_HTTP;
   m_state = new CReadState();
+  m_segmented = NULL;
   m_skipshout = false;
   m_httpresponse = -1;
 }
@@ -398,6 +655,8 @@ void CCurlFile::Close()
   if (m_opened && m_forWrite && !m_inError)
       Write(NULL, 0);
 
+  delete m_segmented;
+  m_segmented = NULL;
   m_state->Disconnect();
 
   m_url.Empty();
@@ -489,8 +748,8 @@ void CCurlFile::SetCommonOptions(CReadState* state)
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYPEER, 0);
   g_curlInterface.easy_setopt(h, CURLOPT_SSL_VERIFYHOST, 0);
 
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_URL, m_url.c_str());
-  g_curlInterface.easy_setopt(m_state->m_easyHandle, CURLOPT_TRANSFERTEXT, FALSE);
+  g_curlInterface.easy_setopt(h, CURLOPT_URL, m_url.c_str());
+  g_curlInterface.easy_setopt(h, CURLOPT_TRANSFERTEXT, FALSE);
 
   // setup POST data if it is set (and it may be empty)
   if (m_postdataset)
@@ -880,6 +1139,8 @@ bool CCurlFile::IsInternet(bool checkDNS /* = true */)
 void CCurlFile::Cancel()
 {
   m_state->m_cancelled = true;
+  if (m_segmented)
+    m_segmented->Cancel();
   while (m_opened)
     Sleep(1);
 }
@@ -960,9 +1221,102 @@ bool CCurlFile::Open(const CURL& url)
   if (CURLE_OK == g_curlInterface.easy_getinfo(m_state->m_easyHandle, CURLINFO_EFFECTIVE_URL,&efurl) && efurl)
     m_url = efurl;
 
+  if (CanReadSegmented(url2))
+    StartSegmentedRead();
+
+  return true;
+}
+
+bool CCurlFile::CanReadSegmented(const CURL &url)
+{
+  if (g_advancedSettings.m_curlsegments < 2 || !m_seekable)
+    return false;
+
+  if (!url.GetProtocol().Equals("http") && !url.GetProtocol().Equals("https"))
+    return false;
+
+  // requests with a body or transformed content can't be split up
+  if (m_postdataset || !m_customrequest.IsEmpty() || !m_contentencoding.IsEmpty())
+    return false;
+
+  if (!m_state->m_httpheader.GetValue("Accept-Ranges").Equals("bytes"))
+    return false;
+
+  // not worth the extra connections unless the file spans several windows
+  int64_t window = (int64_t)g_advancedSettings.m_curlsegments * g_advancedSettings.m_curlsegmentsize;
+  return m_state->m_fileSize >= window * 4;
+}
+
+void CCurlFile::StartSegmentedRead()
+{
+  CURL url(m_url);
+
+  // the main transfer is only kept around for its headers, and as the fallback
+  // should the server turn out to not play along with the range requests
+  g_curlInterface.multi_remove_handle(m_state->m_multiHandle, m_state->m_easyHandle);
+
+  m_segmented = new CSegmentedReadState(m_state->m_multiHandle, m_state->m_filePos, m_state->m_fileSize, g_advancedSettings.m_curlsegmentsize);
+  for (int i = 0; i < g_advancedSettings.m_curlsegments; i++)
+  {
+    CReadState* state = new CReadState();
+    g_curlInterface.easy_aquire(url.GetProtocol(), url.GetHostName(), &state->m_easyHandle, NULL);
+    SetCommonOptions(state);
+    // share the header list of the main transfer, rebuilding it would free it from under that handle
+    if (m_curlHeaderList)
+      g_curlInterface.easy_setopt(state->m_easyHandle, CURLOPT_HTTPHEADER, m_curlHeaderList);
+    m_segmented->AddSegment(state);
+  }
+  m_segmented->Start();
+
+  CLog::Log(LOGDEBUG, "CCurlFile::StartSegmentedRead(%p) %s using %d connections of %u bytes", (void*)this, m_url.c_str(), g_advancedSettings.m_curlsegments, g_advancedSettings.m_curlsegmentsize);
+}
+
+bool CCurlFile::StopSegmentedRead(int64_t pos)
+{
+  delete m_segmented;
+  m_segmented = NULL;
+
+  int64_t fileSize = m_state->m_fileSize;
+  m_state->Disconnect();
+  m_state->m_filePos = pos;
+  m_state->m_fileSize = fileSize;
+
+  m_httpresponse = m_state->Connect(m_bufferSize);
+  if (m_httpresponse < 0 || m_httpresponse >= 400)
+  {
+    m_seekable = false;
+    return false;
+  }
+
+  SetCorrectHeaders(m_state);
   return true;
 }
 
+bool CCurlFile::ReadString(char *szLine, int iLineLength)
+{
+  // line based reads are rare enough to not bother with the segmented path
+  if (m_segmented && !StopSegmentedRead(m_segmented->GetPosition()))
+    return false;
+
+  return m_state->ReadString(szLine, iLineLength);
+}
+
+unsigned int CCurlFile::Read(void* lpBuf, int64_t uiBufSize)
+{
+  if (m_segmented)
+  {
+    unsigned int read = m_segmented->Read(lpBuf, uiBufSize);
+    if (read > 0 || !m_segmented->IsFailed())
+      return read;
+
+    CLog::Log(LOGWARNING, "CCurlFile::Read - segmented transfer of %s failed, falling back to a single connection", m_url.c_str());
+    if (!StopSegmentedRead(m_segmented->GetPosition()))
+      return 0;
+  }
+
+  return m_state->Read(lpBuf, uiBufSize);
+}
+
 bool CCurlFile::OpenForWrite(const CURL& url, bool bOverWrite)
 {
   if(m_opened)
@@ -1114,7 +1468,7 @@ bool CCurlFile::Exists(const CURL& url)
 
 int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
 {
-  int64_t nextPos = m_state->m_filePos;
+  int64_t nextPos = m_segmented ? m_segmented->GetPosition() : m_state->m_filePos;
   switch(iWhence)
   {
     case SEEK_SET:
@@ -1136,6 +1490,15 @@ int64_t CCurlFile::Seek(int64_t iFilePosition, int iWhence)
   // We can't seek beyond EOF
   if (m_state->m_fileSize && nextPos > m_state->m_fileSize) return -1;
 
+  if (m_segmented)
+  {
+    if (m_segmented->Seek(nextPos))
+      return nextPos;
+
+    CLog::Log(LOGWARNING, "CCurlFile::Seek - segmented transfer of %s failed, falling back to a single connection", m_url.c_str());
+    return StopSegmentedRead(nextPos) ? nextPos : -1;
+  }
+
   if(m_state->Seek(nextPos))
     return nextPos;
 
@@ -1191,6 +1554,7 @@ int64_t CCurlFile::GetLength()
 int64_t CCurlFile::GetPosition()
 {
   if (!m_opened) return 0;
+  if (m_segmented) return m_segmented->GetPosition();
   return m_state->m_filePos;
 }
 
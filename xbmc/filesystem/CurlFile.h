@@ -22,6 +22,7 @@
 #include "IFile.h"
 #include "utils/RingBuffer.h"
 #include <map>
+#include <deque>
 #include "utils/HttpHeader.h"
 
 namespace XCURL
@@ -57,8 +58,8 @@ namespace XFILE
       virtual int64_t  GetLength();
       virtual int  Stat(const CURL& url, struct __stat64* buffer);
       virtual void Close();
-      virtual bool ReadString(char *szLine, int iLineLength)     { return m_state->ReadString(szLine, iLineLength); }
-      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize)  { return m_state->Read(lpBuf, uiBufSize); }
+      virtual bool ReadString(char *szLine, int iLineLength);
+      virtual unsigned int Read(void* lpBuf, int64_t uiBufSize);
       virtual int Write(const void* lpBuf, int64_t uiBufSize);
       virtual CStdString GetMimeType()                           { return m_state->m_httpheader.GetMimeType(); }
       virtual int IoControl(EIoControl request, void* param);
@@ -136,15 +137,76 @@ namespace XFILE
           void         Disconnect();
       };
 
+      /*!
+       \brief Reads a file over several concurrent range requests.
+
+       The file is split into fixed size segments which are fetched in parallel
+       on their own easy handles, all driven by a single multi handle. Each
+       segment buffers its whole range, so the segments double as a reorder
+       buffer: data is handed out from the front segment only, and once that is
+       consumed it is recycled to fetch the next range past the read-ahead window.
+       */
+      class CSegmentedReadState
+      {
+      public:
+          CSegmentedReadState(XCURL::CURLM* multiHandle, int64_t filePos, int64_t fileSize, unsigned int segmentSize);
+          ~CSegmentedReadState();
+
+          /*! \brief Add a connection to the pool, takes ownership of the read state.
+           The state must have an easy handle with all common options set. */
+          void         AddSegment(CReadState* state);
+          /*! \brief Start fetching the read-ahead window from the current position. */
+          void         Start();
+
+          bool         Seek(int64_t pos);
+          unsigned int Read(void* lpBuf, int64_t uiBufSize);
+          void         Cancel()                                  { m_cancelled = true; }
+
+          int64_t      GetPosition() const                       { return m_filePos; }
+          bool         IsFailed() const                          { return m_failed; }
+
+      private:
+          struct SSegment
+          {
+            CReadState* state;
+            int64_t     pos;      // file position of the next byte in the segment's buffer
+            int64_t     end;      // last file position covered by the segment
+            bool        active;   // transfer is attached to the multi handle
+            bool        done;     // transfer has completed successfully
+            bool        verified; // server answered with partial content
+            int         retries;
+          };
+
+          void         Schedule(SSegment& segment, int64_t start);
+          void         Connect(SSegment& segment, int64_t from);
+          void         Rotate();
+          bool         FillBuffer(SSegment& segment, unsigned int want);
+          bool         HandleFinished();
+
+          std::deque<SSegment> m_segments;   // ordered by range, the front one is being read
+          XCURL::CURLM*        m_multiHandle;
+          int64_t              m_filePos;
+          int64_t              m_fileSize;
+          int64_t              m_nextStart;  // first byte not yet assigned to a segment
+          unsigned int         m_segmentSize;
+          int                  m_stillRunning;
+          bool                 m_cancelled;
+          bool                 m_failed;
+      };
+
     protected:
       void ParseAndCorrectUrl(CURL &url);
       void SetCommonOptions(CReadState* state);
       void SetRequestHeaders(CReadState* state);
       void SetCorrectHeaders(CReadState* state);
       bool Service(const CStdString& strURL, CStdString& strHTML);
+      bool CanReadSegmented(const CURL &url);
+      void StartSegmentedRead();
+      bool StopSegmentedRead(int64_t pos);
 
     protected:
       CReadState*     m_state;
+      CSegmentedReadState* m_segmented;
       unsigned int    m_bufferSize;
       int64_t         m_writeOffset;
 
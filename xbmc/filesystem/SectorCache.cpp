@@ -0,0 +1,320 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "SectorCache.h"
+#include "File.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace XFILE;
+
+CSectorCache::CSectorCache()
+{
+  m_nextImageId = 1;
+}
+
+CSectorCache &CSectorCache::GetInstance()
+{
+  static CSectorCache sectorCache;
+  return sectorCache;
+}
+
+unsigned int CSectorCache::OpenImage(const std::string &image)
+{
+  CSingleLock lock(m_critSection);
+  ImageMap::iterator it = m_images.find(image);
+  if (it == m_images.end())
+  {
+    // ids aren't reused, blocks of a dropped image must never be found under a new one
+    SImage entry;
+    entry.id = m_nextImageId++;
+    entry.readers = 0;
+    entry.blocks = 0;
+    it = m_images.insert(std::make_pair(image, entry)).first;
+    m_imageIds.insert(std::make_pair(entry.id, it));
+  }
+
+  it->second.readers++;
+  return it->second.id;
+}
+
+void CSectorCache::CloseImage(unsigned int image)
+{
+  CSingleLock lock(m_critSection);
+  std::map<unsigned int, ImageMap::iterator>::iterator it = m_imageIds.find(image);
+  if (it == m_imageIds.end() || it->second->second.readers == 0)
+    return;
+
+  it->second->second.readers--;
+  ReleaseImage(it->second);
+}
+
+unsigned int CSectorCache::GetNumImages()
+{
+  CSingleLock lock(m_critSection);
+  return m_images.size();
+}
+
+void CSectorCache::ReleaseImage(ImageMap::iterator image)
+{
+  if (image->second.readers > 0 || image->second.blocks > 0)
+    return;
+
+  m_imageIds.erase(image->second.id);
+  m_images.erase(image);
+}
+
+bool CSectorCache::Contains(unsigned int image, uint32_t block)
+{
+  CSingleLock lock(m_critSection);
+  return m_index.find(Key(image, block)) != m_index.end();
+}
+
+bool CSectorCache::Read(unsigned int image, uint32_t block, unsigned int offset, unsigned int size, unsigned char *data)
+{
+  CSingleLock lock(m_critSection);
+  std::map<uint64_t, BlockList::iterator>::iterator it = m_index.find(Key(image, block));
+  if (it == m_index.end())
+    return false;
+
+  // move to the front of the lru list
+  m_blocks.splice(m_blocks.begin(), m_blocks, it->second);
+  memcpy(data, &it->second->data[offset], size);
+  return true;
+}
+
+void CSectorCache::Insert(unsigned int image, uint32_t block, const unsigned char *data)
+{
+  CSingleLock lock(m_critSection);
+  uint64_t key = Key(image, block);
+  std::map<uint64_t, BlockList::iterator>::iterator it = m_index.find(key);
+  if (it != m_index.end())
+  {
+    m_blocks.splice(m_blocks.begin(), m_blocks, it->second);
+    return;
+  }
+
+  std::map<unsigned int, ImageMap::iterator>::iterator owner = m_imageIds.find(image);
+  if (owner == m_imageIds.end())
+    return;
+
+  if (m_index.size() >= SECTOR_CACHE_MAX_BLOCKS)
+  {
+    // recycle the least recently used block
+    uint64_t evicted = m_blocks.back().key;
+    m_index.erase(evicted);
+    m_blocks.splice(m_blocks.begin(), m_blocks, --m_blocks.end());
+
+    std::map<unsigned int, ImageMap::iterator>::iterator evictedOwner = m_imageIds.find((unsigned int)(evicted >> 32));
+    if (evictedOwner != m_imageIds.end())
+    {
+      evictedOwner->second->second.blocks--;
+      if (evictedOwner != owner)
+        ReleaseImage(evictedOwner->second);
+    }
+  }
+  else
+    m_blocks.push_front(SBlock());
+
+  owner->second->second.blocks++;
+
+  SBlock &entry = m_blocks.front();
+  entry.key = key;
+  entry.data.assign(data, data + SECTOR_CACHE_BLOCK_SIZE);
+  m_index.insert(std::make_pair(key, m_blocks.begin()));
+}
+
+void CSectorCache::Clear()
+{
+  CSingleLock lock(m_critSection);
+  m_index.clear();
+  m_blocks.clear();
+
+  for (ImageMap::iterator it = m_images.begin(); it != m_images.end();)
+  {
+    ImageMap::iterator image = it++;
+    image->second.blocks = 0;
+    ReleaseImage(image);
+  }
+}
+
+CSectorReader::CSectorReader()
+{
+  m_file = NULL;
+  m_imageId = 0;
+  m_length = 0;
+  m_nextBlock = 0;
+  m_readAhead = 0;
+}
+
+CSectorReader::~CSectorReader()
+{
+  Close();
+}
+
+bool CSectorReader::Open(const CStdString &image)
+{
+  Close();
+
+  m_file = new CFile();
+  if (!m_file->Open(image))
+  {
+    CLog::Log(LOGERROR, "CSectorReader::Open - Could not open %s", image.c_str());
+    delete m_file;
+    m_file = NULL;
+    return false;
+  }
+
+  // include the size and modification time so a replaced image doesn't hit stale blocks
+  m_length = m_file->GetLength();
+  struct __stat64 buffer;
+  int64_t mtime = m_file->Stat(&buffer) == 0 ? (int64_t)buffer.st_mtime : 0;
+  CStdString key;
+  key.Format("%s|%"PRId64"|%"PRId64, image.c_str(), m_length, mtime);
+  m_imageId = CSectorCache::GetInstance().OpenImage(key);
+  m_image = image;
+  m_nextBlock = 0;
+  m_readAhead = 0;
+  m_stats = SSectorCacheStats();
+  return true;
+}
+
+void CSectorReader::Close()
+{
+  if (!m_file)
+    return;
+
+  CLog::Log(LOGDEBUG, "CSectorReader::Close - %s: %"PRIu64" requests, %.1f%% block hit rate, %"PRIu64" reads of %"PRIu64" bytes",
+            m_image.c_str(), m_stats.requests, m_stats.HitRate() * 100.0f, m_stats.reads, m_stats.bytes);
+
+  m_file->Close();
+  delete m_file;
+  m_file = NULL;
+  CSectorCache::GetInstance().CloseImage(m_imageId);
+  m_imageId = 0;
+}
+
+bool CSectorReader::Fetch(uint32_t block, uint32_t count)
+{
+  m_buffer.resize((size_t)count * SECTOR_CACHE_BLOCK_SIZE);
+
+  int64_t pos = (int64_t)block * SECTOR_CACHE_BLOCK_SIZE;
+  if (m_file->Seek(pos, SEEK_SET) != pos)
+  {
+    CLog::Log(LOGERROR, "CSectorReader::Fetch - Can't seek to block %u", block);
+    return false;
+  }
+
+  size_t want = (size_t)std::min<int64_t>(m_buffer.size(), m_length - pos);
+  size_t got = 0;
+  while (got < want)
+  {
+    unsigned int len = m_file->Read(&m_buffer[got], want - got);
+    if (len == 0)
+      break;
+    got += len;
+  }
+  m_stats.reads++;
+  m_stats.bytes += got;
+
+  if (got < want)
+  {
+    CLog::Log(LOGERROR, "CSectorReader::Fetch - Short read at block %u", block);
+    return false;
+  }
+
+  // the last block of the image may be partial
+  memset(&m_buffer[got], 0, m_buffer.size() - got);
+  for (uint32_t i = 0; i < count; i++)
+    CSectorCache::GetInstance().Insert(m_imageId, block + i, &m_buffer[(size_t)i * SECTOR_CACHE_BLOCK_SIZE]);
+
+  return true;
+}
+
+int CSectorReader::ReadSectors(uint32_t sector, unsigned int count, unsigned char *data)
+{
+  if (!m_file)
+    return -1;
+
+  m_stats.requests++;
+
+  int64_t sectors = (m_length + SECTOR_CACHE_SECTOR_SIZE - 1) / SECTOR_CACHE_SECTOR_SIZE;
+  if (sector >= sectors)
+    return 0;
+  count = (unsigned int)std::min<int64_t>(count, sectors - sector);
+  if (count == 0)
+    return 0;
+
+  CSectorCache &cache = CSectorCache::GetInstance();
+  uint32_t blocks = (uint32_t)((m_length + SECTOR_CACHE_BLOCK_SIZE - 1) / SECTOR_CACHE_BLOCK_SIZE);
+  uint32_t first = sector / SECTOR_CACHE_BLOCK_SECTORS;
+  uint32_t last = (sector + count - 1) / SECTOR_CACHE_BLOCK_SECTORS;
+
+  // grow the read-ahead window while access stays sequential
+  if (first == m_nextBlock || first + 1 == m_nextBlock)
+    m_readAhead = std::max(1u, std::min(m_readAhead * 2, (unsigned int)SECTOR_CACHE_MAX_READAHEAD));
+  else
+    m_readAhead = 0;
+
+  uint32_t block = first;
+  while (block <= last)
+  {
+    uint32_t start = std::max(sector, block * SECTOR_CACHE_BLOCK_SECTORS);
+    uint32_t end = std::min(sector + count, (block + 1) * SECTOR_CACHE_BLOCK_SECTORS);
+    unsigned int offset = (start - block * SECTOR_CACHE_BLOCK_SECTORS) * SECTOR_CACHE_SECTOR_SIZE;
+    unsigned int size = (end - start) * SECTOR_CACHE_SECTOR_SIZE;
+    unsigned char *dest = data + (size_t)(start - sector) * SECTOR_CACHE_SECTOR_SIZE;
+
+    if (cache.Read(m_imageId, block, offset, size, dest))
+    {
+      m_stats.hits++;
+      block++;
+      continue;
+    }
+
+    // coalesce the run of missing blocks into one read, and when the run
+    // reaches the end of the request extend it by the read-ahead window
+    uint32_t run = block + 1;
+    while (run <= last && !cache.Contains(m_imageId, run))
+      run++;
+    m_stats.misses += run - block;
+    if (run > last)
+    {
+      uint32_t ahead = std::min(run + m_readAhead, blocks);
+      while (run < ahead && !cache.Contains(m_imageId, run))
+        run++;
+    }
+
+    if (!Fetch(block, run - block))
+      return (int)(start - sector);
+
+    // copy the requested part of the run straight from the fetch buffer
+    start = std::max(sector, block * SECTOR_CACHE_BLOCK_SECTORS);
+    end = std::min(sector + count, run * SECTOR_CACHE_BLOCK_SECTORS);
+    memcpy(dest, &m_buffer[offset], (size_t)(end - start) * SECTOR_CACHE_SECTOR_SIZE);
+    block = std::min(run, last + 1);
+  }
+
+  m_nextBlock = last + 1;
+  return (int)count;
+}
@@ -0,0 +1,141 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StdString.h"
+
+#include <list>
+#include <map>
+#include <vector>
+#include <stdint.h>
+
+#define SECTOR_CACHE_SECTOR_SIZE     2048
+#define SECTOR_CACHE_BLOCK_SECTORS   16    // sectors per cached block (32KB)
+#define SECTOR_CACHE_BLOCK_SIZE      (SECTOR_CACHE_SECTOR_SIZE * SECTOR_CACHE_BLOCK_SECTORS)
+#define SECTOR_CACHE_MAX_BLOCKS      256   // 8MB shared between all images
+#define SECTOR_CACHE_MAX_READAHEAD   8     // blocks fetched ahead of a sequential reader
+
+namespace XFILE
+{
+  class CFile;
+
+  struct SSectorCacheStats
+  {
+    uint64_t requests; // ReadSectors calls
+    uint64_t hits;     // blocks served from the cache
+    uint64_t misses;   // blocks that had to be fetched from the image
+    uint64_t reads;    // reads issued on the underlying file
+    uint64_t bytes;    // bytes read from the underlying file
+
+    SSectorCacheStats() : requests(0), hits(0), misses(0), reads(0), bytes(0) {}
+    float HitRate() const { return hits + misses ? (float)hits / (hits + misses) : 0.0f; }
+  };
+
+  /*!
+   \brief Process wide LRU cache of disc image blocks.
+
+   Blocks are keyed by image and block number so that every reader on the same
+   image (directory listings, playback, metadata probing) shares them. An image
+   keeps its id while a reader has it open or any of its blocks are cached.
+   */
+  class CSectorCache
+  {
+  public:
+    static CSectorCache &GetInstance();
+
+    /*! \brief Get the id blocks of the given image are stored under, and hold it until CloseImage() */
+    unsigned int OpenImage(const std::string &image);
+    void CloseImage(unsigned int image);
+    unsigned int GetNumImages();
+    bool Contains(unsigned int image, uint32_t block);
+    /*! \brief Copy part of a cached block, returns false if it isn't cached */
+    bool Read(unsigned int image, uint32_t block, unsigned int offset, unsigned int size, unsigned char *data);
+    void Insert(unsigned int image, uint32_t block, const unsigned char *data);
+    void Clear();
+
+  private:
+    CSectorCache();
+    CSectorCache(const CSectorCache&);
+    CSectorCache const& operator=(CSectorCache const&);
+
+    struct SBlock
+    {
+      uint64_t key;
+      std::vector<unsigned char> data;
+    };
+    typedef std::list<SBlock> BlockList;
+
+    struct SImage
+    {
+      unsigned int id;
+      unsigned int readers;
+      unsigned int blocks;  // blocks of the image in the cache
+    };
+    typedef std::map<std::string, SImage> ImageMap;
+
+    static uint64_t Key(unsigned int image, uint32_t block) { return ((uint64_t)image << 32) | block; }
+    /*! \brief Drop the image id once nothing refers to it */
+    void ReleaseImage(ImageMap::iterator image);
+
+    CCriticalSection m_critSection;
+    BlockList m_blocks; // most recently used first
+    std::map<uint64_t, BlockList::iterator> m_index;
+    ImageMap m_images;
+    std::map<unsigned int, ImageMap::iterator> m_imageIds;
+    unsigned int m_nextImageId;
+  };
+
+  /*!
+   \brief Sector based access to a disc image through the shared block cache.
+
+   Adjacent blocks missing from the cache are fetched with a single read, and
+   sequential readers get a growing read-ahead window.
+   */
+  class CSectorReader
+  {
+  public:
+    CSectorReader();
+    ~CSectorReader();
+
+    bool Open(const CStdString &image);
+    void Close();
+    bool IsOpen() const { return m_file != NULL; }
+
+    /*! \brief Read sectors from the image
+     \return number of sectors read, which is short at the end of the image, or -1 on error
+     */
+    int ReadSectors(uint32_t sector, unsigned int count, unsigned char *data);
+
+    const SSectorCacheStats &GetStats() const { return m_stats; }
+
+  private:
+    bool Fetch(uint32_t block, uint32_t count);
+
+    CFile *m_file;
+    CStdString m_image;
+    unsigned int m_imageId;
+    int64_t m_length;
+    uint32_t m_nextBlock;
+    unsigned int m_readAhead;
+    std::vector<unsigned char> m_buffer;
+    SSectorCacheStats m_stats;
+  };
+}
@@ -27,14 +27,101 @@
 #include "music/MusicDatabase.h"
 #include "playlists/SmartPlayList.h"
 #include "settings/GUISettings.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "video/VideoDatabase.h"
 
+#include <map>
+
 #define PROPERTY_PATH_DB            "path.db"
 #define PROPERTY_SORT_ORDER         "sort.order"
 #define PROPERTY_SORT_ASCENDING     "sort.ascending"
 
+// the playlists of a folder by name, so that looking one up doesn't list the folder and open
+// every playlist in it each time. A folder is listed again once it has changed.
+struct PlaylistNames
+{
+  int64_t mtime;                                // of the folder when it was listed
+  time_t listed;
+  std::map<CStdString, CStdString> names;       // lower case playlist name -> first playlist listed with it
+  std::map<CStdString, CStdString> fileNames;   // file name -> playlist
+};
+
+static CCriticalSection g_playlistNamesSection;
+static std::map<CStdString, PlaylistNames> g_playlistNames; // by folder
+static unsigned int g_playlistNamesVersion = 0;
+
+static CStdString GetPlaylistsFolder(const CStdString& playlistType)
+{
+  if (playlistType == "songs" || playlistType == "albums")
+    return "special://musicplaylists/";
+  return "special://videoplaylists/"; // all others are video
+}
+
+static bool ListPlaylistNames(const CStdString& folder, PlaylistNames& names)
+{
+  CFileItemList list;
+  if (!XFILE::CDirectory::GetDirectory(folder, list, ".xsp", false))
+    return false;
+
+  for (int i = 0; i < list.Size(); i++)
+  {
+    const CStdString& path = list[i]->GetPath();
+    CSmartPlaylist playlist;
+    if (playlist.OpenAndReadName(path))
+    {
+      CStdString name = playlist.GetName();
+      names.names.insert(std::make_pair(name.ToLower(), path));
+    }
+    names.fileNames.insert(std::make_pair(URIUtils::GetFileName(path), path));
+  }
+  return true;
+}
+
+/* Lists the playlists of a folder again if it changed since it was last listed.
+ * Returns false if it can't be listed */
+static bool RefreshPlaylistNames(const CStdString& folder)
+{
+  int64_t mtime = -1;
+  struct __stat64 buffer;
+  if (XFILE::CFile::Stat(folder, &buffer) == 0)
+    mtime = buffer.st_mtime;
+
+  {
+    // a folder changed within the second it was listed in may have changed again since
+    CSingleLock lock(g_playlistNamesSection);
+    std::map<CStdString, PlaylistNames>::const_iterator it = g_playlistNames.find(folder);
+    if (it != g_playlistNames.end() && mtime >= 0 && it->second.mtime == mtime && mtime < it->second.listed)
+      return true;
+  }
+
+  // list it outside the lock, opening the playlists may take a while
+  PlaylistNames names;
+  names.mtime = mtime;
+  names.listed = time(NULL);
+  bool listed = ListPlaylistNames(folder, names);
+
+  CSingleLock lock(g_playlistNamesSection);
+  std::map<CStdString, PlaylistNames>::iterator it = g_playlistNames.find(folder);
+  if (!listed)
+  {
+    if (it != g_playlistNames.end())
+    {
+      g_playlistNames.erase(it);
+      g_playlistNamesVersion++;
+    }
+    return false;
+  }
+  if (it == g_playlistNames.end())
+    it = g_playlistNames.insert(std::make_pair(folder, PlaylistNames())).first;
+  // the names are all that results depend on, the folder may have changed otherwise
+  if (it->second.names != names.names || it->second.fileNames != names.fileNames)
+    g_playlistNamesVersion++;
+  it->second = names;
+  return true;
+}
+
 namespace XFILE
 {
   CSmartPlaylistDirectory::CSmartPlaylistDirectory()
@@ -288,36 +375,40 @@ namespace XFILE
 
   CStdString CSmartPlaylistDirectory::GetPlaylistByName(const CStdString& name, const CStdString& playlistType)
   {
-    CFileItemList list;
-    bool filesExist = false;
-    if (playlistType == "songs" || playlistType == "albums")
-      filesExist = CDirectory::GetDirectory("special://musicplaylists/", list, ".xsp", false);
-    else // all others are video
-      filesExist = CDirectory::GetDirectory("special://videoplaylists/", list, ".xsp", false);
-    if (filesExist)
-    {
-      for (int i = 0; i < list.Size(); i++)
-      {
-        CFileItemPtr item = list[i];
-        CSmartPlaylist playlist;
-        if (playlist.OpenAndReadName(item->GetPath()))
-        {
-          if (playlist.GetName().CompareNoCase(name) == 0)
-            return item->GetPath();
-        }
-      }
-      for (int i = 0; i < list.Size(); i++)
-      { // check based on filename
-        CFileItemPtr item = list[i];
-        if (URIUtils::GetFileName(item->GetPath()) == name)
-        { // found :)
-          return item->GetPath();
-        }
-      }
-    }
+    CStdString folder = GetPlaylistsFolder(playlistType);
+    if (!RefreshPlaylistNames(folder))
+      return "";
+
+    CSingleLock lock(g_playlistNamesSection);
+    std::map<CStdString, PlaylistNames>::const_iterator names = g_playlistNames.find(folder);
+    if (names == g_playlistNames.end())
+      return "";
+
+    CStdString lowerName(name);
+    std::map<CStdString, CStdString>::const_iterator it = names->second.names.find(lowerName.ToLower());
+    if (it != names->second.names.end())
+      return it->second;
+    // check based on filename
+    it = names->second.fileNames.find(name);
+    if (it != names->second.fileNames.end())
+      return it->second;
     return "";
   }
 
+  unsigned int CSmartPlaylistDirectory::GetPlaylistNamesVersion(const CStdString& playlistType)
+  {
+    RefreshPlaylistNames(GetPlaylistsFolder(playlistType));
+
+    CSingleLock lock(g_playlistNamesSection);
+    return g_playlistNamesVersion;
+  }
+
+  void CSmartPlaylistDirectory::InvalidatePlaylistNames()
+  {
+    CSingleLock lock(g_playlistNamesSection);
+    g_playlistNames.clear();
+  }
+
   bool CSmartPlaylistDirectory::Remove(const char *strPath)
   {
     return XFILE::CFile::Delete(strPath);
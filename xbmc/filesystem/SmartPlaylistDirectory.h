@@ -39,5 +39,13 @@ namespace XFILE
     static bool GetDirectory(const CSmartPlaylist &playlist, CFileItemList& items, const CStdString &strBaseDir = "", bool filter = false);
 
     static CStdString GetPlaylistByName(const CStdString& name, const CStdString& playlistType);
+
+    /*! \brief Count of the changes to the names playlists of the given type are looked up by,
+     so that what was found through GetPlaylistByName() can tell when to look again.
+     */
+    static unsigned int GetPlaylistNamesVersion(const CStdString& playlistType);
+
+    /*! \brief List the playlists again the next time one is looked up by name, as when one is saved */
+    static void InvalidatePlaylistNames();
   };
 }
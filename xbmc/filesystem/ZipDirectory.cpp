@@ -104,7 +104,7 @@ namespace XFILE
         continue;
 
       strEntryName += pathTokens[baseTokens.size()];
-      char c=ze->name[strEntryName.size()];
+      char c=ze->name.c_str()[strEntryName.size()];
       if (c == '/' || c == '\\')
         strEntryName += '/';
       bool bIsFolder = false;
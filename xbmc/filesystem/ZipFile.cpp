@@ -237,8 +237,9 @@ int64_t CZipFile::Seek(int64_t iFilePosition, int iWhence)
 
 bool CZipFile::Exists(const CURL& url)
 {
+  // the central directory has all we need, no need to read the local header
   SZipEntry item;
-  if (g_ZipManager.GetZipEntry(url.Get(),item))
+  if (g_ZipManager.FindZipEntry(url.Get(),item))
     return true;
   return false;
 }
@@ -265,7 +266,7 @@ int CZipFile::Stat(struct __stat64 *buffer)
 
 int CZipFile::Stat(const CURL& url, struct __stat64* buffer)
 {
-  if (!g_ZipManager.GetZipEntry(url.Get(),mZipItem))
+  if (!g_ZipManager.FindZipEntry(url.Get(),mZipItem))
     return -1;
 
   memset(buffer, 0, sizeof(struct __stat64));
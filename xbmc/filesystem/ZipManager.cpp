@@ -22,20 +22,92 @@
 #include "ZipManager.h"
 #include "URL.h"
 #include "File.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
 #include "utils/CharsetConverter.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/EndianSwap.h"
 #include "utils/URIUtils.h"
 #include "SpecialProtocol.h"
 
+#include <algorithm>
+
 
 #ifndef min
 #define min(a,b)            (((a) < (b)) ? (a) : (b))
 #endif
 
+// archives with fewer entries are extracted on the calling thread only
+#define ZIP_EXTRACT_PARALLEL_MIN 16
+#define ZIP_EXTRACT_MAX_WORKERS  4
+
 using namespace XFILE;
 using namespace std;
 
+namespace
+{
+  /* Hands out entries of an archive to any number of threads running it,
+   * each entry is extracted through the zip:// protocol like before.
+   */
+  class CZipExtractor : public IRunnable
+  {
+  public:
+    CZipExtractor(const CStdString& strArchive, const CStdString& strPath, const vector<SZipEntry>& entries)
+      : m_strArchive(strArchive), m_strPath(strPath), m_entries(entries), m_next(0), m_failed(0)
+    {
+    }
+
+    virtual void Run()
+    {
+      long i;
+      while (!m_failed && (i = AtomicIncrement(&m_next) - 1) < (long)m_entries.size())
+      {
+        const SZipEntry& entry = m_entries[i];
+        if (entry.name.empty() || entry.name[entry.name.size()-1] == '/') // skip dirs
+          continue;
+        CStdString strFilePath(entry.name);
+
+        CStdString strZipPath;
+        URIUtils::CreateArchivePath(strZipPath, "zip", m_strArchive, strFilePath);
+        if (!CFile::Cache(strZipPath.c_str(),(m_strPath+strFilePath).c_str()))
+          AtomicIncrement(&m_failed);
+      }
+    }
+
+    bool Failed() const { return m_failed != 0; }
+
+  private:
+    const CStdString&        m_strArchive;
+    const CStdString&        m_strPath;
+    const vector<SZipEntry>& m_entries;
+    volatile long            m_next;
+    volatile long            m_failed;
+  };
+}
+
+namespace
+{
+/* orders the positions in the entries of an archive by entry name, so that the
+ * index doesn't need copies of the names */
+class EntryNameLess
+{
+public:
+  EntryNameLess(const vector<SZipEntry>& entries) : m_entries(entries) {}
+  bool operator()(unsigned int left, unsigned int right) const
+  {
+    return m_entries[left].name < m_entries[right].name;
+  }
+  bool operator()(unsigned int left, const string& right) const
+  {
+    return m_entries[left].name < right;
+  }
+private:
+  const vector<SZipEntry>& m_entries;
+};
+}
+
 CZipManager::CZipManager()
 {
 }
@@ -45,36 +117,54 @@ CZipManager::~CZipManager()
 
 }
 
-bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items)
+CZipManager::SZipArchive* CZipManager::GetArchive(const CStdString& strFile, bool checkDate)
 {
-  CLog::Log(LOGDEBUG, "%s - Processing %s", __FUNCTION__, strPath.c_str());
+  map<CStdString,SZipArchive>::iterator it = mZipMap.find(strFile);
+  if (it != mZipMap.end() && !checkDate)
+    return &it->second;
 
-  CURL url(strPath);
   struct __stat64 m_StatData = {};
-
-  CStdString strFile = url.GetHostName();
-
   if (CFile::Stat(strFile,&m_StatData))
   {
-    CLog::Log(LOGDEBUG,"CZipManager::GetZipList: failed to stat file %s", strPath.c_str());
-    return false;
+    CLog::Log(LOGDEBUG,"CZipManager::GetArchive: failed to stat file %s", strFile.c_str());
+    return NULL;
   }
 
-  map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
   if (it != mZipMap.end()) // already listed, just return it if not changed, else release and reread
   {
-    map<CStdString,int64_t>::iterator it2=mZipDate.find(strFile);
-    CLog::Log(LOGDEBUG,"statdata: %"PRId64" new: %"PRIu64, it2->second, (uint64_t)m_StatData.st_mtime);
+    CLog::Log(LOGDEBUG,"statdata: %"PRId64" new: %"PRIu64, it->second.mtime, (uint64_t)m_StatData.st_mtime);
 
-      if (m_StatData.st_mtime == it2->second)
-      {
-        items = it->second;
-        return true;
-      }
-      mZipMap.erase(it);
-      mZipDate.erase(it2);
+    if (m_StatData.st_mtime == it->second.mtime)
+      return &it->second;
+    mZipMap.erase(it);
   }
 
+  vector<SZipEntry> items;
+  if (!ReadCentralDirectory(strFile, items))
+    return NULL;
+
+  SZipArchive& archive = mZipMap[strFile];
+  archive.mtime = m_StatData.st_mtime;
+  archive.entries.swap(items);
+  archive.index.resize(archive.entries.size());
+  for (unsigned int i = 0; i < archive.entries.size(); i++)
+    archive.index[i] = i;
+  // stable, so that the first of entries with the same name is found
+  stable_sort(archive.index.begin(), archive.index.end(), EntryNameLess(archive.entries));
+
+  return &archive;
+}
+
+SZipEntry* CZipManager::FindEntry(SZipArchive& archive, const string& strFileName)
+{
+  vector<unsigned int>::const_iterator it = lower_bound(archive.index.begin(), archive.index.end(), strFileName, EntryNameLess(archive.entries));
+  if (it == archive.index.end() || archive.entries[*it].name != strFileName)
+    return NULL;
+  return &archive.entries[*it];
+}
+
+bool CZipManager::ReadCentralDirectory(const CStdString& strFile, vector<SZipEntry>& items)
+{
   CFile mFile;
   if (!mFile.Open(strFile))
   {
@@ -90,9 +180,6 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
     mFile.Close();
     return false;
   }
-  // push date for update detection
-  mZipDate.insert(make_pair(strFile,m_StatData.st_mtime));
-
 
   // Look for end of central directory record
   // Zipfile comment may be up to 65535 bytes
@@ -145,99 +232,155 @@ bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items
 
   delete [] buffer;
 
-  if ( !found )
+  char ecdrec[ECDREC_SIZE];
+  if ( !found || mFile.Read(ecdrec, ECDREC_SIZE) != ECDREC_SIZE )
   {
     CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
     mFile.Close();
     return false;
   }
 
-  unsigned int cdirOffset, cdirSize;
-  // Get size of the central directory
-  mFile.Seek(12,SEEK_CUR);
-  mFile.Read(&cdirSize,4);
-  cdirSize = Endian_SwapLE32(cdirSize);
-  // Get Offset of start of central directory with respect to the starting disk number
-  mFile.Read(&cdirOffset,4);
-  cdirOffset = Endian_SwapLE32(cdirOffset);
+  // Get number of entries, size of the central directory and its offset with
+  // respect to the starting disk number
+  unsigned short cdirEntries = Endian_SwapLE16(*(unsigned short*)(ecdrec+10));
+  unsigned int cdirSize = Endian_SwapLE32(*(unsigned int*)(ecdrec+12));
+  unsigned int cdirOffset = Endian_SwapLE32(*(unsigned int*)(ecdrec+16));
+
+  if ((int64_t)cdirOffset + cdirSize > fileSize)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    mFile.Close();
+    return false;
+  }
 
-  // Go to the start of central directory
+  // Pull in the whole central directory at once rather than a header at a
+  // time, archives with thousands of entries otherwise cost as many reads
+  vector<char> cdir(cdirSize + 1);
   mFile.Seek(cdirOffset,SEEK_SET);
+  if (mFile.Read(&cdir[0], cdirSize) != cdirSize)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    mFile.Close();
+    return false;
+  }
+  mFile.Close();
 
-  char temp[CHDR_SIZE];
-  while (mFile.GetPosition() < cdirOffset + cdirSize)
+  items.reserve(cdirEntries);
+  unsigned int pos = 0;
+  while (pos < cdirSize)
   {
     SZipEntry ze;
-    mFile.Read(temp,CHDR_SIZE);
-    readCHeader(temp, ze);
-    if (ze.header != ZIP_CENTRAL_HEADER)
+    if (pos + CHDR_SIZE > cdirSize)
+    {
+      CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+      return false;
+    }
+    readCHeader(&cdir[pos], ze);
+    pos += CHDR_SIZE;
+    if (ze.header != ZIP_CENTRAL_HEADER || pos + ze.flength > cdirSize)
     {
       CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
-      mFile.Close();
       return false;
     }
 
     // Get the filename just after the central file header
-    CStdString strName;
-    mFile.Read(strName.GetBuffer(ze.flength), ze.flength);
-    strName.ReleaseBuffer();
+    CStdString strName(&cdir[pos], ze.flength);
     g_charsetConverter.unknownToUTF8(strName);
-    ZeroMemory(ze.name, 255);
-    strncpy(ze.name, strName.c_str(), strName.size()>254 ? 254 : strName.size());
+    ze.name = strName;
 
-    // Jump after central file header extra field and file comment
-    mFile.Seek(ze.eclength + ze.clength,SEEK_CUR);
+    // Jump after filename, central file header extra field and file comment
+    pos += ze.flength + ze.eclength + ze.clength;
 
+    // The local header extra field length (and with it the data offset) is
+    // only read once the entry is actually opened, see GetZipEntry()
     items.push_back(ze);
   }
 
-  /* go through list and figure out file header lengths */
-  for(vector<SZipEntry>::iterator it = items.begin(); it != items.end(); ++it)
-  {
-    SZipEntry& ze = *it;
-    // Go to the local file header to get the extra field length
-    // !! local header extra field length != central file header extra field length !!
-    mFile.Seek(ze.lhdrOffset+28,SEEK_SET);
-    mFile.Read(&(ze.elength),2);
-    ze.elength = Endian_SwapLE16(ze.elength);
+  return true;
+}
 
-    // Compressed data offset = local header offset + size of local header + filename length + local file header extra field length
-    ze.offset = ze.lhdrOffset + LHDR_SIZE + ze.flength + ze.elength;
+bool CZipManager::ReadLocalHeader(const CStdString& strFile, SZipEntry& item)
+{
+  CFile mFile;
+  if (!mFile.Open(strFile))
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: unable to open file %s!",strFile.c_str());
+    return false;
+  }
 
+  // Go to the local file header to get the extra field length
+  // !! local header extra field length != central file header extra field length !!
+  unsigned short elength;
+  if (mFile.Seek(item.lhdrOffset+28,SEEK_SET) < 0 || mFile.Read(&elength,2) != 2)
+  {
+    CLog::Log(LOGDEBUG,"ZipManager: broken file %s!",strFile.c_str());
+    return false;
   }
+  item.elength = Endian_SwapLE16(elength);
 
-  mZipMap.insert(make_pair(strFile,items));
-  mFile.Close();
+  // Compressed data offset = local header offset + size of local header + filename length + local file header extra field length
+  item.offset = item.lhdrOffset + LHDR_SIZE + item.flength + item.elength;
   return true;
 }
 
-bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
+bool CZipManager::GetZipList(const CStdString& strPath, vector<SZipEntry>& items)
 {
-  CURL url(strPath);
+  CLog::Log(LOGDEBUG, "%s - Processing %s", __FUNCTION__, strPath.c_str());
 
+  CURL url(strPath);
   CStdString strFile = url.GetHostName();
 
-  map<CStdString,vector<SZipEntry> >::iterator it = mZipMap.find(strFile);
-  vector<SZipEntry> items;
-  if (it == mZipMap.end()) // we need to list the zip
-  {
-    GetZipList(strPath,items);
-  }
-  else
-  {
-    items = it->second;
-  }
+  CSingleLock lock(m_critSection);
+  SZipArchive* archive = GetArchive(strFile, true);
+  if (!archive)
+    return false;
+
+  items = archive->entries;
+  return true;
+}
+
+bool CZipManager::GetZipEntry(const CStdString& strPath, SZipEntry& item)
+{
+  if (!FindZipEntry(strPath, item))
+    return false;
+  if (item.offset)
+    return true;
+
+  // read outside the lock, other entries may be opened meanwhile
+  CURL url(strPath);
+  CStdString strFile = url.GetHostName();
+  if (!ReadLocalHeader(strFile, item))
+    return false;
 
-  CStdString strFileName = url.GetFileName();
-  for (vector<SZipEntry>::iterator it2=items.begin();it2 != items.end();++it2)
+  CSingleLock lock(m_critSection);
+  map<CStdString,SZipArchive>::iterator it = mZipMap.find(strFile);
+  if (it != mZipMap.end())
   {
-    if (CStdString(it2->name) == strFileName)
+    SZipEntry* entry = FindEntry(it->second, url.GetFileName());
+    if (entry)
     {
-      memcpy(&item,&(*it2),sizeof(SZipEntry));
-      return true;
+      entry->elength = item.elength;
+      entry->offset = item.offset;
     }
   }
-  return false;
+  return true;
+}
+
+bool CZipManager::FindZipEntry(const CStdString& strPath, SZipEntry& item)
+{
+  CURL url(strPath);
+
+  CSingleLock lock(m_critSection);
+  SZipArchive* archive = GetArchive(url.GetHostName(), false);
+  if (!archive)
+    return false;
+
+  SZipEntry* entry = FindEntry(*archive, url.GetFileName());
+  if (!entry)
+    return false;
+
+  item = *entry;
+  return true;
 }
 
 bool CZipManager::ExtractArchive(const CStdString& strArchive, const CStdString& strPath)
@@ -246,18 +389,31 @@ bool CZipManager::ExtractArchive(const CStdString& strArchive, const CStdString&
   CStdString strZipPath;
   URIUtils::CreateArchivePath(strZipPath, "zip", strArchive, "");
   GetZipList(strZipPath,entry);
-  for (vector<SZipEntry>::iterator it=entry.begin();it != entry.end();++it)
+
+  CZipExtractor extractor(strArchive, strPath, entry);
+
+  // inflating is cpu bound, spread bigger archives over a few extra threads
+  vector<CThread*> workers;
+  if (entry.size() >= ZIP_EXTRACT_PARALLEL_MIN)
   {
-    if (it->name[strlen(it->name)-1] == '/') // skip dirs
-      continue;
-    CStdString strFilePath(it->name);
+    int count = min(g_cpuInfo.getCPUCount(), ZIP_EXTRACT_MAX_WORKERS) - 1;
+    for (int i = 0; i < count; i++)
+    {
+      CThread* worker = new CThread(&extractor, "ZipExtractor");
+      worker->Create();
+      workers.push_back(worker);
+    }
+  }
 
+  extractor.Run();
 
-    URIUtils::CreateArchivePath(strZipPath, "zip", strArchive, strFilePath);
-    if (!CFile::Cache(strZipPath.c_str(),(strPath+strFilePath).c_str()))
-      return false;
+  for (vector<CThread*>::iterator it = workers.begin(); it != workers.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
   }
-  return true;
+
+  return !extractor.Failed();
 }
 
 void CZipManager::CleanUp(const CStdString& strArchive, const CStdString& strPath)
@@ -269,7 +425,7 @@ void CZipManager::CleanUp(const CStdString& strArchive, const CStdString& strPat
   GetZipList(strZipPath,entry);
   for (vector<SZipEntry>::iterator it=entry.begin();it != entry.end();++it)
   {
-    if (it->name[strlen(it->name)-1] == '/') // skip dirs
+    if (it->name.empty() || it->name[it->name.size()-1] == '/') // skip dirs
       continue;
     CStdString strFilePath(it->name);
     CLog::Log(LOGDEBUG,"delete file: %s",(strPath+strFilePath).c_str());
@@ -317,13 +473,8 @@ void CZipManager::readCHeader(const char* buffer, SZipEntry& info)
 void CZipManager::release(const CStdString& strPath)
 {
   CURL url(strPath);
-  map<CStdString,vector<SZipEntry> >::iterator it= mZipMap.find(url.GetHostName());
-  if (it != mZipMap.end())
-  {
-    map<CStdString,int64_t>::iterator it2=mZipDate.find(url.GetHostName());
-    mZipMap.erase(it);
-    mZipDate.erase(it2);
-  }
+  CSingleLock lock(m_critSection);
+  mZipMap.erase(url.GetHostName());
 }
 
 
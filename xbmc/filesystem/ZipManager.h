@@ -30,8 +30,9 @@
 #define ECDREC_SIZE 22
 
 #include  "utils/StdString.h"
+#include "threads/CriticalSection.h"
 
-#include <memory.h>
+#include <string>
 #include <vector>
 #include <map>
 
@@ -50,8 +51,8 @@ struct SZipEntry {
   unsigned short eclength; // extra field length (central file header)
   unsigned short clength; // file comment length (central file header)
   unsigned int lhdrOffset; // Relative offset of local header
-  int64_t offset;         // offset in file to compressed data
-  char name[255];
+  int64_t offset;         // offset in file to compressed data, 0 until the local header has been read
+  std::string name;
 
   SZipEntry()
   {
@@ -70,27 +71,6 @@ struct SZipEntry {
     clength = 0;
     lhdrOffset = 0;
     offset = 0;
-    name[0] = '\0';
-  }
-
-  SZipEntry(const SZipEntry& SNewItem)
-  {
-    memcpy(&header,&SNewItem.header,sizeof(unsigned int));
-    memcpy(&version,&SNewItem.version,sizeof(unsigned short));
-    memcpy(&flags,&SNewItem.flags,sizeof(unsigned short));
-    memcpy(&method,&SNewItem.method,sizeof(unsigned short));
-    memcpy(&mod_time,&SNewItem.mod_time,sizeof(unsigned short));
-    memcpy(&mod_date,&SNewItem.mod_date,sizeof(unsigned short));
-    memcpy(&crc32,&SNewItem.crc32,sizeof(unsigned int));
-    memcpy(&csize,&SNewItem.csize,sizeof(unsigned int));
-    memcpy(&usize,&SNewItem.usize,sizeof(unsigned int));
-    memcpy(&flength,&SNewItem.flength,sizeof(unsigned short));
-    memcpy(&elength,&SNewItem.elength,sizeof(unsigned short));
-    memcpy(&eclength,&SNewItem.eclength,sizeof(unsigned short));
-    memcpy(&clength,&SNewItem.clength,sizeof(unsigned short));
-    memcpy(&lhdrOffset,&SNewItem.lhdrOffset,sizeof(unsigned int));
-    memcpy(&offset,&SNewItem.offset,sizeof(int64_t));
-    memcpy(name,SNewItem.name,255*sizeof(char));
   }
 };
 
@@ -102,14 +82,30 @@ public:
 
   bool GetZipList(const CStdString& strPath, std::vector<SZipEntry>& items);
   bool GetZipEntry(const CStdString& strPath, SZipEntry& item);
+  /*! \brief Look up an entry in the archive's central directory only.
+   Unlike GetZipEntry() the local header isn't read, so the offset of the data is 0 unless the entry has been opened.
+   */
+  bool FindZipEntry(const CStdString& strPath, SZipEntry& item);
   bool ExtractArchive(const CStdString& strArchive, const CStdString& strPath);
   void CleanUp(const CStdString& strArchive, const CStdString& strPath); // deletes extracted archive. use with care!
   void release(const CStdString& strPath); // release resources used by list zip
   static void readHeader(const char* buffer, SZipEntry& info);
   static void readCHeader(const char* buffer, SZipEntry& info);
 private:
-  std::map<CStdString,std::vector<SZipEntry> > mZipMap;
-  std::map<CStdString,int64_t> mZipDate;
+  struct SZipArchive
+  {
+    int64_t mtime;
+    std::vector<SZipEntry> entries;
+    std::vector<unsigned int> index; // positions in entries, sorted by entry name
+  };
+
+  SZipArchive* GetArchive(const CStdString& strFile, bool checkDate);
+  static SZipEntry* FindEntry(SZipArchive& archive, const std::string& strFileName);
+  bool ReadCentralDirectory(const CStdString& strFile, std::vector<SZipEntry>& items);
+  bool ReadLocalHeader(const CStdString& strFile, SZipEntry& item);
+
+  std::map<CStdString, SZipArchive> mZipMap;
+  CCriticalSection m_critSection;
 };
 
 extern CZipManager g_ZipManager;
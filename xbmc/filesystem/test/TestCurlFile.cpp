@@ -0,0 +1,433 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/CurlFile.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/CriticalSection.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "threads/SystemClock.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "URL.h"
+
+#ifdef _LINUX
+#include <sys/socket.h>
+#include <sys/select.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <unistd.h>
+#include <errno.h>
+#include <inttypes.h>
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+#include "gtest/gtest.h"
+
+/* Minimal HTTP/1.1 server standing in for a remote media server. It serves a
+ * generated file, optionally honours range requests, and can be throttled by
+ * a per request latency and a per connection bandwidth cap.
+ */
+class CTestHttpServer : public CThread
+{
+public:
+  CTestHttpServer(int64_t size, bool acceptRanges, bool honourRanges, unsigned int latency, unsigned int bytesPerSecond)
+    : CThread("TestHttpServer"),
+      m_size(size), m_acceptRanges(acceptRanges), m_honourRanges(honourRanges),
+      m_latency(latency), m_bytesPerSecond(bytesPerSecond),
+      m_socket(-1), m_port(0), m_connections(0), m_inflight(0), m_maxInflight(0), m_rangeRequests(0)
+  {
+  }
+
+  ~CTestHttpServer()
+  {
+    StopThread();
+    while (GetConnections() > 0)
+      XbmcThreads::ThreadSleep(10);
+    if (m_socket >= 0)
+      close(m_socket);
+  }
+
+  bool Start()
+  {
+    m_socket = socket(AF_INET, SOCK_STREAM, 0);
+    if (m_socket < 0)
+      return false;
+
+    struct sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    socklen_t len = sizeof(addr);
+    if (bind(m_socket, (struct sockaddr*)&addr, sizeof(addr)) < 0
+    ||  listen(m_socket, 16) < 0
+    ||  getsockname(m_socket, (struct sockaddr*)&addr, &len) < 0)
+      return false;
+
+    m_port = ntohs(addr.sin_port);
+    Create();
+    return true;
+  }
+
+  CStdString GetURL() const
+  {
+    CStdString url;
+    url.Format("http://127.0.0.1:%d/media.bin", m_port);
+    return url;
+  }
+
+  static char ByteAt(int64_t pos) { return (char)((pos * 7 + (pos >> 11)) & 0xff); }
+
+  int GetConnections()   { CSingleLock lock(m_critSection); return m_connections; }
+  int GetMaxInflight()   { CSingleLock lock(m_critSection); return m_maxInflight; }
+  int GetRangeRequests() { CSingleLock lock(m_critSection); return m_rangeRequests; }
+
+  void Serve(int fd);
+
+protected:
+  virtual void Process();
+
+private:
+  bool ReadRequest(int fd, std::string& request);
+  bool SendAll(int fd, const char* data, size_t size);
+
+  int64_t          m_size;
+  bool             m_acceptRanges;
+  bool             m_honourRanges;
+  unsigned int     m_latency;
+  unsigned int     m_bytesPerSecond;
+  int              m_socket;
+  int              m_port;
+  CCriticalSection m_critSection;
+  int              m_connections;
+  int              m_inflight;
+  int              m_maxInflight;
+  int              m_rangeRequests;
+};
+
+class CTestHttpConnection : public CThread
+{
+public:
+  CTestHttpConnection(CTestHttpServer* server, int fd)
+    : CThread("TestHttpConnection"), m_server(server), m_fd(fd) {}
+
+protected:
+  virtual void Process()
+  {
+    m_server->Serve(m_fd);
+  }
+
+private:
+  CTestHttpServer* m_server;
+  int              m_fd;
+};
+
+void CTestHttpServer::Process()
+{
+  while (!m_bStop)
+  {
+    fd_set fds;
+    FD_ZERO(&fds);
+    FD_SET(m_socket, &fds);
+    struct timeval t = { 0, 100000 };
+    if (select(m_socket + 1, &fds, NULL, NULL, &t) <= 0)
+      continue;
+
+    int fd = accept(m_socket, NULL, NULL);
+    if (fd < 0)
+      continue;
+
+    struct timeval timeout = { 0, 100000 };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+
+    {
+      CSingleLock lock(m_critSection);
+      m_connections++;
+    }
+    CTestHttpConnection* connection = new CTestHttpConnection(this, fd);
+    connection->Create(true);
+  }
+}
+
+bool CTestHttpServer::ReadRequest(int fd, std::string& request)
+{
+  request.clear();
+  char buffer[1024];
+  while (request.find("\r\n\r\n") == std::string::npos)
+  {
+    if (m_bStop)
+      return false;
+
+    ssize_t len = recv(fd, buffer, sizeof(buffer), 0);
+    if (len == 0)
+      return false;
+    if (len < 0)
+    {
+      if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)
+        continue;
+      return false;
+    }
+    request.append(buffer, len);
+  }
+  return true;
+}
+
+bool CTestHttpServer::SendAll(int fd, const char* data, size_t size)
+{
+  while (size > 0)
+  {
+    ssize_t len = send(fd, data, size, MSG_NOSIGNAL);
+    if (len <= 0)
+      return false;
+    data += len;
+    size -= len;
+  }
+  return true;
+}
+
+void CTestHttpServer::Serve(int fd)
+{
+  std::string request;
+  while (!m_bStop && ReadRequest(fd, request))
+  {
+    bool head = request.compare(0, 5, "HEAD ") == 0;
+    int64_t start = 0;
+    int64_t end = m_size - 1;
+    bool ranged = false;
+
+    size_t pos = request.find("Range: bytes=");
+    if (pos != std::string::npos && m_honourRanges)
+    {
+      int64_t rangeStart = 0, rangeEnd = -1;
+      int fields = sscanf(request.c_str() + pos, "Range: bytes=%"SCNd64"-%"SCNd64, &rangeStart, &rangeEnd);
+      if (fields >= 1 && rangeStart < m_size)
+      {
+        start = rangeStart;
+        if (fields == 2 && rangeEnd < m_size)
+          end = rangeEnd;
+        ranged = true;
+      }
+    }
+
+    {
+      CSingleLock lock(m_critSection);
+      m_inflight++;
+      if (m_inflight > m_maxInflight)
+        m_maxInflight = m_inflight;
+      if (ranged && (start > 0 || end < m_size - 1))
+        m_rangeRequests++;
+    }
+
+    if (m_latency)
+      XbmcThreads::ThreadSleep(m_latency);
+
+    CStdString header;
+    if (ranged)
+      header.Format("HTTP/1.1 206 Partial Content\r\nContent-Range: bytes %"PRId64"-%"PRId64"/%"PRId64"\r\n", start, end, m_size);
+    else
+      header = "HTTP/1.1 200 OK\r\n";
+    if (m_acceptRanges)
+      header += "Accept-Ranges: bytes\r\n";
+    header.AppendFormat("Content-Type: application/octet-stream\r\nContent-Length: %"PRId64"\r\n\r\n", end - start + 1);
+
+    bool ok = SendAll(fd, header.c_str(), header.size());
+
+    // send the body in 50ms slices to honour the bandwidth cap
+    unsigned int slice = m_bytesPerSecond ? std::max(m_bytesPerSecond / 20, 1024u) : 64 * 1024;
+    std::vector<char> body(slice);
+    for (int64_t offset = start; ok && !head && offset <= end && !m_bStop; offset += slice)
+    {
+      unsigned int chunk = (unsigned int)std::min<int64_t>(slice, end - offset + 1);
+      for (unsigned int i = 0; i < chunk; i++)
+        body[i] = ByteAt(offset + i);
+
+      unsigned int begin = XbmcThreads::SystemClockMillis();
+      ok = SendAll(fd, &body[0], chunk);
+
+      if (m_bytesPerSecond)
+      {
+        unsigned int spent = XbmcThreads::SystemClockMillis() - begin;
+        unsigned int budget = (unsigned int)((uint64_t)chunk * 1000 / m_bytesPerSecond);
+        if (budget > spent)
+          XbmcThreads::ThreadSleep(budget - spent);
+      }
+    }
+
+    {
+      CSingleLock lock(m_critSection);
+      m_inflight--;
+    }
+
+    if (!ok)
+      break;
+  }
+
+  close(fd);
+  CSingleLock lock(m_critSection);
+  m_connections--;
+}
+
+class TestCurlFile : public testing::Test
+{
+protected:
+  TestCurlFile()
+  {
+    m_segments = g_advancedSettings.m_curlsegments;
+    m_segmentSize = g_advancedSettings.m_curlsegmentsize;
+    g_advancedSettings.m_curlsegments = 4;
+    g_advancedSettings.m_curlsegmentsize = 256 * 1024;
+  }
+
+  ~TestCurlFile()
+  {
+    g_advancedSettings.m_curlsegments = m_segments;
+    g_advancedSettings.m_curlsegmentsize = m_segmentSize;
+  }
+
+  static bool Verify(const char* buffer, int64_t pos, unsigned int size)
+  {
+    for (unsigned int i = 0; i < size; i++)
+    {
+      if (buffer[i] != CTestHttpServer::ByteAt(pos + i))
+        return false;
+    }
+    return true;
+  }
+
+  static int64_t ReadAll(XFILE::CCurlFile& file)
+  {
+    char buffer[65536];
+    int64_t pos = file.GetPosition();
+    unsigned int read;
+    while ((read = file.Read(buffer, sizeof(buffer))) > 0)
+    {
+      if (!Verify(buffer, pos, read))
+        return -1;
+      pos += read;
+    }
+    return pos;
+  }
+
+  int          m_segments;
+  unsigned int m_segmentSize;
+};
+
+TEST_F(TestCurlFile, SegmentedRead)
+{
+  const int64_t size = 4 * 1024 * 1024;
+  CTestHttpServer server(size, true, true, 20, 4 * 1024 * 1024);
+  ASSERT_TRUE(server.Start());
+
+  XFILE::CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetURL())));
+  EXPECT_EQ(size, file.GetLength());
+  EXPECT_EQ(size, ReadAll(file));
+  file.Close();
+
+  EXPECT_GT(server.GetRangeRequests(), 1);
+  EXPECT_GT(server.GetMaxInflight(), 1);
+}
+
+TEST_F(TestCurlFile, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  // a remote server capping each connection, read with one and with four connections
+  const int64_t size = 16 * 1024 * 1024;
+  double elapsed[2];
+  for (unsigned int i = 0; i < 2; i++)
+  {
+    g_advancedSettings.m_curlsegments = i ? 4 : 1;
+    CTestHttpServer server(size, true, true, 20, 4 * 1024 * 1024);
+    ASSERT_TRUE(server.Start());
+
+    XFILE::CCurlFile file;
+    ASSERT_TRUE(file.Open(CURL(server.GetURL())));
+    int64_t start = CurrentHostCounter();
+    EXPECT_EQ(size, ReadAll(file));
+    elapsed[i] = CXBMCTestUtils::ElapsedMs(start);
+    file.Close();
+  }
+
+  std::cout << "Read of " << size << " bytes took " << elapsed[0] << "ms over one connection, "
+            << elapsed[1] << "ms in segments" << std::endl;
+}
+
+TEST_F(TestCurlFile, SegmentedSeek)
+{
+  const int64_t size = 8 * 1024 * 1024;
+  CTestHttpServer server(size, true, true, 10, 0);
+  ASSERT_TRUE(server.Start());
+
+  XFILE::CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetURL())));
+
+  const int64_t positions[] = { 1000, 300000, 200000, 5000000, 5100000, 7 * 1024 * 1024, 0, size - 100 };
+  char buffer[4096];
+  for (unsigned int i = 0; i < sizeof(positions) / sizeof(positions[0]); i++)
+  {
+    EXPECT_EQ(positions[i], file.Seek(positions[i], SEEK_SET));
+    EXPECT_EQ(positions[i], file.GetPosition());
+    unsigned int want = (unsigned int)std::min<int64_t>(sizeof(buffer), size - positions[i]);
+    unsigned int read = 0;
+    while (read < want)
+    {
+      unsigned int len = file.Read(buffer + read, want - read);
+      if (!len)
+        break;
+      read += len;
+    }
+    EXPECT_EQ(want, read);
+    EXPECT_TRUE(Verify(buffer, positions[i], read));
+  }
+  EXPECT_EQ(size - 100, file.Seek(-100, SEEK_END));
+  EXPECT_EQ(size, ReadAll(file));
+  file.Close();
+}
+
+TEST_F(TestCurlFile, NoAcceptRanges)
+{
+  const int64_t size = 8 * 1024 * 1024;
+  CTestHttpServer server(size, false, true, 0, 0);
+  ASSERT_TRUE(server.Start());
+
+  XFILE::CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetURL())));
+  EXPECT_EQ(size, ReadAll(file));
+  file.Close();
+
+  EXPECT_EQ(0, server.GetRangeRequests());
+  EXPECT_EQ(1, server.GetMaxInflight());
+}
+
+TEST_F(TestCurlFile, RangesIgnoredFallback)
+{
+  const int64_t size = 8 * 1024 * 1024;
+  CTestHttpServer server(size, true, false, 0, 0);
+  ASSERT_TRUE(server.Start());
+
+  XFILE::CCurlFile file;
+  ASSERT_TRUE(file.Open(CURL(server.GetURL())));
+  EXPECT_EQ(size, ReadAll(file));
+  file.Close();
+}
+#endif
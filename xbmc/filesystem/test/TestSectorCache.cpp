@@ -0,0 +1,207 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/File.h"
+#include "filesystem/SectorCache.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/Thread.h"
+
+#include "gtest/gtest.h"
+
+#include <vector>
+
+#define TEST_IMAGE_SECTORS 2048 // 4MB
+
+using namespace XFILE;
+
+class TestSectorCache : public testing::Test
+{
+protected:
+  TestSectorCache()
+  {
+    m_image = CSpecialProtocol::TranslatePath("special://temp/testsectorcache.iso");
+    CSectorCache::GetInstance().Clear();
+  }
+
+  ~TestSectorCache()
+  {
+    CFile::Delete(m_image);
+    CSectorCache::GetInstance().Clear();
+  }
+
+  static unsigned char SectorByte(uint32_t sector, unsigned int offset)
+  {
+    return (unsigned char)(sector * 31 + offset);
+  }
+
+  /* writes an image where every sector has its own content, the image ends
+   * with a partial sector like truncated rips do */
+  bool GenerateImage(unsigned int sectors, unsigned int tail, unsigned char fill = 0)
+  {
+    std::vector<unsigned char> data(sectors * SECTOR_CACHE_SECTOR_SIZE + tail);
+    for (size_t i = 0; i < data.size(); i++)
+      data[i] = SectorByte(i / SECTOR_CACHE_SECTOR_SIZE, i % SECTOR_CACHE_SECTOR_SIZE) ^ fill;
+
+    CFile file;
+    if (!file.OpenForWrite(m_image, true))
+      return false;
+    bool ok = file.Write(&data[0], data.size()) == (int)data.size();
+    file.Close();
+    return ok;
+  }
+
+  static bool CheckSectors(const unsigned char *data, uint32_t sector, unsigned int count)
+  {
+    for (unsigned int s = 0; s < count; s++)
+      for (unsigned int i = 0; i < SECTOR_CACHE_SECTOR_SIZE; i += 97)
+        if (data[s * SECTOR_CACHE_SECTOR_SIZE + i] != SectorByte(sector + s, i))
+          return false;
+    return true;
+  }
+
+  CStdString m_image;
+};
+
+TEST_F(TestSectorCache, SequentialReadAhead)
+{
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS, 0));
+
+  CSectorReader reader;
+  ASSERT_TRUE(reader.Open(m_image));
+
+  unsigned char buf[SECTOR_CACHE_SECTOR_SIZE];
+  for (uint32_t sector = 0; sector < TEST_IMAGE_SECTORS; sector++)
+  {
+    ASSERT_EQ(1, reader.ReadSectors(sector, 1, buf));
+    ASSERT_TRUE(CheckSectors(buf, sector, 1));
+  }
+
+  const SSectorCacheStats &stats = reader.GetStats();
+
+  // one read per block without read-ahead, far fewer with it
+  EXPECT_EQ((uint64_t)TEST_IMAGE_SECTORS, stats.requests);
+  EXPECT_LT(stats.reads, (uint64_t)(TEST_IMAGE_SECTORS / SECTOR_CACHE_BLOCK_SECTORS / 4));
+  EXPECT_EQ((uint64_t)TEST_IMAGE_SECTORS * SECTOR_CACHE_SECTOR_SIZE, stats.bytes);
+}
+
+TEST_F(TestSectorCache, CoalesceAndShare)
+{
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS, 0));
+
+  std::vector<unsigned char> buf(600 * SECTOR_CACHE_SECTOR_SIZE);
+  CSectorReader reader;
+  ASSERT_TRUE(reader.Open(m_image));
+
+  // a request spanning several missing blocks is a single read
+  ASSERT_EQ(100, reader.ReadSectors(1000, 100, &buf[0]));
+  EXPECT_TRUE(CheckSectors(&buf[0], 1000, 100));
+  EXPECT_EQ(1u, reader.GetStats().reads);
+
+  // the gaps around cached blocks take one read each
+  ASSERT_EQ(1, reader.ReadSectors(1500, 1, &buf[0]));
+  EXPECT_EQ(2u, reader.GetStats().reads);
+  ASSERT_EQ(600, reader.ReadSectors(950, 600, &buf[0]));
+  EXPECT_TRUE(CheckSectors(&buf[0], 950, 600));
+  EXPECT_EQ(5u, reader.GetStats().reads);
+
+  // metadata re-reads (as UDF does walking the directory tree) are hits
+  for (int i = 0; i < 50; i++)
+  {
+    ASSERT_EQ(1, reader.ReadSectors(1024 + (i * 7) % 64, 1, &buf[0]));
+    ASSERT_TRUE(CheckSectors(&buf[0], 1024 + (i * 7) % 64, 1));
+  }
+  EXPECT_EQ(5u, reader.GetStats().reads);
+
+  // the cache is shared between readers of the same image
+  CSectorReader second;
+  ASSERT_TRUE(second.Open(m_image));
+  ASSERT_EQ(64, second.ReadSectors(1100, 64, &buf[0]));
+  EXPECT_TRUE(CheckSectors(&buf[0], 1100, 64));
+  EXPECT_EQ(0u, second.GetStats().reads);
+  EXPECT_FLOAT_EQ(1.0f, second.GetStats().HitRate());
+}
+
+TEST_F(TestSectorCache, EndOfImage)
+{
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS - 3, 100));
+
+  std::vector<unsigned char> buf(16 * SECTOR_CACHE_SECTOR_SIZE);
+  CSectorReader reader;
+  ASSERT_TRUE(reader.Open(m_image));
+
+  // the partial last sector is returned zero padded
+  EXPECT_EQ(4, reader.ReadSectors(TEST_IMAGE_SECTORS - 6, 8, &buf[0]));
+  EXPECT_TRUE(CheckSectors(&buf[0], TEST_IMAGE_SECTORS - 6, 3));
+  EXPECT_EQ(SectorByte(TEST_IMAGE_SECTORS - 3, 99), buf[3 * SECTOR_CACHE_SECTOR_SIZE + 99]);
+  EXPECT_EQ(0, buf[3 * SECTOR_CACHE_SECTOR_SIZE + 100]);
+
+  EXPECT_EQ(0, reader.ReadSectors(TEST_IMAGE_SECTORS, 1, &buf[0]));
+
+  reader.Close();
+  EXPECT_EQ(-1, reader.ReadSectors(0, 1, &buf[0]));
+}
+
+TEST_F(TestSectorCache, ReplacedImage)
+{
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS, 0));
+
+  std::vector<unsigned char> buf(16 * SECTOR_CACHE_SECTOR_SIZE);
+  CSectorReader reader;
+  ASSERT_TRUE(reader.Open(m_image));
+  ASSERT_EQ(16, reader.ReadSectors(0, 16, &buf[0]));
+  reader.Close();
+
+  // the same size written a second later, its blocks must not come from the old image
+  XbmcThreads::ThreadSleep(1100);
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS, 0, 0xff));
+  ASSERT_TRUE(reader.Open(m_image));
+  ASSERT_EQ(16, reader.ReadSectors(0, 16, &buf[0]));
+  EXPECT_EQ(1u, reader.GetStats().reads);
+  EXPECT_EQ((unsigned char)(SectorByte(5, 7) ^ 0xff), buf[5 * SECTOR_CACHE_SECTOR_SIZE + 7]);
+}
+
+TEST_F(TestSectorCache, ImageIds)
+{
+  ASSERT_TRUE(GenerateImage(TEST_IMAGE_SECTORS, 0));
+  CSectorCache &cache = CSectorCache::GetInstance();
+  EXPECT_EQ(0u, cache.GetNumImages());
+
+  // an image that was only opened is forgotten when it's closed
+  CSectorReader reader;
+  ASSERT_TRUE(reader.Open(m_image));
+  EXPECT_EQ(1u, cache.GetNumImages());
+  reader.Close();
+  EXPECT_EQ(0u, cache.GetNumImages());
+
+  // one with cached blocks is kept for the next reader, until the blocks are gone
+  std::vector<unsigned char> buf(16 * SECTOR_CACHE_SECTOR_SIZE);
+  ASSERT_TRUE(reader.Open(m_image));
+  ASSERT_EQ(16, reader.ReadSectors(0, 16, &buf[0]));
+  reader.Close();
+  EXPECT_EQ(1u, cache.GetNumImages());
+
+  ASSERT_TRUE(reader.Open(m_image));
+  ASSERT_EQ(16, reader.ReadSectors(0, 16, &buf[0]));
+  EXPECT_EQ(0u, reader.GetStats().reads);
+  reader.Close();
+
+  cache.Clear();
+  EXPECT_EQ(0u, cache.GetNumImages());
+}
@@ -0,0 +1,270 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "filesystem/ZipManager.h"
+#include "settings/GUISettings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+
+#include "gtest/gtest.h"
+
+#define ZIP_TEST_ENTRIES 20000
+
+class TestZipManager : public testing::Test
+{
+protected:
+  TestZipManager()
+  {
+    /* Add default settings for locale.
+     * Settings here are taken from CGUISettings::Initialize()
+     */
+    CSettingsCategory *loc = g_guiSettings.AddCategory(7, "locale", 14090);
+    g_guiSettings.AddString(loc, "locale.language",248,"english",
+                            SPIN_CONTROL_TEXT);
+    g_guiSettings.AddString(loc, "locale.country", 20026, "USA",
+                            SPIN_CONTROL_TEXT);
+    g_guiSettings.AddString(loc, "locale.charset", 14091, "DEFAULT",
+                            SPIN_CONTROL_TEXT); // charset is set by the
+                                                // language file
+
+    m_archive = CSpecialProtocol::TranslatePath("special://temp/testzipmanager.zip");
+  }
+
+  ~TestZipManager()
+  {
+    g_ZipManager.release(ZipPath(""));
+    XFILE::CFile::Delete(m_archive);
+    g_guiSettings.Clear();
+  }
+
+  CStdString ZipPath(const CStdString& name) const
+  {
+    CStdString path;
+    URIUtils::CreateArchivePath(path, "zip", m_archive, name);
+    return path;
+  }
+
+  static CStdString EntryName(int i)
+  {
+    CStdString name;
+    name.Format("dir%02d/file%05d.txt", i % 50, i);
+    return name;
+  }
+
+  static CStdString EntryData(int i)
+  {
+    CStdString data;
+    data.Format("entry %d\n", i);
+    return data;
+  }
+
+  static void Put16(std::string& out, unsigned short value)
+  {
+    out += (char)(value & 0xff);
+    out += (char)(value >> 8);
+  }
+
+  static void Put32(std::string& out, unsigned int value)
+  {
+    Put16(out, value & 0xffff);
+    Put16(out, value >> 16);
+  }
+
+  /* writes a stored (uncompressed) archive with the given number of entries,
+   * every local header carries an extra field to exercise the offset lookup */
+  bool GenerateArchive(int count)
+  {
+    std::string data, cdir;
+    for (int i = 0; i < count; i++)
+    {
+      CStdString name = EntryName(i);
+      CStdString content = EntryData(i);
+      unsigned int offset = data.size();
+
+      Put32(data, ZIP_LOCAL_HEADER);
+      Put16(data, 10);               // version
+      Put16(data, 0);                // flags
+      Put16(data, 0);                // method
+      Put16(data, 0);                // mod time
+      Put16(data, 0);                // mod date
+      Put32(data, 0);                // crc32
+      Put32(data, content.size());   // compressed size
+      Put32(data, content.size());   // uncompressed size
+      Put16(data, name.size());
+      Put16(data, 4);                // extra field length
+      data += name;
+      data.append(4, '\0');
+      data += content;
+
+      Put32(cdir, ZIP_CENTRAL_HEADER);
+      Put16(cdir, 10);               // version made by
+      Put16(cdir, 10);               // version
+      Put16(cdir, 0);                // flags
+      Put16(cdir, 0);                // method
+      Put16(cdir, 0);                // mod time
+      Put16(cdir, 0);                // mod date
+      Put32(cdir, 0);                // crc32
+      Put32(cdir, content.size());
+      Put32(cdir, content.size());
+      Put16(cdir, name.size());
+      Put16(cdir, 0);                // extra field length
+      Put16(cdir, 0);                // comment length
+      Put16(cdir, 0);                // disk number
+      Put16(cdir, 0);                // internal attributes
+      Put32(cdir, 0);                // external attributes
+      Put32(cdir, offset);
+      cdir += name;
+    }
+
+    std::string ecdrec;
+    Put32(ecdrec, ZIP_END_CENTRAL_HEADER);
+    Put16(ecdrec, 0);
+    Put16(ecdrec, 0);
+    Put16(ecdrec, count);
+    Put16(ecdrec, count);
+    Put32(ecdrec, cdir.size());
+    Put32(ecdrec, data.size());
+    Put16(ecdrec, 0);
+
+    XFILE::CFile file;
+    if (!file.OpenForWrite(m_archive, true))
+      return false;
+    bool ok = file.Write(data.c_str(), data.size()) == (int)data.size()
+           && file.Write(cdir.c_str(), cdir.size()) == (int)cdir.size()
+           && file.Write(ecdrec.c_str(), ecdrec.size()) == (int)ecdrec.size();
+    file.Close();
+    return ok;
+  }
+
+  CStdString m_archive;
+};
+
+TEST_F(TestZipManager, LargeArchive)
+{
+  ASSERT_TRUE(GenerateArchive(ZIP_TEST_ENTRIES));
+
+  std::vector<SZipEntry> entries;
+  ASSERT_TRUE(g_ZipManager.GetZipList(ZipPath(""), entries));
+  ASSERT_EQ((size_t)ZIP_TEST_ENTRIES, entries.size());
+  EXPECT_STREQ(EntryName(123).c_str(), entries[123].name.c_str());
+
+  for (int i = 0; i < ZIP_TEST_ENTRIES; i++)
+  {
+    SZipEntry entry;
+    ASSERT_TRUE(g_ZipManager.GetZipEntry(ZipPath(EntryName(i)), entry));
+    EXPECT_EQ(EntryData(i).size(), entry.usize);
+  }
+
+  SZipEntry missing;
+  EXPECT_FALSE(g_ZipManager.GetZipEntry(ZipPath("dir00/nothere.txt"), missing));
+
+  // entry data offsets are resolved lazily, make sure they are right
+  const int samples[] = { 0, 1, 4999, 12345, ZIP_TEST_ENTRIES - 1 };
+  for (unsigned int i = 0; i < sizeof(samples) / sizeof(samples[0]); i++)
+  {
+    CStdString expected = EntryData(samples[i]);
+    char buf[32] = {};
+    XFILE::CFile file;
+    ASSERT_TRUE(file.Open(ZipPath(EntryName(samples[i]))));
+    EXPECT_EQ(expected.size(), file.Read(buf, sizeof(buf)));
+    EXPECT_STREQ(expected.c_str(), buf);
+    file.Close();
+  }
+}
+
+TEST_F(TestZipManager, StatFromIndex)
+{
+  ASSERT_TRUE(GenerateArchive(100));
+
+  // checking and stating entries is answered from the central directory alone
+  CStdString path = ZipPath(EntryName(42));
+  EXPECT_TRUE(XFILE::CFile::Exists(path));
+  struct __stat64 buffer;
+  ASSERT_EQ(0, XFILE::CFile::Stat(path, &buffer));
+  EXPECT_EQ((int64_t)EntryData(42).size(), buffer.st_size);
+  EXPECT_FALSE(XFILE::CFile::Exists(ZipPath("dir00/nothere.txt")));
+
+  SZipEntry entry;
+  ASSERT_TRUE(g_ZipManager.FindZipEntry(path, entry));
+  EXPECT_EQ(0, entry.offset);
+
+  // until the entry is opened
+  ASSERT_TRUE(g_ZipManager.GetZipEntry(path, entry));
+  EXPECT_LT(0, entry.offset);
+  ASSERT_TRUE(g_ZipManager.FindZipEntry(path, entry));
+  EXPECT_LT(0, entry.offset);
+}
+
+TEST_F(TestZipManager, ExtractArchive)
+{
+  const int count = 2000;
+  ASSERT_TRUE(GenerateArchive(count));
+
+  CStdString dest = CSpecialProtocol::TranslatePath("special://temp/testzipmanager/");
+  EXPECT_TRUE(g_ZipManager.ExtractArchive(m_archive, dest));
+
+  for (int i = 0; i < count; i += 97)
+  {
+    CStdString expected = EntryData(i);
+    char buf[32] = {};
+    XFILE::CFile file;
+    ASSERT_TRUE(file.Open(dest + EntryName(i)));
+    EXPECT_EQ(expected.size(), file.Read(buf, sizeof(buf)));
+    EXPECT_STREQ(expected.c_str(), buf);
+    file.Close();
+  }
+
+  g_ZipManager.CleanUp(m_archive, dest);
+  XFILE::CDirectory::Remove(dest);
+}
+
+TEST_F(TestZipManager, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  ASSERT_TRUE(GenerateArchive(ZIP_TEST_ENTRIES));
+
+  std::vector<SZipEntry> entries;
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(g_ZipManager.GetZipList(ZipPath(""), entries));
+  double list = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < ZIP_TEST_ENTRIES; i++)
+  {
+    SZipEntry entry;
+    g_ZipManager.GetZipEntry(ZipPath(EntryName(i)), entry);
+  }
+  double lookup = CXBMCTestUtils::ElapsedMs(start);
+
+  CStdString dest = CSpecialProtocol::TranslatePath("special://temp/testzipmanager/");
+  start = CurrentHostCounter();
+  EXPECT_TRUE(g_ZipManager.ExtractArchive(m_archive, dest));
+  double extract = CXBMCTestUtils::ElapsedMs(start);
+  g_ZipManager.CleanUp(m_archive, dest);
+  XFILE::CDirectory::Remove(dest);
+
+  std::cout << "Listing " << ZIP_TEST_ENTRIES << " entries took " << list << "ms, "
+            << "looking all of them up took " << lookup << "ms, "
+            << "extracting them took " << extract << "ms" << std::endl;
+}
@@ -27,7 +27,6 @@
 #include "system.h"
 #include "utils/log.h"
 #include "udf25.h"
-#include "File.h"
 
 /* For direct data access, LSB first */
 #define GETN1(p) ((uint8_t)data[p])
@@ -360,87 +359,6 @@ static int UDFDescriptor( uint8_t *data, uint16_t *TagID )
   return 0;
 }
 
-/**
- * initialize and open a DVD device or file.
- */
-static CFile* file_open(const char *target)
-{
-  CFile* fp = new CFile();
-
-  if(!fp->Open(target))
-  {
-    CLog::Log(LOGERROR,"file_open - Could not open input");
-    delete fp;
-    return NULL;
-  }
-
-  return fp;
-}
-
-
-/**
- * seek into the device.
- */
-static int file_seek(CFile* fp, int blocks)
-{
-  off64_t pos;
-
-  pos = fp->Seek((off64_t)blocks * (off64_t)DVD_VIDEO_LB_LEN, SEEK_SET);
-
-  if(pos < 0) {
-    return (int) pos;
-  }
-  /* assert pos % DVD_VIDEO_LB_LEN == 0 */
-  return (int) (pos / DVD_VIDEO_LB_LEN);
-}
-
-/**
- * read data from the device.
- */
-static int file_read(CFile* fp, void *buffer, int blocks, int flags)
-{
-  size_t len;
-  ssize_t ret;
-
-  len = (size_t)blocks * DVD_VIDEO_LB_LEN;
-
-  while(len > 0) {
-
-    ret = fp->Read(buffer, len);
-
-    if(ret < 0) {
-      /* One of the reads failed, too bad.  We won't even bother
-       * returning the reads that went OK, and as in the POSIX spec
-       * the file position is left unspecified after a failure. */
-      return ret;
-    }
-
-    if(ret == 0) {
-      /* Nothing more to read.  Return all of the whole blocks, if any.
-       * Adjust the file position back to the previous block boundary. */
-      size_t bytes = (size_t)blocks * DVD_VIDEO_LB_LEN - len;
-      off_t over_read = -(off_t)(bytes % DVD_VIDEO_LB_LEN);
-      /*off_t pos =*/ fp->Seek(over_read, SEEK_CUR);
-      /* should have pos % 2048 == 0 */
-      return (int) (bytes / DVD_VIDEO_LB_LEN);
-    }
-
-    len -= ret;
-  }
-
-  return blocks;
-}
-
-/**
- * close the DVD device and clean up.
- */
-static int file_close(CFile* fp)
-{
-  fp->Close();
-
-  return 0;
-}
-
 // offset is in bytes, force_size is in sectors
 uint64_t DVDFileSeekForce(BD_FILE bdfile, uint64_t offset, int64_t force_size)
 {
@@ -732,16 +650,7 @@ int udf25::GetUDFCache(UDFCacheType type, uint32_t nr, void *data)
 
 int udf25::UDFReadBlocksRaw( uint32_t lb_number, size_t block_count, unsigned char *data, int encrypted )
 {
-  int ret;
-
-  ret = file_seek( m_fp, (int) lb_number );
-  if( ret != (int) lb_number ) {
-    CLog::Log(LOGERROR, "udf25::UDFReadBlocksRaw -  Can't seek to block %u (got %u)", lb_number, ret );
-    return 0;
-  }
-
-  ret = file_read( m_fp, (char *) data, (int) block_count, encrypted );
-  return ret;
+  return m_reader.ReadSectors(lb_number, (unsigned int) block_count, data);
 }
 
 int udf25::DVDReadLBUDF( uint32_t lb_number, size_t block_count, unsigned char *data, int encrypted )
@@ -1048,15 +957,13 @@ int udf25::UDFScanDir( struct FileAD Dir, char *FileName, struct Partition *part
 
 udf25::udf25( )
 {
-  m_fp = NULL;
   m_udfcache_level = 1;
   m_udfcache = NULL;
 }
 
 udf25::~udf25( )
 {
-  if(m_fp)
-    m_fp->Close();
+  free(m_udfcache);
 }
 
 UDF_FILE udf25::UDFFindFile( const char* filename, uint64_t *filesize )
@@ -1174,8 +1081,7 @@ HANDLE udf25::OpenFile( const char* isoname, const char* filename )
   UDF_FILE file = NULL;
   BD_FILE bdfile = NULL;
 
-  m_fp = file_open(isoname);
-  if(m_fp)
+  if(m_reader.Open(isoname))
   {
     file = UDFFindFile(filename, &filesize);
     if(file)
@@ -1250,12 +1156,7 @@ void udf25::CloseFile(HANDLE hFile)
   free(m_udfcache);
   m_udfcache = NULL;
 
-  if(m_fp)
-  {
-    file_close(m_fp);
-    delete(m_fp);
-    m_fp = NULL;
-  }
+  m_reader.Close();
 }
 
 int64_t udf25::Seek(HANDLE hFile, int64_t lOffset, int whence)
@@ -23,7 +23,8 @@
  * Jorgen Lundman did the necessary modifications to support udf 2.5
  */
 
-#include "File.h"
+#include "PlatformDefs.h"
+#include "SectorCache.h"
 
 /**
  * The length of one Logical Block of a DVD.
@@ -214,7 +215,7 @@ protected:
     /* Filesystem cache */
   int m_udfcache_level; /* 0 - turned off, 1 - on */
   void *m_udfcache;
-  XFILE::CFile* m_fp;
+  XFILE::CSectorReader m_reader;
 };
 
 #endif
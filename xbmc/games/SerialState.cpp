@@ -25,17 +25,27 @@
 #include "system.h" // for SAFE_DELETE_ARRAY()
 
 
+#include <algorithm>
+#include <string.h>
+
 // Pad forward to nearest boundary of bytes
 #define PAD_TO_CEIL(x, bytes) (((x) + (bytes) - 1) / (bytes))
 
-void CSerialState::Init(size_t frameSize, size_t frameCount)
+// Unchanged words closer than this to the previous change stay inside its run,
+// which is no more expensive than the two word header of a new run
+#define RUN_MERGE_DISTANCE 3
+
+void CSerialState::Init(size_t frameSize, size_t frameCount, size_t maxBytes /* = REWIND_BUFFER_MAX_BYTES */)
 {
   Reset();
   m_frameSize = frameSize; // Size of the frame from retro_serialize_size()
-  m_maxFrames = frameCount;
+  m_maxBytes = maxBytes;
   m_stateSize = PAD_TO_CEIL(m_frameSize, sizeof(uint32_t)); // Size of the padded frame ( >= m_frameSize)
   m_state = new uint32_t[m_stateSize];
   m_nextState = new uint32_t[m_stateSize];
+  // Worst case delta, runs are at least RUN_MERGE_DISTANCE words apart
+  m_scratch.resize(m_stateSize + 3);
+  Resize(frameCount);
 }
 
 // Make sure m_state and m_nextState are zero-initialized in the constructor
@@ -43,64 +53,183 @@ void CSerialState::Reset()
 {
   SAFE_DELETE_ARRAY(m_state);
   SAFE_DELETE_ARRAY(m_nextState);
-  m_rewindBuffer.clear();
+  std::vector<uint32_t>().swap(m_arena);
+  std::vector<uint32_t>().swap(m_scratch);
+  std::vector<Record>().swap(m_frames);
+  m_firstFrame = 0;
+  m_frameCount = 0;
+  m_tail = 0;
+  m_used = 0;
   m_frameSize = 0;
   m_maxFrames = 0;
+  m_maxBytes = 0;
   m_stateSize = 0;
 }
 
 void CSerialState::SetMaxFrames(size_t frameCount)
 {
-  m_maxFrames = frameCount;
-  if (!m_maxFrames && (m_state || m_nextState))
-  {
+  if (!frameCount && (m_state || m_nextState))
     Reset();
-  }
   else
+    Resize(frameCount);
+}
+
+void CSerialState::Resize(size_t frameCount)
+{
+  while (m_frameCount > frameCount)
+    PopOldest();
+
+  // Enough room for frameCount full frames, capped by the memory budget
+  size_t capacity = std::min(m_maxBytes / sizeof(uint32_t), frameCount * (m_stateSize + 3));
+  while (m_used > capacity)
+    PopOldest();
+
+  // Move the remaining frames to the start of the new arena
+  std::vector<uint32_t> arena(capacity);
+  std::vector<Record> frames(frameCount);
+  size_t pos = 0;
+  for (size_t i = 0; i < m_frameCount; i++)
   {
-    while (m_rewindBuffer.size() > m_maxFrames)
-      m_rewindBuffer.pop_front();
+    Record record = m_frames[(m_firstFrame + i) % m_frames.size()];
+    memcpy(&arena[pos], &m_arena[record.offset], record.size * sizeof(uint32_t));
+    record.offset = pos;
+    frames[i] = record;
+    pos += record.size;
   }
+
+  m_arena.swap(arena);
+  m_frames.swap(frames);
+  m_firstFrame = 0;
+  m_tail = pos;
+  m_maxFrames = frameCount;
 }
 
-void CSerialState::AdvanceFrame()
+size_t CSerialState::EncodeDelta()
 {
-  m_rewindBuffer.push_back(DeltaPairVector());
-  DeltaPairVector& buffer = m_rewindBuffer.back();
+  const uint32_t *state = m_state;
+  const uint32_t *next = m_nextState;
+  uint32_t *out = &m_scratch[1];
+  uint32_t runs = 0;
+  size_t pos = 0;
+  size_t i = 0;
 
-  for (size_t i = 0; i < m_stateSize; i++)
+  while (i < m_stateSize)
   {
-    uint32_t xor_val = m_state[i] ^ m_nextState[i];
-    if (xor_val)
+    // Skip unchanged words, four at a time while possible
+    while (i + 4 <= m_stateSize &&
+           !((state[i] ^ next[i]) | (state[i + 1] ^ next[i + 1]) |
+             (state[i + 2] ^ next[i + 2]) | (state[i + 3] ^ next[i + 3])))
+      i += 4;
+    while (i < m_stateSize && state[i] == next[i])
+      i++;
+    if (i == m_stateSize)
+      break;
+
+    size_t end = i + 1;
+    for (size_t j = end; j < m_stateSize && j < end + RUN_MERGE_DISTANCE; j++)
     {
-      DeltaPair pair = {i, xor_val};
-      buffer.push_back(pair);
+      if (state[j] != next[j])
+        end = j + 1;
     }
+
+    *out++ = (uint32_t)(i - pos);
+    *out++ = (uint32_t)(end - i);
+    for (size_t j = i; j < end; j++)
+      *out++ = state[j] ^ next[j];
+
+    runs++;
+    pos = end;
+    i = end;
+  }
+
+  m_scratch[0] = runs;
+  return out - &m_scratch[0];
+}
+
+void CSerialState::PushRecord(size_t size)
+{
+  if (m_frames.empty())
+    return;
+
+  if (size > m_arena.size())
+  {
+    // The history before a frame that can't be stored is of no use
+    while (m_frameCount)
+      PopOldest();
+    return;
+  }
+
+  if (m_frameCount == m_frames.size())
+    PopOldest();
+
+  if (m_tail + size > m_arena.size())
+  {
+    // Wrap around, the frames between the tail and the end are the oldest
+    while (m_frameCount && Oldest().offset >= m_tail)
+      PopOldest();
+    m_tail = 0;
   }
 
+  while (m_frameCount && Oldest().offset >= m_tail && Oldest().offset < m_tail + size)
+    PopOldest();
+
+  memcpy(&m_arena[m_tail], &m_scratch[0], size * sizeof(uint32_t));
+
+  Record &record = m_frames[(m_firstFrame + m_frameCount) % m_frames.size()];
+  record.offset = m_tail;
+  record.size = size;
+  m_frameCount++;
+  m_tail += size;
+  m_used += size;
+}
+
+void CSerialState::PopOldest()
+{
+  m_used -= Oldest().size;
+  m_firstFrame = (m_firstFrame + 1) % m_frames.size();
+  if (--m_frameCount == 0)
+    m_tail = 0;
+}
+
+void CSerialState::PopNewest()
+{
+  m_used -= Newest().size;
+  m_frameCount--;
+  m_tail = m_frameCount ? Newest().offset + Newest().size : 0;
+}
+
+void CSerialState::AdvanceFrame()
+{
+  PushRecord(EncodeDelta());
+
   // Delta is generated, bring the new frame forward (m_nextState is now disposable)
   std::swap(m_state, m_nextState);
-
-  while (m_rewindBuffer.size() > m_maxFrames)
-    m_rewindBuffer.pop_front();
 }
 
 unsigned int CSerialState::RewindFrames(unsigned int frameCount)
 {
   unsigned int rewound = 0;
-  while (frameCount > 0 && !m_rewindBuffer.empty())
+  while (frameCount > 0 && m_frameCount > 0)
   {
-    const DeltaPair *buffer = m_rewindBuffer.back().data();
+    const uint32_t *delta = &m_arena[Newest().offset];
+    uint32_t runs = *delta++;
+    uint32_t *state = m_state;
 
-    size_t bufferSize = m_rewindBuffer.back().size();
-    // buffer pointer redirection violates data-dependency requirements...
-    // no vecorization for us :(
-    for (size_t i = 0; i < bufferSize; i++)
-      m_state[buffer[i].pos] ^= buffer[i].delta;
+    // Runs are contiguous, so the inner loop is free to vectorize
+    for (uint32_t run = 0; run < runs; run++)
+    {
+      state += delta[0];
+      uint32_t length = delta[1];
+      delta += 2;
+      for (uint32_t i = 0; i < length; i++)
+        state[i] ^= delta[i];
+      state += length;
+      delta += length;
+    }
 
     rewound++;
     frameCount--;
-    m_rewindBuffer.pop_back();
+    PopNewest();
   }
 
   return rewound;
@@ -20,18 +20,21 @@
  */
 #pragma once
 
-#include <deque>
 #include <vector>
 #include <stdint.h>
 #include <stdlib.h>
 
+// Memory cap of the rewind history, old frames are dropped to stay within it
+#define REWIND_BUFFER_MAX_BYTES (32 * 1024 * 1024)
+
 class CSerialState
 {
 public:
-  CSerialState() : m_frameSize(0), m_maxFrames(0), m_stateSize(0), m_state(NULL), m_nextState(NULL) { }
+  CSerialState() : m_frameSize(0), m_maxFrames(0), m_maxBytes(0), m_stateSize(0), m_state(NULL), m_nextState(NULL),
+                   m_firstFrame(0), m_frameCount(0), m_tail(0), m_used(0) { }
   ~CSerialState() { Reset(); }
 
-  void Init(size_t frameSize, size_t frameCount);
+  void Init(size_t frameSize, size_t frameCount, size_t maxBytes = REWIND_BUFFER_MAX_BYTES);
   bool IsInited() const { return m_state && m_nextState; }
   void Reset(); // Free up any memory allocated
   void SetMaxFrames(size_t frameCount);
@@ -40,16 +43,34 @@ public:
   uint8_t *GetNextState() const { return reinterpret_cast<uint8_t*>(m_nextState); }
   size_t GetFrameSize() const { return m_frameSize; }
   size_t GetMaxFrames() const { return m_maxFrames; }
-  size_t GetFramesAvailable() const { return m_rewindBuffer.size(); }
+  size_t GetFramesAvailable() const { return m_frameCount; }
+  size_t GetBufferSize() const { return m_arena.size() * sizeof(uint32_t); }
+  size_t GetBufferUsed() const { return m_used * sizeof(uint32_t); }
 
   void AdvanceFrame();
   unsigned int RewindFrames(unsigned int frameCount);
 
 private:
+  struct Record
+  {
+    size_t offset; // in words from the start of the arena
+    size_t size;   // in words
+  };
+
+  size_t EncodeDelta();
+  void PushRecord(size_t size);
+  void PopOldest();
+  void PopNewest();
+  void Resize(size_t frameCount);
+  Record &Oldest() { return m_frames[m_firstFrame]; }
+  Record &Newest() { return m_frames[(m_firstFrame + m_frameCount - 1) % m_frames.size()]; }
+
   // Size of the serialized data returned by retro_serialize_size()
   size_t m_frameSize;
   // Maximum number of frames in the history rewind buffer
   size_t m_maxFrames;
+  // Maximum size of the history rewind buffer in bytes
+  size_t m_maxBytes;
 
   /**
    * Simple double-buffering. After XORing the two states, the next becomes the
@@ -62,18 +83,21 @@ private:
 
   /**
    * Rewinding is implemented by applying XOR deltas on the specific parts of
-   * the save state buffer which have changed. In practice, this is very fast
-   * and simple (linear scan) and allows deltas to be compressed down to 1-3%
-   * of original save state size depending on the system. The algorithm runs on
-   * 32 bits at a time for speed. The state buffer has a fixed number of frames.
+   * the save state buffer which have changed. A delta is stored as a run count
+   * followed by runs of changed words, each run being a {skip, length} header
+   * and the XOR values, so both encoding and applying a delta are linear scans over
+   * contiguous memory. Zero gaps of a couple of words are kept inside a run as
+   * that is cheaper than starting a new one.
    *
-   * Use std::deque here to achieve amortized O(1) on pop/push to front and back.
+   * Deltas are packed into a fixed size ring arena allocated once, with a
+   * ring of records indexing the frames in it. Pushing a frame evicts the
+   * oldest ones when the arena or the frame count is exhausted.
    */
-  struct DeltaPair
-  {
-    size_t   pos;
-    uint32_t delta;
-  };
-  typedef std::vector<DeltaPair> DeltaPairVector;
-  std::deque<DeltaPairVector>    m_rewindBuffer;
+  std::vector<uint32_t> m_arena;
+  std::vector<uint32_t> m_scratch; // delta of the frame being encoded
+  std::vector<Record>   m_frames;
+  size_t                m_firstFrame;
+  size_t                m_frameCount;
+  size_t                m_tail; // arena write position in words
+  size_t                m_used; // words used by the stored frames
 };
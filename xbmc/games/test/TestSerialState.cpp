@@ -0,0 +1,264 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "games/SerialState.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <deque>
+#include <string.h>
+
+#define STATE_SIZE   (128 * 1024 + 2) // odd sized like real cores
+#define FRAME_RATE   60
+
+/* Produces a sequence of save states resembling a running core: a couple of
+ * frame counters, a sprite table rewritten every frame and sparse writes into
+ * work RAM */
+class CStateRecorder
+{
+public:
+  CStateRecorder(size_t size) : m_state(size, 0), m_seed(12345), m_frame(0) { }
+
+  const uint8_t *NextFrame()
+  {
+    m_frame++;
+    memcpy(&m_state[16], &m_frame, sizeof(m_frame));
+    for (size_t i = 0x1000; i < 0x1200; i += 4)
+      m_state[i] = (uint8_t)(m_frame + i);
+    for (int i = 0; i < 24; i++)
+      m_state[0x2000 + Random() % (m_state.size() - 0x2000)] ^= (uint8_t)Random();
+    return &m_state[0];
+  }
+
+private:
+  uint32_t Random()
+  {
+    m_seed = m_seed * 1103515245 + 12345;
+    return m_seed >> 8;
+  }
+
+  std::vector<uint8_t> m_state;
+  uint32_t m_seed;
+  uint32_t m_frame;
+};
+
+/* The previous rewind buffer, one {pos, xor} pair per changed word */
+class CLegacySerialState
+{
+public:
+  CLegacySerialState(size_t frameSize, size_t maxFrames)
+    : m_stateSize((frameSize + 3) / 4), m_state(m_stateSize), m_nextState(m_stateSize), m_maxFrames(maxFrames) { }
+
+  uint8_t *GetNextState() { return reinterpret_cast<uint8_t*>(&m_nextState[0]); }
+
+  void AdvanceFrame()
+  {
+    m_rewindBuffer.push_back(DeltaPairVector());
+    DeltaPairVector& buffer = m_rewindBuffer.back();
+    for (size_t i = 0; i < m_stateSize; i++)
+    {
+      uint32_t xor_val = m_state[i] ^ m_nextState[i];
+      if (xor_val)
+      {
+        DeltaPair pair = {i, xor_val};
+        buffer.push_back(pair);
+      }
+    }
+    m_state.swap(m_nextState);
+    while (m_rewindBuffer.size() > m_maxFrames)
+      m_rewindBuffer.pop_front();
+  }
+
+  void RewindFrames(unsigned int frameCount)
+  {
+    while (frameCount-- > 0 && !m_rewindBuffer.empty())
+    {
+      const DeltaPairVector &buffer = m_rewindBuffer.back();
+      for (size_t i = 0; i < buffer.size(); i++)
+        m_state[buffer[i].pos] ^= buffer[i].delta;
+      m_rewindBuffer.pop_back();
+    }
+  }
+
+  size_t GetMemoryUsed() const
+  {
+    size_t used = 0;
+    for (size_t i = 0; i < m_rewindBuffer.size(); i++)
+      used += sizeof(DeltaPairVector) + m_rewindBuffer[i].capacity() * sizeof(DeltaPair);
+    return used;
+  }
+
+private:
+  struct DeltaPair
+  {
+    size_t   pos;
+    uint32_t delta;
+  };
+  typedef std::vector<DeltaPair> DeltaPairVector;
+
+  size_t m_stateSize;
+  std::vector<uint32_t> m_state;
+  std::vector<uint32_t> m_nextState;
+  size_t m_maxFrames;
+  std::deque<DeltaPairVector> m_rewindBuffer;
+};
+
+TEST(TestSerialState, Rewind)
+{
+  const size_t frames = 200;
+  CStateRecorder recorder(STATE_SIZE);
+  std::vector< std::vector<uint8_t> > history;
+
+  CSerialState state;
+  state.Init(STATE_SIZE, frames);
+  memcpy(state.GetState(), recorder.NextFrame(), STATE_SIZE);
+  history.push_back(std::vector<uint8_t>(state.GetState(), state.GetState() + STATE_SIZE));
+
+  for (size_t i = 0; i < frames + 50; i++)
+  {
+    memcpy(state.GetNextState(), recorder.NextFrame(), STATE_SIZE);
+    state.AdvanceFrame();
+    history.push_back(std::vector<uint8_t>(state.GetState(), state.GetState() + STATE_SIZE));
+  }
+  EXPECT_EQ(frames, state.GetFramesAvailable());
+
+  // unchanged frames still take a slot
+  memcpy(state.GetNextState(), state.GetState(), STATE_SIZE);
+  state.AdvanceFrame();
+  EXPECT_EQ(1u, state.RewindFrames(1));
+  EXPECT_EQ(0, memcmp(&history.back()[0], state.GetState(), STATE_SIZE));
+
+  EXPECT_EQ(1u, state.RewindFrames(1));
+  EXPECT_EQ(0, memcmp(&history[history.size() - 2][0], state.GetState(), STATE_SIZE));
+  EXPECT_EQ(10u, state.RewindFrames(10));
+  EXPECT_EQ(0, memcmp(&history[history.size() - 12][0], state.GetState(), STATE_SIZE));
+
+  // can't go further back than the history
+  EXPECT_EQ(frames - 12, state.RewindFrames(1000));
+  EXPECT_EQ(0, memcmp(&history[history.size() - frames][0], state.GetState(), STATE_SIZE));
+  EXPECT_EQ(0u, state.GetFramesAvailable());
+  EXPECT_EQ(0u, state.GetBufferUsed());
+}
+
+TEST(TestSerialState, MemoryBudget)
+{
+  const size_t budget = 256 * 1024;
+  CStateRecorder recorder(STATE_SIZE);
+  std::deque< std::vector<uint8_t> > history;
+
+  CSerialState state;
+  state.Init(STATE_SIZE, 60 * FRAME_RATE, budget);
+  EXPECT_LE(state.GetBufferSize(), budget);
+
+  for (int i = 0; i < 2000; i++)
+  {
+    memcpy(state.GetNextState(), recorder.NextFrame(), STATE_SIZE);
+    state.AdvanceFrame();
+    history.push_back(std::vector<uint8_t>(state.GetState(), state.GetState() + STATE_SIZE));
+    EXPECT_LE(state.GetBufferUsed(), budget);
+  }
+
+  // the oldest frames have been dropped to stay within the budget
+  size_t available = state.GetFramesAvailable();
+  EXPECT_GT(available, 100u);
+  EXPECT_LT(available, 2000u);
+
+  EXPECT_EQ(available, state.RewindFrames(available));
+  EXPECT_EQ(0, memcmp(&history[history.size() - 1 - available][0], state.GetState(), STATE_SIZE));
+
+  // shrinking the history keeps the newest frames
+  for (int i = 0; i < 100; i++)
+  {
+    memcpy(state.GetNextState(), recorder.NextFrame(), STATE_SIZE);
+    state.AdvanceFrame();
+    history.push_back(std::vector<uint8_t>(state.GetState(), state.GetState() + STATE_SIZE));
+  }
+  state.SetMaxFrames(30);
+  EXPECT_EQ(30u, state.GetFramesAvailable());
+  EXPECT_EQ(30u, state.RewindFrames(100));
+  EXPECT_EQ(0, memcmp(&history[history.size() - 31][0], state.GetState(), STATE_SIZE));
+}
+
+TEST(TestSerialState, MemoryUsed)
+{
+  const size_t frames = 5 * FRAME_RATE;
+  CStateRecorder recorder(STATE_SIZE), legacyRecorder(STATE_SIZE);
+  CSerialState state;
+  CLegacySerialState legacy(STATE_SIZE, frames);
+  state.Init(STATE_SIZE, frames);
+
+  for (size_t i = 0; i < frames; i++)
+  {
+    memcpy(legacy.GetNextState(), legacyRecorder.NextFrame(), STATE_SIZE);
+    legacy.AdvanceFrame();
+    memcpy(state.GetNextState(), recorder.NextFrame(), STATE_SIZE);
+    state.AdvanceFrame();
+  }
+  EXPECT_LT(state.GetBufferUsed(), legacy.GetMemoryUsed());
+}
+
+TEST(TestSerialState, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  const size_t frames = 60 * FRAME_RATE; // a minute of gameplay
+  CStateRecorder recorder(STATE_SIZE), legacyRecorder(STATE_SIZE);
+  CSerialState state;
+  CLegacySerialState legacy(STATE_SIZE, frames);
+  state.Init(STATE_SIZE, frames);
+
+  int64_t start = CurrentHostCounter();
+  for (size_t i = 0; i < frames; i++)
+  {
+    memcpy(legacy.GetNextState(), legacyRecorder.NextFrame(), STATE_SIZE);
+    legacy.AdvanceFrame();
+  }
+  double legacyAdvance = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (size_t i = 0; i < frames; i++)
+  {
+    memcpy(state.GetNextState(), recorder.NextFrame(), STATE_SIZE);
+    state.AdvanceFrame();
+  }
+  double advance = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(frames, state.GetFramesAvailable());
+
+  size_t legacyMemory = legacy.GetMemoryUsed();
+  size_t memory = state.GetBufferUsed();
+
+  start = CurrentHostCounter();
+  legacy.RewindFrames(frames);
+  double legacyRewind = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  EXPECT_EQ(frames, state.RewindFrames(frames));
+  double rewind = CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << frames << " frames of " << STATE_SIZE << " bytes" << std::endl
+            << "  deque of delta pairs: " << legacyMemory / 1024 << "KB, "
+            << legacyAdvance * 1000.0 / frames << "us per frame, "
+            << legacyRewind * 1000.0 / frames << "us per rewound frame" << std::endl
+            << "  run length arena:     " << memory / 1024 << "KB, "
+            << advance * 1000.0 / frames << "us per frame, "
+            << rewind * 1000.0 / frames << "us per rewound frame" << std::endl;
+}
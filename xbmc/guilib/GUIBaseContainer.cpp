@@ -157,10 +157,7 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
   if (focused)
   {
     if (!item->GetFocusedLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_focusedLayout);
-      item->SetFocusedLayout(layout);
-    }
+      item->SetFocusedLayout(m_layoutPool.Get(*m_focusedLayout));
     if (item->GetFocusedLayout())
     {
       if (item != m_lastItem || !HasFocus())
@@ -184,11 +181,9 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
     if (item->GetFocusedLayout())
       item->GetFocusedLayout()->SetFocusedItem(0);  // focus is not set
     if (!item->GetLayout())
-    {
-      CGUIListItemLayout *layout = new CGUIListItemLayout(*m_layout);
-      item->SetLayout(layout);
-    }
-    if (item->GetFocusedLayout())
+      item->SetLayout(m_layoutPool.Get(*m_layout));
+    // the focused layout is only rendered until it has animated out of focus
+    if (item->GetFocusedLayout() && item->GetFocusedLayout()->IsAnimating(ANIM_TYPE_UNFOCUS))
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     if (item->GetLayout())
       item->GetLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
@@ -812,6 +807,7 @@ void CGUIBaseContainer::FreeResources(bool immediately)
   { // free any static content
     Reset();
   }
+  m_layoutPool.Clear();
   m_scroller.Stop();
 }
 
@@ -820,7 +816,7 @@ void CGUIBaseContainer::UpdateLayout(bool updateAllItems)
   if (updateAllItems)
   { // free memory of items
     for (iItems it = m_items.begin(); it != m_items.end(); it++)
-      (*it)->FreeMemory();
+      ReleaseLayouts(it->get());
   }
   // and recalculate the layout
   CalculateLayout();
@@ -1086,17 +1082,42 @@ void CGUIBaseContainer::FreeMemory(int keepStart, int keepEnd)
   if (keepStart < keepEnd)
   { // remove before keepStart and after keepEnd
     for (int i = 0; i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      ReleaseLayouts(m_items[i].get());
     for (int i = std::max(keepEnd + 1, 0); i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      ReleaseLayouts(m_items[i].get());
   }
   else
   { // wrapping
     for (int i = std::max(keepEnd + 1, 0); i < keepStart && i < (int)m_items.size(); ++i)
-      m_items[i]->FreeMemory();
+      ReleaseLayouts(m_items[i].get());
   }
 }
 
+void CGUIBaseContainer::ReleaseLayouts(CGUIListItem *item)
+{
+  // layouts copied from ours are kept for the items scrolling into view
+  if (item->GetLayout() && IsItemLayout(item->GetLayout()->GetSource()))
+    m_layoutPool.Release(item->ReleaseLayout());
+  if (item->GetFocusedLayout() && IsItemLayout(item->GetFocusedLayout()->GetSource()))
+    m_layoutPool.Release(item->ReleaseFocusedLayout());
+  item->FreeMemory();
+}
+
+bool CGUIBaseContainer::IsItemLayout(const CGUIListItemLayout *layout) const
+{
+  for (vector<CGUIListItemLayout>::const_iterator it = m_layouts.begin(); it != m_layouts.end(); ++it)
+  {
+    if (&*it == layout)
+      return true;
+  }
+  for (vector<CGUIListItemLayout>::const_iterator it = m_focusedLayouts.begin(); it != m_focusedLayouts.end(); ++it)
+  {
+    if (&*it == layout)
+      return true;
+  }
+  return false;
+}
+
 bool CGUIBaseContainer::InsideLayout(const CGUIListItemLayout *layout, const CPoint &point) const
 {
   if (!layout) return false;
@@ -27,6 +27,7 @@
 
 #include "GUIControl.h"
 #include "GUIListItemLayout.h"
+#include "GUIListItemLayoutPool.h"
 #include "boost/shared_ptr.hpp"
 #include "utils/Stopwatch.h"
 
@@ -141,6 +142,8 @@ protected:
   inline float Size() const;
   void MoveToRow(int row);
   void FreeMemory(int keepStart, int keepEnd);
+  void ReleaseLayouts(CGUIListItem *item);
+  bool IsItemLayout(const CGUIListItemLayout *layout) const;
   void GetCurrentLayouts();
   CGUIListItemLayout *GetFocusedLayout() const;
 
@@ -163,6 +166,7 @@ protected:
 
   CGUIListItemLayout *m_layout;
   CGUIListItemLayout *m_focusedLayout;
+  CGUIListItemLayoutPool m_layoutPool;  ///< copies of m_layouts and m_focusedLayouts no item uses
 
   void ScrollToOffset(int offset);
   void SetContainerMoving(int direction);
@@ -55,6 +55,11 @@ void CGUIBorderedImage::Process(unsigned int currentTime, CDirtyRegionList &dirt
   CGUIImage::Process(currentTime, dirtyregions);
 }
 
+bool CGUIBorderedImage::IsStatic() const
+{
+  return CGUIImage::IsStatic() && (!IsVisible() || m_borderImage.IsSettled());
+}
+
 void CGUIBorderedImage::Render()
 {
   if (!m_borderImage.GetFileName().IsEmpty() && m_texture.ReadyToRender())
@@ -38,6 +38,7 @@ public:
   virtual void AllocResources();
   virtual void FreeResources(bool immediately = false);
   virtual void DynamicResourceAlloc(bool bOnOff);
+  virtual bool IsStatic() const;
   
   virtual CRect CalcRenderRegion() const;
 
@@ -19,6 +19,7 @@
  */
 
 #include "GUIColorManager.h"
+#include "GUITextLayoutCache.h"
 #include "filesystem/SpecialProtocol.h"
 #include "addons/Skin.h"
 #include "utils/log.h"
@@ -45,6 +46,8 @@ void CGUIColorManager::Clear()
 void CGUIColorManager::Load(const CStdString &colorFile)
 {
   Clear();
+  // cached layouts hold the colors of the old color map
+  g_textLayoutCache.Clear();
 
   // load the global color map if it exists
   CXBMCTinyXML xmlDoc;
@@ -21,6 +21,7 @@
 #include "GUIControl.h"
 
 #include "GUIInfoManager.h"
+#include "interfaces/info/InfoBool.h"
 #include "utils/log.h"
 #include "LocalizeStrings.h"
 #include "GUIWindowManager.h"
@@ -641,6 +642,14 @@ bool CGUIControl::UpdateColors()
   return m_diffuseColor.Update();
 }
 
+bool CGUIControl::HasStaticConditions() const
+{
+  if (!m_animations.empty() || !m_diffuseColor.IsConstant())
+    return false;
+  unsigned int sources = g_infoManager.GetBoolSources(m_visibleCondition) | g_infoManager.GetBoolSources(m_enableCondition);
+  return !(sources & INFO_SOURCE_POLLED);
+}
+
 void CGUIControl::SetInitialVisibility()
 {
   if (m_visibleCondition)
@@ -232,6 +232,13 @@ public:
   virtual void UpdateInfo(const CGUIListItem *item = NULL) {};
   virtual void SetPushUpdates(bool pushUpdates) { m_pushedUpdates = pushUpdates; };
 
+  /*! \brief Whether processing the control again would change nothing
+   Asked of the controls in list item layouts, which look the same as long as the item they
+   show, their state and their position are unchanged if they are static.
+   \return true if the control is static, false by default
+   */
+  virtual bool IsStatic() const { return false; };
+
   virtual bool IsGroup() const { return false; };
   virtual bool IsContainer() const { return false; };
   virtual bool GetCondition(int condition, int data) const { return false; };
@@ -307,6 +314,11 @@ protected:
   virtual bool CanFocusFromPoint(const CPoint &point) const;
 
   virtual bool UpdateColors();
+  /*! \brief Whether the control has no animations, a constant diffuse colour, and visibility
+   and enable conditions that only change with the list item or a source that is invalidated
+   \sa IsStatic
+   */
+  bool HasStaticConditions() const;
   virtual bool Animate(unsigned int currentTime);
   virtual bool CheckAnimation(ANIMATION_TYPE animType);
   void UpdateStates(ANIMATION_TYPE type, ANIMATION_PROCESS currentProcess, ANIMATION_STATE currentState);
@@ -21,6 +21,7 @@
 #include "GUIFont.h"
 #include "GUIFontTTF.h"
 #include "GraphicContext.h"
+#include "GUITextLayoutCache.h"
 
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
@@ -67,6 +68,7 @@ CGUIFont::CGUIFont(const CStdString& strFontName, uint32_t style, color_t textCo
   m_lineSpacing = lineSpacing;
   m_origHeight = origHeight;
   m_font = font;
+  m_generation = 0;
 
   if (m_font)
     m_font->AddReference();
@@ -74,6 +76,7 @@ CGUIFont::CGUIFont(const CStdString& strFontName, uint32_t style, color_t textCo
 
 CGUIFont::~CGUIFont()
 {
+  g_textLayoutCache.Flush(this);
   if (m_font)
     m_font->RemoveReference();
 }
@@ -301,9 +304,12 @@ void CGUIFont::SetFont(CGUIFontTTFBase *font)
 {
   if (m_font == font)
     return; // no need to update the font if we already have it
+  // text laid out in the old font measures differently
+  g_textLayoutCache.Flush(this);
   if (m_font)
     m_font->RemoveReference();
   m_font = font;
+  m_generation++;
   if (m_font)
     m_font->AddReference();
 }
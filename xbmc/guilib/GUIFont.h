@@ -148,6 +148,9 @@ public:
 
   void SetFont(CGUIFontTTFBase* font);
 
+  /*! \brief Count of the fonts this has been given, so text laid out in an earlier one can be told apart */
+  unsigned int GetGeneration() const { return m_generation; }
+
 protected:
   CStdString m_strFontName;
   uint32_t m_style;
@@ -156,6 +159,7 @@ protected:
   float m_lineSpacing;
   float m_origHeight;
   CGUIFontTTFBase *m_font; // the font object has the size information
+  unsigned int m_generation;
 
 private:
   bool ClippedRegionIsEmpty(float x, float y, float width, uint32_t alignment) const;
@@ -0,0 +1,219 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIFontGlyphCache.h"
+
+#define GLYPH_CACHE_MIN_BUCKETS 64
+
+const unsigned int CGUIFontGlyphCache::INVALID_SLOT;
+unsigned int CGUIFontGlyphCache::m_budget = 0;
+unsigned int CGUIFontGlyphCache::m_usage = 0;
+
+CGUIFontGlyphCache::CGUIFontGlyphCache()
+{
+  m_width = 0;
+  m_lineHeight = 0;
+  m_maxLines = 0;
+  m_currentLine = 0;
+  m_numGlyphs = 0;
+  m_evictions = 0;
+  m_batch = 0;
+  m_buckets.assign(GLYPH_CACHE_MIN_BUCKETS, INVALID_SLOT);
+}
+
+CGUIFontGlyphCache::~CGUIFontGlyphCache()
+{
+  Clear();
+}
+
+void CGUIFontGlyphCache::Reset(unsigned int width, unsigned int lineHeight, unsigned int maxHeight)
+{
+  Clear();
+  m_width = width;
+  m_lineHeight = lineHeight;
+  m_maxLines = lineHeight ? maxHeight / lineHeight : 0;
+}
+
+void CGUIFontGlyphCache::Clear()
+{
+  m_usage -= m_lines.size() * m_width * m_lineHeight;
+  m_lines.clear();
+  m_glyphs.clear();
+  m_slotLines.clear();
+  m_freeSlots.clear();
+  m_buckets.assign(GLYPH_CACHE_MIN_BUCKETS, INVALID_SLOT);
+  m_currentLine = 0;
+  m_numGlyphs = 0;
+}
+
+CGUIFontGlyphCache::Glyph *CGUIFontGlyphCache::Insert(uint32_t key, unsigned int width, unsigned int &x, unsigned int &y, bool &evicted)
+{
+  evicted = false;
+  if (width > m_width)
+    return NULL;
+
+  if (m_lines.empty() || m_lines[m_currentLine].used + width > m_width)
+  {
+    if (!AddLine())
+    {
+      int line = FindEvictableLine();
+      if (line < 0)
+        return NULL;
+      EvictLine(line);
+      evicted = true;
+      m_currentLine = line;
+    }
+  }
+
+  Line &line = m_lines[m_currentLine];
+  x = line.used;
+  y = m_currentLine * m_lineHeight;
+  line.used += width;
+  line.lastUse = m_batch;
+
+  unsigned int slot;
+  if (!m_freeSlots.empty())
+  {
+    slot = m_freeSlots.back();
+    m_freeSlots.pop_back();
+    m_slotLines[slot] = m_currentLine;
+  }
+  else
+  {
+    slot = m_glyphs.size();
+    m_glyphs.push_back(Glyph());
+    m_slotLines.push_back(m_currentLine);
+  }
+  line.slots.push_back(slot);
+
+  Glyph &glyph = m_glyphs[slot];
+  glyph.letterAndStyle = key;
+  m_numGlyphs++;
+  // keep the table at most half full so probe sequences stay short
+  if (m_numGlyphs * 2 > m_buckets.size())
+    Rehash(m_buckets.size() * 2);
+  else
+    AddToHash(slot);
+
+  return &glyph;
+}
+
+bool CGUIFontGlyphCache::AddLine()
+{
+  if (m_lines.size() >= m_maxLines)
+    return false;
+
+  // every font gets at least one line, whatever the others use
+  unsigned int size = m_width * m_lineHeight;
+  if (m_budget && m_usage + size > m_budget && !m_lines.empty())
+    return false;
+
+  Line line;
+  line.used = 0;
+  line.lastUse = m_batch;
+  m_lines.push_back(line);
+  m_currentLine = m_lines.size() - 1;
+  m_usage += size;
+  return true;
+}
+
+int CGUIFontGlyphCache::FindEvictableLine() const
+{
+  // lines used in the current batch may have glyphs waiting to be rendered
+  int oldest = -1;
+  for (unsigned int i = 0; i < m_lines.size(); i++)
+  {
+    if (m_lines[i].lastUse == m_batch)
+      continue;
+    if (oldest < 0 || m_batch - m_lines[i].lastUse > m_batch - m_lines[oldest].lastUse)
+      oldest = i;
+  }
+  return oldest;
+}
+
+void CGUIFontGlyphCache::EvictLine(unsigned int line)
+{
+  Line &evicted = m_lines[line];
+  for (std::vector<unsigned int>::const_iterator it = evicted.slots.begin(); it != evicted.slots.end(); ++it)
+  {
+    RemoveFromHash(*it);
+    m_glyphs[*it].letterAndStyle = INVALID_SLOT;
+    m_freeSlots.push_back(*it);
+  }
+  m_numGlyphs -= evicted.slots.size();
+  evicted.slots.clear();
+  evicted.used = 0;
+  evicted.lastUse = m_batch;
+  m_evictions++;
+}
+
+void CGUIFontGlyphCache::AddToHash(unsigned int slot)
+{
+  unsigned int mask = m_buckets.size() - 1;
+  unsigned int i = Hash(m_glyphs[slot].letterAndStyle) & mask;
+  while (m_buckets[i] != INVALID_SLOT)
+    i = (i + 1) & mask;
+  m_buckets[i] = slot;
+}
+
+void CGUIFontGlyphCache::RemoveFromHash(unsigned int slot)
+{
+  unsigned int mask = m_buckets.size() - 1;
+  unsigned int i = Hash(m_glyphs[slot].letterAndStyle) & mask;
+  while (m_buckets[i] != slot)
+    i = (i + 1) & mask;
+
+  // shift back the entries probing past the removed one, so no lookup stops at the gap
+  for (unsigned int j = (i + 1) & mask; m_buckets[j] != INVALID_SLOT; j = (j + 1) & mask)
+  {
+    unsigned int home = Hash(m_glyphs[m_buckets[j]].letterAndStyle) & mask;
+    if (((j - home) & mask) >= ((j - i) & mask))
+    {
+      m_buckets[i] = m_buckets[j];
+      i = j;
+    }
+  }
+  m_buckets[i] = INVALID_SLOT;
+}
+
+void CGUIFontGlyphCache::Rehash(unsigned int buckets)
+{
+  m_buckets.assign(buckets, INVALID_SLOT);
+  for (unsigned int slot = 0; slot < m_glyphs.size(); slot++)
+  {
+    if (m_glyphs[slot].letterAndStyle != INVALID_SLOT)
+      AddToHash(slot);
+  }
+}
+
+void CGUIFontGlyphCache::SetBudget(unsigned int bytes)
+{
+  m_budget = bytes;
+}
+
+unsigned int CGUIFontGlyphCache::GetBudget()
+{
+  return m_budget;
+}
+
+unsigned int CGUIFontGlyphCache::GetUsage()
+{
+  return m_usage;
+}
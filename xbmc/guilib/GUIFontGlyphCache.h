@@ -0,0 +1,150 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+#include <deque>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Glyph lookup and texture space management for a font's glyph texture
+
+ Glyphs are kept in a hash table keyed by letter and style, and packed into lines of the
+ texture that are each as high as the font's cells. The texture grows a line at a time
+ while the memory used by the glyph textures of all fonts stays within a shared budget.
+ Once it can't grow any more, the least recently used line is evicted and reused, unless
+ it was used since the last call to BeginBatch() as its glyphs may still be pending render.
+
+ Only the budget is shared, each font keeps a texture of its own: fonts bind their texture
+ in Begin() and scale texture coordinates by its size when queueing vertices, and their
+ lines are as high as their cells. Glyphs are rasterised when first measured or drawn, as
+ layout needs their advance right away and FreeType faces can't be used from two threads.
+ */
+class CGUIFontGlyphCache
+{
+public:
+  struct Glyph
+  {
+    short offsetX, offsetY;
+    float left, top, right, bottom;
+    float advance;
+    uint32_t letterAndStyle;
+  };
+
+  CGUIFontGlyphCache();
+  ~CGUIFontGlyphCache();
+
+  /*! \brief Remove all glyphs and set the texture geometry
+   \param width width of the texture
+   \param lineHeight height of each line of glyphs in the texture
+   \param maxHeight maximal height of the texture
+   */
+  void Reset(unsigned int width, unsigned int lineHeight, unsigned int maxHeight);
+
+  /*! \brief Remove all glyphs and release the texture space */
+  void Clear();
+
+  /*! \brief Find a cached glyph, marking its line as used
+   \param key letter and style of the glyph
+   \return the glyph, NULL if not cached
+   */
+  inline Glyph *Find(uint32_t key)
+  {
+    unsigned int mask = m_buckets.size() - 1;
+    for (unsigned int i = Hash(key) & mask; m_buckets[i] != INVALID_SLOT; i = (i + 1) & mask)
+    {
+      Glyph &glyph = m_glyphs[m_buckets[i]];
+      if (glyph.letterAndStyle == key)
+      {
+        m_lines[m_slotLines[m_buckets[i]]].lastUse = m_batch;
+        return &glyph;
+      }
+    }
+    return NULL;
+  }
+
+  /*! \brief Make space for a new glyph
+   \param key letter and style of the glyph
+   \param width width the glyph takes up in the texture
+   \param x [out] horizontal position of the glyph in the texture
+   \param y [out] vertical position of the glyph in the texture, the top of its line
+   \param evicted [out] true if the line at y was evicted and has to be cleared
+   \return the glyph to fill in, NULL if there is no space. Glyphs returned before
+           may have been evicted if evicted is true.
+   */
+  Glyph *Insert(uint32_t key, unsigned int width, unsigned int &x, unsigned int &y, bool &evicted);
+
+  /*! \brief Start a new batch of glyphs to render, lines used before may be evicted again */
+  void BeginBatch() { m_batch++; }
+
+  /*! \brief Height of the texture that holds all the lines in use */
+  unsigned int GetHeight() const { return m_lines.size() * m_lineHeight; }
+
+  unsigned int GetNumGlyphs() const { return m_numGlyphs; }
+  unsigned int GetNumEvictions() const { return m_evictions; }
+
+  /*! \brief Set the memory shared by the glyph textures of all fonts
+   \param bytes size of the budget, 0 for no limit
+   */
+  static void SetBudget(unsigned int bytes);
+  static unsigned int GetBudget();
+  static unsigned int GetUsage();
+
+private:
+  static const unsigned int INVALID_SLOT = 0xffffffff;
+
+  struct Line
+  {
+    unsigned int used;      ///< horizontal space taken up
+    unsigned int lastUse;   ///< batch the line was last used in
+    std::vector<unsigned int> slots;
+  };
+
+  static inline unsigned int Hash(uint32_t key)
+  {
+    return (key * 2654435761u) >> 8;
+  }
+  bool AddLine();
+  int FindEvictableLine() const;
+  void EvictLine(unsigned int line);
+  void AddToHash(unsigned int slot);
+  void RemoveFromHash(unsigned int slot);
+  void Rehash(unsigned int buckets);
+
+  std::deque<Glyph> m_glyphs;              ///< glyph slots, a deque so glyphs never move
+  std::vector<unsigned int> m_slotLines;   ///< line of each slot
+  std::vector<unsigned int> m_freeSlots;
+  std::vector<unsigned int> m_buckets;     ///< open addressed hash table of slots
+  std::vector<Line> m_lines;
+  unsigned int m_currentLine;
+  unsigned int m_numGlyphs;
+  unsigned int m_evictions;
+  unsigned int m_batch;
+
+  unsigned int m_width;
+  unsigned int m_lineHeight;
+  unsigned int m_maxLines;
+
+  static unsigned int m_budget;
+  static unsigned int m_usage;
+};
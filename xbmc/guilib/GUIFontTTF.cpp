@@ -27,6 +27,7 @@
 #include "utils/MathUtils.h"
 #include "utils/log.h"
 #include "windowing/WindowingFactory.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/GUISettings.h"
 
 #include <math.h>
@@ -48,7 +49,6 @@ using namespace std;
 
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
-#define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -135,8 +135,6 @@ XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
-  m_char = NULL;
-  m_maxChars = 0;
   m_nestedBeginCount = 0;
 
   m_bTextureLoaded = false;
@@ -145,13 +143,10 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 
   m_face = NULL;
   m_stroker = NULL;
-  memset(m_charquick, 0, sizeof(m_charquick));
   m_strFileName = strFileName;
   m_referenceCount = 0;
   m_originX = m_originY = 0.0f;
   m_cellBaseLine = m_cellHeight = 0;
-  m_numChars = 0;
-  m_posX = m_posY = 0;
   m_textureHeight = m_textureWidth = 0;
   m_textureScaleX = m_textureScaleY = 0.0;
   m_ellipsesWidth = m_height = 0.0f;
@@ -186,14 +181,8 @@ void CGUIFontTTFBase::ClearCharacterCache()
   DeleteHardwareTexture();
 
   m_texture = NULL;
-  delete[] m_char;
-  m_char = new Character[CHAR_CHUNK];
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_numChars = 0;
-  m_maxChars = CHAR_CHUNK;
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  m_glyphs.Reset(m_textureWidth, GetTextureLineHeight(), g_Windowing.GetMaxTextureSize());
   m_textureHeight = 0;
 }
 
@@ -201,13 +190,7 @@ void CGUIFontTTFBase::Clear()
 {
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  memset(m_charquick, 0, sizeof(m_charquick));
-  m_char = NULL;
-  m_maxChars = 0;
-  m_numChars = 0;
-  m_posX = 0;
-  m_posY = 0;
+  m_glyphs.Clear();
   m_nestedBeginCount = 0;
 
   if (m_face)
@@ -282,11 +265,6 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
 
   delete(m_texture);
   m_texture = NULL;
-  delete[] m_char;
-  m_char = NULL;
-
-  m_maxChars = 0;
-  m_numChars = 0;
 
   m_strFilename = strFilename;
 
@@ -298,9 +276,9 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   if (m_textureWidth > g_Windowing.GetMaxTextureSize())
     m_textureWidth = g_Windowing.GetMaxTextureSize();
 
-  // set the posX and posY so that our texture will be created on first character write.
-  m_posX = m_textureWidth;
-  m_posY = -(int)GetTextureLineHeight();
+  // our texture will be created on first character write.
+  CGUIFontGlyphCache::SetBudget(g_advancedSettings.m_guiFontCacheSize * 1024);
+  m_glyphs.Reset(m_textureWidth, GetTextureLineHeight(), g_Windowing.GetMaxTextureSize());
 
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
@@ -473,61 +451,25 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (letter == L'\r')
     return NULL;
 
-  // quick access to ascii chars
-  if (letter < 255)
-  {
-    character_t ch = (style << 8) | letter;
-    if (m_charquick[ch])
-      return m_charquick[ch];
-  }
-
   // letters are stored based on style and letter
   character_t ch = (style << 16) | letter;
 
-  int low = 0;
-  int high = m_numChars - 1;
-  int mid;
-  while (low <= high)
-  {
-    mid = (low + high) >> 1;
-    if (ch > m_char[mid].letterAndStyle)
-      low = mid + 1;
-    else if (ch < m_char[mid].letterAndStyle)
-      high = mid - 1;
-    else
-      return &m_char[mid];
-  }
-  // if we get to here, then low is where we should insert the new character
+  Character *character = m_glyphs.Find(ch);
+  if (character)
+    return character;
 
-  // increase the size of the buffer if we need it
-  if (m_numChars >= m_maxChars)
-  { // need to increase the size of the buffer
-    Character *newTable = new Character[m_maxChars + CHAR_CHUNK];
-    if (m_char)
-    {
-      memcpy(newTable, m_char, low * sizeof(Character));
-      memcpy(newTable + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-      delete[] m_char;
-    }
-    m_char = newTable;
-    m_maxChars += CHAR_CHUNK;
-
-  }
-  else
-  { // just move the data along as necessary
-    memmove(m_char + low + 1, m_char + low, (m_numChars - low) * sizeof(Character));
-  }
   // render the character to our texture
   // must End() as we can't render text to our texture during a Begin(), End() block
   unsigned int nestedBeginCount = m_nestedBeginCount;
   m_nestedBeginCount = 1;
   if (nestedBeginCount) End();
-  if (!CacheCharacter(letter, style, m_char + low))
+  character = CacheCharacter(letter, style);
+  if (!character)
   { // unable to cache character - try clearing them all out and starting over
-    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %i characters", m_numChars);
+    CLog::Log(LOGDEBUG, "GUIFontTTF::GetCharacter: Unable to cache character.  Clearing character cache of %u characters", m_glyphs.GetNumGlyphs());
     ClearCharacterCache();
-    low = 0;
-    if (!CacheCharacter(letter, style, m_char + low))
+    character = CacheCharacter(letter, style);
+    if (!character)
     {
       CLog::Log(LOGERROR, "GUIFontTTF::GetCharacter: Unable to cache character (out of memory?)");
       if (nestedBeginCount) Begin();
@@ -538,21 +480,11 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
   if (nestedBeginCount) Begin();
   m_nestedBeginCount = nestedBeginCount;
 
-  // fixup quick access
-  memset(m_charquick, 0, sizeof(m_charquick));
-  for(int i=0;i<m_numChars;i++)
-  {
-    if ((m_char[i].letterAndStyle & 0xffff) < 255)
-    {
-      character_t ch = ((m_char[i].letterAndStyle & 0xffff0000) >> 8) | (m_char[i].letterAndStyle & 0xff);
-      m_charquick[ch] = m_char+i;
-    }
-  }
-
-  return m_char + low;
+  // mark the character as used by the batch we're now in
+  return m_glyphs.Find(ch);
 }
 
-bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
+CGUIFontTTFBase::Character* CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style)
 {
   int glyph_index = FT_Get_Char_Index( m_face, letter );
 
@@ -560,7 +492,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
-    return false;
+    return NULL;
   }
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
@@ -572,7 +504,7 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Get_Glyph(m_face->glyph, &glyph))
   {
     CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
-    return false;
+    return NULL;
   }
   if (m_stroker)
     FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
@@ -580,73 +512,70 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
   {
     CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    return NULL;
   }
   FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
   FT_Bitmap bitmap = bitGlyph->bitmap;
-  if (bitGlyph->left < 0)
-    m_posX += -bitGlyph->left;
-
-  // check we have enough room for the character
-  if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
-  { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
-    m_posX = 0;
-    m_posY += GetTextureLineHeight();
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
-
-    if(m_posY + GetTextureLineHeight() >= m_textureHeight)
-    {
-      // create the new larger texture
-      unsigned int newHeight = m_posY + GetTextureLineHeight();
-      // check for max height
-      if (newHeight > g_Windowing.GetMaxTextureSize())
-      {
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: New cache texture is too large (%u > %u pixels long)", newHeight, g_Windowing.GetMaxTextureSize());
-        FT_Done_Glyph(glyph);
-        return false;
-      }
+  int advance = MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
 
-      CBaseTexture* newTexture = NULL;
-      newTexture = ReallocTexture(newHeight);
-      if(newTexture == NULL)
-      {
-        FT_Done_Glyph(glyph);
-        CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
-        return false;
-      }
-      m_texture = newTexture;
+  // the space the character takes up in the texture, including any part left of its origin
+  int originX = max(-bitGlyph->left, 0);
+  unsigned int width = originX + max(bitGlyph->left + (int)bitmap.width, advance) + spacing_between_characters_in_texture;
+
+  unsigned int posX, posY;
+  bool evicted;
+  Character *ch = m_glyphs.Insert((style << 16) | letter, width, posX, posY, evicted);
+  if (!ch)
+  {
+    CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: No space left in the cache texture for %u characters", m_glyphs.GetNumGlyphs());
+    FT_Done_Glyph(glyph);
+    return NULL;
+  }
+
+  if (m_glyphs.GetHeight() > m_textureHeight)
+  {
+    // create the new larger texture
+    unsigned int newHeight = m_glyphs.GetHeight();
+    CBaseTexture* newTexture = NULL;
+    newTexture = ReallocTexture(newHeight);
+    if(newTexture == NULL)
+    {
+      FT_Done_Glyph(glyph);
+      CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: Failed to allocate new texture of height %u", newHeight);
+      return NULL;
     }
+    m_texture = newTexture;
   }
 
   if(m_texture == NULL)
   {
     CLog::Log(LOGDEBUG, "GUIFontTTF::CacheCharacter: no texture to cache character to");
-    return false;
+    FT_Done_Glyph(glyph);
+    return NULL;
   }
 
+  if (evicted)
+    ClearTextureLine(posY);
+
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
   ch->offsetX = (short)bitGlyph->left;
   ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
-  ch->left = (float)m_posX + ch->offsetX;
-  ch->top = (float)m_posY + ch->offsetY;
+  ch->left = (float)(posX + originX) + ch->offsetX;
+  ch->top = (float)posY + ch->offsetY;
   ch->right = ch->left + bitmap.width;
   ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->advance = (float)advance;
 
   // we need only render if we actually have some pixels
   if (bitmap.width * bitmap.rows)
   {
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
-    unsigned int x1 = max(m_posX + ch->offsetX, 0);
-    unsigned int y1 = max(m_posY + ch->offsetY, 0);
+    unsigned int x1 = max((int)ch->left, 0);
+    unsigned int y1 = max((int)ch->top, 0);
     unsigned int x2 = min(x1 + bitmap.width, m_textureWidth);
     unsigned int y2 = min(y1 + bitmap.rows, m_textureHeight);
     CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
   }
-  m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
-  m_numChars++;
 
   m_textureScaleX = 1.0f / m_textureWidth;
   m_textureScaleY = 1.0f / m_textureHeight;
@@ -654,7 +583,23 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   // free the glyph
   FT_Done_Glyph(glyph);
 
-  return true;
+  return ch;
+}
+
+void CGUIFontTTFBase::ClearTextureLine(unsigned int y)
+{
+  // blank out the glyphs that were evicted from the line, so that filtering can't
+  // pick up their pixels at the edges of the glyphs replacing them
+  unsigned int height = min(GetTextureLineHeight(), m_textureHeight - y);
+  std::vector<unsigned char> blank(m_textureWidth * height, 0);
+
+  FT_BitmapGlyphRec glyph;
+  memset(&glyph, 0, sizeof(glyph));
+  glyph.bitmap.buffer = &blank[0];
+  glyph.bitmap.width = m_textureWidth;
+  glyph.bitmap.rows = height;
+  glyph.bitmap.pitch = m_textureWidth;
+  CopyCharToTexture(&glyph, 0, y, m_textureWidth, y + height);
 }
 
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
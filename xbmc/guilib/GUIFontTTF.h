@@ -27,6 +27,8 @@
  *
  */
 
+#include "GUIFontGlyphCache.h"
+
 // forward definition
 class CBaseTexture;
 
@@ -83,13 +85,7 @@ public:
   const CStdString& GetFileName() const { return m_strFileName; };
 
 protected:
-  struct Character
-  {
-    short offsetX, offsetY;
-    float left, top, right, bottom;
-    float advance;
-    character_t letterAndStyle;
-  };
+  typedef CGUIFontGlyphCache::Glyph Character;
   void AddReference();
   void RemoveReference();
 
@@ -108,7 +104,8 @@ protected:
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
-  bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  Character *CacheCharacter(wchar_t letter, uint32_t style);
+  void ClearTextureLine(unsigned int y);
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
 
@@ -124,8 +121,6 @@ protected:
 
   unsigned int m_textureWidth;       // width of our texture
   unsigned int m_textureHeight;      // heigth of our texture
-  int m_posX;                        // current position in the texture
-  int m_posY;
 
   /*! \brief the height of each line in the texture.
    Accounts for spacing between lines to avoid characters overlapping.
@@ -135,10 +130,7 @@ protected:
 
   color_t m_color;
 
-  Character *m_char;                 // our characters
-  Character *m_charquick[256*4];     // ascii chars (4 styles) here
-  int m_maxChars;                    // size of character array (can be incremented)
-  int m_numChars;                    // the current number of cached characters
+  CGUIFontGlyphCache m_glyphs;       // our characters and their place in the texture
 
   float m_ellipsesWidth;               // this is used every character (width of '.')
 
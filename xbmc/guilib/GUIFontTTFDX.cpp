@@ -57,6 +57,9 @@ void CGUIFontTTFDX::Begin()
 
   if (m_nestedBeginCount == 0)
   {
+    // glyphs rendered before this batch may be evicted from the texture now
+    m_glyphs.BeginBatch();
+
     int unit = 0;
     // just have to blit from our texture.
     m_texture->BindToUnit(unit);
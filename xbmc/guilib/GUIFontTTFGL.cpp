@@ -54,6 +54,9 @@ void CGUIFontTTFGL::Begin()
 {
   if (m_nestedBeginCount == 0)
   {
+    // glyphs rendered before this batch may be evicted from the texture now
+    m_glyphs.BeginBatch();
+
     if (!m_bTextureLoaded)
     {
       // Have OpenGL generate a texture object handle for us
@@ -77,6 +77,20 @@ void CGUIImage::UpdateInfo(const CGUIListItem *item)
     SetFileName(m_info.GetLabel(m_parentID, true, &m_currentFallback));
 }
 
+bool CGUIImage::IsStatic() const
+{
+  if (!HasStaticConditions())
+    return false;
+  if (!IsVisible())
+    return true; // we're not processed while hidden, so have nothing to load
+  if (!m_fadingTextures.empty())
+    return false;
+  // a failed texture is replaced by the fallback the next time we're processed
+  if (m_texture.FailedToAlloc() && !m_texture.GetFileName().Equals(m_info.GetFallback()))
+    return false;
+  return m_texture.IsSettled();
+}
+
 void CGUIImage::AllocateOnDemand()
 {
   // if we're hidden, we can free our resources and return
@@ -78,6 +78,7 @@ public:
   virtual void SetInvalid();
   virtual bool CanFocus() const;
   virtual void UpdateInfo(const CGUIListItem *item = NULL);
+  virtual bool IsStatic() const;
 
   virtual void SetInfo(const CGUIInfoLabel &info);
   virtual void SetFileName(const CStdString& strFileName, bool setConstant = false);
@@ -50,6 +50,9 @@ public:
   void ResolveIncludes(TiXmlElement *node, std::map<int, bool>* xmlIncludeConditions = NULL);
   const INFO::CSkinVariableString* CreateSkinVariable(const CStdString& name, int context);
 
+  /*! \brief The include files loaded so far, in the order they were loaded */
+  const std::vector<CStdString> &GetFiles() const { return m_files; }
+
 private:
   void ResolveIncludesForNode(TiXmlElement *node, std::map<int, bool>* xmlIncludeConditions = NULL);
   CStdString ResolveConstant(const CStdString &constant) const;
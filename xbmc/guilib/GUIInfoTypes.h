@@ -60,6 +60,7 @@ public:
 
   bool Update();
   void Parse(const CStdString &label, int context);
+  bool IsConstant() const { return !m_info; };
 
 private:
   color_t GetColor() const;
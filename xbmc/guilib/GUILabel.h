@@ -55,6 +55,11 @@ public:
 
     return changed;
   };
+  bool HasConstantColors() const
+  {
+    return textColor.IsConstant() && shadowColor.IsConstant() && selectedColor.IsConstant() &&
+           disabledColor.IsConstant() && focusedColor.IsConstant();
+  };
   
   CGUIInfoColor textColor;
   CGUIInfoColor shadowColor;
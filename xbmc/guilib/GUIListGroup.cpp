@@ -171,6 +171,18 @@ void CGUIListGroup::SetInvalid()
   }
 }
 
+bool CGUIListGroup::IsStatic() const
+{
+  if (!HasStaticConditions())
+    return false;
+  for (ciControls it = m_children.begin(); it != m_children.end(); ++it)
+  {
+    if (!(*it)->IsStatic())
+      return false;
+  }
+  return true;
+}
+
 void CGUIListGroup::SetFocusedItem(unsigned int focus)
 {
   for (iControls it = m_children.begin(); it != m_children.end(); it++)
@@ -46,6 +46,7 @@ public:
   virtual void UpdateVisibility(const CGUIListItem *item = NULL);
   virtual void UpdateInfo(const CGUIListItem *item);
   virtual void SetInvalid();
+  virtual bool IsStatic() const;
 
   void EnlargeWidth(float difference);
   void EnlargeHeight(float difference);
@@ -375,6 +375,13 @@ CGUIListItemLayout *CGUIListItem::GetLayout()
   return m_layout;
 }
 
+CGUIListItemLayout *CGUIListItem::ReleaseLayout()
+{
+  CGUIListItemLayout *layout = m_layout;
+  m_layout = NULL;
+  return layout;
+}
+
 void CGUIListItem::SetFocusedLayout(CGUIListItemLayout *layout)
 {
   delete m_focusedLayout;
@@ -386,6 +393,13 @@ CGUIListItemLayout *CGUIListItem::GetFocusedLayout()
   return m_focusedLayout;
 }
 
+CGUIListItemLayout *CGUIListItem::ReleaseFocusedLayout()
+{
+  CGUIListItemLayout *layout = m_focusedLayout;
+  m_focusedLayout = NULL;
+  return layout;
+}
+
 void CGUIListItem::SetInvalid()
 {
   if (m_layout) m_layout->SetInvalid();
@@ -394,7 +408,15 @@ void CGUIListItem::SetInvalid()
 
 void CGUIListItem::SetProperty(const CStdString &strKey, const CVariant &value)
 {
-  m_mapProperties[strKey] = value;
+  // layouts only update when the item is invalid, as ListItem.Property() is taken from the item
+  PropertyMap::iterator iter = m_mapProperties.find(strKey);
+  if (iter == m_mapProperties.end())
+    m_mapProperties.insert(make_pair(strKey, value));
+  else if (iter->second == value)
+    return;
+  else
+    iter->second = value;
+  SetInvalid();
 }
 
 CVariant CGUIListItem::GetProperty(const CStdString &strKey) const
@@ -419,12 +441,18 @@ void CGUIListItem::ClearProperty(const CStdString &strKey)
 {
   PropertyMap::iterator iter = m_mapProperties.find(strKey);
   if (iter != m_mapProperties.end())
+  {
     m_mapProperties.erase(iter);
+    SetInvalid();
+  }
 }
 
 void CGUIListItem::ClearProperties()
 {
+  if (m_mapProperties.empty())
+    return;
   m_mapProperties.clear();
+  SetInvalid();
 }
 
 void CGUIListItem::IncrementProperty(const CStdString &strKey, int nVal)
@@ -141,9 +141,12 @@ public:
 
   void SetLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetLayout();
+  /*! \brief Take the layout from the item, the caller owns it from then on */
+  CGUIListItemLayout *ReleaseLayout();
 
   void SetFocusedLayout(CGUIListItemLayout *layout);
   CGUIListItemLayout *GetFocusedLayout();
+  CGUIListItemLayout *ReleaseFocusedLayout();
 
   void FreeIcons();
   void FreeMemory(bool immediately = false);
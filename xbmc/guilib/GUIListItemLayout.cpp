@@ -22,6 +22,7 @@
 #include "FileItem.h"
 #include "GUIControlFactory.h"
 #include "GUIInfoManager.h"
+#include "interfaces/info/InfoBool.h"
 #include "GUIListLabel.h"
 #include "GUIImage.h"
 #include "utils/XBMCTinyXML.h"
@@ -36,6 +37,11 @@ CGUIListItemLayout::CGUIListItemLayout()
   m_condition = 0;
   m_focused = false;
   m_invalidated = true;
+  m_source = NULL;
+  m_static = false;
+  m_lastItem = NULL;
+  m_lastSelected = false;
+  m_lastEpoch = 0;
   m_group.SetPushUpdates(true);
 }
 
@@ -47,6 +53,11 @@ CGUIListItemLayout::CGUIListItemLayout(const CGUIListItemLayout &from)
   m_focused = from.m_focused;
   m_condition = from.m_condition;
   m_invalidated = true;
+  m_source = &from;
+  m_static = false;
+  m_lastItem = NULL;
+  m_lastSelected = false;
+  m_lastEpoch = 0;
 }
 
 CGUIListItemLayout::~CGUIListItemLayout()
@@ -70,6 +81,14 @@ float CGUIListItemLayout::Size(ORIENTATION orientation) const
 
 void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
+  // an unfocused item that only shows data of the item looks the same until the item, its
+  // state or its position changes, or the skin settings or library its conditions check do
+  unsigned int epoch = g_infoManager.GetSourcesEpoch(INFO_SOURCE_SKIN | INFO_SOURCE_LIBRARY);
+  const TransformMatrix &transform = g_graphicsContext.GetFinalTransform();
+  if (m_static && !m_invalidated && item == m_lastItem && item->IsSelected() == m_lastSelected &&
+      epoch == m_lastEpoch && transform == m_lastTransform)
+    return;
+
   if (m_invalidated)
   { // need to update our item
     m_invalidated = false;
@@ -87,7 +106,14 @@ void CGUIListItemLayout::Process(CGUIListItem *item, int parentID, unsigned int
   // update visibility, and render
   m_group.SetState(item->IsSelected() || m_isPlaying, m_focused);
   m_group.UpdateVisibility(item);
+  unsigned int dirty = dirtyregions.size();
   m_group.DoProcess(currentTime, dirtyregions);
+
+  m_static = !m_focused && dirtyregions.size() == dirty && m_group.IsStatic();
+  m_lastItem = item;
+  m_lastSelected = item->IsSelected();
+  m_lastEpoch = epoch;
+  m_lastTransform = transform;
 }
 
 void CGUIListItemLayout::Render(CGUIListItem *item, int parentID)
@@ -217,6 +243,7 @@ void CGUIListItemLayout::CreateListControlLayouts(float width, float height, boo
 void CGUIListItemLayout::FreeResources(bool immediately)
 {
   m_group.FreeResources(immediately);
+  m_static = false;
 }
 
 #ifdef _DEBUG
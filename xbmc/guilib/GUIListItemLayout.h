@@ -23,6 +23,7 @@
 #include "GUIListGroup.h"
 #include "GUITexture.h"
 #include "GUIInfoTypes.h"
+#include "TransformMatrix.h"
 
 class CGUIListItem;
 class CFileItem;
@@ -45,6 +46,9 @@ public:
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
 
+  /*! \brief The layout this one was copied from */
+  const CGUIListItemLayout *GetSource() const { return m_source; };
+
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const CStdString &nofocusCondition, const CStdString &focusCondition);
 //#endif
@@ -69,6 +73,14 @@ protected:
   float m_height;
   bool m_focused;
   bool m_invalidated;
+  const CGUIListItemLayout *m_source;
+
+  // what we were last processed with, processing again is skipped while it's unchanged
+  bool m_static;
+  const CGUIListItem *m_lastItem;
+  bool m_lastSelected;
+  unsigned int m_lastEpoch;
+  TransformMatrix m_lastTransform;
 
   unsigned int m_condition;
   CGUIInfoBool m_isPlaying;
@@ -0,0 +1,78 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIListItemLayoutPool.h"
+#include "GUIListItemLayout.h"
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool()
+{
+  m_created = 0;
+  m_reused = 0;
+}
+
+CGUIListItemLayoutPool::CGUIListItemLayoutPool(const CGUIListItemLayoutPool &pool)
+{
+  m_created = 0;
+  m_reused = 0;
+}
+
+CGUIListItemLayoutPool::~CGUIListItemLayoutPool()
+{
+  Clear();
+}
+
+CGUIListItemLayout *CGUIListItemLayoutPool::Get(const CGUIListItemLayout &layout)
+{
+  LayoutMap::iterator i = m_layouts.find(&layout);
+  if (i == m_layouts.end() || i->second.empty())
+  {
+    m_created++;
+    return new CGUIListItemLayout(layout);
+  }
+  CGUIListItemLayout *copy = i->second.back();
+  i->second.pop_back();
+  copy->SetInvalid();
+  m_reused++;
+  return copy;
+}
+
+void CGUIListItemLayoutPool::Release(CGUIListItemLayout *layout)
+{
+  layout->FreeResources();
+  m_layouts[layout->GetSource()].push_back(layout);
+}
+
+void CGUIListItemLayoutPool::Clear()
+{
+  for (LayoutMap::iterator i = m_layouts.begin(); i != m_layouts.end(); ++i)
+  {
+    for (std::vector<CGUIListItemLayout *>::iterator j = i->second.begin(); j != i->second.end(); ++j)
+      delete *j;
+  }
+  m_layouts.clear();
+}
+
+unsigned int CGUIListItemLayoutPool::GetNumPooled() const
+{
+  unsigned int pooled = 0;
+  for (LayoutMap::const_iterator i = m_layouts.begin(); i != m_layouts.end(); ++i)
+    pooled += i->second.size();
+  return pooled;
+}
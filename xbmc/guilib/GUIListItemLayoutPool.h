@@ -0,0 +1,68 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <map>
+#include <vector>
+
+class CGUIListItemLayout;
+
+/*!
+ \ingroup controls
+ \brief Copies of a container's item layouts, recycled as items scroll in and out of view
+
+ Layouts released by items that scrolled out of view are kept per layout they were copied
+ from, and handed to the items scrolling into view instead of copying the layout again.
+ */
+class CGUIListItemLayoutPool
+{
+public:
+  CGUIListItemLayoutPool();
+  CGUIListItemLayoutPool(const CGUIListItemLayoutPool &pool);
+  ~CGUIListItemLayoutPool();
+
+  /*! \brief Get a copy of a layout, reusing a released one if there is one
+   \param layout the layout to copy
+   \return the copy, owned by the caller until released
+   */
+  CGUIListItemLayout *Get(const CGUIListItemLayout &layout);
+
+  /*! \brief Free the resources of a copy and keep it for reuse
+   \param layout a copy returned by Get
+   */
+  void Release(CGUIListItemLayout *layout);
+
+  /*! \brief Delete the released copies */
+  void Clear();
+
+  unsigned int GetNumCreated() const { return m_created; }
+  unsigned int GetNumReused() const { return m_reused; }
+  unsigned int GetNumPooled() const;
+
+private:
+  // copies start out empty, as the layouts in the pool belong to another container
+  const CGUIListItemLayoutPool &operator=(const CGUIListItemLayoutPool &pool);
+
+  typedef std::map<const CGUIListItemLayout *, std::vector<CGUIListItemLayout *> > LayoutMap;
+  LayoutMap m_layouts;
+  unsigned int m_created;
+  unsigned int m_reused;
+};
@@ -81,6 +81,11 @@ void CGUIListLabel::Process(unsigned int currentTime, CDirtyRegionList &dirtyreg
   CGUIControl::Process(currentTime, dirtyregions);
 }
 
+bool CGUIListLabel::IsStatic() const
+{
+  return !m_alwaysScroll && m_label.GetLabelInfo().HasConstantColors() && HasStaticConditions();
+}
+
 void CGUIListLabel::Render()
 {
   m_label.Render();
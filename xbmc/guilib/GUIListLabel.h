@@ -47,6 +47,7 @@ public:
   virtual void SetFocus(bool focus);
   virtual void SetInvalid();
   virtual void SetWidth(float width);
+  virtual bool IsStatic() const;
 
   void SetLabel(const CStdString &label);
   void SetSelected(bool selected);
@@ -111,8 +111,10 @@ void CGUIRSSControl::Process(unsigned int currentTime, CDirtyRegionList &dirtyre
 
 void CGUIRSSControl::Render()
 {
+  static CSettingHandle settingEnableRSS("lookandfeel.enablerssfeeds");
+
   // only render the control if they are enabled
-  if (g_guiSettings.GetBool("lookandfeel.enablerssfeeds") && CRssManager::Get().IsActive())
+  if (g_guiSettings.GetBool(settingEnableRSS) && CRssManager::Get().IsActive())
   {
     CSingleLock lock(m_criticalSection);
     // Create RSS background/worker thread if needed
@@ -122,7 +122,7 @@ void CGUITextBox::DoProcess(unsigned int currentTime, CDirtyRegionList &dirtyreg
 void CGUITextBox::Process(unsigned int currentTime, CDirtyRegionList &dirtyregions)
 {
   // update our auto-scrolling as necessary
-  if (m_autoScrollTime && m_lines.size() > m_itemsPerPage)
+  if (m_autoScrollTime && m_layout->m_lines.size() > m_itemsPerPage)
   {
     if (!m_autoScrollCondition || g_infoManager.GetBoolValue(m_autoScrollCondition))
     {
@@ -131,7 +131,7 @@ void CGUITextBox::Process(unsigned int currentTime, CDirtyRegionList &dirtyregio
       if (m_autoScrollDelayTime > (unsigned int)m_autoScrollDelay && m_scrollSpeed == 0)
       { // delay is finished - start scrolling
         MarkDirtyRegion();
-        if (m_offset < (int)m_lines.size() - m_itemsPerPage)
+        if (m_offset < (int)m_layout->m_lines.size() - m_itemsPerPage)
           ScrollToOffset(m_offset + 1, true);
         else
         { // at the end, run a delay and restart
@@ -214,12 +214,12 @@ void CGUITextBox::Render()
     {
       m_font->Begin();
       int current = offset;
-      while (posY < m_posY + m_height && current < (int)m_lines.size())
+      while (posY < m_posY + m_height && current < (int)m_layout->m_lines.size())
       {
         uint32_t align = m_label.align;
-        if (m_lines[current].m_text.size() && m_lines[current].m_carriageReturn)
+        if (m_layout->m_lines[current].m_text.size() && m_layout->m_lines[current].m_carriageReturn)
           align &= ~XBFONT_JUSTIFIED; // last line of a paragraph shouldn't be justified
-        m_font->DrawText(posX, posY + 2, m_colors, m_label.shadowColor, m_lines[current].m_text, align, m_width);
+        m_font->DrawText(posX, posY + 2, m_colors, m_label.shadowColor, m_layout->m_lines[current].m_text, align, m_width);
         posY += m_itemHeight;
         current++;
       }
@@ -254,7 +254,7 @@ bool CGUITextBox::OnMessage(CGUIMessage& message)
       CGUITextLayout::Reset();
       if (m_pageControl)
       {
-        CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), m_pageControl, m_itemsPerPage, m_lines.size());
+        CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), m_pageControl, m_itemsPerPage, m_layout->m_lines.size());
         SendWindowMessage(msg);
       }
     }
@@ -276,7 +276,7 @@ void CGUITextBox::UpdatePageControl()
 {
   if (m_pageControl)
   {
-    CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), m_pageControl, m_itemsPerPage, m_lines.size());
+    CGUIMessage msg(GUI_MSG_LABEL_RESET, GetID(), m_pageControl, m_itemsPerPage, m_layout->m_lines.size());
     SendWindowMessage(msg);
   }
 }
@@ -299,10 +299,10 @@ void CGUITextBox::SetInfo(const CGUIInfoLabel &infoLabel)
 void CGUITextBox::Scroll(unsigned int offset)
 {
   ResetAutoScrolling();
-  if (m_lines.size() <= m_itemsPerPage)
+  if (m_layout->m_lines.size() <= m_itemsPerPage)
     return; // no need to scroll
-  if (offset > m_lines.size() - m_itemsPerPage)
-    offset = m_lines.size() - m_itemsPerPage; // on last page
+  if (offset > m_layout->m_lines.size() - m_itemsPerPage)
+    offset = m_layout->m_lines.size() - m_itemsPerPage; // on last page
   ScrollToOffset(offset);
 }
 
@@ -339,7 +339,7 @@ void CGUITextBox::ResetAutoScrolling()
 
 unsigned int CGUITextBox::GetRows() const
 {
-  return m_lines.size();
+  return m_layout->m_lines.size();
 }
 
 int CGUITextBox::GetCurrentPage() const
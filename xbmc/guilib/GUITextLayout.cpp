@@ -22,6 +22,7 @@
 #include "GUIFont.h"
 #include "GUIControl.h"
 #include "GUIColorManager.h"
+#include "GUITextLayoutCache.h"
 #include "utils/CharsetConverter.h"
 #include "utils/StringUtils.h"
 
@@ -43,6 +44,45 @@ CStdString CGUIString::GetAsString() const
   return text;
 }
 
+CGUITextRun::CGUITextRun(unsigned int next, unsigned int depends)
+{
+  m_next = next;
+  m_depends = depends;
+  m_width = -1;
+}
+
+CGUITextLayoutParams::CGUITextLayoutParams()
+{
+  m_font = NULL;
+  m_fontGeneration = 0;
+  m_style = 0;
+  m_scaleX = 0;
+  m_scaleY = 0;
+  m_maxWidth = 0;
+  m_maxLines = -1;
+  m_forceLTR = false;
+}
+
+bool CGUITextLayoutParams::operator==(const CGUITextLayoutParams &right) const
+{
+  return m_font == right.m_font && m_fontGeneration == right.m_fontGeneration && m_style == right.m_style &&
+         m_scaleX == right.m_scaleX && m_scaleY == right.m_scaleY &&
+         m_maxWidth == right.m_maxWidth && m_maxLines == right.m_maxLines &&
+         m_forceLTR == right.m_forceLTR;
+}
+
+bool CGUITextLayoutParams::operator<(const CGUITextLayoutParams &right) const
+{
+  if (m_font != right.m_font) return m_font < right.m_font;
+  if (m_fontGeneration != right.m_fontGeneration) return m_fontGeneration < right.m_fontGeneration;
+  if (m_style != right.m_style) return m_style < right.m_style;
+  if (m_scaleX != right.m_scaleX) return m_scaleX < right.m_scaleX;
+  if (m_scaleY != right.m_scaleY) return m_scaleY < right.m_scaleY;
+  if (m_maxWidth != right.m_maxWidth) return m_maxWidth < right.m_maxWidth;
+  if (m_maxLines != right.m_maxLines) return m_maxLines < right.m_maxLines;
+  return m_forceLTR < right.m_forceLTR;
+}
+
 CGUITextLayout::CGUITextLayout(CGUIFont *font, bool wrap, float fHeight, CGUIFont *borderFont)
 {
   m_font = font;
@@ -52,6 +92,7 @@ CGUITextLayout::CGUITextLayout(CGUIFont *font, bool wrap, float fHeight, CGUIFon
   m_maxHeight = fHeight;
   m_textWidth = 0;
   m_textHeight = 0;
+  m_layout.reset(new CGUITextLines);
 }
 
 void CGUITextLayout::SetWrap(bool bWrap)
@@ -77,11 +118,11 @@ void CGUITextLayout::Render(float x, float y, float angle, color_t color, color_
   // center our text vertically
   if (alignment & XBFONT_CENTER_Y)
   {
-    y -= m_font->GetTextHeight(m_lines.size()) * 0.5f;;
+    y -= m_font->GetTextHeight(m_layout->m_lines.size()) * 0.5f;;
     alignment &= ~XBFONT_CENTER_Y;
   }
   m_font->Begin();
-  for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  for (vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); i++)
   {
     const CGUIString &string = *i;
     uint32_t align = alignment;
@@ -117,7 +158,7 @@ void CGUITextLayout::RenderScrolling(float x, float y, float angle, color_t colo
   // center our text vertically
   if (alignment & XBFONT_CENTER_Y)
   {
-    y -= m_font->GetTextHeight(m_lines.size()) * 0.5f;;
+    y -= m_font->GetTextHeight(m_layout->m_lines.size()) * 0.5f;;
     alignment &= ~XBFONT_CENTER_Y;
   }
   m_font->Begin();
@@ -128,7 +169,7 @@ void CGUITextLayout::RenderScrolling(float x, float y, float angle, color_t colo
   //       jumpy with this sort of thing.  It's not exactly a well used situation
   //       though, so this hack is probably OK.
   float speed = scrollInfo.pixelSpeed;
-  for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  for (vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); i++)
   {
     const CGUIString &string = *i;
     m_font->DrawScrollingText(x, y, m_colors, shadowColor, string.m_text, alignment, maxWidth, scrollInfo);
@@ -154,7 +195,7 @@ void CGUITextLayout::RenderOutline(float x, float y, color_t color, color_t outl
   // center our text vertically
   if (alignment & XBFONT_CENTER_Y)
   {
-    y -= m_font->GetTextHeight(m_lines.size()) * 0.5f;;
+    y -= m_font->GetTextHeight(m_layout->m_lines.size()) * 0.5f;;
     alignment &= ~XBFONT_CENTER_Y;
   }
   if (m_borderFont)
@@ -162,7 +203,7 @@ void CGUITextLayout::RenderOutline(float x, float y, color_t color, color_t outl
     // adjust so the baselines of the fonts align
     float by = y + m_font->GetTextBaseLine() - m_borderFont->GetTextBaseLine();
     m_borderFont->Begin();
-    for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+    for (vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); i++)
     {
       const CGUIString &string = *i;
       uint32_t align = alignment;
@@ -194,7 +235,7 @@ void CGUITextLayout::RenderOutline(float x, float y, color_t color, color_t outl
     m_colors[0] = color;
 
   m_font->Begin();
-  for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  for (vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); i++)
   {
     const CGUIString &string = *i;
     uint32_t align = alignment;
@@ -223,42 +264,103 @@ bool CGUITextLayout::UpdateW(const CStdStringW &text, float maxWidth /*= 0*/, bo
   if (text.Equals(m_lastText) && !forceUpdate)
     return false;
 
-  vecText parsedText;
+  // the same text may have been laid out by another label using this font
+  CGUITextLayoutParams params = GetLayoutParams(maxWidth, forceLTRReadingOrder);
+  CGUITextLinesPtr cached = g_textLayoutCache.Get(params, text);
+  if (cached)
+  {
+    m_layout = cached;
+    m_colors = cached->m_colors;
+    m_colors[0] = m_textColor;
+    m_textWidth = cached->m_width;
+    m_textHeight = cached->m_height;
+    m_params = params;
+    m_lastText = text;
+    return true;
+  }
+
+  // our previous layout may be shared, so we lay out into a new one
+  boost::shared_ptr<CGUITextLines> layout(new CGUITextLines);
 
-  // empty out our previous string
-  m_lines.clear();
+  // empty out our previous colors
   m_colors.clear();
   m_colors.push_back(m_textColor);
 
   // parse the text into our string objects
-  ParseText(text, parsedText);
+  ParseText(text, layout->m_parsedText);
 
   // add \n to the end of the string
-  parsedText.push_back(L'\n');
+  layout->m_parsedText.push_back(L'\n');
+
+  // keep the lines that depend only on the part of the text that hasn't changed,
+  // so that a changed or appended suffix is all we lay out again. Lines laid out
+  // in another font, or before the font was given new glyphs, are all laid out again.
+  unsigned int keep = 0;
+  if (params == m_params)
+  {
+    const vecText &parsedText = layout->m_parsedText;
+    size_t common = 0;
+    size_t length = std::min(parsedText.size(), m_layout->m_parsedText.size());
+    while (common < length && parsedText[common] == m_layout->m_parsedText[common])
+      common++;
+    while (keep < m_layout->m_runs.size() && m_layout->m_runs[keep].m_depends <= common)
+      keep++;
+  }
+  layout->m_lines.assign(m_layout->m_lines.begin(), m_layout->m_lines.begin() + keep);
+  layout->m_runs.assign(m_layout->m_runs.begin(), m_layout->m_runs.begin() + keep);
+  unsigned int start = keep ? layout->m_runs[keep - 1].m_next : 0;
 
   // if we need to wrap the text, then do so
-  if (m_wrap && maxWidth > 0)
-    WrapText(parsedText, maxWidth);
+  if (params.m_maxWidth > 0)
+    WrapText(layout->m_parsedText, start, params.m_maxWidth, *layout);
   else
-    LineBreakText(parsedText, m_lines);
+    LineBreakText(layout->m_parsedText, start, *layout);
 
   // remove any trailing blank lines
-  while (!m_lines.empty() && m_lines.back().m_text.empty())
-    m_lines.pop_back();
+  while (!layout->m_lines.empty() && layout->m_lines.back().m_text.empty())
+  {
+    layout->m_lines.pop_back();
+    layout->m_runs.pop_back();
+  }
+  keep = std::min<unsigned int>(keep, layout->m_lines.size());
 
-  BidiTransform(m_lines, forceLTRReadingOrder);
+  BidiTransform(layout->m_lines, forceLTRReadingOrder, keep);
 
   // and cache the width and height for later reading
-  CalcTextExtent();
+  CalcTextExtent(*layout);
 
+  layout->m_colors = m_colors;
+  m_layout = layout;
+  m_params = params;
   m_lastText = text;
+
+  g_textLayoutCache.Add(params, text, m_layout);
   return true;
 }
 
+CGUITextLayoutParams CGUITextLayout::GetLayoutParams(float maxWidth, bool forceLTRReadingOrder) const
+{
+  CGUITextLayoutParams params;
+  params.m_font = m_font;
+  params.m_fontGeneration = m_font ? m_font->GetGeneration() : 0;
+  params.m_style = m_font ? m_font->GetStyle() : 0;
+  params.m_scaleX = g_graphicsContext.GetGUIScaleX();
+  params.m_scaleY = g_graphicsContext.GetGUIScaleY();
+  params.m_maxWidth = (m_wrap && maxWidth > 0) ? maxWidth : 0;
+  params.m_maxLines = GetMaxLines();
+  params.m_forceLTR = forceLTRReadingOrder;
+  return params;
+}
+
+int CGUITextLayout::GetMaxLines() const
+{
+  return (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
+}
+
 // BidiTransform is used to handle RTL text flipping in the string
-void CGUITextLayout::BidiTransform(vector<CGUIString> &lines, bool forceLTRReadingOrder)
+void CGUITextLayout::BidiTransform(vector<CGUIString> &lines, bool forceLTRReadingOrder, unsigned int start /*= 0*/)
 {
-  for (unsigned int i=0; i<lines.size(); i++)
+  for (unsigned int i=start; i<lines.size(); i++)
   {
     CGUIString &line = lines[i];
 
@@ -450,49 +552,54 @@ void CGUITextLayout::SetMaxHeight(float fHeight)
   m_maxHeight = fHeight;
 }
 
-void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
+void CGUITextLayout::WrapText(const vecText &text, unsigned int start, float maxWidth, CGUITextLines &lines)
 {
   if (!m_font)
     return;
 
-  int nMaxLines = (m_maxHeight > 0 && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
-
-  m_lines.clear();
-
-  vector<CGUIString> lines;
-  LineBreakText(text, lines);
+  int nMaxLines = GetMaxLines();
 
-  for (unsigned int i = 0; i < lines.size(); i++)
+  unsigned int lineStart = start;
+  while (lineStart < text.size() && (nMaxLines <= 0 || lines.m_lines.size() < (size_t)nMaxLines))
   {
-    const CGUIString &line = lines[i];
-    vecText::const_iterator lastSpace = line.m_text.begin();
-    vecText::const_iterator pos = line.m_text.begin();
+    // find the end of this line of text
+    unsigned int lineEnd = lineStart;
+    while (lineEnd < text.size() && (text[lineEnd] & 0xffff) != L'\n')
+      lineEnd++;
+    if (lineEnd == text.size())
+      return;
+
+    unsigned int curStart = lineStart;
+    unsigned int lastSpace = lineStart;
     unsigned int lastSpaceInLine = 0;
+    unsigned int pos = lineStart;
     vecText curLine;
-    while (pos != line.m_text.end())
+    while (pos != lineEnd)
     {
       // Get the current letter in the string
-      character_t letter = *pos;
+      character_t letter = text[pos];
       // check for a space
       if (CanWrapAtLetter(letter))
       {
         float width = m_font->GetTextWidth(curLine);
         if (width > maxWidth)
         {
-          if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
+          if (lastSpace != lineStart && lastSpaceInLine > 0)
           {
-            CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
-            m_lines.push_back(string);
+            // skip over spaces
+            unsigned int next = lastSpace;
+            while (next != lineEnd && IsSpace(text[next]))
+              next++;
+            // whether we wrap here depends on the letters up to this one, and where
+            // the next line starts on the spaces that follow
+            AddLine(text, curStart, curStart + lastSpaceInLine, false, next, std::max(pos, next) + 1, lines);
             // check for exceeding our number of lines
-            if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
+            if (nMaxLines > 0 && lines.m_lines.size() >= (size_t)nMaxLines)
               return;
-            // skip over spaces
-            pos = lastSpace;
-            while (pos != line.m_text.end() && IsSpace(*pos))
-              pos++;
+            pos = curStart = next;
             curLine.clear();
             lastSpaceInLine = 0;
-            lastSpace = line.m_text.begin();
+            lastSpace = lineStart;
             continue;
           }
         }
@@ -507,73 +614,77 @@ void CGUITextLayout::WrapText(const vecText &text, float maxWidth)
     if (width > maxWidth)
     {
       // too long - put up to the last space on if we can + remove it from what's left.
-      if (lastSpace != line.m_text.begin() && lastSpaceInLine > 0)
+      if (lastSpace != lineStart && lastSpaceInLine > 0)
       {
-        CGUIString string(curLine.begin(), curLine.begin() + lastSpaceInLine, false);
-        m_lines.push_back(string);
+        unsigned int next = curStart + lastSpaceInLine;
+        while (next != lineEnd && IsSpace(text[next]))
+          next++;
+        AddLine(text, curStart, curStart + lastSpaceInLine, false, next, lineEnd + 1, lines);
         // check for exceeding our number of lines
-        if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
+        if (nMaxLines > 0 && lines.m_lines.size() >= (size_t)nMaxLines)
           return;
-        curLine.erase(curLine.begin(), curLine.begin() + lastSpaceInLine);
-        while (curLine.size() && IsSpace(curLine.at(0)))
-          curLine.erase(curLine.begin());
+        curStart = next;
       }
     }
-    CGUIString string(curLine.begin(), curLine.end(), true);
-    m_lines.push_back(string);
+    AddLine(text, curStart, lineEnd, true, lineEnd + 1, lineEnd + 1, lines);
     // check for exceeding our number of lines
-    if (nMaxLines > 0 && m_lines.size() >= (size_t)nMaxLines)
+    if (nMaxLines > 0 && lines.m_lines.size() >= (size_t)nMaxLines)
       return;
+    lineStart = lineEnd + 1;
   }
 }
 
-void CGUITextLayout::LineBreakText(const vecText &text, vector<CGUIString> &lines)
+void CGUITextLayout::LineBreakText(const vecText &text, unsigned int start, CGUITextLines &lines)
 {
-  int nMaxLines = (m_maxHeight > 0 && m_font && m_font->GetLineHeight() > 0)?(int)ceilf(m_maxHeight / m_font->GetLineHeight()):-1;
-  vecText::const_iterator lineStart = text.begin();
-  vecText::const_iterator pos = text.begin();
-  while (pos != text.end() && (nMaxLines <= 0 || lines.size() < (size_t)nMaxLines))
+  int nMaxLines = GetMaxLines();
+  unsigned int lineStart = start;
+  for (unsigned int pos = start; pos < text.size() && (nMaxLines <= 0 || lines.m_lines.size() < (size_t)nMaxLines); pos++)
   {
-    // Get the current letter in the string
-    character_t letter = *pos;
-
     // Handle the newline character
-    if ((letter & 0xffff) == L'\n' )
+    if ((text[pos] & 0xffff) == L'\n' )
     { // push back everything up till now
-      CGUIString string(lineStart, pos, true);
-      lines.push_back(string);
+      AddLine(text, lineStart, pos, true, pos + 1, pos + 1, lines);
       lineStart = pos + 1;
     }
-    pos++;
   }
 }
 
+void CGUITextLayout::AddLine(const vecText &text, unsigned int start, unsigned int end, bool carriageReturn, unsigned int next, unsigned int depends, CGUITextLines &lines)
+{
+  lines.m_lines.push_back(CGUIString(text.begin() + start, text.begin() + end, carriageReturn));
+  lines.m_runs.push_back(CGUITextRun(next, depends));
+}
+
 void CGUITextLayout::GetTextExtent(float &width, float &height) const
 {
   width = m_textWidth;
   height = m_textHeight;
 }
 
-void CGUITextLayout::CalcTextExtent()
+void CGUITextLayout::CalcTextExtent(CGUITextLines &lines)
 {
   m_textWidth = 0;
   m_textHeight = 0;
-  if (!m_font) return;
-
-  for (vector<CGUIString>::iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  if (m_font)
   {
-    const CGUIString &string = *i;
-    float w = m_font->GetTextWidth(string.m_text);
-    if (w > m_textWidth)
-      m_textWidth = w;
+    // only the lines laid out since the last time need measuring
+    for (unsigned int i = 0; i < lines.m_lines.size(); i++)
+    {
+      if (lines.m_runs[i].m_width < 0)
+        lines.m_runs[i].m_width = m_font->GetTextWidth(lines.m_lines[i].m_text);
+      if (lines.m_runs[i].m_width > m_textWidth)
+        m_textWidth = lines.m_runs[i].m_width;
+    }
+    m_textHeight = m_font->GetTextHeight(lines.m_lines.size());
   }
-  m_textHeight = m_font->GetTextHeight(m_lines.size());
+  lines.m_width = m_textWidth;
+  lines.m_height = m_textHeight;
 }
 
 unsigned int CGUITextLayout::GetTextLength() const
 {
   unsigned int length = 0;
-  for (vector<CGUIString>::const_iterator i = m_lines.begin(); i != m_lines.end(); i++)
+  for (vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); i++)
     length += i->m_text.size();
   return length;
 }
@@ -581,8 +692,8 @@ unsigned int CGUITextLayout::GetTextLength() const
 void CGUITextLayout::GetFirstText(vecText &text) const
 {
   text.clear();
-  if (m_lines.size())
-    text = m_lines[0].m_text;
+  if (m_layout->m_lines.size())
+    text = m_layout->m_lines[0].m_text;
 }
 
 float CGUITextLayout::GetTextWidth(const CStdStringW &text) const
@@ -642,7 +753,7 @@ void CGUITextLayout::AppendToUTF32(const CStdString &utf8, character_t colStyle,
 
 void CGUITextLayout::Reset()
 {
-  m_lines.clear();
+  m_layout.reset(new CGUITextLines);
   m_lastText.Empty();
   m_textWidth = m_textHeight = 0;
 }
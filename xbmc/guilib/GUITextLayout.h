@@ -23,6 +23,7 @@
 #include "utils/StdString.h"
 
 #include <vector>
+#include <boost/shared_ptr.hpp>
 
 #ifdef __GNUC__
 // under gcc, inline will only take place if optimizations are applied (-O). this will force inline even without optimizations.
@@ -61,6 +62,53 @@ public:
   bool m_carriageReturn; // true if we have a carriage return here
 };
 
+/*! \brief Where a laid out line came from in the parsed text, and its width */
+class CGUITextRun
+{
+public:
+  CGUITextRun(unsigned int next, unsigned int depends);
+
+  unsigned int m_next;    // offset of the parsed text the following line starts at
+  unsigned int m_depends; // the line (and those before it) depends only on the parsed text before this offset
+  float m_width;          // width of the line, negative until measured
+};
+
+/*! \brief The settings a text is laid out with, all that its lines depend on besides the text */
+class CGUITextLayoutParams
+{
+public:
+  CGUITextLayoutParams();
+
+  bool operator==(const CGUITextLayoutParams &right) const;
+  bool operator<(const CGUITextLayoutParams &right) const;
+
+  const CGUIFont *m_font;
+  unsigned int m_fontGeneration; // changes whenever the font is given new glyphs
+  uint32_t m_style;
+  float m_scaleX;
+  float m_scaleY;
+  float m_maxWidth;       // width to wrap to, 0 when not wrapping
+  int m_maxLines;         // -1 for no limit
+  bool m_forceLTR;
+};
+
+/*! \brief Text as laid out: the parsed text, the lines it was split into and their extent.
+ Layouts of the same text share one through the layout cache, so it isn't changed once laid out. */
+class CGUITextLines
+{
+public:
+  CGUITextLines() : m_width(0), m_height(0) {}
+
+  vecColors m_colors;
+  vecText m_parsedText;
+  std::vector<CGUIString> m_lines;
+  std::vector<CGUITextRun> m_runs;
+  float m_width;
+  float m_height;
+};
+
+typedef boost::shared_ptr<const CGUITextLines> CGUITextLinesPtr;
+
 class CGUITextLayout
 {
 public:
@@ -101,16 +149,21 @@ public:
 
 protected:
   void ParseText(const CStdStringW &text, vecText &parsedText);
-  void LineBreakText(const vecText &text, std::vector<CGUIString> &lines);
-  void WrapText(const vecText &text, float maxWidth);
-  void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder);
+  void LineBreakText(const vecText &text, unsigned int start, CGUITextLines &lines);
+  void WrapText(const vecText &text, unsigned int start, float maxWidth, CGUITextLines &lines);
+  void AddLine(const vecText &text, unsigned int start, unsigned int end, bool carriageReturn, unsigned int next, unsigned int depends, CGUITextLines &lines);
+  void BidiTransform(std::vector<CGUIString> &lines, bool forceLTRReadingOrder, unsigned int start = 0);
   CStdStringW BidiFlip(const CStdStringW &text, bool forceLTRReadingOrder);
-  void CalcTextExtent();
+  void CalcTextExtent(CGUITextLines &lines);
+  CGUITextLayoutParams GetLayoutParams(float maxWidth, bool forceLTRReadingOrder) const;
+  int GetMaxLines() const;
 
-  // our text to render
+  // our text to render, and what the lines were laid out from, to lay out only what
+  // changes in the next text. Our own colors, as rendering sets the main one.
+  CGUITextLinesPtr m_layout;
   vecColors m_colors;
-  std::vector<CGUIString> m_lines;
   typedef std::vector<CGUIString>::iterator iLine;
+  CGUITextLayoutParams m_params;
 
   // the layout and font details
   CGUIFont *m_font;        // has style, colour info
@@ -0,0 +1,106 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUITextLayoutCache.h"
+#include "threads/SingleLock.h"
+
+bool CGUITextLayoutCache::Key::operator<(const Key &right) const
+{
+  if (m_params < right.m_params)
+    return true;
+  if (right.m_params < m_params)
+    return false;
+  return m_text < right.m_text;
+}
+
+CGUITextLayoutCache::CGUITextLayoutCache(unsigned int maxEntries)
+{
+  m_maxEntries = maxEntries;
+  m_hits = 0;
+  m_misses = 0;
+}
+
+CGUITextLinesPtr CGUITextLayoutCache::Get(const CGUITextLayoutParams &params, const CStdStringW &text)
+{
+  CSingleLock lock(m_section);
+  LayoutMap::iterator i = m_layouts.find(Key(params, text));
+  if (i == m_layouts.end())
+  {
+    m_misses++;
+    return CGUITextLinesPtr();
+  }
+  m_used.splice(m_used.begin(), m_used, i->second.m_used);
+  m_hits++;
+  return i->second.m_layout;
+}
+
+void CGUITextLayoutCache::Add(const CGUITextLayoutParams &params, const CStdStringW &text, const CGUITextLinesPtr &layout)
+{
+  if (!m_maxEntries)
+    return;
+
+  CSingleLock lock(m_section);
+  std::pair<LayoutMap::iterator, bool> added = m_layouts.insert(std::make_pair(Key(params, text), Entry()));
+  Entry &entry = added.first->second;
+  entry.m_layout = layout;
+  if (added.second)
+  {
+    m_used.push_front(added.first);
+    entry.m_used = m_used.begin();
+  }
+  else
+    m_used.splice(m_used.begin(), m_used, entry.m_used);
+
+  while (m_layouts.size() > m_maxEntries)
+  {
+    m_layouts.erase(m_used.back());
+    m_used.pop_back();
+  }
+}
+
+void CGUITextLayoutCache::Flush(const CGUIFont *font)
+{
+  CSingleLock lock(m_section);
+  for (LayoutList::iterator i = m_used.begin(); i != m_used.end();)
+  {
+    if ((*i)->first.m_params.m_font == font)
+    {
+      m_layouts.erase(*i);
+      i = m_used.erase(i);
+    }
+    else
+      ++i;
+  }
+}
+
+void CGUITextLayoutCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_layouts.clear();
+  m_used.clear();
+  m_hits = 0;
+  m_misses = 0;
+}
+
+unsigned int CGUITextLayoutCache::GetNumEntries() const
+{
+  CSingleLock lock(m_section);
+  return m_layouts.size();
+}
@@ -0,0 +1,94 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "GUITextLayout.h"
+#include "threads/CriticalSection.h"
+#include "utils/GlobalsHandling.h"
+
+#include <list>
+#include <map>
+
+#define TEXT_LAYOUT_CACHE_SIZE 2000
+
+/*!
+ \ingroup textures
+ \brief Process wide cache of measured and wrapped text
+
+ Layouts are keyed by the text and the settings it was laid out with, so labels that show
+ the same text in the same font share the work of parsing, bidi flipping, wrapping and
+ measuring it. The least recently used layouts are dropped once the cache is full.
+ */
+class CGUITextLayoutCache
+{
+public:
+  CGUITextLayoutCache(unsigned int maxEntries = TEXT_LAYOUT_CACHE_SIZE);
+
+  /*! \brief Fetch a layout, marking it as recently used
+   \param params settings the text is laid out with
+   \param text text to lay out, as given to CGUITextLayout
+   \return the cached layout, shared with the cache rather than copied, or empty if it isn't cached
+   */
+  CGUITextLinesPtr Get(const CGUITextLayoutParams &params, const CStdStringW &text);
+
+  /*! \brief Cache a layout, dropping the least recently used one if the cache is full */
+  void Add(const CGUITextLayoutParams &params, const CStdStringW &text, const CGUITextLinesPtr &layout);
+
+  /*! \brief Drop all layouts in the given font, as when its glyphs change */
+  void Flush(const CGUIFont *font);
+  void Clear();
+
+  unsigned int GetNumEntries() const;
+  unsigned int GetNumHits() const { return m_hits; }
+  unsigned int GetNumMisses() const { return m_misses; }
+
+private:
+  class Key
+  {
+  public:
+    Key(const CGUITextLayoutParams &params, const CStdStringW &text) : m_params(params), m_text(text) {}
+    bool operator<(const Key &right) const;
+
+    CGUITextLayoutParams m_params;
+    CStdStringW m_text;
+  };
+
+  class Entry;
+  typedef std::map<Key, Entry> LayoutMap;
+  typedef std::list<LayoutMap::iterator> LayoutList;
+
+  class Entry
+  {
+  public:
+    CGUITextLinesPtr m_layout;
+    LayoutList::iterator m_used;  // position in the list of recently used layouts
+  };
+
+  LayoutMap m_layouts;
+  LayoutList m_used;              // most recently used first
+  unsigned int m_maxEntries;
+  unsigned int m_hits;
+  unsigned int m_misses;
+  mutable CCriticalSection m_section;
+};
+
+XBMC_GLOBAL_REF(CGUITextLayoutCache, g_textLayoutCache);
+#define g_textLayoutCache XBMC_GLOBAL_USE(CGUITextLayoutCache)
@@ -551,6 +551,13 @@ bool CGUITextureBase::ReadyToRender() const
   return m_texture.size() > 0;
 }
 
+bool CGUITextureBase::IsSettled() const
+{
+  if (m_info.filename.IsEmpty() || !m_visible || FailedToAlloc())
+    return true;
+  return m_texture.size() == 1 && !m_invalid;
+}
+
 void CGUITextureBase::OrientateTexture(CRect &rect, float width, float height, int orientation)
 {
   switch (orientation & 3)
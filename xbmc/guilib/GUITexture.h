@@ -119,6 +119,8 @@ public:
   bool IsAllocated() const { return m_isAllocated != NO; };
   bool FailedToAlloc() const { return m_isAllocated == NORMAL_FAILED || m_isAllocated == LARGE_FAILED; };
   bool ReadyToRender() const;
+  /*! \brief Whether the texture is done loading, or failed to, and doesn't animate */
+  bool IsSettled() const;
 protected:
   bool CalculateSize();
   void LoadDiffuseImage();
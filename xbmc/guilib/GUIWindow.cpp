@@ -26,6 +26,7 @@
 #include "GUIControlFactory.h"
 #include "GUIControlGroup.h"
 #include "GUIControlProfiler.h"
+#include "GUIWindowCache.h"
 #include "settings/Settings.h"
 #ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
 #include "GUIEditControl.h"
@@ -130,25 +131,39 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
-  // load window xml if we don't have it stored yet
-  if (!m_windowXMLRootElement)
+  // use the cached window if its includes would still resolve the same
+  TiXmlElement *rootElement = CGUIWindowCache::Load(strPath, m_xmlIncludeConditions);
+  if (rootElement)
+    CLog::Log(LOGDEBUG, "Using cached xml for %s", strPath.c_str());
+  else
   {
-    CXBMCTinyXML xmlDoc;
-    if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+    // load window xml if we don't have it stored yet
+    if (!m_windowXMLRootElement)
     {
-      CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
-      SetID(WINDOW_INVALID);
-      return false;
+      CXBMCTinyXML xmlDoc;
+      if ( !xmlDoc.LoadFile(strPath) && !xmlDoc.LoadFile(CStdString(strPath).ToLower()) && !xmlDoc.LoadFile(strLowerPath))
+      {
+        CLog::Log(LOGERROR, "unable to load:%s, Line %d\n%s", strPath.c_str(), xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+        SetID(WINDOW_INVALID);
+        return false;
+      }
+      m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
     }
-    m_windowXMLRootElement = (TiXmlElement*)xmlDoc.RootElement()->Clone();
+    else
+      CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
+
+    // resolve the includes on a copy so the stored root element is left unchanged
+    rootElement = (TiXmlElement*)m_windowXMLRootElement->Clone();
+    g_SkinInfo->ResolveIncludes(rootElement, &m_xmlIncludeConditions);
+    CGUIWindowCache::Store(strPath, rootElement, m_xmlIncludeConditions);
   }
-  else
-    CLog::Log(LOGDEBUG, "Using already stored xml root node for %s", strPath.c_str());
 
-  return Load(m_windowXMLRootElement);
+  bool ret = Load(rootElement, true);
+  delete rootElement;
+  return ret;
 }
 
-bool CGUIWindow::Load(TiXmlElement* pRootElement)
+bool CGUIWindow::Load(TiXmlElement* pRootElement, bool resolved /* = false */)
 {
   if (!pRootElement)
     return false;
@@ -159,16 +174,19 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
     return false;
   }
 
-  // we must create copy of root element as we will manipulate it when resolving includes
-  // and we don't want original root element to change
-  pRootElement = (TiXmlElement*)pRootElement->Clone();
-
   // set the scaling resolution so that any control creation or initialisation can
   // be done with respect to the correct aspect ratio
   g_graphicsContext.SetScalingResolution(m_coordsRes, m_needsScaling);
 
-  // Resolve any includes that may be present and save conditions used to do it
-  g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  if (!resolved)
+  {
+    // we must create copy of root element as we will manipulate it when resolving includes
+    // and we don't want original root element to change
+    pRootElement = (TiXmlElement*)pRootElement->Clone();
+
+    // Resolve any includes that may be present and save conditions used to do it
+    g_SkinInfo->ResolveIncludes(pRootElement, &m_xmlIncludeConditions);
+  }
   // now load in the skin file
   SetDefaults();
 
@@ -264,7 +282,8 @@ bool CGUIWindow::Load(TiXmlElement* pRootElement)
 
   m_windowLoaded = true;
   OnWindowLoaded();
-  delete pRootElement;
+  if (!resolved)
+    delete pRootElement;
   return true;
 }
 
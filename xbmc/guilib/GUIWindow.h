@@ -197,7 +197,7 @@ public:
 protected:
   virtual EVENT_RESULT OnMouseEvent(const CPoint &point, const CMouseEvent &event);
   virtual bool LoadXML(const CStdString& strPath, const CStdString &strLowerPath);  ///< Loads from the given file
-  bool Load(TiXmlElement *pRootElement);                 ///< Loads from the given XML root element
+  bool Load(TiXmlElement *pRootElement, bool resolved = false); ///< Loads from the given XML root element, resolving its includes unless already done
   /*! \brief Check if XML file needs (re)loading
    XML file has to be (re)loaded when window is not loaded or include conditions values were changed
    */
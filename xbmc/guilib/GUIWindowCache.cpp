@@ -0,0 +1,500 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIWindowCache.h"
+#include "addons/Skin.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "GUIInfoManager.h"
+#include "utils/Crc32.h"
+#include "utils/log.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+using namespace XFILE;
+
+#define WINDOW_CACHE_PATH     "special://temp/skincache/"
+#define WINDOW_CACHE_MAGIC    0x43574258 // "XBWC"
+#define WINDOW_CACHE_VERSION  2
+
+// node types in the serialized tree
+#define NODE_ELEMENT  1
+#define NODE_TEXT     2
+#define NODE_CDATA    3
+
+namespace
+{
+
+class CCacheWriter
+{
+public:
+  CCacheWriter(string &data) : m_data(data) {}
+
+  void WriteUInt(uint32_t value) { m_data.append((const char *)&value, sizeof(value)); }
+  void WriteUInt64(uint64_t value) { m_data.append((const char *)&value, sizeof(value)); }
+  void WriteByte(uint8_t value) { m_data.append(1, (char)value); }
+  void WriteString(const string &value)
+  {
+    WriteUInt(value.size());
+    m_data.append(value);
+  }
+
+private:
+  string &m_data;
+};
+
+class CCacheReader
+{
+public:
+  CCacheReader(const char *data, size_t size) : m_pos(data), m_end(data + size), m_failed(false) {}
+
+  uint32_t ReadUInt() { uint32_t value = 0; Read(&value, sizeof(value)); return value; }
+  uint64_t ReadUInt64() { uint64_t value = 0; Read(&value, sizeof(value)); return value; }
+  uint8_t ReadByte() { uint8_t value = 0; Read(&value, sizeof(value)); return value; }
+  string ReadString()
+  {
+    uint32_t size = ReadUInt();
+    if (m_failed || size > (size_t)(m_end - m_pos))
+    {
+      m_failed = true;
+      return "";
+    }
+    string value(m_pos, size);
+    m_pos += size;
+    return value;
+  }
+
+  const char *Position() const { return m_pos; }
+  size_t Remaining() const { return m_end - m_pos; }
+  bool Failed() const { return m_failed; }
+
+private:
+  void Read(void *value, size_t size)
+  {
+    if (m_failed || size > (size_t)(m_end - m_pos))
+    {
+      m_failed = true;
+      return;
+    }
+    memcpy(value, m_pos, size);
+    m_pos += size;
+  }
+
+  const char *m_pos;
+  const char *m_end;
+  bool m_failed;
+};
+
+typedef map<string, uint32_t> StringTable;
+
+uint32_t AddString(StringTable &strings, const string &value)
+{
+  StringTable::const_iterator it = strings.find(value);
+  if (it != strings.end())
+    return it->second;
+  uint32_t index = strings.size();
+  strings.insert(make_pair(value, index));
+  return index;
+}
+
+bool IsSerialized(const TiXmlNode *node)
+{
+  return node->Type() == TiXmlNode::TINYXML_ELEMENT || node->Type() == TiXmlNode::TINYXML_TEXT;
+}
+
+void SerializeNode(const TiXmlNode *node, StringTable &strings, CCacheWriter &writer)
+{
+  if (node->Type() == TiXmlNode::TINYXML_TEXT)
+  {
+    writer.WriteByte(node->ToText()->CDATA() ? NODE_CDATA : NODE_TEXT);
+    writer.WriteUInt(AddString(strings, node->ValueStr()));
+    return;
+  }
+
+  const TiXmlElement *element = node->ToElement();
+  writer.WriteByte(NODE_ELEMENT);
+  writer.WriteUInt(AddString(strings, element->ValueStr()));
+
+  uint32_t attributes = 0;
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+    attributes++;
+  writer.WriteUInt(attributes);
+  for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+  {
+    writer.WriteUInt(AddString(strings, attribute->Name()));
+    writer.WriteUInt(AddString(strings, attribute->ValueStr()));
+  }
+
+  uint32_t children = 0;
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (IsSerialized(child))
+      children++;
+  }
+  writer.WriteUInt(children);
+  for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+  {
+    if (IsSerialized(child))
+      SerializeNode(child, strings, writer);
+  }
+}
+
+const string *GetString(const vector<string> &strings, CCacheReader &reader)
+{
+  uint32_t index = reader.ReadUInt();
+  if (reader.Failed() || index >= strings.size())
+    return NULL;
+  return &strings[index];
+}
+
+TiXmlNode *DeserializeNode(const vector<string> &strings, CCacheReader &reader)
+{
+  uint8_t type = reader.ReadByte();
+  const string *value = GetString(strings, reader);
+  if (!value)
+    return NULL;
+
+  if (type == NODE_TEXT || type == NODE_CDATA)
+  {
+    TiXmlText *text = new TiXmlText(*value);
+    text->SetCDATA(type == NODE_CDATA);
+    return text;
+  }
+  if (type != NODE_ELEMENT)
+    return NULL;
+
+  TiXmlElement *element = new TiXmlElement(*value);
+  uint32_t attributes = reader.ReadUInt();
+  for (uint32_t i = 0; i < attributes && !reader.Failed(); i++)
+  {
+    const string *name = GetString(strings, reader);
+    const string *attribute = GetString(strings, reader);
+    if (!name || !attribute)
+    {
+      delete element;
+      return NULL;
+    }
+    element->SetAttribute(*name, *attribute);
+  }
+
+  uint32_t children = reader.ReadUInt();
+  for (uint32_t i = 0; i < children; i++)
+  {
+    TiXmlNode *child = DeserializeNode(strings, reader);
+    if (!child)
+    {
+      delete element;
+      return NULL;
+    }
+    element->LinkEndChild(child);
+  }
+  return element;
+}
+
+bool ReadCacheFile(const CStdString &path, string &data)
+{
+  CFile file;
+  if (!file.Open(path))
+    return false;
+  int64_t length = file.GetLength();
+  if (length > 0)
+  {
+    data.resize((size_t)length);
+    if (file.Read(&data[0], length) != length)
+      data.clear();
+  }
+  file.Close();
+  return !data.empty();
+}
+
+bool WriteCacheFile(const CStdString &path, const string &data)
+{
+  CDirectory::Create(WINDOW_CACHE_PATH);
+  CFile file;
+  return file.OpenForWrite(path, true) && file.Write(data.c_str(), data.size()) == (int)data.size();
+}
+
+// the expressions of the include conditions seen for a window, in any of its cached variants
+bool LoadConditionIndex(const CStdString &indexFile, const CStdString &path, vector<CStdString> &expressions)
+{
+  string data;
+  if (!ReadCacheFile(indexFile, data))
+    return false;
+
+  CCacheReader reader(data.c_str(), data.size());
+  if (reader.ReadUInt() != WINDOW_CACHE_MAGIC || reader.ReadUInt() != WINDOW_CACHE_VERSION ||
+      reader.ReadString() != path)
+    return false;
+
+  uint32_t count = reader.ReadUInt();
+  for (uint32_t i = 0; i < count && !reader.Failed(); i++)
+    expressions.push_back(reader.ReadString());
+  return !reader.Failed();
+}
+
+bool StoreConditionIndex(const CStdString &indexFile, const CStdString &path, const vector<CStdString> &expressions)
+{
+  string data;
+  CCacheWriter writer(data);
+  writer.WriteUInt(WINDOW_CACHE_MAGIC);
+  writer.WriteUInt(WINDOW_CACHE_VERSION);
+  writer.WriteString(path);
+  writer.WriteUInt(expressions.size());
+  for (vector<CStdString>::const_iterator it = expressions.begin(); it != expressions.end(); ++it)
+    writer.WriteString(*it);
+  return WriteCacheFile(indexFile, data);
+}
+
+// the variant of a window is told by the current values of its include conditions
+unsigned int GetVariant(const vector<CStdString> &expressions)
+{
+  string values;
+  for (vector<CStdString>::const_iterator it = expressions.begin(); it != expressions.end(); ++it)
+  {
+    values += *it;
+    values += g_infoManager.GetBoolValue(g_infoManager.Register(*it)) ? "=1;" : "=0;";
+  }
+  Crc32 crc;
+  crc.Compute(values.c_str(), values.size());
+  return (unsigned int)crc;
+}
+
+bool GetFileStamp(const CStdString &path, uint64_t &mtime, uint64_t &size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0)
+    return false;
+  mtime = buffer.st_mtime;
+  size = buffer.st_size;
+  return true;
+}
+
+}
+
+TiXmlElement *CGUIWindowCache::Load(const CStdString &path, map<int, bool> &xmlIncludeConditions)
+{
+  if (!g_SkinInfo)
+    return NULL;
+
+  vector<CStdString> expressions;
+  if (!LoadConditionIndex(GetIndexFile(path), path, expressions))
+    return NULL;
+
+  string data;
+  if (!ReadCacheFile(GetCacheFile(path, GetVariant(expressions)), data))
+    return NULL;
+
+  CCacheReader reader(data.c_str(), data.size());
+  if (reader.ReadUInt() != WINDOW_CACHE_MAGIC || reader.ReadUInt() != WINDOW_CACHE_VERSION ||
+      reader.ReadString() != g_SkinInfo->ID() ||
+      reader.ReadString() != g_SkinInfo->Version().c_str() ||
+      reader.ReadString() != path)
+    return NULL;
+
+  // the window file comes first, followed by the include files
+  vector<CStdString> includeFiles;
+  uint32_t files = reader.ReadUInt();
+  for (uint32_t i = 0; i < files && !reader.Failed(); i++)
+  {
+    CStdString filePath = reader.ReadString();
+    uint64_t mtime = reader.ReadUInt64();
+    uint64_t size = reader.ReadUInt64();
+    uint64_t currentMtime, currentSize;
+    if (reader.Failed() || !GetFileStamp(filePath, currentMtime, currentSize) ||
+        mtime != currentMtime || size != currentSize)
+    {
+      CLog::Log(LOGDEBUG, "%s - %s changed, not using cached %s", __FUNCTION__, filePath.c_str(), path.c_str());
+      return NULL;
+    }
+    if (i > 0)
+      includeFiles.push_back(filePath);
+  }
+
+  // includes are resolved differently if any of their conditions changed value
+  map<int, bool> conditions;
+  uint32_t count = reader.ReadUInt();
+  for (uint32_t i = 0; i < count && !reader.Failed(); i++)
+  {
+    CStdString expression = reader.ReadString();
+    bool value = reader.ReadByte() != 0;
+    if (reader.Failed())
+      return NULL;
+    int condition = g_infoManager.Register(expression);
+    if (g_infoManager.GetBoolValue(condition) != value)
+      return NULL;
+    conditions[condition] = value;
+  }
+  if (reader.Failed())
+    return NULL;
+
+  TiXmlElement *root = Deserialize(string(reader.Position(), reader.Remaining()));
+  if (!root)
+  {
+    CLog::Log(LOGERROR, "%s - invalid cache entry for %s", __FUNCTION__, path.c_str());
+    return NULL;
+  }
+
+  // skin variables are defined in the include files, make sure we have them
+  for (vector<CStdString>::const_iterator it = includeFiles.begin(); it != includeFiles.end(); ++it)
+    g_SkinInfo->LoadIncludeFile(*it);
+
+  xmlIncludeConditions.swap(conditions);
+  return root;
+}
+
+bool CGUIWindowCache::Store(const CStdString &path, const TiXmlElement *root, const map<int, bool> &xmlIncludeConditions)
+{
+  if (!g_SkinInfo || !root)
+    return false;
+
+  string data;
+  CCacheWriter writer(data);
+  writer.WriteUInt(WINDOW_CACHE_MAGIC);
+  writer.WriteUInt(WINDOW_CACHE_VERSION);
+  writer.WriteString(g_SkinInfo->ID());
+  writer.WriteString(g_SkinInfo->Version().c_str());
+  writer.WriteString(path);
+
+  vector<CStdString> files;
+  files.push_back(path);
+  const vector<CStdString> &includeFiles = g_SkinInfo->GetIncludeFiles();
+  files.insert(files.end(), includeFiles.begin(), includeFiles.end());
+  writer.WriteUInt(files.size());
+  for (vector<CStdString>::const_iterator it = files.begin(); it != files.end(); ++it)
+  {
+    uint64_t mtime, size;
+    if (!GetFileStamp(*it, mtime, size))
+      return false;
+    writer.WriteString(*it);
+    writer.WriteUInt64(mtime);
+    writer.WriteUInt64(size);
+  }
+
+  writer.WriteUInt(xmlIncludeConditions.size());
+  for (map<int, bool>::const_iterator it = xmlIncludeConditions.begin(); it != xmlIncludeConditions.end(); ++it)
+  {
+    writer.WriteString(g_infoManager.GetBoolExpression(it->first));
+    writer.WriteByte(it->second ? 1 : 0);
+  }
+
+  string tree;
+  Serialize(root, tree);
+  data.append(tree);
+
+  // the index gathers the conditions of all variants, so loading can tell which variant is current
+  vector<CStdString> expressions;
+  CStdString indexFile = GetIndexFile(path);
+  if (!LoadConditionIndex(indexFile, path, expressions))
+    expressions.clear();
+  bool indexChanged = false;
+  for (map<int, bool>::const_iterator it = xmlIncludeConditions.begin(); it != xmlIncludeConditions.end(); ++it)
+  {
+    CStdString expression = g_infoManager.GetBoolExpression(it->first);
+    if (find(expressions.begin(), expressions.end(), expression) == expressions.end())
+    {
+      expressions.push_back(expression);
+      indexChanged = true;
+    }
+  }
+
+  if ((indexChanged && !StoreConditionIndex(indexFile, path, expressions)) ||
+      !WriteCacheFile(GetCacheFile(path, GetVariant(expressions)), data))
+  {
+    CLog::Log(LOGERROR, "%s - unable to cache %s", __FUNCTION__, path.c_str());
+    return false;
+  }
+  return true;
+}
+
+void CGUIWindowCache::Clear()
+{
+  CFileItemList items;
+  CDirectory::GetDirectory(WINDOW_CACHE_PATH, items);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->m_bIsFolder)
+      CFile::Delete(items[i]->GetPath());
+  }
+  CDirectory::Remove(WINDOW_CACHE_PATH);
+}
+
+void CGUIWindowCache::Serialize(const TiXmlElement *root, string &data)
+{
+  // names and values repeat a lot, so the tree refers to them by index into a string table
+  StringTable strings;
+  string tree;
+  CCacheWriter treeWriter(tree);
+  SerializeNode(root, strings, treeWriter);
+
+  vector<const string *> table(strings.size());
+  for (StringTable::const_iterator it = strings.begin(); it != strings.end(); ++it)
+    table[it->second] = &it->first;
+
+  CCacheWriter writer(data);
+  writer.WriteUInt(table.size());
+  for (vector<const string *>::const_iterator it = table.begin(); it != table.end(); ++it)
+    writer.WriteString(**it);
+  data.append(tree);
+}
+
+TiXmlElement *CGUIWindowCache::Deserialize(const string &data)
+{
+  CCacheReader reader(data.c_str(), data.size());
+  uint32_t count = reader.ReadUInt();
+  if (reader.Failed() || count > reader.Remaining())
+    return NULL;
+
+  vector<string> strings;
+  strings.reserve(count);
+  for (uint32_t i = 0; i < count && !reader.Failed(); i++)
+    strings.push_back(reader.ReadString());
+  if (reader.Failed())
+    return NULL;
+
+  TiXmlNode *root = DeserializeNode(strings, reader);
+  if (root && (reader.Failed() || !root->ToElement()))
+  {
+    delete root;
+    return NULL;
+  }
+  return (TiXmlElement *)root;
+}
+
+CStdString CGUIWindowCache::GetCacheFile(const CStdString &path, unsigned int variant)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  CStdString cacheFile;
+  cacheFile.Format(WINDOW_CACHE_PATH "%08x-%08x.bin", (unsigned int)crc, variant);
+  return cacheFile;
+}
+
+CStdString CGUIWindowCache::GetIndexFile(const CStdString &path)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  CStdString indexFile;
+  indexFile.Format(WINDOW_CACHE_PATH "%08x.idx", (unsigned int)crc);
+  return indexFile;
+}
@@ -0,0 +1,78 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include "utils/StdString.h"
+
+#include <map>
+#include <string>
+
+class TiXmlElement;
+
+/*!
+ \ingroup windows
+ \brief Cache of skin window definitions with their includes and constants resolved
+
+ Windows are stored in a compact binary form under special://temp/skincache/, together
+ with everything the resolved definition depends on: the skin and its version, the
+ modification time and size of the window file and the include files, and the value
+ of every include condition. An entry is only used while all of these still match,
+ which saves parsing the window file and resolving its includes on every load.
+
+ A window has an entry for each combination of include condition values it was resolved
+ with, so flipping a condition back and forth doesn't rewrite the entry each time. The
+ cache is cleared when the skin is reloaded.
+ */
+class CGUIWindowCache
+{
+public:
+  /*! \brief Load a resolved window definition from the cache
+   \param path path of the window file
+   \param xmlIncludeConditions [out] the include conditions the definition was resolved with
+   \return the resolved root element to be deleted by the caller, NULL if there is no valid entry
+   */
+  static TiXmlElement *Load(const CStdString &path, std::map<int, bool> &xmlIncludeConditions);
+
+  /*! \brief Store a resolved window definition in the cache
+   \param path path of the window file
+   \param root the root element with includes resolved
+   \param xmlIncludeConditions the include conditions used while resolving
+   \return true if the definition was stored
+   */
+  static bool Store(const CStdString &path, const TiXmlElement *root, const std::map<int, bool> &xmlIncludeConditions);
+
+  /*! \brief Remove all cached window definitions */
+  static void Clear();
+
+  /*! \brief Serialize an element tree to the binary cache format
+   Elements, attributes and text are kept, comments and declarations are dropped.
+   */
+  static void Serialize(const TiXmlElement *root, std::string &data);
+
+  /*! \brief Rebuild an element tree serialized with Serialize
+   \return the root element to be deleted by the caller, NULL if the data is invalid
+   */
+  static TiXmlElement *Deserialize(const std::string &data);
+
+private:
+  static CStdString GetCacheFile(const CStdString &path, unsigned int variant);
+  static CStdString GetIndexFile(const CStdString &path);
+};
@@ -24,12 +24,22 @@
 #include "windowing/WindowingFactory.h"
 #include "settings/AdvancedSettings.h"
 #include "filesystem/File.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "XBTF.h"
 #include "JpegIO.h"
 
 #include <setjmp.h>
 
+#ifndef JCS_EXTENSIONS
+// the SSSE3 swizzles are built for the target alone and only run on cpus that have it
+#if (defined(__i386__) || defined(__x86_64__)) && \
+    (defined(__SSSE3__) || defined(__clang__) || __GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))
+#define HAS_SSSE3_SWIZZLE
+#include <tmmintrin.h>
+#endif
+#endif
+
 #define EXIF_TAG_ORIENTATION    0x0112
 
 struct my_error_mgr
@@ -38,6 +48,91 @@ struct my_error_mgr
   jmp_buf setjmp_buffer;        // for return to caller
 };
 
+#ifndef JCS_EXTENSIONS
+/* Without libjpeg-turbo's extended colorspaces libjpeg only reads and writes RGB, so
+   scanlines are swizzled to and from our BGRA surfaces, 16 pixels at a time with SSSE3. */
+
+#ifdef HAS_SSSE3_SWIZZLE
+// returns the number of pixels done, the rest of the scanline is left to the caller
+__attribute__((target("ssse3")))
+static unsigned int SwizzleRGBToBGRA_SSSE3(const unsigned char *src, unsigned char *dst, unsigned int width)
+{
+  unsigned int x = 0;
+  const __m128i shuffle = _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1);
+  const __m128i alpha = _mm_set1_epi32((int)0xff000000);
+  for (; x + 16 <= width; x += 16, src += 48, dst += 64)
+  {
+    __m128i in0 = _mm_loadu_si128((const __m128i *)src);
+    __m128i in1 = _mm_loadu_si128((const __m128i *)(src + 16));
+    __m128i in2 = _mm_loadu_si128((const __m128i *)(src + 32));
+    _mm_storeu_si128((__m128i *)dst,        _mm_or_si128(_mm_shuffle_epi8(in0, shuffle), alpha));
+    _mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in1, in0, 12), shuffle), alpha));
+    _mm_storeu_si128((__m128i *)(dst + 32), _mm_or_si128(_mm_shuffle_epi8(_mm_alignr_epi8(in2, in1, 8), shuffle), alpha));
+    _mm_storeu_si128((__m128i *)(dst + 48), _mm_or_si128(_mm_shuffle_epi8(_mm_srli_si128(in2, 4), shuffle), alpha));
+  }
+  return x;
+}
+
+__attribute__((target("ssse3")))
+static unsigned int SwizzleBGRAToRGB_SSSE3(const unsigned char *src, unsigned char *dst, unsigned int width)
+{
+  unsigned int x = 0;
+  // each block of 4 pixels packs into the low 12 bytes, which are then joined up
+  const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+  for (; x + 16 <= width; x += 16, src += 64, dst += 48)
+  {
+    __m128i rgb0 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)src), shuffle);
+    __m128i rgb1 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 16)), shuffle);
+    __m128i rgb2 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 32)), shuffle);
+    __m128i rgb3 = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + 48)), shuffle);
+    _mm_storeu_si128((__m128i *)dst,        _mm_or_si128(rgb0, _mm_slli_si128(rgb1, 12)));
+    _mm_storeu_si128((__m128i *)(dst + 16), _mm_or_si128(_mm_srli_si128(rgb1, 4), _mm_slli_si128(rgb2, 8)));
+    _mm_storeu_si128((__m128i *)(dst + 32), _mm_or_si128(_mm_srli_si128(rgb2, 8), _mm_slli_si128(rgb3, 4)));
+  }
+  return x;
+}
+#endif
+
+static void SwizzleRGBToBGRA(const unsigned char *src, unsigned char *dst, unsigned int width)
+{
+  unsigned int x = 0;
+#ifdef HAS_SSSE3_SWIZZLE
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSSE3)
+  {
+    x = SwizzleRGBToBGRA_SSSE3(src, dst, width);
+    src += x * 3;
+    dst += x * 4;
+  }
+#endif
+  for (; x < width; x++, src += 3, dst += 4)
+  {
+    dst[0] = src[2];
+    dst[1] = src[1];
+    dst[2] = src[0];
+    dst[3] = 0xff;
+  }
+}
+
+static void SwizzleBGRAToRGB(const unsigned char *src, unsigned char *dst, unsigned int width)
+{
+  unsigned int x = 0;
+#ifdef HAS_SSSE3_SWIZZLE
+  if (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSSE3)
+  {
+    x = SwizzleBGRAToRGB_SSSE3(src, dst, width);
+    src += x * 4;
+    dst += x * 3;
+  }
+#endif
+  for (; x < width; x++, src += 4, dst += 3)
+  {
+    dst[0] = src[2];
+    dst[1] = src[1];
+    dst[2] = src[0];
+  }
+}
+#endif
+
 #if JPEG_LIB_VERSION < 80
 
 /*Versions of libjpeg prior to 8.0 did not have a pre-made mechanism for
@@ -237,12 +332,32 @@ CJpegIO::CJpegIO()
   m_inputBuff = NULL;
   m_texturePath = "";
   memset(&m_cinfo, 0, sizeof(m_cinfo));
+  memset(&m_compressInfo, 0, sizeof(m_compressInfo));
+  m_decompressCreated = false;
+  m_compressCreated = false;
   m_thumbnailbuffer = NULL;
+  m_thumbnailbufferSize = 0;
+  m_rowBuffer = NULL;
+  m_rowBufferSize = 0;
 }
 
 CJpegIO::~CJpegIO()
 {
   Close();
+  ReleaseThumbnailBuffer();
+  free(m_rowBuffer);
+
+  struct my_error_mgr jerr;
+  if (m_decompressCreated)
+  {
+    m_cinfo.err = jpeg_std_error(&jerr.pub);
+    jpeg_destroy_decompress(&m_cinfo);
+  }
+  if (m_compressCreated)
+  {
+    m_compressInfo.err = jpeg_std_error(&jerr.pub);
+    jpeg_destroy_compress(&m_compressInfo);
+  }
 }
 
 void CJpegIO::Close()
@@ -250,7 +365,19 @@ void CJpegIO::Close()
   free(m_inputBuff);
   m_inputBuff = NULL;
   m_inputBuffSize = 0;
-  ReleaseThumbnailBuffer();
+}
+
+unsigned char* CJpegIO::GetRowBuffer(unsigned int size)
+{
+  if (size > m_rowBufferSize)
+  {
+    free(m_rowBuffer);
+    m_rowBuffer = (unsigned char *)malloc(size);
+    m_rowBufferSize = m_rowBuffer ? size : 0;
+    if (!m_rowBuffer)
+      CLog::Log(LOGERROR, "%s unable to allocate buffer of size %u", __FUNCTION__, size);
+  }
+  return m_rowBuffer;
 }
 
 bool CJpegIO::Open(const CStdString &texturePath, unsigned int minx, unsigned int miny, bool read)
@@ -326,10 +453,20 @@ bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int min
   m_cinfo.err = jpeg_std_error(&jerr.pub);
   jerr.pub.error_exit = jpeg_error_exit;
 
+  // the instance is reused, an image without exif data mustn't take the last one's orientation
+  m_orientation = 0;
+
   if (buffer == NULL || !bufSize )
     return false;
 
-  jpeg_create_decompress(&m_cinfo);
+  // the decompressor is created once and reset for each image that follows
+  if (!m_decompressCreated)
+  {
+    jpeg_create_decompress(&m_cinfo);
+    m_decompressCreated = true;
+  }
+  else
+    jpeg_abort_decompress(&m_cinfo);
 #if JPEG_LIB_VERSION < 80
   x_mem_src(&m_cinfo, buffer, bufSize);
 #else
@@ -338,7 +475,7 @@ bool CJpegIO::Read(unsigned char* buffer, unsigned int bufSize, unsigned int min
 
   if (setjmp(jerr.setjmp_buffer))
   {
-    jpeg_destroy_decompress(&m_cinfo);
+    jpeg_abort_decompress(&m_cinfo);
     return false;
   }
   else
@@ -401,15 +538,15 @@ bool CJpegIO::Decode(const unsigned char *pixels, unsigned int pitch, unsigned i
 
   if (setjmp(jerr.setjmp_buffer))
   {
-    jpeg_destroy_decompress(&m_cinfo);
+    jpeg_abort_decompress(&m_cinfo);
     return false;
   }
   else
   {
-    jpeg_start_decompress(&m_cinfo);
-
     if (format == XB_FMT_RGB8)
     {
+      m_cinfo.out_color_space = JCS_RGB;
+      jpeg_start_decompress(&m_cinfo);
       while (m_cinfo.output_scanline < m_height)
       {
         jpeg_read_scanlines(&m_cinfo, &dst, 1);
@@ -418,32 +555,40 @@ bool CJpegIO::Decode(const unsigned char *pixels, unsigned int pitch, unsigned i
     }
     else if (format == XB_FMT_A8R8G8B8)
     {
-      unsigned char* row = new unsigned char[m_width * 3];
+#ifdef JCS_EXTENSIONS
+      // libjpeg-turbo writes our pixel layout itself
+      m_cinfo.out_color_space = JCS_EXT_BGRA;
+      jpeg_start_decompress(&m_cinfo);
+      while (m_cinfo.output_scanline < m_height)
+      {
+        jpeg_read_scanlines(&m_cinfo, &dst, 1);
+        dst += pitch;
+      }
+#else
+      unsigned char* row = GetRowBuffer(m_width * 3);
+      if (!row)
+      {
+        jpeg_abort_decompress(&m_cinfo);
+        return false;
+      }
+      jpeg_start_decompress(&m_cinfo);
       while (m_cinfo.output_scanline < m_height)
       {
         jpeg_read_scanlines(&m_cinfo, &row, 1);
-        unsigned char *src2 = row;
-        unsigned char *dst2 = dst;
-        for (unsigned int x = 0; x < m_width; x++, src2 += 3)
-        {
-          *dst2++ = src2[2];
-          *dst2++ = src2[1];
-          *dst2++ = src2[0];
-          *dst2++ = 0xff;
-        }
+        SwizzleRGBToBGRA(row, dst, m_width);
         dst += pitch;
       }
-      delete[] row;
+#endif
     }
     else
     {
       CLog::Log(LOGWARNING, "JpegIO: Incorrect output format specified");
-      jpeg_destroy_decompress(&m_cinfo);
+      jpeg_abort_decompress(&m_cinfo);
       return false;
     }
+    // leaves the decompressor ready for the next image
     jpeg_finish_decompress(&m_cinfo);
   }
-  jpeg_destroy_decompress(&m_cinfo);
   return true;
 }
 
@@ -484,106 +629,117 @@ bool CJpegIO::CreateThumbnailFromMemory(unsigned char* buffer, unsigned int bufS
 bool CJpegIO::CreateThumbnailFromSurface(unsigned char* buffer, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, const CStdString& destFile)
 {
   //Encode raw data from buffer, save to destFile
-  struct jpeg_compress_struct cinfo;
-  struct my_error_mgr jerr;
-  JSAMPROW row_pointer[1];
-  long unsigned int outBufSize = width * height;
-  unsigned char* result;
-  unsigned char* src = buffer;
-  unsigned char* rgbbuf, *src2, *dst2;
+  unsigned long outBufSize = 0;
+  if (!Encode(buffer, width, height, format, pitch, outBufSize))
+    return false;
 
-  if(buffer == NULL)
+  XFILE::CFile file;
+  if (file.OpenForWrite(destFile, true))
   {
-    CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface no buffer");
-    return false;
+    file.Write(m_thumbnailbuffer, outBufSize);
+    file.Close();
+    return true;
   }
+  return false;
+}
 
-  result = (unsigned char*) malloc(outBufSize); //Initial buffer. Grows as-needed.
-  if (result == NULL)
+bool CJpegIO::Encode(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, unsigned long &outSize)
+{
+  if (bufferin == NULL)
   {
-    CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface error allocating memory for image buffer");
+    CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface no buffer");
     return false;
   }
 
-  if(format == XB_FMT_RGB8)
+  if (format != XB_FMT_RGB8 && format != XB_FMT_A8R8G8B8)
   {
-    rgbbuf = buffer;
+    CLog::Log(LOGWARNING, "JpegIO::CreateThumbnailFromSurface Unsupported format");
+    return false;
   }
-  else if(format == XB_FMT_A8R8G8B8)
+
+  if (m_thumbnailbufferSize < width * height)
   {
-    // create a copy for bgra -> rgb.
-    rgbbuf = new unsigned char [(width * height * 3)];
-    unsigned char* dst = rgbbuf;
-    for (unsigned int y = 0; y < height; y++)
+    // initial buffer, grown by libjpeg as needed
+    free(m_thumbnailbuffer);
+    m_thumbnailbuffer = (unsigned char*) malloc(width * height);
+    m_thumbnailbufferSize = m_thumbnailbuffer ? width * height : 0;
+    if (m_thumbnailbuffer == NULL)
     {
-      dst2 = dst;
-      src2 = src;
-      for (unsigned int x = 0; x < width; x++, src2 += 4)
-      {
-        *dst2++ = src2[2];
-        *dst2++ = src2[1];
-        *dst2++ = src2[0];
-      }
-      dst += width * 3;
-      src += pitch;
+      CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface error allocating memory for image buffer");
+      return false;
     }
   }
-  else
-  {
-    CLog::Log(LOGWARNING, "JpegIO::CreateThumbnailFromSurface Unsupported format");
-    free(result);
+
+#ifndef JCS_EXTENSIONS
+  unsigned char* rgbrow = NULL;
+  if (format == XB_FMT_A8R8G8B8 && (rgbrow = GetRowBuffer(width * 3)) == NULL)
     return false;
-  }
+#endif
 
-  cinfo.err = jpeg_std_error(&jerr.pub);
+  struct my_error_mgr jerr;
+  m_compressInfo.err = jpeg_std_error(&jerr.pub);
   jerr.pub.error_exit = jpeg_error_exit;
-  jpeg_create_compress(&cinfo);
+
+  // the compressor is created once; jpeg_finish_compress leaves it ready for the next image
+  if (!m_compressCreated)
+  {
+    jpeg_create_compress(&m_compressInfo);
+    m_compressCreated = true;
+  }
+
+  unsigned char* result = m_thumbnailbuffer;
+  outSize = m_thumbnailbufferSize;
 
   if (setjmp(jerr.setjmp_buffer))
   {
-    jpeg_destroy_compress(&cinfo);
-    free(result);
-    if(format != XB_FMT_RGB8)
-      delete [] rgbbuf;
+    jpeg_abort_compress(&m_compressInfo);
     return false;
   }
   else
   {
 #if JPEG_LIB_VERSION < 80
-    x_jpeg_mem_dest(&cinfo, &result, &outBufSize);
+    x_jpeg_mem_dest(&m_compressInfo, &result, &outSize);
 #else
-    jpeg_mem_dest(&cinfo, &result, &outBufSize);
+    jpeg_mem_dest(&m_compressInfo, &result, &outSize);
 #endif
-    cinfo.image_width = width;
-    cinfo.image_height = height;
-    cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
-    jpeg_set_defaults(&cinfo);
-    jpeg_set_quality(&cinfo, 90, TRUE);
-    jpeg_start_compress(&cinfo, TRUE);
-
-    while (cinfo.next_scanline < cinfo.image_height)
+    m_compressInfo.image_width = width;
+    m_compressInfo.image_height = height;
+#ifdef JCS_EXTENSIONS
+    // libjpeg-turbo reads our pixel layout itself
+    m_compressInfo.input_components = format == XB_FMT_RGB8 ? 3 : 4;
+    m_compressInfo.in_color_space = format == XB_FMT_RGB8 ? JCS_RGB : JCS_EXT_BGRX;
+#else
+    m_compressInfo.input_components = 3;
+    m_compressInfo.in_color_space = JCS_RGB;
+#endif
+    jpeg_set_defaults(&m_compressInfo);
+    jpeg_set_quality(&m_compressInfo, 90, TRUE);
+    jpeg_start_compress(&m_compressInfo, TRUE);
+
+    while (m_compressInfo.next_scanline < m_compressInfo.image_height)
     {
-      row_pointer[0] = &rgbbuf[cinfo.next_scanline * width * 3];
-      jpeg_write_scanlines(&cinfo, row_pointer, 1);
+      JSAMPROW row_pointer = bufferin + m_compressInfo.next_scanline * pitch;
+#ifndef JCS_EXTENSIONS
+      if (format == XB_FMT_A8R8G8B8)
+      {
+        SwizzleBGRAToRGB(row_pointer, rgbrow, width);
+        row_pointer = rgbrow;
+      }
+#endif
+      jpeg_write_scanlines(&m_compressInfo, &row_pointer, 1);
     }
 
-    jpeg_finish_compress(&cinfo);
-    jpeg_destroy_compress(&cinfo);
+    jpeg_finish_compress(&m_compressInfo);
   }
-  if(format != XB_FMT_RGB8)
-    delete [] rgbbuf;
 
-  XFILE::CFile file;
-  if (file.OpenForWrite(destFile, true))
+  // libjpeg moves to a buffer of its own when the image outgrows ours
+  if (result != m_thumbnailbuffer)
   {
-    file.Write(result, outBufSize);
-    file.Close();
-    free(result);
-    return true;
+    free(m_thumbnailbuffer);
+    m_thumbnailbuffer = result;
+    m_thumbnailbufferSize = outSize;
   }
-  free(result);
-  return false;
+  return true;
 }
 
 // override libjpeg's error function to avoid an exit() call
@@ -737,98 +893,12 @@ bool CJpegIO::CreateThumbnailFromSurface(unsigned char* bufferin, unsigned int w
                                          unsigned char* &bufferout, unsigned int &bufferoutSize)
 {
   //Encode raw data from buffer, save to destbuffer
-  struct jpeg_compress_struct cinfo;
-  struct my_error_mgr jerr;
-  JSAMPROW row_pointer[1];
-  long unsigned int outBufSize = width * height;
-  unsigned char* src = bufferin;
-  unsigned char* rgbbuf, *src2, *dst2;
-
-  if(bufferin == NULL)
-  {
-    CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface no buffer");
+  unsigned long outBufSize = 0;
+  if (!Encode(bufferin, width, height, format, pitch, outBufSize))
     return false;
-  }
-
-  m_thumbnailbuffer = (unsigned char*) malloc(outBufSize); //Initial buffer. Grows as-needed.
-  if (m_thumbnailbuffer == NULL)
-  {
-    CLog::Log(LOGERROR, "JpegIO::CreateThumbnailFromSurface error allocating memory for image buffer");
-    return false;
-  }
-
-  if(format == XB_FMT_RGB8)
-  {
-    rgbbuf = bufferin;
-  }
-  else if(format == XB_FMT_A8R8G8B8)
-  {
-    // create a copy for bgra -> rgb.
-    rgbbuf = new unsigned char [(width * height * 3)];
-    unsigned char* dst = rgbbuf;
-    for (unsigned int y = 0; y < height; y++)
-    {
-      dst2 = dst;
-      src2 = src;
-      for (unsigned int x = 0; x < width; x++, src2 += 4)
-      {
-        *dst2++ = src2[2];
-        *dst2++ = src2[1];
-        *dst2++ = src2[0];
-      }
-      dst += width * 3;
-      src += pitch;
-    }
-  }
-  else
-  {
-    CLog::Log(LOGWARNING, "JpegIO::CreateThumbnailFromSurface Unsupported format");
-    free(m_thumbnailbuffer);
-    return false;
-  }
-
-  cinfo.err = jpeg_std_error(&jerr.pub);
-  jerr.pub.error_exit = jpeg_error_exit;
-  jpeg_create_compress(&cinfo);
-
-  if (setjmp(jerr.setjmp_buffer))
-  {
-    jpeg_destroy_compress(&cinfo);
-    free(m_thumbnailbuffer);
-    if(format != XB_FMT_RGB8)
-      delete [] rgbbuf;
-    return false;
-  }
-  else
-  {
-#if JPEG_LIB_VERSION < 80
-    x_jpeg_mem_dest(&cinfo, &m_thumbnailbuffer, &outBufSize);
-#else
-    jpeg_mem_dest(&cinfo, &m_thumbnailbuffer, &outBufSize);
-#endif
-    cinfo.image_width = width;
-    cinfo.image_height = height;
-    cinfo.input_components = 3;
-    cinfo.in_color_space = JCS_RGB;
-    jpeg_set_defaults(&cinfo);
-    jpeg_set_quality(&cinfo, 90, TRUE);
-    jpeg_start_compress(&cinfo, TRUE);
-
-    while (cinfo.next_scanline < cinfo.image_height)
-    {
-      row_pointer[0] = &rgbbuf[cinfo.next_scanline * width * 3];
-      jpeg_write_scanlines(&cinfo, row_pointer, 1);
-    }
-
-    jpeg_finish_compress(&cinfo);
-    jpeg_destroy_compress(&cinfo);
-  }
-  if(format != XB_FMT_RGB8)
-    delete [] rgbbuf;
 
   bufferout = m_thumbnailbuffer;
   bufferoutSize = outBufSize;
-
   return true;
 }
 
@@ -838,5 +908,6 @@ void CJpegIO::ReleaseThumbnailBuffer()
   {
     free(m_thumbnailbuffer);
     m_thumbnailbuffer = NULL;
+    m_thumbnailbufferSize = 0;
   }
 }
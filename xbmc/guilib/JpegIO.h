@@ -53,12 +53,25 @@ protected:
   static  void   jpeg_error_exit(j_common_ptr cinfo);
 
   unsigned int   GetExifOrientation(unsigned char* exif_data, unsigned int exif_data_size);
+  unsigned char* GetRowBuffer(unsigned int size);
+
+  /*! \brief Encode an RGB8 or A8R8G8B8 surface to jpeg in m_thumbnailbuffer
+   The libjpeg state and the output buffer are kept from one image to the next, so a
+   CJpegIO that encodes many images only allocates when an image is bigger than the last.
+   */
+  bool           Encode(unsigned char* bufferin, unsigned int width, unsigned int height, unsigned int format, unsigned int pitch, unsigned long &outSize);
 
   unsigned char  *m_inputBuff;
   unsigned int   m_inputBuffSize;
   struct         jpeg_decompress_struct m_cinfo;
+  struct         jpeg_compress_struct m_compressInfo;
+  bool           m_decompressCreated;
+  bool           m_compressCreated;
   CStdString     m_texturePath;
   unsigned char* m_thumbnailbuffer;
+  unsigned long  m_thumbnailbufferSize;
+  unsigned char* m_rowBuffer;        // a scanline for the formats libjpeg can't read or write directly
+  unsigned int   m_rowBufferSize;
 };
 
 #endif
@@ -0,0 +1,157 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "JpegService.h"
+#include "JpegIO.h"
+#include "XBTF.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+
+using namespace std;
+
+// tracks a batch of thumbnails until its last job is done
+class CJpegBatch
+{
+public:
+  CJpegBatch(unsigned int remaining) : m_remaining(remaining), m_created(0) {}
+
+  void Done(bool success)
+  {
+    CSingleLock lock(m_section);
+    if (success)
+      m_created++;
+    if (--m_remaining == 0)
+      m_done.Set();
+  }
+
+  unsigned int m_remaining;
+  unsigned int m_created;
+  CEvent m_done;
+  CCriticalSection m_section;
+};
+
+class CJpegThumbnailJob : public CJob
+{
+public:
+  CJpegThumbnailJob(CJpegBatch &batch, const CStdString &source, const CStdString &dest, unsigned int width, unsigned int height) :
+    m_batch(batch), m_source(source), m_dest(dest), m_width(width), m_height(height) {}
+
+  virtual const char *GetType() const { return "jpegthumbnail"; }
+
+  virtual bool DoWork()
+  {
+    CJpegIO *jpeg = CJpegService::Get().Acquire();
+    bool success = jpeg->CreateThumbnail(m_source, m_dest, m_width, m_height, false);
+    if (!success)
+      CLog::Log(LOGERROR, "%s - unable to create thumbnail %s from %s", __FUNCTION__, m_dest.c_str(), m_source.c_str());
+    CJpegService::Get().Release(jpeg);
+    m_batch.Done(success);
+    return success;
+  }
+
+private:
+  CJpegBatch &m_batch;
+  CStdString m_source;
+  CStdString m_dest;
+  unsigned int m_width;
+  unsigned int m_height;
+};
+
+CJpegService &CJpegService::Get()
+{
+  static CJpegService s_service;
+  return s_service;
+}
+
+CJpegService::CJpegService() : CJobQueue(false, GetJobsAtOnce(), CJob::PRIORITY_NORMAL)
+{
+  m_created = 0;
+}
+
+CJpegService::~CJpegService()
+{
+  CancelJobs();
+  for (vector<CJpegIO *>::iterator i = m_pool.begin(); i != m_pool.end(); ++i)
+    delete *i;
+}
+
+unsigned int CJpegService::GetJobsAtOnce()
+{
+  return std::max(1, g_cpuInfo.getCPUCount());
+}
+
+CJpegIO *CJpegService::Acquire()
+{
+  CSingleLock lock(m_section);
+  if (!m_pool.empty())
+  {
+    CJpegIO *jpeg = m_pool.back();
+    m_pool.pop_back();
+    return jpeg;
+  }
+  m_created++;
+  return new CJpegIO();
+}
+
+void CJpegService::Release(CJpegIO *jpeg)
+{
+  jpeg->Close();
+  jpeg->ReleaseThumbnailBuffer();
+  {
+    CSingleLock lock(m_section);
+    // keep as many as are used at once, dropping the rest
+    if (m_pool.size() < GetJobsAtOnce())
+    {
+      m_pool.push_back(jpeg);
+      return;
+    }
+  }
+  delete jpeg;
+}
+
+bool CJpegService::CreateThumbnailFromSurface(const unsigned char *buffer, unsigned int width, unsigned int height, unsigned int pitch, const CStdString &destFile)
+{
+  CJpegIO *jpeg = Acquire();
+  bool success = jpeg->CreateThumbnailFromSurface((unsigned char *)buffer, width, height, XB_FMT_A8R8G8B8, pitch, destFile);
+  Release(jpeg);
+  return success;
+}
+
+unsigned int CJpegService::CreateThumbnails(const vector<pair<CStdString, CStdString> > &files, unsigned int width, unsigned int height)
+{
+  if (files.empty())
+    return 0;
+
+  CJpegBatch batch(files.size());
+  for (vector<pair<CStdString, CStdString> >::const_iterator i = files.begin(); i != files.end(); ++i)
+    AddJob(new CJpegThumbnailJob(batch, i->first, i->second, width, height));
+  batch.m_done.Wait();
+
+  CSingleLock lock(batch.m_section);
+  return batch.m_created;
+}
+
+unsigned int CJpegService::GetNumCreated() const
+{
+  CSingleLock lock(m_section);
+  return m_created;
+}
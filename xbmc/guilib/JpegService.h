@@ -0,0 +1,78 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include "utils/JobManager.h"
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+class CJpegIO;
+
+/*!
+ \ingroup textures,jobs
+ \brief Encodes and decodes jpegs with pooled CJpegIO instances
+
+ A CJpegIO keeps its libjpeg state and buffers from one image to the next, so the
+ service hands them out to whichever thread needs one rather than creating one per image.
+ Batches of thumbnails are spread over the cpu cores through the job manager.
+
+ \sa CJpegIO
+ */
+class CJpegService : public CJobQueue
+{
+public:
+  static CJpegService &Get();
+
+  /*! \brief Borrow a CJpegIO, to be handed back with Release() */
+  CJpegIO *Acquire();
+
+  /*! \brief Hand back a CJpegIO from Acquire() */
+  void Release(CJpegIO *jpeg);
+
+  /*! \brief Encode an A8R8G8B8 surface to a jpeg file with a pooled CJpegIO */
+  bool CreateThumbnailFromSurface(const unsigned char *buffer, unsigned int width, unsigned int height, unsigned int pitch, const CStdString &destFile);
+
+  /*! \brief Create thumbnails of a batch of jpegs in parallel, returning once all are done
+   \param files pairs of source jpeg and destination thumbnail
+   \param width the minimum width of the thumbnails
+   \param height the minimum height of the thumbnails
+   \return the number of thumbnails created
+   \sa CJpegIO::CreateThumbnail
+   */
+  unsigned int CreateThumbnails(const std::vector<std::pair<CStdString, CStdString> > &files, unsigned int width, unsigned int height);
+
+  /*! \brief Number of CJpegIO instances created so far */
+  unsigned int GetNumCreated() const;
+
+  /*! \brief Number of batch jobs run at once, one per cpu core */
+  static unsigned int GetJobsAtOnce();
+
+private:
+  // private construction, and no assignements; use the provided singleton methods
+  CJpegService();
+  CJpegService(const CJpegService&);
+  CJpegService const& operator=(CJpegService const&);
+  virtual ~CJpegService();
+
+  std::vector<CJpegIO *> m_pool;
+  unsigned int m_created;
+  mutable CCriticalSection m_section;
+};
@@ -360,18 +360,18 @@ bool CBaseTexture::LoadFromFileInternal(const CStdString& texturePath, unsigned
   IImage* pImage = ImageFactory::CreateLoader(url);
   if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height, autoRotate))
   {
-    delete pImage;
+    ImageFactory::Release(pImage);
     pImage = NULL;
     pImage = ImageFactory::CreateFallbackLoader(texturePath);
     if(!LoadIImage(pImage, inputBuff, inputBuffSize, width, height))
     {
       CLog::Log(LOGDEBUG, "%s - Load of %s failed.", __FUNCTION__, texturePath.c_str());
-      delete pImage;
+      ImageFactory::Release(pImage);
       free(inputBuff);
       return false;
     }
   }
-  delete pImage;
+  ImageFactory::Release(pImage);
   free(inputBuff);
 
   return true;
@@ -388,16 +388,16 @@ bool CBaseTexture::LoadFromFileInMem(unsigned char* buffer, size_t size, const s
   IImage* pImage = ImageFactory::CreateLoaderFromMimeType(mimeType);
   if(!LoadIImage(pImage, buffer, size, width, height))
   {
-    delete pImage;
+    ImageFactory::Release(pImage);
     pImage = NULL;
     pImage = ImageFactory::CreateFallbackLoader(mimeType);
     if(!LoadIImage(pImage, buffer, size, width, height))
     {
-      delete pImage;
+      ImageFactory::Release(pImage);
       return false;
     }
   }
-  delete pImage;
+  ImageFactory::Release(pImage);
   return true;
 }
 
@@ -134,6 +134,25 @@ public:
     identity = (a == 1.0f);
   }
 
+  // comparison operators
+  bool operator ==(const TransformMatrix &right) const
+  {
+    for (unsigned int i = 0; i < 3; i++)
+    {
+      for (unsigned int j = 0; j < 4; j++)
+      {
+        if (m[i][j] != right.m[i][j])
+          return false;
+      }
+    }
+    return alpha == right.alpha;
+  }
+
+  bool operator !=(const TransformMatrix &right) const
+  {
+    return !(*this == right);
+  }
+
   // multiplication operators
   const TransformMatrix &operator *=(const TransformMatrix &right)
   {
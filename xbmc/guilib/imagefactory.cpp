@@ -21,6 +21,7 @@
 
 #include "imagefactory.h"
 #include "guilib/JpegIO.h"
+#include "guilib/JpegService.h"
 #include "guilib/cximage.h"
 
 IImage* ImageFactory::CreateLoader(const std::string& strFileName)
@@ -37,10 +38,20 @@ IImage* ImageFactory::CreateLoader(const CURL& url)
 IImage* ImageFactory::CreateLoaderFromMimeType(const std::string& strMimeType)
 {
   if(strMimeType == "image/jpeg" || strMimeType == "image/tbn" || strMimeType == "image/jpg")
-    return new CJpegIO();
+    return CJpegService::Get().Acquire();
   return new CXImage(strMimeType);
 }
 
+void ImageFactory::Release(IImage* image)
+{
+  // jpeg loaders go back to the pool, keeping their libjpeg state for the next image
+  CJpegIO* jpeg = dynamic_cast<CJpegIO*>(image);
+  if (jpeg)
+    CJpegService::Get().Release(jpeg);
+  else
+    delete image;
+}
+
 IImage* ImageFactory::CreateFallbackLoader(const std::string& strMimeType)
 {
   return new CXImage(strMimeType);
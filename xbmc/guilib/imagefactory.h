@@ -34,4 +34,8 @@ public:
   static IImage* CreateLoaderFromMimeType(const std::string& strMimeType);
   static IImage* CreateFallbackLoader(const std::string& strMimeType);
   static IImage* CreateFallbackLoader(const CURL& url);
+  /*!
+   \brief Free a loader from one of the Create functions, instead of deleting it
+   */
+  static void Release(IImage* image);
 };
\ No newline at end of file
@@ -0,0 +1,192 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIPanelContainer.h"
+#include "guilib/GraphicContext.h"
+#include "guilib/GUIMessage.h"
+#include "FileItem.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/Variant.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#define CONTAINER_TEST_ITEMS        10000
+#define CONTAINER_TEST_COLUMNS      7
+#define CONTAINER_TEST_FRAME_TIME   16
+
+// a 7x4 poster wall
+static const char *testLayouts =
+  "<control type=\"panel\">\n"
+  "  <itemlayout width=\"180\" height=\"180\">\n"
+  "    <control type=\"image\">\n"
+  "      <width>170</width>\n"
+  "      <height>170</height>\n"
+  "      <texture>$INFO[ListItem.Icon]</texture>\n"
+  "    </control>\n"
+  "    <control type=\"image\">\n"
+  "      <width>170</width>\n"
+  "      <height>170</height>\n"
+  "      <texture>$INFO[ListItem.Thumb]</texture>\n"
+  "      <visible>!IsEmpty(ListItem.Label) + !ListItem.IsFolder</visible>\n"
+  "    </control>\n"
+  "    <control type=\"image\">\n"
+  "      <width>40</width>\n"
+  "      <height>40</height>\n"
+  "      <texture>$INFO[ListItem.Property(overlay)]</texture>\n"
+  "    </control>\n"
+  "  </itemlayout>\n"
+  "  <focusedlayout width=\"180\" height=\"180\">\n"
+  "    <control type=\"image\">\n"
+  "      <width>180</width>\n"
+  "      <height>180</height>\n"
+  "      <texture>$INFO[ListItem.Icon]</texture>\n"
+  "    </control>\n"
+  "  </focusedlayout>\n"
+  "</control>\n";
+
+class TestPanelContainer : public CGUIPanelContainer
+{
+public:
+  TestPanelContainer()
+    : CGUIPanelContainer(0, 50, 0, 0, 180 * CONTAINER_TEST_COLUMNS, 720, VERTICAL, CScroller(), 0)
+  {
+  }
+
+  const CGUIListItemLayoutPool &GetLayoutPool() const { return m_layoutPool; }
+};
+
+class TestGUIBaseContainer : public testing::Test
+{
+protected:
+  TestGUIBaseContainer()
+  {
+    CXBMCTinyXML doc;
+    doc.Parse(testLayouts);
+    m_panel.LoadLayout(doc.RootElement());
+    m_panel.SetFocus(true);
+
+    for (unsigned int i = 0; i < CONTAINER_TEST_ITEMS; i++)
+    {
+      CStdString label;
+      label.Format("Movie %u", i);
+      CFileItemPtr item(new CFileItem(label));
+      item->m_bIsFolder = (i % 10 == 0);
+      m_items.Add(item);
+    }
+    CGUIMessage msg(GUI_MSG_LABEL_BIND, 0, m_panel.GetID(), 0, 0, &m_items);
+    m_panel.OnMessage(msg);
+    m_time = 0;
+  }
+
+  // process the panel as its window would, returning the number of dirty regions
+  unsigned int ProcessFrame()
+  {
+    CDirtyRegionList dirtyRegions;
+    m_time += CONTAINER_TEST_FRAME_TIME;
+    g_graphicsContext.AddGUITransform();
+    m_panel.DoProcess(m_time, dirtyRegions);
+    g_graphicsContext.RemoveTransform();
+    return dirtyRegions.size();
+  }
+
+  TestPanelContainer m_panel;
+  CFileItemList m_items;
+  unsigned int m_time;
+};
+
+TEST_F(TestGUIBaseContainer, RecycleLayouts)
+{
+  ProcessFrame();
+  unsigned int created = m_panel.GetLayoutPool().GetNumCreated();
+  EXPECT_GT(created, 0u);
+
+  // scroll down a page and back, the layouts of the items scrolled out are reused
+  for (unsigned int i = 0; i < 8; i++)
+  {
+    CGUIMessage msg(GUI_MSG_ITEM_SELECT, 0, m_panel.GetID(), (i < 4 ? i + 1 : 8 - i - 1) * 4 * CONTAINER_TEST_COLUMNS);
+    m_panel.OnMessage(msg);
+    for (unsigned int frame = 0; frame < 20; frame++)
+      ProcessFrame();
+  }
+  EXPECT_GT(m_panel.GetLayoutPool().GetNumReused(), 0u);
+  EXPECT_LE(m_panel.GetLayoutPool().GetNumCreated(), 3 * created);
+
+  // nothing changes once the list settles, so nothing is processed
+  EXPECT_EQ(0u, ProcessFrame());
+  m_items[3]->SetLabel("");
+  EXPECT_GT(ProcessFrame(), 0u);
+  EXPECT_EQ(0u, ProcessFrame());
+
+  // as do properties set by scripts and jobs after the items are shown
+  m_items[4]->SetProperty("overlay", "overlay.png");
+  EXPECT_GT(ProcessFrame(), 0u);
+  m_items[4]->SetProperty("overlay", "overlay.png");
+  EXPECT_EQ(0u, ProcessFrame());
+  m_items[4]->ClearProperty("overlay");
+  EXPECT_GT(ProcessFrame(), 0u);
+  EXPECT_EQ(0u, ProcessFrame());
+}
+
+TEST_F(TestGUIBaseContainer, FastScroll)
+{
+  ProcessFrame();
+
+  // a row per frame through the whole list, as when holding down
+  for (int item = 0; item < CONTAINER_TEST_ITEMS; item += CONTAINER_TEST_COLUMNS)
+  {
+    CGUIMessage msg(GUI_MSG_ITEM_SELECT, 0, m_panel.GetID(), item);
+    m_panel.OnMessage(msg);
+    ProcessFrame();
+  }
+  const CGUIListItemLayoutPool &pool = m_panel.GetLayoutPool();
+  EXPECT_GT(pool.GetNumReused(), (unsigned int)CONTAINER_TEST_ITEMS / 2);
+  EXPECT_LT(pool.GetNumCreated(), (unsigned int)CONTAINER_TEST_ITEMS / 50);
+}
+
+TEST_F(TestGUIBaseContainer, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  ProcessFrame();
+
+  int64_t start = CurrentHostCounter();
+  unsigned int frames = 0;
+  for (int item = 0; item < CONTAINER_TEST_ITEMS; item += CONTAINER_TEST_COLUMNS, frames++)
+  {
+    CGUIMessage msg(GUI_MSG_ITEM_SELECT, 0, m_panel.GetID(), item);
+    m_panel.OnMessage(msg);
+    ProcessFrame();
+  }
+  double scrolling = CXBMCTestUtils::ElapsedMs(start) / frames;
+  const CGUIListItemLayoutPool &pool = m_panel.GetLayoutPool();
+
+  // and the wall once it settled
+  for (unsigned int frame = 0; frame < 20; frame++)
+    ProcessFrame();
+  start = CurrentHostCounter();
+  for (unsigned int frame = 0; frame < 100; frame++)
+    ProcessFrame();
+  double settled = CXBMCTestUtils::ElapsedMs(start) / 100;
+
+  std::cout << "Scrolled " << CONTAINER_TEST_ITEMS << " items in " << frames << " frames at "
+            << scrolling << " ms/frame, copying " << pool.GetNumCreated() << " layouts and reusing "
+            << pool.GetNumReused() << "; a settled frame takes " << settled << " ms" << std::endl;
+}
@@ -0,0 +1,264 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIFontGlyphCache.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+#define GLYPH_TEST_WIDTH        1024
+#define GLYPH_TEST_LINE_HEIGHT  30
+#define GLYPH_TEST_GLYPH_WIDTH  24
+#define GLYPH_TEST_MAX_HEIGHT   2048
+
+// CJK unified ideographs, of which the most frequent few thousand cover nearly all text
+#define CJK_FIRST               0x4e00
+#define CJK_CHARACTERS          6000
+#define CJK_LINE_LENGTH         20
+#define CJK_LINES               20000
+
+class TestGUIFontGlyphCache : public testing::Test
+{
+protected:
+  TestGUIFontGlyphCache()
+  {
+    m_budget = CGUIFontGlyphCache::GetBudget();
+    CGUIFontGlyphCache::SetBudget(0);
+  }
+
+  ~TestGUIFontGlyphCache()
+  {
+    CGUIFontGlyphCache::SetBudget(m_budget);
+  }
+
+  static void Insert(CGUIFontGlyphCache &cache, uint32_t key)
+  {
+    unsigned int x, y;
+    bool evicted;
+    CGUIFontGlyphCache::Glyph *glyph = cache.Insert(key, GLYPH_TEST_GLYPH_WIDTH, x, y, evicted);
+    ASSERT_TRUE(glyph != NULL);
+    glyph->left = (float)x;
+    glyph->top = (float)y;
+  }
+
+  /* Subtitle-like lines of CJK text, character frequencies following Zipf's law as they
+     do in natural language */
+  static void GetCJKCorpus(std::vector<std::vector<uint32_t> > &lines)
+  {
+    std::vector<double> cumulative(CJK_CHARACTERS);
+    double total = 0;
+    for (int i = 0; i < CJK_CHARACTERS; i++)
+    {
+      total += 1.0 / (i + 1);
+      cumulative[i] = total;
+    }
+
+    srand(1);
+    lines.resize(CJK_LINES);
+    for (int i = 0; i < CJK_LINES; i++)
+    {
+      for (int j = 0; j < CJK_LINE_LENGTH; j++)
+      {
+        double r = total * rand() / ((double)RAND_MAX + 1);
+        int rank = std::upper_bound(cumulative.begin(), cumulative.end(), r) - cumulative.begin();
+        lines[i].push_back(CJK_FIRST + rank);
+      }
+    }
+  }
+
+  // every line of text is rendered in a batch of its own, returns the number of cache hits
+  static unsigned int Render(CGUIFontGlyphCache &cache, const std::vector<std::vector<uint32_t> > &lines)
+  {
+    unsigned int hits = 0;
+    for (unsigned int line = 0; line < lines.size(); line++)
+    {
+      cache.BeginBatch();
+      for (unsigned int j = 0; j < lines[line].size(); j++)
+      {
+        if (cache.Find(lines[line][j]))
+        {
+          hits++;
+          continue;
+        }
+        unsigned int x, y;
+        bool evicted;
+        EXPECT_TRUE(cache.Insert(lines[line][j], GLYPH_TEST_GLYPH_WIDTH, x, y, evicted) != NULL);
+      }
+    }
+    return hits;
+  }
+
+  unsigned int m_budget;
+};
+
+TEST_F(TestGUIFontGlyphCache, FindInsert)
+{
+  CGUIFontGlyphCache cache;
+  cache.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, GLYPH_TEST_MAX_HEIGHT);
+  EXPECT_TRUE(cache.Find('a') == NULL);
+  EXPECT_EQ(0u, cache.GetHeight());
+
+  const unsigned int perLine = GLYPH_TEST_WIDTH / GLYPH_TEST_GLYPH_WIDTH;
+  for (uint32_t key = 0; key < perLine + 1; key++)
+    Insert(cache, key);
+  EXPECT_EQ(perLine + 1, cache.GetNumGlyphs());
+  EXPECT_EQ(2u * GLYPH_TEST_LINE_HEIGHT, cache.GetHeight());
+
+  // glyphs are packed left to right and keep their place
+  for (uint32_t key = 0; key < perLine + 1; key++)
+  {
+    CGUIFontGlyphCache::Glyph *glyph = cache.Find(key);
+    ASSERT_TRUE(glyph != NULL);
+    EXPECT_EQ(key, glyph->letterAndStyle);
+    EXPECT_EQ((float)(key % perLine) * GLYPH_TEST_GLYPH_WIDTH, glyph->left);
+    EXPECT_EQ((float)(key / perLine) * GLYPH_TEST_LINE_HEIGHT, glyph->top);
+  }
+  EXPECT_TRUE(cache.Find(perLine + 1) == NULL);
+
+  // glyphs wider than the texture don't fit
+  unsigned int x, y;
+  bool evicted;
+  EXPECT_TRUE(cache.Insert(0x10000, GLYPH_TEST_WIDTH + 1, x, y, evicted) == NULL);
+
+  cache.Clear();
+  EXPECT_TRUE(cache.Find(0) == NULL);
+  EXPECT_EQ(0u, CGUIFontGlyphCache::GetUsage());
+}
+
+TEST_F(TestGUIFontGlyphCache, EvictLeastRecentlyUsed)
+{
+  // room for three lines
+  CGUIFontGlyphCache cache;
+  cache.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, 3 * GLYPH_TEST_LINE_HEIGHT);
+  const unsigned int perLine = GLYPH_TEST_WIDTH / GLYPH_TEST_GLYPH_WIDTH;
+  for (uint32_t key = 0; key < 3 * perLine; key++)
+    Insert(cache, key);
+  EXPECT_EQ(0u, cache.GetNumEvictions());
+
+  // everything was used in this batch, so nothing can be evicted
+  unsigned int x, y;
+  bool evicted;
+  EXPECT_TRUE(cache.Insert(1000, GLYPH_TEST_GLYPH_WIDTH, x, y, evicted) == NULL);
+
+  // in the next batch the first and last lines are used, the second one goes
+  cache.BeginBatch();
+  EXPECT_TRUE(cache.Find(0) != NULL);
+  EXPECT_TRUE(cache.Find(2 * perLine) != NULL);
+  ASSERT_TRUE(cache.Insert(1000, GLYPH_TEST_GLYPH_WIDTH, x, y, evicted) != NULL);
+  EXPECT_TRUE(evicted);
+  EXPECT_EQ(0u, x);
+  EXPECT_EQ((unsigned int)GLYPH_TEST_LINE_HEIGHT, y);
+  EXPECT_EQ(1u, cache.GetNumEvictions());
+  EXPECT_EQ(2 * perLine + 1, cache.GetNumGlyphs());
+
+  EXPECT_TRUE(cache.Find(perLine) == NULL);
+  EXPECT_TRUE(cache.Find(2 * perLine - 1) == NULL);
+  EXPECT_TRUE(cache.Find(1000) != NULL);
+  EXPECT_TRUE(cache.Find(perLine - 1) != NULL);
+  EXPECT_TRUE(cache.Find(3 * perLine - 1) != NULL);
+}
+
+TEST_F(TestGUIFontGlyphCache, SharedBudget)
+{
+  const unsigned int lineSize = GLYPH_TEST_WIDTH * GLYPH_TEST_LINE_HEIGHT;
+  CGUIFontGlyphCache::SetBudget(3 * lineSize);
+
+  CGUIFontGlyphCache first, second;
+  first.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, GLYPH_TEST_MAX_HEIGHT);
+  second.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, GLYPH_TEST_MAX_HEIGHT);
+
+  const unsigned int perLine = GLYPH_TEST_WIDTH / GLYPH_TEST_GLYPH_WIDTH;
+  for (uint32_t key = 0; key < 2 * perLine; key++)
+    Insert(first, key);
+  EXPECT_EQ(2 * lineSize, CGUIFontGlyphCache::GetUsage());
+
+  // the second font gets the line left, and then starts evicting its own glyphs
+  for (uint32_t key = 0; key < 2 * perLine; key++)
+  {
+    second.BeginBatch();
+    Insert(second, key);
+  }
+  EXPECT_EQ(3 * lineSize, CGUIFontGlyphCache::GetUsage());
+  EXPECT_EQ((unsigned int)GLYPH_TEST_LINE_HEIGHT, second.GetHeight());
+  EXPECT_LT(0u, second.GetNumEvictions());
+  EXPECT_EQ(0u, first.GetNumEvictions());
+
+  first.Clear();
+  EXPECT_EQ(lineSize, CGUIFontGlyphCache::GetUsage());
+}
+
+TEST_F(TestGUIFontGlyphCache, CJKCorpus)
+{
+  std::vector<std::vector<uint32_t> > lines;
+  GetCJKCorpus(lines);
+
+  // a quarter of the texture, about 700 glyphs
+  const unsigned int budget = GLYPH_TEST_WIDTH * GLYPH_TEST_MAX_HEIGHT / 4;
+  const unsigned int sizes[] = { 0, budget };
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    CGUIFontGlyphCache::SetBudget(sizes[i]);
+    CGUIFontGlyphCache cache;
+    cache.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, GLYPH_TEST_MAX_HEIGHT);
+
+    double hitRate = 100.0 * Render(cache, lines) / (CJK_LINES * CJK_LINE_LENGTH);
+    EXPECT_LE(cache.GetHeight(), (unsigned int)GLYPH_TEST_MAX_HEIGHT);
+    if (sizes[i])
+    {
+      EXPECT_LE(CGUIFontGlyphCache::GetUsage(), sizes[i]);
+      EXPECT_LT(0u, cache.GetNumEvictions());
+      // the frequent characters stay cached
+      EXPECT_GT(hitRate, 55.0);
+    }
+    else
+      EXPECT_GT(hitRate, 80.0);
+  }
+}
+
+TEST_F(TestGUIFontGlyphCache, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  std::vector<std::vector<uint32_t> > lines;
+  GetCJKCorpus(lines);
+
+  const unsigned int budget = GLYPH_TEST_WIDTH * GLYPH_TEST_MAX_HEIGHT / 4;
+  const unsigned int sizes[] = { 0, budget };
+  for (unsigned int i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++)
+  {
+    CGUIFontGlyphCache::SetBudget(sizes[i]);
+    CGUIFontGlyphCache cache;
+    cache.Reset(GLYPH_TEST_WIDTH, GLYPH_TEST_LINE_HEIGHT, GLYPH_TEST_MAX_HEIGHT);
+
+    const unsigned int lookups = CJK_LINES * CJK_LINE_LENGTH;
+    int64_t start = CurrentHostCounter();
+    unsigned int hits = Render(cache, lines);
+    double elapsed = CXBMCTestUtils::ElapsedMs(start);
+
+    std::cout << "CJK corpus with " << (sizes[i] ? sizes[i] / 1024 : GLYPH_TEST_WIDTH * GLYPH_TEST_MAX_HEIGHT / 1024) << "KB: "
+              << lookups << " lookups, " << 100.0 * hits / lookups << "% hits, "
+              << cache.GetNumEvictions() << " evictions, "
+              << elapsed * 1e6 / lookups << "ns per glyph" << std::endl;
+  }
+}
@@ -0,0 +1,267 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUITextLayoutCache.h"
+#include "guilib/GUIFont.h"
+#include "guilib/GUIFontTTF.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#define TEXT_LAYOUT_TEST_LABELS     1000
+#define TEXT_LAYOUT_TEST_WIDTH      400.0f
+
+static const char *words[] = { "the", "of", "night", "return", "episode", "live", "at", "blue",
+                               "remastered", "a", "story", "and", "king", "river", "edition", "one" };
+
+class TestTextLayout : public CGUITextLayout
+{
+public:
+  TestTextLayout(CGUIFont *font, bool wrap) : CGUITextLayout(font, wrap) {}
+
+  // the lines as text, so layouts can be compared
+  std::string GetLines() const
+  {
+    std::string text;
+    for (std::vector<CGUIString>::const_iterator i = m_layout->m_lines.begin(); i != m_layout->m_lines.end(); ++i)
+      text += i->GetAsString() + (i->m_carriageReturn ? "\n" : "|");
+    return text;
+  }
+
+  CGUITextLinesPtr GetLayout() const { return m_layout; }
+};
+
+class TestGUITextLayout : public testing::Test
+{
+protected:
+  TestGUITextLayout()
+  {
+    m_fontFile = new CGUIFontTTF("test");
+    m_fontFile->Load(XBMC_REF_FILE_PATH("addons/skin.confluence/fonts/Roboto-Regular.ttf"), 20.0f);
+    m_font = new CGUIFont("font13", FONT_STYLE_NORMAL, 0, 0, 1.0f, 20.0f, m_fontFile);
+    g_textLayoutCache.Clear();
+  }
+
+  ~TestGUITextLayout()
+  {
+    g_textLayoutCache.Clear();
+    delete m_font;
+    delete m_fontFile;
+  }
+
+  static CStdString GetWords(unsigned int seed, unsigned int count)
+  {
+    CStdString text;
+    for (unsigned int i = 0; i < count; i++)
+    {
+      seed = seed * 1103515245 + 12345;
+      if (i)
+        text += " ";
+      text += words[(seed >> 16) % (sizeof(words) / sizeof(words[0]))];
+    }
+    return text;
+  }
+
+  // labels as a music or video library list would show them
+  static void GetLabels(std::vector<CStdString> &labels)
+  {
+    for (unsigned int i = 0; i < TEXT_LAYOUT_TEST_LABELS; i++)
+    {
+      CStdString label;
+      label.Format("%02u. [B]%s[/B] - %s", i % 100 + 1, GetWords(i, 2).c_str(), GetWords(i * 7 + 3, 3 + i % 4).c_str());
+      labels.push_back(label);
+    }
+  }
+
+  CGUIFontTTFBase *m_fontFile;
+  CGUIFont *m_font;
+};
+
+TEST_F(TestGUITextLayout, CacheEviction)
+{
+  CGUITextLayoutCache cache(2);
+  CGUITextLayoutParams params, otherFont;
+  otherFont.m_font = (CGUIFont *)&cache;
+  boost::shared_ptr<CGUITextLines> first(new CGUITextLines), second(new CGUITextLines);
+  first->m_width = 1;
+  second->m_width = 2;
+  cache.Add(params, L"first", first);
+  cache.Add(params, L"second", second);
+  EXPECT_FALSE(cache.Get(otherFont, L"first"));
+
+  // the first layout was used last, so the second one goes
+  CGUITextLinesPtr layout = cache.Get(params, L"first");
+  ASSERT_TRUE(layout);
+  EXPECT_EQ(first, layout);
+  EXPECT_EQ(1.0f, layout->m_width);
+  cache.Add(otherFont, L"third", layout);
+  EXPECT_EQ(2u, cache.GetNumEntries());
+  EXPECT_FALSE(cache.Get(params, L"second"));
+  EXPECT_TRUE(cache.Get(params, L"first"));
+
+  cache.Flush(otherFont.m_font);
+  EXPECT_EQ(1u, cache.GetNumEntries());
+  EXPECT_FALSE(cache.Get(otherFont, L"third"));
+  EXPECT_EQ(2u, cache.GetNumHits());
+  EXPECT_EQ(3u, cache.GetNumMisses());
+}
+
+TEST_F(TestGUITextLayout, SharedLayouts)
+{
+  TestTextLayout first(m_font, true), second(m_font, true), unwrapped(m_font, false);
+  CStdString text = GetWords(1, 40);
+  EXPECT_TRUE(first.Update(text, TEXT_LAYOUT_TEST_WIDTH));
+  EXPECT_EQ(0u, g_textLayoutCache.GetNumHits());
+  EXPECT_TRUE(second.Update(text, TEXT_LAYOUT_TEST_WIDTH));
+  EXPECT_EQ(1u, g_textLayoutCache.GetNumHits());
+  EXPECT_EQ(first.GetLayout(), second.GetLayout());
+  EXPECT_EQ(first.GetLines(), second.GetLines());
+  EXPECT_EQ(first.GetTextWidth(), second.GetTextWidth());
+  EXPECT_LE(first.GetTextWidth(), TEXT_LAYOUT_TEST_WIDTH);
+
+  // a layout that doesn't wrap is laid out separately
+  EXPECT_TRUE(unwrapped.Update(text, TEXT_LAYOUT_TEST_WIDTH));
+  EXPECT_EQ(1u, g_textLayoutCache.GetNumHits());
+  EXPECT_GT(unwrapped.GetTextWidth(), TEXT_LAYOUT_TEST_WIDTH);
+
+  // and the font going away drops them all
+  g_textLayoutCache.Flush(m_font);
+  EXPECT_EQ(0u, g_textLayoutCache.GetNumEntries());
+}
+
+TEST_F(TestGUITextLayout, ChangedSuffix)
+{
+  TestTextLayout layout(m_font, true);
+  CStdString text = "[COLOR red]" + GetWords(2, 30) + "[/COLOR][CR]" + GetWords(3, 30);
+  for (unsigned int i = 0; i < 50; i++)
+  {
+    // alternately append words and replace the last ones
+    text = (i % 2) ? text + " " + GetWords(i, 3) : text.Left(text.size() - 5) + GetWords(i, 2);
+    layout.Update(text, TEXT_LAYOUT_TEST_WIDTH);
+
+    g_textLayoutCache.Clear();
+    TestTextLayout full(m_font, true);
+    full.Update(text, TEXT_LAYOUT_TEST_WIDTH);
+    EXPECT_EQ(full.GetLines(), layout.GetLines()) << text;
+    EXPECT_EQ(full.GetTextWidth(), layout.GetTextWidth()) << text;
+  }
+}
+
+TEST_F(TestGUITextLayout, FontChange)
+{
+  TestTextLayout layout(m_font, true);
+  CStdString text = GetWords(5, 40);
+  layout.Update(text, TEXT_LAYOUT_TEST_WIDTH);
+  CGUITextLinesPtr shared = layout.GetLayout();
+
+  // the font is given bigger glyphs, as when the skin's fonts are reloaded
+  CGUIFontTTF bigger("test30");
+  bigger.Load(XBMC_REF_FILE_PATH("addons/skin.confluence/fonts/Roboto-Regular.ttf"), 30.0f);
+  m_font->SetFont(&bigger);
+  EXPECT_EQ(0u, g_textLayoutCache.GetNumEntries());
+
+  // the text changing only at its end still lays out the lines before it again
+  text += " " + GetWords(6, 2);
+  layout.Update(text, TEXT_LAYOUT_TEST_WIDTH);
+  TestTextLayout full(m_font, true);
+  g_textLayoutCache.Clear();
+  full.Update(text, TEXT_LAYOUT_TEST_WIDTH);
+  EXPECT_EQ(full.GetLines(), layout.GetLines());
+  EXPECT_EQ(full.GetTextWidth(), layout.GetTextWidth());
+  EXPECT_NE(shared, layout.GetLayout());
+
+  // and the layout shared before the change is left as it was
+  EXPECT_EQ(GetWords(5, 40).size(), (size_t)shared->m_parsedText.size() - 1);
+
+  m_font->SetFont(m_fontFile);
+}
+
+TEST_F(TestGUITextLayout, LayoutLabels)
+{
+  std::vector<CStdString> labels;
+  GetLabels(labels);
+
+  // each label laid out by a list item of its own, first when the cache is cold
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    CGUITextLayout layout(m_font, false);
+    layout.Update(labels[i]);
+  }
+  EXPECT_EQ(0u, g_textLayoutCache.GetNumHits());
+
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    CGUITextLayout layout(m_font, false);
+    layout.Update(labels[i]);
+  }
+  EXPECT_EQ(labels.size(), g_textLayoutCache.GetNumHits());
+}
+
+TEST_F(TestGUITextLayout, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  std::vector<CStdString> labels;
+  GetLabels(labels);
+
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    CGUITextLayout layout(m_font, false);
+    layout.Update(labels[i]);
+  }
+  double cold = labels.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < labels.size(); i++)
+  {
+    CGUITextLayout layout(m_font, false);
+    layout.Update(labels[i]);
+  }
+  double warm = labels.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  // a wrapped text growing a few words at a time, as a textbox being filled in
+  CStdString text = GetWords(4, 50);
+  std::vector<CStdString> texts;
+  for (unsigned int i = 0; i < 200; i++)
+  {
+    text += " " + GetWords(i, 2);
+    texts.push_back(text);
+  }
+  TestTextLayout incremental(m_font, true);
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < texts.size(); i++)
+    incremental.Update(texts[i], TEXT_LAYOUT_TEST_WIDTH);
+  double appended = texts.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < texts.size(); i++)
+  {
+    g_textLayoutCache.Clear();
+    TestTextLayout full(m_font, true);
+    full.Update(texts[i], TEXT_LAYOUT_TEST_WIDTH);
+  }
+  double scratch = texts.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << "Laid out " << labels.size() << " labels at " << cold << " layouts/s cold, "
+            << warm << " layouts/s cached; a growing wrapped text at " << appended
+            << " layouts/s incrementally, " << scratch << " layouts/s from scratch" << std::endl;
+}
@@ -0,0 +1,255 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/GUIWindowCache.h"
+#include "addons/Skin.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "GUIInfoManager.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#define WINDOW_CACHE_TEST_PASSES 5
+
+static const char *testWindow =
+  "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n"
+  "<window id=\"0\">\n"
+  "  <!-- comments are dropped -->\n"
+  "  <defaultcontrol always=\"true\">9000</defaultcontrol>\n"
+  "  <controls>\n"
+  "    <control type=\"label\" id=\"2\">\n"
+  "      <posx>10</posx>\n"
+  "      <label>$INFO[ListItem.Label]</label>\n"
+  "      <onclick><![CDATA[SetFocus(50)]]></onclick>\n"
+  "    </control>\n"
+  "    <control type=\"label\" id=\"3\"/>\n"
+  "  </controls>\n"
+  "</window>\n";
+
+class TestGUIWindowCache : public testing::Test
+{
+protected:
+  TestGUIWindowCache()
+  {
+    ADDON::AddonProps props("skin.confluence", ADDON::ADDON_SKIN, "2.1.3", "");
+    props.path = XBMC_REF_FILE_PATH("addons/skin.confluence/");
+    g_SkinInfo = boost::shared_ptr<ADDON::CSkinInfo>(new ADDON::CSkinInfo(props, RESOLUTION_INFO(1280, 720, 0, "720p")));
+    g_SkinInfo->Start();
+    g_SkinInfo->LoadIncludes();
+    CGUIWindowCache::Clear();
+  }
+
+  ~TestGUIWindowCache()
+  {
+    CGUIWindowCache::Clear();
+    g_SkinInfo.reset();
+  }
+
+  // parse the window and resolve its includes, as CGUIWindow does without the cache
+  static TiXmlElement *LoadWindow(const CStdString &path, std::map<int, bool> &conditions)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(path) || strcmp(doc.RootElement()->Value(), "window"))
+      return NULL;
+    TiXmlElement *root = (TiXmlElement *)doc.RootElement()->Clone();
+    g_SkinInfo->ResolveIncludes(root, &conditions);
+    return root;
+  }
+
+  // the first load stores the resolved windows, it also loads any include files they use
+  static void StoreSkinWindows(std::vector<CStdString> &windows)
+  {
+    CFileItemList items;
+    ASSERT_TRUE(XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.confluence/720p/"), items, ".xml"));
+
+    for (int i = 0; i < items.Size(); i++)
+    {
+      std::map<int, bool> conditions;
+      TiXmlElement *root = LoadWindow(items[i]->GetPath(), conditions);
+      if (!root)
+        continue;
+      EXPECT_TRUE(CGUIWindowCache::Store(items[i]->GetPath(), root, conditions));
+      windows.push_back(items[i]->GetPath());
+      delete root;
+    }
+    ASSERT_FALSE(windows.empty());
+  }
+};
+
+TEST_F(TestGUIWindowCache, Serialize)
+{
+  CXBMCTinyXML doc;
+  doc.Parse(testWindow);
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CGUIWindowCache::Serialize(doc.RootElement(), data);
+  TiXmlElement *root = CGUIWindowCache::Deserialize(data);
+  ASSERT_TRUE(root != NULL);
+
+  EXPECT_STREQ("window", root->Value());
+  EXPECT_STREQ("0", root->Attribute("id"));
+  const TiXmlElement *defaultControl = root->FirstChildElement("defaultcontrol");
+  ASSERT_TRUE(defaultControl != NULL);
+  EXPECT_STREQ("true", defaultControl->Attribute("always"));
+  EXPECT_STREQ("9000", defaultControl->FirstChild()->Value());
+  EXPECT_TRUE(defaultControl->PreviousSibling() == NULL);
+
+  const TiXmlElement *control = root->FirstChildElement("controls")->FirstChildElement("control");
+  ASSERT_TRUE(control != NULL);
+  EXPECT_STREQ("$INFO[ListItem.Label]", control->FirstChildElement("label")->FirstChild()->Value());
+  const TiXmlText *onclick = control->FirstChildElement("onclick")->FirstChild()->ToText();
+  ASSERT_TRUE(onclick != NULL);
+  EXPECT_TRUE(onclick->CDATA());
+  EXPECT_STREQ("SetFocus(50)", onclick->Value());
+  control = control->NextSiblingElement("control");
+  ASSERT_TRUE(control != NULL);
+  EXPECT_STREQ("3", control->Attribute("id"));
+  EXPECT_TRUE(control->FirstChild() == NULL);
+
+  // a rebuilt tree serializes the same
+  std::string again;
+  CGUIWindowCache::Serialize(root, again);
+  EXPECT_EQ(data, again);
+  delete root;
+
+  // truncated data is rejected
+  for (size_t size = 0; size < data.size(); size += 7)
+    EXPECT_TRUE(CGUIWindowCache::Deserialize(data.substr(0, size)) == NULL);
+}
+
+TEST_F(TestGUIWindowCache, LoadSkinWindows)
+{
+  std::vector<CStdString> windows;
+  StoreSkinWindows(windows);
+  if (HasFatalFailure())
+    return;
+
+  // the cached windows are the windows we would have resolved
+  for (unsigned int i = 0; i < windows.size(); i++)
+  {
+    std::map<int, bool> resolvedConditions, cachedConditions;
+    TiXmlElement *resolved = LoadWindow(windows[i], resolvedConditions);
+    TiXmlElement *cached = CGUIWindowCache::Load(windows[i], cachedConditions);
+    ASSERT_TRUE(cached != NULL);
+    std::string resolvedData, cachedData;
+    CGUIWindowCache::Serialize(resolved, resolvedData);
+    CGUIWindowCache::Serialize(cached, cachedData);
+    EXPECT_TRUE(resolvedData == cachedData) << windows[i];
+    EXPECT_EQ(resolvedConditions, cachedConditions) << windows[i];
+    delete resolved;
+    delete cached;
+  }
+}
+
+TEST_F(TestGUIWindowCache, ConditionVariants)
+{
+  CStdString path = "special://temp/testwindowcache.xml";
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(path, true));
+  ASSERT_EQ((int)strlen(testWindow), file.Write(testWindow, strlen(testWindow)));
+  file.Close();
+
+  int setting = g_settings.TranslateSkinBool("windowcachetest");
+  int condition = g_infoManager.Register("Skin.HasSetting(windowcachetest)");
+  CXBMCTinyXML doc;
+  doc.Parse(testWindow);
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  // the window as resolved with the condition set, and with it unset
+  g_settings.SetSkinBool(setting, true);
+  std::map<int, bool> conditions;
+  conditions[condition] = true;
+  TiXmlElement on(*doc.RootElement());
+  on.SetAttribute("variant", "on");
+  EXPECT_TRUE(CGUIWindowCache::Store(path, &on, conditions));
+
+  g_settings.SetSkinBool(setting, false);
+  EXPECT_TRUE(CGUIWindowCache::Load(path, conditions) == NULL);
+  conditions[condition] = false;
+  TiXmlElement off(*doc.RootElement());
+  off.SetAttribute("variant", "off");
+  EXPECT_TRUE(CGUIWindowCache::Store(path, &off, conditions));
+
+  // both are kept, flipping the condition picks the other one without storing it again
+  for (int i = 0; i < 4; i++)
+  {
+    bool value = i % 2 == 0;
+    g_settings.SetSkinBool(setting, value);
+    std::map<int, bool> loadedConditions;
+    TiXmlElement *root = CGUIWindowCache::Load(path, loadedConditions);
+    ASSERT_TRUE(root != NULL);
+    EXPECT_STREQ(value ? "on" : "off", root->Attribute("variant"));
+    EXPECT_EQ(value, loadedConditions[condition]);
+    delete root;
+  }
+
+  // a reload of the skin forgets them
+  CGUIWindowCache::Clear();
+  EXPECT_TRUE(CGUIWindowCache::Load(path, conditions) == NULL);
+
+  g_settings.SetSkinBool(setting, false);
+  XFILE::CFile::Delete(path);
+}
+
+TEST_F(TestGUIWindowCache, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  std::vector<CStdString> windows;
+  StoreSkinWindows(windows);
+  if (HasFatalFailure())
+    return;
+
+  int64_t start = CurrentHostCounter();
+  for (int pass = 0; pass < WINDOW_CACHE_TEST_PASSES; pass++)
+  {
+    for (unsigned int i = 0; i < windows.size(); i++)
+    {
+      std::map<int, bool> conditions;
+      delete LoadWindow(windows[i], conditions);
+    }
+  }
+  double cold = CXBMCTestUtils::ElapsedMs(start) / WINDOW_CACHE_TEST_PASSES;
+
+  start = CurrentHostCounter();
+  unsigned int hits = 0;
+  for (int pass = 0; pass < WINDOW_CACHE_TEST_PASSES; pass++)
+  {
+    for (unsigned int i = 0; i < windows.size(); i++)
+    {
+      std::map<int, bool> conditions;
+      TiXmlElement *root = CGUIWindowCache::Load(windows[i], conditions);
+      if (root)
+        hits++;
+      delete root;
+    }
+  }
+  double warm = CXBMCTestUtils::ElapsedMs(start) / WINDOW_CACHE_TEST_PASSES;
+  EXPECT_EQ(windows.size() * WINDOW_CACHE_TEST_PASSES, hits);
+
+  std::cout << "Loaded " << windows.size() << " windows in " << cold << "ms from xml, "
+            << warm << "ms from the cache" << std::endl;
+}
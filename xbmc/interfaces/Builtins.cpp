@@ -38,6 +38,7 @@
 #include "dialogs/GUIDialogYesNo.h"
 #include "GUIUserMessages.h"
 #include "windows/GUIWindowLoginScreen.h"
+#include "video/ThumbExtractionService.h"
 #include "video/windows/GUIWindowVideoBase.h"
 #include "addons/GUIWindowAddonBrowser.h"
 #include "addons/Addon.h" // for TranslateType, TranslateContent
@@ -1276,6 +1277,9 @@ int CBuiltins::Execute(const CStdString& execString)
 
     ADDON::CAddonMgr::Get().StopServices(true);
 
+    // thumbs waiting to be extracted are kept with the profile
+    CThumbExtractionService::Get().Stop();
+
     g_application.getNetwork().NetworkMessage(CNetwork::SERVICES_DOWN,1);
     g_settings.LoadMasterForLogin();
     g_passwordManager.bMasterUser = false;
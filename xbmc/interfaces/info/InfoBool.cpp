@@ -30,6 +30,7 @@ InfoSingle::InfoSingle(const CStdString &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression);
+  m_sources = g_infoManager.GetInfoSources(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -142,6 +143,11 @@ void InfoExpression::Parse(const CStdString &expression)
     operators.pop();
   }
 
+  // we depend on whatever our operands depend on
+  m_sources = INFO_SOURCE_CONSTANT;
+  for (vector<unsigned int>::const_iterator it = m_operands.begin(); it != m_operands.end(); ++it)
+    m_sources |= g_infoManager.GetBoolSources(*it);
+
   // test evaluate
   bool test;
   if (!Evaluate(NULL, test))
@@ -28,6 +28,14 @@ class CGUIListItem;
 
 namespace INFO
 {
+// Sources of the data info bools depend on. Sources other than INFO_SOURCE_POLLED
+// and INFO_SOURCE_ITEM publish their changes via CGUIInfoManager::InvalidateSource
+#define INFO_SOURCE_CONSTANT  0x00 ///< never changes
+#define INFO_SOURCE_SKIN      0x01 ///< skin settings
+#define INFO_SOURCE_LIBRARY   0x02 ///< library contents
+#define INFO_SOURCE_ITEM      0x04 ///< the list item, polled unless evaluated for a given item
+#define INFO_SOURCE_POLLED    0x80 ///< anything else, re-evaluated once per frame
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -38,30 +46,58 @@ public:
   InfoBool(const CStdString &expression, int context)
     : m_value(false),
       m_context(context),
+      m_sources(INFO_SOURCE_POLLED),
       m_expression(expression),
-      m_lastUpdate(0)
+      m_dirty(true),
+      m_lastUpdate(0),
+      m_lastEpoch(0)
   {
   };
 
   virtual ~InfoBool() {};
 
+  /*! \brief Whether the value of this info bool needs to be updated
+   \param time current time, polled info bools are updated when it changes
+   \param epoch change epoch of the sources of this info bool
+   \sa GetSources
+   */
+  inline bool IsDirty(unsigned int time, unsigned int epoch) const
+  {
+    if (m_dirty)
+      return true;
+    if (m_sources & (INFO_SOURCE_POLLED | INFO_SOURCE_ITEM))
+      return time != m_lastUpdate;
+    return epoch != m_lastEpoch;
+  }
+
   /*! \brief Get the value of this info bool
    This is called to update (if necessary) and fetch the value of the info bool
    \param time current time (used to test if we need to update yet)
+   \param epoch change epoch of the sources of this info bool
    \param item the item used to evaluate the bool
    */
-  inline bool Get(unsigned int time, const CGUIListItem *item = NULL)
+  inline bool Get(unsigned int time, unsigned int epoch, const CGUIListItem *item = NULL)
   {
     if (item)
+    {
       Update(item);
-    else if (time - m_lastUpdate > 0)
+      m_dirty = true; // the value is specific to the item
+    }
+    else if (IsDirty(time, epoch))
     {
       Update(NULL);
+      m_dirty = false;
       m_lastUpdate = time;
+      m_lastEpoch = epoch;
     }
     return m_value;
   }
 
+  /*! \brief The INFO_SOURCE_* flags of the data this info bool depends on */
+  unsigned int GetSources() const { return m_sources; }
+
+  const CStdString &GetExpression() const { return m_expression; }
+
   bool operator==(const InfoBool &right) const
   {
     return (m_context == right.m_context && 
@@ -77,10 +113,13 @@ protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
+  unsigned int m_sources;      ///< INFO_SOURCE_* flags of the data the value depends on
 
 private:
   CStdString m_expression;     ///< original expression
+  bool m_dirty;                ///< value needs updating regardless of time and epoch
   unsigned int m_lastUpdate;   ///< last update time (to determine dirty status)
+  unsigned int m_lastEpoch;    ///< change epoch of our sources at the last update
 };
 
 /*! \brief Class to wrap active boolean conditions
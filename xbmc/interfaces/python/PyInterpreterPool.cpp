@@ -0,0 +1,141 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#if (defined HAVE_CONFIG_H) && (!defined WIN32)
+  #include "config.h"
+#endif
+
+// python.h should always be included first before any other includes
+#include <Python.h>
+
+#include "PyInterpreterPool.h"
+#include "LanguageHook.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/log.h"
+
+CPyInterpreterPool::CPyInterpreterPool()
+{
+  m_capacity = PYTHON_POOL_SIZE;
+}
+
+CPyInterpreterPool::~CPyInterpreterPool()
+{
+  // python is finalized by now, all we can do is forget about them
+  if (!m_idle.empty())
+    CLog::Log(LOGWARNING, "%s - %u python interpreters were never ended", __FUNCTION__, (unsigned int)m_idle.size());
+}
+
+bool CPyInterpreterPool::Acquire(const CStdString &addonId, const CStdString &addonVersion, const CStdString &addonPath, Interpreter &interpreter)
+{
+  CSingleLock lock(m_critSection);
+  for (InterpreterList::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+  {
+    // an updated or moved add-on has to run its new code
+    if (it->addonId == addonId && it->addonVersion == addonVersion && it->addonPath == addonPath)
+    {
+      interpreter = *it;
+      m_idle.erase(it);
+      CLog::Log(LOGDEBUG, "%s - reusing python interpreter of %s", __FUNCTION__, addonId.c_str());
+      return true;
+    }
+  }
+  return false;
+}
+
+void CPyInterpreterPool::Release(const Interpreter &interpreter)
+{
+  InterpreterList expired;
+  {
+    CSingleLock lock(m_critSection);
+    m_idle.push_front(interpreter);
+    m_idle.front().lastUsed = XbmcThreads::SystemClockMillis();
+    while (m_idle.size() > m_capacity)
+      expired.splice(expired.end(), m_idle, --m_idle.end());
+  }
+  End(expired);
+}
+
+void CPyInterpreterPool::Expire(unsigned int idleTime)
+{
+  InterpreterList expired;
+  {
+    CSingleLock lock(m_critSection);
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    while (!m_idle.empty() && now - m_idle.back().lastUsed > idleTime)
+      expired.splice(expired.end(), m_idle, --m_idle.end());
+  }
+  End(expired);
+}
+
+void CPyInterpreterPool::Clear()
+{
+  InterpreterList expired;
+  {
+    CSingleLock lock(m_critSection);
+    expired.swap(m_idle);
+  }
+  End(expired);
+}
+
+bool CPyInterpreterPool::IsEmpty()
+{
+  CSingleLock lock(m_critSection);
+  return m_idle.empty();
+}
+
+void CPyInterpreterPool::SetCapacity(unsigned int capacity)
+{
+  InterpreterList expired;
+  {
+    CSingleLock lock(m_critSection);
+    m_capacity = capacity;
+    while (m_idle.size() > m_capacity)
+      expired.splice(expired.end(), m_idle, --m_idle.end());
+  }
+  End(expired);
+}
+
+void CPyInterpreterPool::End(InterpreterList &interpreters)
+{
+  for (InterpreterList::iterator it = interpreters.begin(); it != interpreters.end(); ++it)
+    End(*it);
+}
+
+void CPyInterpreterPool::End(Interpreter &interpreter)
+{
+  CLog::Log(LOGDEBUG, "%s - ending python interpreter of %s", __FUNCTION__, interpreter.addonId.c_str());
+
+  PyInterpreterState *interp = (PyInterpreterState*)interpreter.interp;
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> languageHook(XBMCAddon::Python::LanguageHook::GetIfExists(interp));
+
+  // Py_EndInterpreter needs a thread state of the interpreter to be current
+  PyEval_AcquireLock();
+  PyThreadState *state = PyThreadState_New(interp);
+  PyThreadState_Swap(state);
+  Py_XDECREF((PyObject*)interpreter.mainDict);
+  Py_EndInterpreter(state);
+  PyThreadState_Swap(NULL);
+  PyEval_ReleaseLock();
+
+  if (!languageHook.isNull())
+    languageHook->UnregisterMe();
+}
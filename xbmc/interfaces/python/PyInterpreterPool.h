@@ -0,0 +1,94 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *  http://www.gnu.org/copyleft/gpl.html
+ *
+ */
+
+#include "threads/CriticalSection.h"
+#include "utils/StdString.h"
+
+#include <list>
+
+// Number of idle sub-interpreters kept warm
+#define PYTHON_POOL_SIZE          4
+// Idle sub-interpreters are ended after this long
+#define PYTHON_POOL_IDLE_TIMEOUT  120000 // ms
+
+/**
+ * Keeps the sub-interpreters of finished plugin invocations around so the
+ * next invocation of the same add-on can skip Py_NewInterpreter, the setup of
+ * the xbmc modules and the import of the modules the add-on depends on, which
+ * stay cached in the interpreter's sys.modules. The add-on's own modules are
+ * dropped before an interpreter is kept, as they may have read sys.argv when
+ * they were imported.
+ *
+ * Interpreters are handed out exclusively and are kept per add-on, version
+ * and path since the interpreter setup depends on the add-on's API version.
+ * An interpreter is only returned to the pool by XBPyThread when the script
+ * ended cleanly.
+ */
+class CPyInterpreterPool
+{
+public:
+  struct Interpreter
+  {
+    Interpreter() : interp(NULL), mainDict(NULL), lastUsed(0) { }
+
+    void*        interp;   // PyInterpreterState*
+    void*        mainDict; // copy of __main__'s dict after the interpreter setup
+    CStdString   addonId;
+    CStdString   addonVersion;
+    CStdString   addonPath;
+    CStdString   basePath; // sys.path before the add-on's paths were added
+    unsigned int lastUsed;
+  };
+
+  CPyInterpreterPool();
+  ~CPyInterpreterPool();
+
+  /*! \brief Take an idle interpreter set up for the given add-on, version and path */
+  bool Acquire(const CStdString &addonId, const CStdString &addonVersion, const CStdString &addonPath, Interpreter &interpreter);
+
+  /*! \brief Keep an interpreter for reuse, the least recently used one is
+   ended if the pool is full. Must be called without holding the GIL. */
+  void Release(const Interpreter &interpreter);
+
+  /*! \brief End interpreters idle for longer than the given time.
+   Must be called without holding the GIL. */
+  void Expire(unsigned int idleTime);
+
+  /*! \brief End all idle interpreters. Must be called without holding the GIL. */
+  void Clear();
+
+  bool IsEmpty();
+
+  void SetCapacity(unsigned int capacity);
+  unsigned int GetCapacity() const { return m_capacity; }
+
+private:
+  typedef std::list<Interpreter> InterpreterList;
+
+  static void End(Interpreter &interpreter);
+  static void End(InterpreterList &interpreters);
+
+  CCriticalSection m_critSection;
+  InterpreterList  m_idle; // most recently used first
+  unsigned int     m_capacity;
+};
@@ -35,6 +35,7 @@
 #include "utils/log.h"
 #include "threads/SingleLock.h"
 #include "utils/URIUtils.h"
+#include "utils/StringUtils.h"
 #include "addons/AddonManager.h"
 #include "addons/Addon.h"
 #include "Application.h"
@@ -53,6 +54,7 @@
 #include "interfaces/python/swig.h"
 #include "utils/CharsetConverter.h"
 #include "PyContext.h"
+#include "PyInterpreterPool.h"
 
 #ifdef _WIN32
 extern "C" FILE *fopen_utf8(const char *_Filename, const char *_Mode);
@@ -78,6 +80,7 @@ XBPyThread::XBPyThread(XBPython *pExecuter, int id) : CThread("XBPyThread")
   m_threadState = NULL;
   m_id          = id;
   m_stopping    = false;
+  m_pooled      = false;
   m_argv        = NULL;
   m_source      = NULL;
   m_argc        = 0;
@@ -169,15 +172,42 @@ static const CStdString getListOfAddonClassesAsString(XBMCAddon::AddonClass::Ref
   return message;
 }
 
+// Drops the modules loaded from below the given path from sys.modules. They
+// are imported again on the next run, so whatever they read from sys.argv at
+// import time is up to date.
+static void RemoveModulesUnder(CStdString path)
+{
+  URIUtils::AddSlashAtEnd(path);
+  PyObject *modules = PyImport_GetModuleDict(); // borrowed ref
+  PyObject *names = PyDict_Keys(modules);
+  for (Py_ssize_t i = 0; names && i < PyList_Size(names); i++)
+  {
+    PyObject *name = PyList_GetItem(names, i); // borrowed ref
+    PyObject *module = PyDict_GetItem(modules, name); // borrowed ref
+    if (!module || !PyModule_Check(module))
+      continue;
+
+    const char *file = PyModule_GetFilename(module);
+    if (!file)
+      PyErr_Clear(); // builtin modules have no file
+    else if (StringUtils::StartsWith(file, path))
+      PyDict_DelItem(modules, name);
+  }
+  Py_XDECREF(names);
+}
+
 void XBPyThread::Process()
 {
   CLog::Log(LOGDEBUG,"Python thread: start processing");
 
   int m_Py_file_input = Py_file_input;
 
+  CPyInterpreterPool::Interpreter pooled;
+  bool reused = m_pooled && addon && m_pExecuter->GetInterpreterPool().Acquire(addon->ID(), addon->Version().c_str(), addon->Path(), pooled);
+
   // get the global lock
   PyEval_AcquireLock();
-  PyThreadState* state = Py_NewInterpreter();
+  PyThreadState* state = reused ? PyThreadState_New((PyInterpreterState*)pooled.interp) : Py_NewInterpreter();
   if (!state)
   {
     PyEval_ReleaseLock();
@@ -187,10 +217,25 @@ void XBPyThread::Process()
   // swap in my thread state
   PyThreadState_Swap(state);
 
-  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> languageHook(new XBMCAddon::Python::LanguageHook(state->interp));
-  languageHook->RegisterMe();
+  XBMCAddon::AddonClass::Ref<XBMCAddon::Python::LanguageHook> languageHook;
+  if (reused)
+  {
+    // the interpreter was set up by a previous run of this add-on
+    languageHook = XBMCAddon::Python::LanguageHook::GetIfExists(state->interp);
+    PyObject *m = PyImport_AddModule((char*)"xbmc");
+    if(!m || PyObject_SetAttrString(m, (char*)"abortRequested", Py_False))
+      CLog::Log(LOGERROR, "Python thread: failed to reset abortRequested");
+  }
+  else
+  {
+    languageHook = new XBMCAddon::Python::LanguageHook(state->interp);
+    languageHook->RegisterMe();
 
-  m_pExecuter->InitializeInterpreter(addon);
+    m_pExecuter->InitializeInterpreter(addon);
+
+    // remember what __main__ looks like after the setup to restore it before reuse
+    pooled.mainDict = m_pooled ? PyDict_Copy(PyModule_GetDict(PyImport_AddModule((char*)"__main__"))) : NULL;
+  }
 
   CLog::Log(LOGDEBUG, "%s - The source file to load is %s", __FUNCTION__, m_source);
 
@@ -218,29 +263,36 @@ void XBPyThread::Process()
   // and add on whatever our default path is
   path += PY_PATH_SEP;
 
-  // we want to use sys.path so it includes site-packages
-  // if this fails, default to using Py_GetPath
-  PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
-  PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
-  PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
-
-  if( pathObj && PyList_Check(pathObj) )
+  // a reused interpreter already has our paths in sys.path, so use the one
+  // it started out with
+  CStdString basePath = pooled.basePath;
+  if (!reused)
   {
-    for( int i = 0; i < PyList_Size(pathObj); i++ )
+    // we want to use sys.path so it includes site-packages
+    // if this fails, default to using Py_GetPath
+    PyObject *sysMod(PyImport_ImportModule((char*)"sys")); // must call Py_DECREF when finished
+    PyObject *sysModDict(PyModule_GetDict(sysMod)); // borrowed ref, no need to delete
+    PyObject *pathObj(PyDict_GetItemString(sysModDict, "path")); // borrowed ref, no need to delete
+
+    if( pathObj && PyList_Check(pathObj) )
     {
-      PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
-      if( e && PyString_Check(e) )
+      for( int i = 0; i < PyList_Size(pathObj); i++ )
       {
-        path += PyString_AsString(e); // returns internal data, don't delete or modify
-        path += PY_PATH_SEP;
+        PyObject *e = PyList_GetItem(pathObj, i); // borrowed ref, no need to delete
+        if( e && PyString_Check(e) )
+        {
+          basePath += PyString_AsString(e); // returns internal data, don't delete or modify
+          basePath += PY_PATH_SEP;
+        }
       }
     }
+    else
+    {
+      basePath += Py_GetPath();
+    }
+    Py_DECREF(sysMod); // release ref to sysMod
   }
-  else
-  {
-    path += Py_GetPath();
-  }
-  Py_DECREF(sysMod); // release ref to sysMod
+  path += basePath;
 
   // set current directory and python's path.
   if (m_argv != NULL)
@@ -321,6 +373,7 @@ void XBPyThread::Process()
   }
 
   bool systemExitThrown = false;
+  bool failed = false;
   if (!PyErr_Occurred())
     CLog::Log(LOGINFO, "Scriptresult: Success");
   else if (PyErr_ExceptionMatches(PyExc_SystemExit))
@@ -330,6 +383,7 @@ void XBPyThread::Process()
   }
   else
   {
+    failed = true;
     PythonBindings::PythonToCppException e;
     e.LogThrowMessage();
 
@@ -404,6 +458,33 @@ void XBPyThread::Process()
 
   m_pExecuter->DeInitializeInterpreter();
 
+  // keep the interpreter for the next run of the add-on if the script ended
+  // cleanly and nothing it created outlives it
+  bool reusable = m_pooled && pooled.mainDict && !stopping && !m_stopping && !systemExitThrown && !failed;
+  if (reusable)
+  {
+    PyDict_Clear(moduleDict);
+    PyDict_Update(moduleDict, (PyObject*)pooled.mainDict);
+    RemoveModulesUnder(CSpecialProtocol::TranslatePath(addon->Path()));
+    PyErr_Clear();
+    PyGC_Collect();
+    reusable = !languageHook->HasRegisteredAddonClasses();
+  }
+  if (reusable)
+  {
+    pooled.interp = state->interp;
+    pooled.addonId = addon->ID();
+    pooled.addonVersion = addon->Version().c_str();
+    pooled.addonPath = addon->Path();
+    pooled.basePath = basePath;
+
+    PyThreadState_Clear(state);
+    PyThreadState_DeleteCurrent(); // releases the GIL
+    m_pExecuter->GetInterpreterPool().Release(pooled);
+    return;
+  }
+  Py_XDECREF((PyObject*)pooled.mainDict);
+
   // run the gc before finishing
   //
   // if the script exited by throwing a SystemExit excepton then going back
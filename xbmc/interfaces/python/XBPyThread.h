@@ -41,6 +41,8 @@ public:
   void stop();
 
   void setAddon(ADDON::AddonPtr _addon) { addon = _addon; }
+  // allow running in a pooled interpreter which is kept for reuse after a clean exit
+  void setPooled(bool pooled) { m_pooled = pooled; }
 
 protected:
   CCriticalSection m_critSec;
@@ -53,6 +55,7 @@ protected:
   char **m_argv;
   unsigned int  m_argc;
   bool m_stopping;
+  bool m_pooled;
   int  m_id;
   ADDON::AddonPtr addon;
 
@@ -580,6 +580,8 @@ void XBPython::Finalize()
     m_mainThreadState = NULL; // clear the main thread state before releasing the lock
     {
       CSingleExit exit(m_critSection);
+      m_interpreterPool.Clear();
+
       PyEval_AcquireLock();
       PyThreadState_Swap(curTs);
 
@@ -652,8 +654,11 @@ void XBPython::Process()
     //delete scripts which are done
     tmpvec.clear(); // boost releases the XBPyThreads which, if deleted, calls FinalizeScript
 
+    // python stays loaded while there are warm interpreters
+    m_interpreterPool.Expire(PYTHON_POOL_IDLE_TIMEOUT);
+
     CSingleLock l2(m_critSection);
-    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 )
+    if(m_iDllScriptCounter == 0 && (XbmcThreads::SystemClockMillis() - m_endtime) > 10000 && m_interpreterPool.IsEmpty())
     {
       Finalize();
     }
@@ -707,6 +712,8 @@ int XBPython::evalFile(const CStdString &src, const std::vector<CStdString> &arg
   boost::shared_ptr<XBPyThread> pyThread = boost::shared_ptr<XBPyThread>(new XBPyThread(this, m_nextid));
   pyThread->setArgv(argv);
   pyThread->setAddon(addon);
+  // plugin directory listings are short lived and frequent, let them reuse interpreters
+  pyThread->setPooled(addon && !argv.empty() && argv[0].Left(9).Equals("plugin://") && m_interpreterPool.GetCapacity() > 0);
   pyThread->evalFile(src);
   PyElem inf;
   inf.id        = m_nextid;
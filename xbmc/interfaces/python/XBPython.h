@@ -22,6 +22,7 @@
  */
 
 #include "XBPyThread.h"
+#include "PyInterpreterPool.h"
 #include "cores/IPlayerCallback.h"
 #include "threads/CriticalSection.h"
 #include "interfaces/IAnnouncer.h"
@@ -130,6 +131,8 @@ public:
 
   void* getMainThreadState();
 
+  CPyInterpreterPool& GetInterpreterPool() { return m_interpreterPool; }
+
   bool m_bLogin;
 private:
   CCriticalSection    m_critSection;
@@ -147,6 +150,7 @@ private:
   PlayerCallbackList  m_vecPlayerCallbackList;
   MonitorCallbackList m_vecMonitorCallbackList;
   LibraryLoader*      m_pDll;
+  CPyInterpreterPool  m_interpreterPool;
 
   // any global events that scripts should be using
   CEvent m_globalEvent;
@@ -0,0 +1,195 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "../XBPython.h"
+#include "addons/PluginSource.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "test/TestUtils.h"
+#include "threads/SystemClock.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#define POOL_TEST_ADDON   "plugin.test.interpreterpool"
+#define POOL_TEST_RUNS    10
+
+// A plugin importing a module of its own plus some of the standard library,
+// which fails if it sees anything left behind by a previous run
+#define POOL_TEST_SCRIPT \
+  "import sys, xbmc, xbmcplugin\n" \
+  "import poollib\n" \
+  "if 'leftover' in globals() or xbmc.abortRequested:\n" \
+  "  raise RuntimeError('interpreter state was not reset')\n" \
+  "leftover = True\n" \
+  "poollib.run()\n"
+
+// Reads the arguments when it is imported, like many plugins' helper modules do
+#define POOL_TEST_MODULE \
+  "import sys, json, urllib, urlparse, re, xml.dom.minidom\n" \
+  "output = sys.argv[1]\n" \
+  "params = dict(urlparse.parse_qsl(sys.argv[2][1:]))\n" \
+  "def run():\n" \
+  "  f = open(output, 'w')\n" \
+  "  f.write(json.dumps(params))\n" \
+  "  f.close()\n"
+
+class TestInterpreterPool : public testing::Test
+{
+protected:
+  TestInterpreterPool()
+  {
+    m_path = CSpecialProtocol::TranslatePath("special://temp/" POOL_TEST_ADDON "/");
+    XFILE::CDirectory::Create(m_path);
+    WriteFile(m_path + "default.py", POOL_TEST_SCRIPT);
+    WriteFile(m_path + "poollib.py", POOL_TEST_MODULE);
+
+    ADDON::AddonProps props(POOL_TEST_ADDON, ADDON::ADDON_PLUGIN, "1.0.0", "");
+    props.path = m_path;
+    props.libname = "default.py";
+    props.dependencies.insert(std::make_pair("xbmc.python", std::make_pair(ADDON::AddonVersion("2.1.0"), false)));
+    m_addon = ADDON::AddonPtr(new ADDON::CPluginSource(props));
+  }
+
+  ~TestInterpreterPool()
+  {
+    g_pythonParser.GetInterpreterPool().Clear();
+    g_pythonParser.GetInterpreterPool().SetCapacity(PYTHON_POOL_SIZE);
+    XFILE::CFile::Delete(m_path + "default.py");
+    XFILE::CFile::Delete(m_path + "poollib.py");
+    XFILE::CFile::Delete(m_path + "poollib.pyc");
+    XFILE::CDirectory::Remove(m_path);
+  }
+
+  static void WriteFile(const CStdString &path, const char *data)
+  {
+    XFILE::CFile file;
+    ASSERT_TRUE(file.OpenForWrite(path, true));
+    file.Write(data, strlen(data));
+    file.Close();
+  }
+
+  // run a listing like CPluginDirectory does, returns the latency in ms
+  double RunListing(int run)
+  {
+    CStdString output;
+    output.Format("%soutput%d.json", CSpecialProtocol::TranslatePath("special://temp/").c_str(), run);
+
+    std::vector<CStdString> argv;
+    argv.push_back("plugin://" POOL_TEST_ADDON "/");
+    argv.push_back(output);
+    argv.push_back("?folder=1");
+
+    int64_t start = CurrentHostCounter();
+    int id = g_pythonParser.evalFile(m_path + "default.py", argv, m_addon);
+    EXPECT_GE(id, 0);
+    XbmcThreads::EndTime timeout(10000);
+    while (g_pythonParser.isRunning(id) && !timeout.IsTimePast())
+      Sleep(1);
+    double elapsed = CXBMCTestUtils::ElapsedMs(start);
+
+    // the script only gets to write its output if nothing was left behind
+    EXPECT_TRUE(XFILE::CFile::Exists(output));
+    XFILE::CFile::Delete(output);
+    return elapsed;
+  }
+
+  CStdString m_path;
+  ADDON::AddonPtr m_addon;
+};
+
+TEST_F(TestInterpreterPool, NoPoolWithoutCapacity)
+{
+  g_pythonParser.GetInterpreterPool().SetCapacity(0);
+  RunListing(0);
+  RunListing(1);
+  EXPECT_TRUE(g_pythonParser.GetInterpreterPool().IsEmpty());
+}
+
+TEST_F(TestInterpreterPool, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  // the first run loads python itself, keep it out of the numbers
+  g_pythonParser.GetInterpreterPool().SetCapacity(0);
+  RunListing(0);
+
+  double withoutPool = 0;
+  for (int i = 0; i < POOL_TEST_RUNS; i++)
+    withoutPool += RunListing(i);
+
+  g_pythonParser.GetInterpreterPool().SetCapacity(PYTHON_POOL_SIZE);
+  double firstPooled = RunListing(0);
+
+  double withPool = 0;
+  for (int i = 0; i < POOL_TEST_RUNS; i++)
+    withPool += RunListing(i);
+
+  std::cout << "Plugin listing latency without pool: " << withoutPool / POOL_TEST_RUNS << "ms, "
+            << "with pool: " << withPool / POOL_TEST_RUNS << "ms "
+            << "(first pooled run " << firstPooled << "ms)" << std::endl;
+}
+
+TEST_F(TestInterpreterPool, ModulesSeeNewArguments)
+{
+  // every run has to write to its own output, not to the one poollib saw on
+  // its first import
+  for (int i = 0; i < 3; i++)
+  {
+    RunListing(i);
+    EXPECT_FALSE(g_pythonParser.GetInterpreterPool().IsEmpty());
+  }
+}
+
+TEST_F(TestInterpreterPool, KeyedOnVersionAndPath)
+{
+  CPyInterpreterPool pool;
+  CPyInterpreterPool::Interpreter interpreter;
+  interpreter.addonId = POOL_TEST_ADDON;
+  interpreter.addonVersion = "1.0.0";
+  interpreter.addonPath = m_path;
+  pool.Release(interpreter);
+
+  CPyInterpreterPool::Interpreter acquired;
+  EXPECT_FALSE(pool.Acquire(POOL_TEST_ADDON, "1.0.1", m_path, acquired));
+  EXPECT_FALSE(pool.Acquire(POOL_TEST_ADDON, "1.0.0", m_path + "other/", acquired));
+  EXPECT_FALSE(pool.Acquire("plugin.test.other", "1.0.0", m_path, acquired));
+  EXPECT_TRUE(pool.Acquire(POOL_TEST_ADDON, "1.0.0", m_path, acquired));
+  EXPECT_TRUE(pool.IsEmpty());
+}
+
+TEST_F(TestInterpreterPool, FailedScriptIsNotReused)
+{
+  WriteFile(m_path + "default.py", "raise RuntimeError('broken plugin')\n");
+
+  std::vector<CStdString> argv;
+  argv.push_back("plugin://" POOL_TEST_ADDON "/");
+  argv.push_back("-1");
+  argv.push_back("");
+
+  int id = g_pythonParser.evalFile(m_path + "default.py", argv, m_addon);
+  ASSERT_GE(id, 0);
+  XbmcThreads::EndTime timeout(10000);
+  while (g_pythonParser.isRunning(id) && !timeout.IsTimePast())
+    Sleep(1);
+
+  EXPECT_TRUE(g_pythonParser.GetInterpreterPool().IsEmpty());
+}
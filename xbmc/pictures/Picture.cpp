@@ -28,14 +28,20 @@
 #include "settings/GUISettings.h"
 #include "FileItem.h"
 #include "filesystem/File.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "DllSwScale.h"
 #include "guilib/Texture.h"
 #include "guilib/imagefactory.h"
+#include "guilib/JpegService.h"
 #if defined(HAS_OMXPLAYER)
 #include "cores/omxplayer/OMXImage.h"
 #endif
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 
 using namespace XFILE;
 
@@ -53,6 +59,11 @@ bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width
     }
     delete omxImage;
 #endif
+    // pooled, so the libjpeg state and buffers carry over from one thumb to the next
+    if (CJpegService::Get().CreateThumbnailFromSurface(buffer, width, height, stride, thumbFile))
+      return true;
+    CLog::Log(LOGERROR, "Failed to CreateThumbnailFromSurface for %s", thumbFile.c_str());
+    return false;
   }
 
   unsigned char *thumb = NULL;
@@ -61,7 +72,7 @@ bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width
   if(pImage == NULL || !pImage->CreateThumbnailFromSurface((BYTE *)buffer, width, height, XB_FMT_A8R8G8B8, stride, thumbFile.c_str(), thumb, thumbsize))
   {
     CLog::Log(LOGERROR, "Failed to CreateThumbnailFromSurface for %s", thumbFile.c_str());
-    delete pImage;
+    ImageFactory::Release(pImage);
     return false;
   }
 
@@ -71,11 +82,11 @@ bool CPicture::CreateThumbnailFromSurface(const unsigned char *buffer, int width
     file.Write(thumb, thumbsize);
     file.Close();
     pImage->ReleaseThumbnailBuffer();
-    delete pImage;
+    ImageFactory::Release(pImage);
     return true;
   }
   pImage->ReleaseThumbnailBuffer();
-  delete pImage;
+  ImageFactory::Release(pImage);
   return false;
 }
 
@@ -257,7 +268,6 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
 
 bool CPicture::OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation)
 {
-  // ideas for speeding these functions up: http://cgit.freedesktop.org/pixman/tree/pixman/pixman-fast-path.c
   bool out = false;
   switch (orientation)
   {
@@ -289,115 +299,194 @@ bool CPicture::OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned i
   return out;
 }
 
-bool CPicture::FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+/* The transforms work on square tiles so that both the rows read and the rows written stay
+   in cache, and large images are split into bands of rows that are transformed on threads of
+   their own. Every transform only moves whole pixels, so the result doesn't depend on how
+   the image is split up. */
+
+#define PICTURE_TILE_SIZE    32
+#define PICTURE_BAND_PIXELS  (512 * 1024) // fewest pixels worth a thread of their own
+
+typedef struct
 {
-  // this can be done in-place easily enough
-  for (unsigned int y = 0; y < height; ++y)
+  uint32_t *src;
+  uint32_t *dst;
+  unsigned int width;   // of the source
+  unsigned int height;
+  bool flipRows;        // dst row y, column x comes from the source row x or height-1-x...
+  bool flipCols;        // ...and the source column y or width-1-y
+} TransformArgs;
+
+typedef void (*TransformKernel)(const TransformArgs &args, unsigned int begin, unsigned int end);
+
+class CPictureBandThread : public CThread
+{
+public:
+  CPictureBandThread(TransformKernel kernel, const TransformArgs &args, unsigned int begin, unsigned int end)
+    : CThread("PictureBand"), m_kernel(kernel), m_args(args), m_begin(begin), m_end(end) {}
+
+protected:
+  virtual void Process() { m_kernel(m_args, m_begin, m_end); }
+
+private:
+  TransformKernel m_kernel;
+  TransformArgs m_args;
+  unsigned int m_begin;
+  unsigned int m_end;
+};
+
+static void RunBands(TransformKernel kernel, const TransformArgs &args, unsigned int rows, unsigned int rowPixels)
+{
+  unsigned int bands = std::min((unsigned int)std::max(1, g_cpuInfo.getCPUCount()), rows * rowPixels / PICTURE_BAND_PIXELS);
+  if (bands <= 1)
   {
-    uint32_t *line = pixels + y * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
+    kernel(args, 0, rows);
+    return;
   }
-  return true;
-}
 
-bool CPicture::FlipVertical(uint32_t *&pixels, unsigned int &width, unsigned int &height)
-{
-  // this can be done in-place easily enough
-  for (unsigned int y = 0; y < height / 2; ++y)
+  // bands start on a tile boundary, so no tile is split between threads
+  unsigned int bandRows = ((rows + bands - 1) / bands + PICTURE_TILE_SIZE - 1) / PICTURE_TILE_SIZE * PICTURE_TILE_SIZE;
+  std::vector<CPictureBandThread *> threads;
+  for (unsigned int begin = bandRows; begin < rows; begin += bandRows)
   {
-    uint32_t *line1 = pixels + y * width;
-    uint32_t *line2 = pixels + (height - 1 - y) * width;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2++);
+    threads.push_back(new CPictureBandThread(kernel, args, begin, std::min(begin + bandRows, rows)));
+    threads.back()->Create();
+  }
+  kernel(args, 0, std::min(bandRows, rows));
+
+  // the threads exit once their band is done
+  for (std::vector<CPictureBandThread *>::iterator i = threads.begin(); i != threads.end(); ++i)
+  {
+    (*i)->StopThread(true);
+    delete *i;
   }
-  return true;
 }
 
-bool CPicture::Rotate180CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+#ifdef __SSE2__
+static inline __m128i Reverse(__m128i pixels)
 {
-  // this can be done in-place easily enough
-  for (unsigned int y = 0; y < height / 2; ++y)
+  return _mm_shuffle_epi32(pixels, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+// transposes the 4x4 block of the destination at column x, row y
+static inline void TransposeBlock(const TransformArgs &args, unsigned int x, unsigned int y)
+{
+  unsigned int col = args.flipCols ? args.width - 4 - y : y;
+  __m128i rows[4];
+  for (unsigned int i = 0; i < 4; i++)
   {
-    uint32_t *line1 = pixels + y * width;
-    uint32_t *line2 = pixels + (height - 1 - y) * width + width - 1;
-    for (unsigned int x = 0; x < width; ++x)
-      std::swap(*line1++, *line2--);
+    unsigned int row = args.flipRows ? args.height - 1 - x - i : x + i;
+    rows[i] = _mm_loadu_si128((const __m128i *)(args.src + row * args.width + col));
+    if (args.flipCols)
+      rows[i] = Reverse(rows[i]);
   }
-  if (height % 2)
-  { // height is odd, so flip the middle row as well
-    uint32_t *line = pixels + (height - 1)/2 * width;
-    for (unsigned int x = 0; x < width / 2; ++x)
-      std::swap(line[x], line[width - 1 - x]);
-  }
-  return true;
+  __m128i lo01 = _mm_unpacklo_epi32(rows[0], rows[1]);
+  __m128i lo23 = _mm_unpacklo_epi32(rows[2], rows[3]);
+  __m128i hi01 = _mm_unpackhi_epi32(rows[0], rows[1]);
+  __m128i hi23 = _mm_unpackhi_epi32(rows[2], rows[3]);
+  uint32_t *dst = args.dst + y * args.height + x;
+  _mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi64(lo01, lo23));
+  _mm_storeu_si128((__m128i *)(dst + args.height), _mm_unpackhi_epi64(lo01, lo23));
+  _mm_storeu_si128((__m128i *)(dst + 2 * args.height), _mm_unpacklo_epi64(hi01, hi23));
+  _mm_storeu_si128((__m128i *)(dst + 3 * args.height), _mm_unpackhi_epi64(hi01, hi23));
 }
+#endif
 
-bool CPicture::Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+static inline uint32_t TransposedPixel(const TransformArgs &args, unsigned int x, unsigned int y)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (dest)
+  unsigned int row = args.flipRows ? args.height - 1 - x : x;
+  unsigned int col = args.flipCols ? args.width - 1 - y : y;
+  return args.src[row * args.width + col];
+}
+
+// writes the destination rows [begin, end), which are the source columns
+static void TransposeKernel(const TransformArgs &args, unsigned int begin, unsigned int end)
+{
+  unsigned int d_width = args.height;
+  for (unsigned int ty = begin; ty < end; ty += PICTURE_TILE_SIZE)
   {
-    unsigned int d_height = width, d_width = height;
-    for (unsigned int y = 0; y < d_height; y++)
+    unsigned int tyEnd = std::min(ty + PICTURE_TILE_SIZE, end);
+    for (unsigned int tx = 0; tx < d_width; tx += PICTURE_TILE_SIZE)
     {
-      const uint32_t *src = pixels + (d_height - 1 - y); // y-th col from right, starting at top
-      uint32_t *dst = dest + d_width * y;                // y-th row from top, starting at left
-      for (unsigned int x = 0; x < d_width; x++)
+      unsigned int txEnd = std::min(tx + PICTURE_TILE_SIZE, d_width);
+      unsigned int y = ty;
+#ifdef __SSE2__
+      for (; y + 4 <= tyEnd; y += 4)
+      {
+        unsigned int x = tx;
+        for (; x + 4 <= txEnd; x += 4)
+          TransposeBlock(args, x, y);
+        for (; x < txEnd; x++)
+        {
+          for (unsigned int j = 0; j < 4; j++)
+            args.dst[(y + j) * d_width + x] = TransposedPixel(args, x, y + j);
+        }
+      }
+#endif
+      for (; y < tyEnd; y++)
       {
-        *dst++ = *src;
-        src += width;
+        uint32_t *dst = args.dst + y * d_width;
+        for (unsigned int x = tx; x < txEnd; x++)
+          dst[x] = TransposedPixel(args, x, y);
       }
     }
-    delete[] pixels;
-    pixels = dest;
-    std::swap(width, height);
-    return true;
   }
-  return false;
 }
 
-bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+// swaps line1[x] with line2[count - 1 - x], reversing a line in place if both are the same
+static void SwapReversed(uint32_t *line1, uint32_t *line2, unsigned int count)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return false;
+  uint32_t *lo = line1, *hi = line2 + count;
+  uint32_t *loEnd = line1 + (line1 == line2 ? count / 2 : count);
+#ifdef __SSE2__
+  while (lo + 4 <= loEnd)
+  {
+    hi -= 4;
+    __m128i a = _mm_loadu_si128((const __m128i *)lo);
+    __m128i b = _mm_loadu_si128((const __m128i *)hi);
+    _mm_storeu_si128((__m128i *)lo, Reverse(b));
+    _mm_storeu_si128((__m128i *)hi, Reverse(a));
+    lo += 4;
+  }
+#endif
+  while (lo < loEnd)
+    std::swap(*lo++, *--hi);
+}
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
+static void FlipHorizontalKernel(const TransformArgs &args, unsigned int begin, unsigned int end)
+{
+  for (unsigned int y = begin; y < end; ++y)
   {
-    const uint32_t *src = pixels + width * (d_width - 1) + y; // y-th col from left, starting at bottom
-    uint32_t *dst = dest + d_width * y;                       // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
+    uint32_t *line = args.src + y * args.width;
+    SwapReversed(line, line, args.width);
+  }
+}
+
+// works on the rows [begin, end) of the top half and their mirror rows
+static void FlipVerticalKernel(const TransformArgs &args, unsigned int begin, unsigned int end)
+{
+  for (unsigned int y = begin; y < end; ++y)
+  {
+    uint32_t *line1 = args.src + y * args.width;
+    uint32_t *line2 = args.src + (args.height - 1 - y) * args.width;
+    std::swap_ranges(line1, line1 + args.width, line2);
   }
+}
 
-  delete[] pixels;
-  pixels = dest;
-  std::swap(width, height);
-  return true;
+static void Rotate180Kernel(const TransformArgs &args, unsigned int begin, unsigned int end)
+{
+  for (unsigned int y = begin; y < end; ++y)
+    SwapReversed(args.src + y * args.width, args.src + (args.height - 1 - y) * args.width, args.width);
 }
 
-bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+static bool TransposeImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, bool flipRows, bool flipCols)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
+  uint32_t *dest = new uint32_t[width * height];
   if (!dest)
     return false;
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + y;   // y-th col from left, starting at top
-    uint32_t *dst = dest + d_width * y; // y-th row from top, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src += width;
-    }
-  }
+  TransformArgs args = { pixels, dest, width, height, flipRows, flipCols };
+  RunBands(TransposeKernel, args, width, height);
 
   delete[] pixels;
   pixels = dest;
@@ -405,26 +494,55 @@ bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &h
   return true;
 }
 
-bool CPicture::TransposeOffAxis(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+bool CPicture::FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned int &height)
 {
-  uint32_t *dest = new uint32_t[width * height * 4];
-  if (!dest)
-    return false;
+  // this can be done in-place easily enough
+  TransformArgs args = { pixels, NULL, width, height, false, false };
+  RunBands(FlipHorizontalKernel, args, height, width);
+  return true;
+}
 
-  unsigned int d_height = width, d_width = height;
-  for (unsigned int y = 0; y < d_height; y++)
-  {
-    const uint32_t *src = pixels + width * (d_width - 1) + (d_height - 1 - y); // y-th col from right, starting at bottom
-    uint32_t *dst = dest + d_width * y;                                        // y-th row, starting at left
-    for (unsigned int x = 0; x < d_width; x++)
-    {
-      *dst++ = *src;
-      src -= width;
-    }
-  }
+bool CPicture::FlipVertical(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // this can be done in-place easily enough
+  TransformArgs args = { pixels, NULL, width, height, false, false };
+  RunBands(FlipVerticalKernel, args, height / 2, width * 2);
+  return true;
+}
 
-  delete[] pixels;
-  pixels = dest;
-  std::swap(width, height);
+bool CPicture::Rotate180CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // this can be done in-place easily enough
+  TransformArgs args = { pixels, NULL, width, height, false, false };
+  RunBands(Rotate180Kernel, args, height / 2, width * 2);
+  if (height % 2)
+  { // height is odd, so flip the middle row as well
+    uint32_t *line = pixels + (height - 1)/2 * width;
+    SwapReversed(line, line, width);
+  }
   return true;
 }
+
+bool CPicture::Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // destination rows are the source columns from the right, read from the top
+  return TransposeImage(pixels, width, height, false, true);
+}
+
+bool CPicture::Rotate270CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // destination rows are the source columns from the left, read from the bottom
+  return TransposeImage(pixels, width, height, true, false);
+}
+
+bool CPicture::Transpose(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // destination rows are the source columns from the left, read from the top
+  return TransposeImage(pixels, width, height, false, false);
+}
+
+bool CPicture::TransposeOffAxis(uint32_t *&pixels, unsigned int &width, unsigned int &height)
+{
+  // destination rows are the source columns from the right, read from the bottom
+  return TransposeImage(pixels, width, height, true, true);
+}
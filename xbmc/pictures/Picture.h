@@ -44,12 +44,23 @@ public:
   static bool CacheTexture(CBaseTexture *texture, uint32_t &dest_width, uint32_t &dest_height, const std::string &dest);
   static bool CacheTexture(uint8_t *pixels, uint32_t width, uint32_t height, uint32_t pitch, int orientation, uint32_t &dest_width, uint32_t &dest_height, const std::string &dest);
 
-private:
-  static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
   static bool ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                          uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch);
+
+  /*! \brief Rotate and flip an image as given by its EXIF orientation
+   Flips and half turns are done in place, quarter turns replace the pixels with a new buffer.
+   Large images are split up between the cpu cores.
+   \param pixels [in/out] the image, as allocated with new[]
+   \param width [in/out] width of the image, replaced with the width after rotation
+   \param height [in/out] height of the image, replaced with the height after rotation
+   \param orientation EXIF orientation less one, from 1 to 7
+   \return true if successful, false otherwise
+   */
   static bool OrientateImage(uint32_t *&pixels, unsigned int &width, unsigned int &height, int orientation);
 
+private:
+  static void GetScale(unsigned int width, unsigned int height, unsigned int &out_width, unsigned int &out_height);
+
   static bool FlipHorizontal(uint32_t *&pixels, unsigned int &width, unsigned int &height);
   static bool FlipVertical(uint32_t *&pixels, unsigned int &width, unsigned int &height);
   static bool Rotate90CCW(uint32_t *&pixels, unsigned int &width, unsigned int &height);
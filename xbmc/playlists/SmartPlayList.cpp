@@ -24,6 +24,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SmartPlaylistDirectory.h"
 #include "guilib/LocalizeStrings.h"
+#include "threads/SingleLock.h"
 #include "utils/CharsetConverter.h"
 #include "utils/DatabaseUtils.h"
 #include "utils/JSONVariantParser.h"
@@ -35,6 +36,8 @@
 #include "utils/XMLUtils.h"
 #include "video/VideoDatabase.h"
 
+#include <list>
+
 using namespace std;
 using namespace XFILE;
 
@@ -1002,6 +1005,8 @@ CSmartPlaylistRuleCombination::CSmartPlaylistRuleCombination()
   : m_type(CombinationAnd)
 { }
 
+static bool GetNestedWhereClause(const CDatabase &db, const CStdString &path, const CStdString &type, set<CStdString> &referencedPlaylists, CStdString &where);
+
 CStdString CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, const CStdString& strType, std::set<CStdString> &referencedPlaylists) const
 {
   CStdString rule, currentRule;
@@ -1027,16 +1032,8 @@ CStdString CSmartPlaylistRuleCombination::GetWhereClause(const CDatabase &db, co
       if (!playlistFile.IsEmpty() && referencedPlaylists.find(playlistFile) == referencedPlaylists.end())
       {
         referencedPlaylists.insert(playlistFile);
-        CSmartPlaylist playlist;
-        playlist.Load(playlistFile);
         CStdString playlistQuery;
-        // only playlists of same type will be part of the query
-        if (playlist.GetType().Equals(strType) || (playlist.GetType().Equals("mixed") && (strType == "songs" || strType == "musicvideos")) || playlist.GetType().IsEmpty())
-        {
-          playlist.SetType(strType);
-          playlistQuery = playlist.GetWhereClause(db, referencedPlaylists);
-        }
-        if (playlist.GetType().Equals(strType))
+        if (GetNestedWhereClause(db, playlistFile, strType, referencedPlaylists, playlistQuery))
         {
           if (it->m_operator == CSmartPlaylistRule::OPERATOR_DOES_NOT_EQUAL)
             currentRule.Format("NOT (%s)", playlistQuery.c_str());
@@ -1154,12 +1151,221 @@ CSmartPlaylist::CSmartPlaylist()
   Reset();
 }
 
-bool CSmartPlaylist::OpenAndReadName(const CStdString &path)
+struct CachedPlaylist;
+typedef map<CStdString, CachedPlaylist> PlaylistCache;
+typedef list<PlaylistCache::iterator> PlaylistCacheList;
+
+typedef pair<int64_t, int64_t> FileStamp; // modification time and size
+
+struct CachedWhereClause
+{
+  unsigned int namesVersion;        // of the names the nested playlists were looked up by
+  bool matches;                     // whether the playlist is of the type it was laid out as
+  CStdString where;
+  set<CStdString> referenced;       // the nested playlists it was laid out from
+  map<CStdString, FileStamp> stamps; // of those and of the playlist itself
+};
+
+struct CachedPlaylist
+{
+  int64_t mtime;
+  int64_t size;
+  bool valid;             // the file holds a smart playlist
+  bool loaded;            // its rules loaded
+  CSmartPlaylist playlist;
+  map<CStdString, CachedWhereClause> where; // by the type it was laid out as, when referenced by another playlist
+  PlaylistCacheList::iterator used; // position in the list of recently used playlists
+};
+
+// playlists loaded from files, reused until the file changes. Nested playlists are loaded
+// again for every query and every playlist is opened to look one up by name, so without it
+// the same files are read and parsed over and over. The least recently used playlists are
+// dropped once the cache is full
+static CCriticalSection g_playlistCacheSection;
+static PlaylistCache g_playlistCache;
+static PlaylistCacheList g_playlistCacheUsed; // most recently used first
+
+static void RemoveFromCache(const CStdString &path)
+{
+  PlaylistCache::iterator it = g_playlistCache.find(path);
+  if (it == g_playlistCache.end())
+    return;
+
+  g_playlistCacheUsed.erase(it->second.used);
+  g_playlistCache.erase(it);
+}
+
+static bool GetFileStamp(const CStdString &path, int64_t &mtime, int64_t &size)
+{
+  struct __stat64 buffer;
+  if (CFile::Stat(path, &buffer) != 0)
+    return false;
+
+  mtime = buffer.st_mtime;
+  size = buffer.st_size;
+  return true;
+}
+
+bool CSmartPlaylist::loadFromCache(const CStdString &path, bool &valid, bool &loaded)
 {
-  if (readNameFromPath(path) == NULL)
+  int64_t mtime, size;
+  if (!GetFileStamp(path, mtime, size))
     return false;
 
-  return !m_playlistName.empty();
+  CSingleLock lock(g_playlistCacheSection);
+  PlaylistCache::iterator it = g_playlistCache.find(path);
+  if (it == g_playlistCache.end() || it->second.mtime != mtime || it->second.size != size)
+    return false;
+
+  g_playlistCacheUsed.splice(g_playlistCacheUsed.begin(), g_playlistCacheUsed, it->second.used);
+  *this = it->second.playlist;
+  valid = it->second.valid;
+  loaded = it->second.loaded;
+  return true;
+}
+
+void CSmartPlaylist::addToCache(const CStdString &path, bool valid, bool loaded)
+{
+  // the document was only needed while loading
+  m_xmlDoc.Clear();
+
+  int64_t mtime, size;
+  if (!GetFileStamp(path, mtime, size))
+    return;
+
+  CSingleLock lock(g_playlistCacheSection);
+  pair<PlaylistCache::iterator, bool> added = g_playlistCache.insert(make_pair(path, CachedPlaylist()));
+  CachedPlaylist &cached = added.first->second;
+  cached.mtime = mtime;
+  cached.size = size;
+  cached.valid = valid;
+  cached.loaded = loaded;
+  cached.playlist = *this;
+  cached.where.clear();
+  if (added.second)
+  {
+    g_playlistCacheUsed.push_front(added.first);
+    cached.used = g_playlistCacheUsed.begin();
+  }
+  else
+    g_playlistCacheUsed.splice(g_playlistCacheUsed.begin(), g_playlistCacheUsed, cached.used);
+
+  while (g_playlistCache.size() > SMARTPLAYLIST_CACHE_SIZE)
+  {
+    g_playlistCache.erase(g_playlistCacheUsed.back());
+    g_playlistCacheUsed.pop_back();
+  }
+}
+
+static bool GetCachedWhereClause(const CStdString &path, const CStdString &type, unsigned int namesVersion, CachedWhereClause &clause)
+{
+  {
+    CSingleLock lock(g_playlistCacheSection);
+    PlaylistCache::const_iterator it = g_playlistCache.find(path);
+    if (it == g_playlistCache.end())
+      return false;
+    map<CStdString, CachedWhereClause>::const_iterator where = it->second.where.find(type);
+    if (where == it->second.where.end() || where->second.namesVersion != namesVersion)
+      return false;
+    clause = where->second;
+  }
+
+  // stat outside the lock, it's only the files that need checking
+  for (map<CStdString, FileStamp>::const_iterator it = clause.stamps.begin(); it != clause.stamps.end(); ++it)
+  {
+    int64_t mtime, size;
+    if (!GetFileStamp(it->first, mtime, size) || it->second != FileStamp(mtime, size))
+      return false;
+  }
+  return true;
+}
+
+static void AddCachedWhereClause(const CStdString &path, const CStdString &type, const CachedWhereClause &clause)
+{
+  map<CStdString, FileStamp>::const_iterator stamp = clause.stamps.find(path);
+  if (stamp == clause.stamps.end())
+    return;
+
+  // kept with the playlist only as long as it's the one that was laid out
+  CSingleLock lock(g_playlistCacheSection);
+  PlaylistCache::iterator it = g_playlistCache.find(path);
+  if (it != g_playlistCache.end() && FileStamp(it->second.mtime, it->second.size) == stamp->second)
+    it->second.where[type] = clause;
+}
+
+static bool BuildWhereClause(const CDatabase &db, const CStdString &path, const CStdString &type, set<CStdString> &referencedPlaylists, CStdString &where)
+{
+  CSmartPlaylist playlist;
+  playlist.Load(path);
+  // only playlists of same type will be part of the query
+  if (playlist.GetType().Equals(type) || (playlist.GetType().Equals("mixed") && (type == "songs" || type == "musicvideos")) || playlist.GetType().IsEmpty())
+  {
+    playlist.SetType(type);
+    where = playlist.GetWhereClause(db, referencedPlaylists);
+  }
+  return playlist.GetType().Equals(type);
+}
+
+/* Lays out a playlist referenced by another one, returning whether it is of the type asked for.
+ * It's laid out as if nothing else referenced the playlists it references in turn, and reused until
+ * any of those files change or the playlists are looked up by different names. When the referencing
+ * playlists have laid out any of them already, it's laid out again without them */
+static bool GetNestedWhereClause(const CDatabase &db, const CStdString &path, const CStdString &type, set<CStdString> &referencedPlaylists, CStdString &where)
+{
+  unsigned int namesVersion = CSmartPlaylistDirectory::GetPlaylistNamesVersion(type);
+  CachedWhereClause clause;
+  if (!GetCachedWhereClause(path, type, namesVersion, clause))
+  {
+    set<CStdString> nested;
+    nested.insert(path);
+    clause.namesVersion = namesVersion;
+    clause.matches = BuildWhereClause(db, path, type, nested, clause.where);
+
+    bool stamped = true;
+    for (set<CStdString>::const_iterator it = nested.begin(); it != nested.end() && stamped; ++it)
+    {
+      int64_t mtime, size;
+      stamped = GetFileStamp(*it, mtime, size);
+      if (stamped)
+        clause.stamps[*it] = FileStamp(mtime, size);
+    }
+    nested.erase(path);
+    clause.referenced.swap(nested);
+    if (stamped)
+      AddCachedWhereClause(path, type, clause);
+  }
+
+  for (set<CStdString>::const_iterator it = clause.referenced.begin(); it != clause.referenced.end(); ++it)
+  {
+    if (referencedPlaylists.find(*it) != referencedPlaylists.end())
+      return BuildWhereClause(db, path, type, referencedPlaylists, where);
+  }
+
+  referencedPlaylists.insert(clause.referenced.begin(), clause.referenced.end());
+  where = clause.where;
+  return clause.matches;
+}
+
+unsigned int CSmartPlaylist::GetNumCached()
+{
+  CSingleLock lock(g_playlistCacheSection);
+  return g_playlistCache.size();
+}
+
+bool CSmartPlaylist::OpenAndReadName(const CStdString &path)
+{
+  bool valid, loaded;
+  if (!loadFromCache(path, valid, loaded))
+  {
+    // the rules are loaded too so the playlist is cached whole
+    const TiXmlNode *root = readNameFromPath(path);
+    valid = root != NULL;
+    loaded = load(root);
+    if (valid)
+      addToCache(path, valid, loaded);
+  }
+
+  return valid && !m_playlistName.empty();
 }
 
 const TiXmlNode* CSmartPlaylist::readName(const TiXmlNode *root)
@@ -1249,7 +1455,15 @@ bool CSmartPlaylist::load(const TiXmlNode *root)
 
 bool CSmartPlaylist::Load(const CStdString &path)
 {
-  return load(readNameFromPath(path));
+  bool valid, loaded;
+  if (loadFromCache(path, valid, loaded))
+    return loaded;
+
+  const TiXmlNode *root = readNameFromPath(path);
+  loaded = load(root);
+  if (root != NULL)
+    addToCache(path, true, loaded);
+  return loaded;
 }
 
 bool CSmartPlaylist::Load(const CVariant &obj)
@@ -1376,6 +1590,14 @@ bool CSmartPlaylist::Save(const CStdString &path) const
     nodeOrder.InsertEndChild(order);
     pRoot->InsertEndChild(nodeOrder);
   }
+
+  // a file rewritten within the same second and of the same size would still look unchanged,
+  // and its folder doesn't change when its name does
+  {
+    CSingleLock lock(g_playlistCacheSection);
+    RemoveFromCache(path);
+  }
+  CSmartPlaylistDirectory::InvalidatePlaylistNames();
   return doc.SaveFile(path);
 }
 
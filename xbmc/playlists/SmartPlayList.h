@@ -26,6 +26,8 @@
 #include "utils/StdString.h"
 #include "utils/XBMCTinyXML.h"
 
+#define SMARTPLAYLIST_CACHE_SIZE 200
+
 class CDatabase;
 class CVariant;
 
@@ -201,6 +203,9 @@ public:
   static void GetAvailableOperators(std::vector<std::string> &operatorList);
 
   bool IsEmpty(bool ignoreSortAndLimit = true) const;
+
+  /*! \brief the number of playlist files held in the cache, which keeps at most SMARTPLAYLIST_CACHE_SIZE */
+  static unsigned int GetNumCached();
 private:
   friend class CGUIDialogSmartPlaylistEditor;
   friend class CGUIDialogMediaFilter;
@@ -209,6 +214,8 @@ private:
   const TiXmlNode* readNameFromPath(const CStdString &path);
   const TiXmlNode* readNameFromXml(const CStdString &xml);
   bool load(const TiXmlNode *root);
+  bool loadFromCache(const CStdString &path, bool &valid, bool &loaded);
+  void addToCache(const CStdString &path, bool valid, bool loaded);
 
   CSmartPlaylistRuleCombination m_ruleCombination;
   CStdString m_playlistName;
@@ -375,7 +375,7 @@ int CPVRDatabase::Get(CPVRChannelGroupInternal &results)
         CLog::Log(LOGDEBUG, "PVR - %s - channel '%s' loaded from the database", __FUNCTION__, channel->m_strChannelName.c_str());
 #endif
         PVRChannelGroupMember newMember = { channel, (unsigned int)m_pDS->fv("iChannelNumber").get_asInt() };
-        results.m_members.push_back(newMember);
+        results.AddMember(newMember);
 
         m_pDS->next();
         ++iReturn;
@@ -730,7 +730,7 @@ int CPVRDatabase::Get(CPVRChannelGroup &group)
           CLog::Log(LOGDEBUG, "PVR - %s - channel '%s' loaded from the database", __FUNCTION__, channel->m_strChannelName.c_str());
 #endif
           PVRChannelGroupMember newMember = { channel, (unsigned int)iChannelNumber };
-          group.m_members.push_back(newMember);
+          group.AddMember(newMember);
           iReturn++;
         }
         else
@@ -963,7 +963,10 @@ bool CPVRDatabase::Persist(CPVRChannel &channel, bool bQueueWrite /* = false */)
   {
     CSingleLock lock(channel.m_critSection);
     if (channel.m_iChannelId <= 0)
+    {
       channel.m_iChannelId = (int)m_pDS->lastinsertid();
+      CPVRChannel::IdentityChanged();
+    }
     bReturn = true;
   }
 
@@ -589,6 +589,24 @@ PVR_ERROR CPVRClient::GetRecordings(CPVRRecordings *results)
   return retVal;
 }
 
+CStdString CPVRClient::GetRecordingsChangeToken(void)
+{
+  CStdString strToken;
+  /* add-ons built against an older API don't set it */
+  if (!m_bReadyToUse || !m_addonCapabilities.bSupportsRecordings || !m_pStruct->GetRecordingsChangeToken)
+    return strToken;
+
+  try
+  {
+    const char *strReturn = m_pStruct->GetRecordingsChangeToken();
+    if (strReturn)
+      strToken = strReturn;
+  }
+  catch (exception &e) { LogException(e, __FUNCTION__); }
+
+  return strToken;
+}
+
 PVR_ERROR CPVRClient::DeleteRecording(const CPVRRecording &recording)
 {
   if (!m_bReadyToUse)
@@ -792,6 +810,24 @@ PVR_ERROR CPVRClient::GetTimers(CPVRTimers *results)
   return retVal;
 }
 
+CStdString CPVRClient::GetTimersChangeToken(void)
+{
+  CStdString strToken;
+  /* add-ons built against an older API don't set it */
+  if (!m_bReadyToUse || !m_addonCapabilities.bSupportsTimers || !m_pStruct->GetTimersChangeToken)
+    return strToken;
+
+  try
+  {
+    const char *strReturn = m_pStruct->GetTimersChangeToken();
+    if (strReturn)
+      strToken = strReturn;
+  }
+  catch (exception &e) { LogException(e, __FUNCTION__); }
+
+  return strToken;
+}
+
 PVR_ERROR CPVRClient::AddTimer(const CPVRTimerInfoTag &timer)
 {
   if (!m_bReadyToUse)
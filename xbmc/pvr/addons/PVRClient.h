@@ -230,6 +230,12 @@ namespace PVR
      */
     PVR_ERROR GetRecordings(CPVRRecordings *results);
 
+    /*!
+     * @brief Get the token that changes whenever the recordings on the backend change.
+     * @return The token, or an empty string if the backend can't tell.
+     */
+    CStdString GetRecordingsChangeToken(void);
+
     /*!
      * @brief Delete a recording on the backend.
      * @param recording The recording to delete.
@@ -290,6 +296,12 @@ namespace PVR
      */
     PVR_ERROR GetTimers(CPVRTimers *results);
 
+    /*!
+     * @brief Get the token that changes whenever the timers on the backend change.
+     * @return The token, or an empty string if the backend can't tell.
+     */
+    CStdString GetTimersChangeToken(void);
+
     /*!
      * @brief Add a timer on the backend.
      * @param timer The timer to add.
@@ -373,18 +373,25 @@ bool CPVRClients::HasTimerSupport(int iClientId)
   return IsConnectedClient(iClientId) && m_clientMap[iClientId]->SupportsTimers();
 }
 
-PVR_ERROR CPVRClients::GetTimers(CPVRTimers *timers)
+PVR_ERROR CPVRClients::GetTimers(CPVRTimers *timers, map<int, CStdString> &changeTokens, set<int> &unchangedClients)
 {
   PVR_ERROR error(PVR_ERROR_NO_ERROR);
   PVR_CLIENTMAP clients;
   GetConnectedClients(clients);
+  RemoveDisconnectedTokens(clients, changeTokens);
 
-  /* get the timer list from each client */
+  /* get the timer list from each client that changed since the last time */
   for (PVR_CLIENTMAP_ITR itrClients = clients.begin(); itrClients != clients.end(); itrClients++)
   {
+    CStdString strToken = (*itrClients).second->GetTimersChangeToken();
+    if (IsUnchanged((*itrClients).first, strToken, changeTokens))
+    {
+      unchangedClients.insert((*itrClients).first);
+      continue;
+    }
+
     PVR_ERROR currentError = (*itrClients).second->GetTimers(timers);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
+    if (!StoreChangeToken((*itrClients).first, strToken, currentError, changeTokens))
     {
       CLog::Log(LOGERROR, "PVR - %s - cannot get timers from client '%d': %s",__FUNCTION__, (*itrClients).first, CPVRClient::ToString(currentError));
       error = currentError;
@@ -447,17 +454,24 @@ PVR_ERROR CPVRClients::RenameTimer(const CPVRTimerInfoTag &timer, const CStdStri
   return error;
 }
 
-PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings)
+PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings, map<int, CStdString> &changeTokens, set<int> &unchangedClients)
 {
   PVR_ERROR error(PVR_ERROR_NO_ERROR);
   PVR_CLIENTMAP clients;
   GetConnectedClients(clients);
+  RemoveDisconnectedTokens(clients, changeTokens);
 
   for (PVR_CLIENTMAP_ITR itrClients = clients.begin(); itrClients != clients.end(); itrClients++)
   {
+    CStdString strToken = (*itrClients).second->GetRecordingsChangeToken();
+    if (IsUnchanged((*itrClients).first, strToken, changeTokens))
+    {
+      unchangedClients.insert((*itrClients).first);
+      continue;
+    }
+
     PVR_ERROR currentError = (*itrClients).second->GetRecordings(recordings);
-    if (currentError != PVR_ERROR_NOT_IMPLEMENTED &&
-        currentError != PVR_ERROR_NO_ERROR)
+    if (!StoreChangeToken((*itrClients).first, strToken, currentError, changeTokens))
     {
       CLog::Log(LOGERROR, "PVR - %s - cannot get recordings from client '%d': %s",__FUNCTION__, (*itrClients).first, CPVRClient::ToString(currentError));
       error = currentError;
@@ -467,6 +481,39 @@ PVR_ERROR CPVRClients::GetRecordings(CPVRRecordings *recordings)
   return error;
 }
 
+void CPVRClients::RemoveDisconnectedTokens(const PVR_CLIENTMAP &clients, map<int, CStdString> &changeTokens)
+{
+  for (map<int, CStdString>::iterator it = changeTokens.begin(); it != changeTokens.end();)
+  {
+    if (clients.find(it->first) == clients.end())
+      changeTokens.erase(it++);
+    else
+      ++it;
+  }
+}
+
+bool CPVRClients::IsUnchanged(int iClientId, const CStdString &strToken, const map<int, CStdString> &changeTokens)
+{
+  if (strToken.IsEmpty())
+    return false;
+
+  map<int, CStdString>::const_iterator it = changeTokens.find(iClientId);
+  return it != changeTokens.end() && it->second == strToken;
+}
+
+bool CPVRClients::StoreChangeToken(int iClientId, const CStdString &strToken, PVR_ERROR error, map<int, CStdString> &changeTokens)
+{
+  if (error != PVR_ERROR_NOT_IMPLEMENTED &&
+      error != PVR_ERROR_NO_ERROR)
+  {
+    changeTokens.erase(iClientId);
+    return false;
+  }
+
+  changeTokens[iClientId] = strToken;
+  return true;
+}
+
 PVR_ERROR CPVRClients::RenameRecording(const CPVRRecording &recording)
 {
   PVR_ERROR error(PVR_ERROR_UNKNOWN);
@@ -29,6 +29,7 @@
 
 #include <vector>
 #include <deque>
+#include <set>
 
 namespace EPG
 {
@@ -328,9 +329,11 @@ namespace PVR
     /*!
      * @brief Get all timers from clients
      * @param timers Store the timers in this container.
+     * @param changeTokens The change token of each client when its timers were last fetched, updated by this call.
+     * @param unchangedClients The clients that weren't asked for their timers because their change token is the same.
      * @return The amount of timers that were added.
      */
-    PVR_ERROR GetTimers(CPVRTimers *timers);
+    PVR_ERROR GetTimers(CPVRTimers *timers, std::map<int, CStdString> &changeTokens, std::set<int> &unchangedClients);
 
     /*!
      * @brief Add a new timer to a backend.
@@ -381,9 +384,11 @@ namespace PVR
     /*!
      * @brief Get all recordings from clients
      * @param recordings Store the recordings in this container.
+     * @param changeTokens The change token of each client when its recordings were last fetched, updated by this call.
+     * @param unchangedClients The clients that weren't asked for their recordings because their change token is the same.
      * @return The amount of recordings that were added.
      */
-    PVR_ERROR GetRecordings(CPVRRecordings *recordings);
+    PVR_ERROR GetRecordings(CPVRRecordings *recordings, std::map<int, CStdString> &changeTokens, std::set<int> &unchangedClients);
 
     /*!
      * @brief Rename a recordings on the backend.
@@ -561,6 +566,37 @@ namespace PVR
 
     bool GetPlayingClient(PVR_CLIENT &client) const;
 
+    /*! @name Change tokens, telling whether a client's recordings or timers need to be fetched again */
+    //@{
+
+    /*!
+     * @brief Forget the change tokens of clients that aren't connected anymore.
+     * @param clients The connected clients.
+     * @param changeTokens The change tokens to clean up.
+     */
+    static void RemoveDisconnectedTokens(const PVR_CLIENTMAP &clients, std::map<int, CStdString> &changeTokens);
+
+    /*!
+     * @brief Check whether a client's data is the same as when it was last fetched.
+     * @param iClientId The id of the client.
+     * @param strToken The change token the client gives now, empty if it doesn't support them.
+     * @param changeTokens The change token of each client when its data was last fetched.
+     * @return True if the data doesn't need to be fetched again, false otherwise.
+     */
+    static bool IsUnchanged(int iClientId, const CStdString &strToken, const std::map<int, CStdString> &changeTokens);
+
+    /*!
+     * @brief Keep the change token a client gave once its data was fetched.
+     * @param iClientId The id of the client.
+     * @param strToken The change token the client gave before its data was fetched.
+     * @param error The result of the fetch. A failed fetch forgets the token, so the data is fetched again next time.
+     * @param changeTokens The change tokens to update.
+     * @return True if the fetch succeeded, false otherwise.
+     */
+    static bool StoreChangeToken(int iClientId, const CStdString &strToken, PVR_ERROR error, std::map<int, CStdString> &changeTokens);
+
+    //@}
+
   private:
     /*!
      * @brief Update add-ons from the AddonManager
@@ -25,6 +25,7 @@
 #include "filesystem/File.h"
 #include "settings/GUISettings.h"
 #include "utils/StringUtils.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 
 #include "pvr/channels/PVRChannelGroupInternal.h"
@@ -37,6 +38,8 @@
 using namespace PVR;
 using namespace EPG;
 
+volatile long CPVRChannel::m_iIdentityVersion = 0;
+
 bool CPVRChannel::operator==(const CPVRChannel &right) const
 {
   return (m_bIsRadio  == right.m_bIsRadio &&
@@ -111,13 +114,19 @@ CPVRChannel::CPVRChannel(const PVR_CHANNEL &channel, unsigned int iClientId)
   UpdateEncryptionName();
 }
 
-CPVRChannel::CPVRChannel(const CPVRChannel &channel)
+CPVRChannel::CPVRChannel(const CPVRChannel &channel) :
+    m_iChannelId(channel.m_iChannelId),
+    m_iEpgId(channel.m_iEpgId),
+    m_iUniqueId(channel.m_iUniqueId),
+    m_iClientId(channel.m_iClientId)
 {
   *this = channel;
 }
 
 CPVRChannel &CPVRChannel::operator=(const CPVRChannel &channel)
 {
+  /* copies go into file items and aren't members of a group, so the identity version isn't moved on here.
+     The ids of channels in groups only change through the setters */
   m_iChannelId              = channel.m_iChannelId;
   m_bIsRadio                = channel.m_bIsRadio;
   m_bIsHidden               = channel.m_bIsHidden;
@@ -245,6 +254,7 @@ bool CPVRChannel::SetChannelID(int iChannelId)
   {
     /* update the id */
     m_iChannelId = iChannelId;
+    IdentityChanged();
     SetChanged();
     m_bChanged = true;
 
@@ -393,6 +403,7 @@ bool CPVRChannel::SetUniqueID(int iUniqueId)
   {
     /* update the unique ID */
     m_iUniqueId = iUniqueId;
+    IdentityChanged();
     SetChanged();
     m_bChanged = true;
 
@@ -410,6 +421,7 @@ bool CPVRChannel::SetClientID(int iClientId)
   {
     /* update the client ID */
     m_iClientId = iClientId;
+    IdentityChanged();
     SetChanged();
     m_bChanged = true;
 
@@ -849,7 +861,11 @@ int CPVRChannel::EpgID(void) const
 void CPVRChannel::SetEpgID(int iEpgId)
 {
   CSingleLock lock(m_critSection);
-  m_iEpgId = iEpgId;
+  if (m_iEpgId != iEpgId)
+  {
+    m_iEpgId = iEpgId;
+    IdentityChanged();
+  }
   SetChanged();
 }
 
@@ -870,3 +886,13 @@ bool CPVRChannel::CanRecord(void) const
 {
   return g_PVRClients->SupportsRecordings(m_iClientId);
 }
+
+long CPVRChannel::IdentityVersion(void)
+{
+  return m_iIdentityVersion;
+}
+
+void CPVRChannel::IdentityChanged(void)
+{
+  AtomicIncrement(&m_iIdentityVersion);
+}
@@ -454,7 +454,20 @@ namespace PVR
 
     bool CanRecord(void) const;
     //@}
+
+    /*!
+     * @brief A counter that changes whenever the database, EPG, unique or client id of any channel changes.
+     * Channel groups compare it to know when their indexes are out of date.
+     * @return The current value of the counter.
+     */
+    static long IdentityVersion(void);
+
   private:
+    /*!
+     * @brief Move the counter returned by IdentityVersion() on.
+     */
+    static void IdentityChanged(void);
+
     /*!
      * @brief Update the encryption name after SetEncryptionSystem() has been called.
      */
@@ -499,6 +512,8 @@ namespace PVR
     CStdString       m_strClientEncryptionName; /*!< the name of the encryption system used by this channel */
     //@}
 
+    static volatile long m_iIdentityVersion;     /*!< changes when an id of any channel changes */
+
     CCriticalSection m_critSection;
   };
 }
@@ -40,6 +40,8 @@
 #include "pvr/addons/PVRClients.h"
 #include "epg/EpgContainer.h"
 
+#include <limits.h>
+
 using namespace PVR;
 using namespace EPG;
 
@@ -50,7 +52,9 @@ CPVRChannelGroup::CPVRChannelGroup(void) :
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_bIndexesValid(false),
+    m_iIndexedVersion(0)
 {
 }
 
@@ -62,7 +66,9 @@ CPVRChannelGroup::CPVRChannelGroup(bool bRadio, unsigned int iGroupId, const CSt
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_bIndexesValid(false),
+    m_iIndexedVersion(0)
 {
 }
 
@@ -74,7 +80,9 @@ CPVRChannelGroup::CPVRChannelGroup(const PVR_CHANNEL_GROUP &group) :
     m_bLoaded(false),
     m_bChanged(false),
     m_bUsingBackendChannelOrder(false),
-    m_bPreventSortAndRenumber(false)
+    m_bPreventSortAndRenumber(false),
+    m_bIndexesValid(false),
+    m_iIndexedVersion(0)
 {
 }
 
@@ -96,7 +104,9 @@ bool CPVRChannelGroup::operator!=(const CPVRChannelGroup &right) const
   return !(*this == right);
 }
 
-CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group)
+CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group) :
+    m_bIndexesValid(false),
+    m_iIndexedVersion(0)
 {
   m_bRadio                      = group.m_bRadio;
   m_iGroupType                  = group.m_iGroupType;
@@ -108,7 +118,7 @@ CPVRChannelGroup::CPVRChannelGroup(const CPVRChannelGroup &group)
   m_bUsingBackendChannelNumbers = group.m_bUsingBackendChannelNumbers;
 
   for (int iPtr = 0; iPtr < group.Size(); iPtr++)
-    m_members.push_back(group.m_members.at(iPtr));
+    AddMember(group.m_members.at(iPtr));
 }
 
 bool CPVRChannelGroup::Load(void)
@@ -148,6 +158,7 @@ void CPVRChannelGroup::Unload(void)
   CSingleLock lock(m_critSection);
   g_guiSettings.UnregisterObserver(this);
   m_members.clear();
+  InvalidateIndexes();
 }
 
 bool CPVRChannelGroup::Update(void)
@@ -168,18 +179,13 @@ bool CPVRChannelGroup::SetChannelNumber(const CPVRChannel &channel, unsigned int
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
+  int iChannelPtr = GetIndex(channel);
+  if (iChannelPtr >= 0 && m_members.at(iChannelPtr).iChannelNumber != iChannelNumber)
   {
-    if (*m_members.at(iChannelPtr).channel == channel)
-    {
-      if (m_members.at(iChannelPtr).iChannelNumber != iChannelNumber)
-      {
-        m_bChanged = true;
-        bReturn = true;
-        m_members.at(iChannelPtr).iChannelNumber = iChannelNumber;
-      }
-      break;
-    }
+    m_bChanged = true;
+    bReturn = true;
+    m_members.at(iChannelPtr).iChannelNumber = iChannelNumber;
+    InvalidateIndexes();
   }
 
   return bReturn;
@@ -211,6 +217,7 @@ bool CPVRChannelGroup::MoveChannel(unsigned int iOldChannelNumber, unsigned int
   PVRChannelGroupMember entry = m_members.at(iOldChannelNumber - 1);
   m_members.erase(m_members.begin() + iOldChannelNumber - 1);
   m_members.insert(m_members.begin() + iNewChannelNumber - 1, entry);
+  InvalidateIndexes();
 
   /* renumber the list */
   Renumber();
@@ -303,6 +310,19 @@ struct sortByChannelNumber
   }
 };
 
+/* most changes leave the members in order, which is cheaper to check than to sort again */
+template <class Compare>
+static bool IsSorted(const std::vector<PVRChannelGroupMember> &members, Compare compare)
+{
+  for (unsigned int iChannelPtr = 1; iChannelPtr < members.size(); iChannelPtr++)
+  {
+    if (compare(members.at(iChannelPtr), members.at(iChannelPtr - 1)))
+      return false;
+  }
+
+  return true;
+}
+
 bool CPVRChannelGroup::SortAndRenumber(void)
 {
   if (PreventSortAndRenumber())
@@ -322,15 +342,21 @@ bool CPVRChannelGroup::SortAndRenumber(void)
 void CPVRChannelGroup::SortByClientChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
-  if (!PreventSortAndRenumber())
+  if (!PreventSortAndRenumber() && !IsSorted(m_members, sortByClientChannelNumber()))
+  {
     sort(m_members.begin(), m_members.end(), sortByClientChannelNumber());
+    InvalidateIndexes();
+  }
 }
 
 void CPVRChannelGroup::SortByChannelNumber(void)
 {
   CSingleLock lock(m_critSection);
-  if (!PreventSortAndRenumber())
+  if (!PreventSortAndRenumber() && !IsSorted(m_members, sortByChannelNumber()))
+  {
     sort(m_members.begin(), m_members.end(), sortByChannelNumber());
+    InvalidateIndexes();
+  }
 }
 
 /********** getters **********/
@@ -338,14 +364,11 @@ void CPVRChannelGroup::SortByChannelNumber(void)
 CPVRChannelPtr CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueChannelId &&
-        groupMember.channel->ClientID() == iClientID)
-      return groupMember.channel;
-  }
+  std::map<std::pair<int, int>, unsigned int>::const_iterator it = m_indexByUniqueId.find(std::make_pair(iUniqueChannelId, iClientID));
+  if (it != m_indexByUniqueId.end())
+    return m_members.at(it->second).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -354,13 +377,11 @@ CPVRChannelPtr CPVRChannelGroup::GetByClient(int iUniqueChannelId, int iClientID
 CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->ChannelID() == iChannelID)
-      return groupMember.channel;
-  }
+  std::map<int, unsigned int>::const_iterator it = m_indexByChannelId.find(iChannelID);
+  if (it != m_indexByChannelId.end())
+    return m_members.at(it->second).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -369,13 +390,11 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelID(int iChannelID) const
 CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
-  {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->EpgID() == iEpgID)
-      return groupMember.channel;
-  }
+  std::map<int, unsigned int>::const_iterator it = m_indexByEpgId.find(iEpgID);
+  if (it != m_indexByEpgId.end())
+    return m_members.at(it->second).channel;
 
   CPVRChannelPtr empty;
   return empty;
@@ -384,14 +403,20 @@ CPVRChannelPtr CPVRChannelGroup::GetByChannelEpgID(int iEpgID) const
 CPVRChannelPtr CPVRChannelGroup::GetByUniqueID(int iUniqueID) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  /* the first member with this unique id, whatever client it's from */
+  unsigned int iIndex = m_members.size();
+  for (std::map<std::pair<int, int>, unsigned int>::const_iterator it = m_indexByUniqueId.lower_bound(std::make_pair(iUniqueID, INT_MIN));
+       it != m_indexByUniqueId.end() && it->first.first == iUniqueID; ++it)
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.channel->UniqueID() == iUniqueID)
-      return groupMember.channel;
+    if (it->second < iIndex)
+      iIndex = it->second;
   }
 
+  if (iIndex < m_members.size())
+    return m_members.at(iIndex).channel;
+
   CPVRChannelPtr empty;
   return empty;
 }
@@ -440,35 +465,26 @@ CFileItemPtr CPVRChannelGroup::GetLastPlayedChannel(unsigned int iCurrentChannel
 
 unsigned int CPVRChannelGroup::GetChannelNumber(const CPVRChannel &channel) const
 {
-  unsigned int iReturn = 0;
   CSingleLock lock(m_critSection);
-  unsigned int iSize = m_members.size();
+  UpdateIndexes();
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < iSize; iChannelPtr++)
-  {
-    PVRChannelGroupMember member = m_members.at(iChannelPtr);
-    if (member.channel->ChannelID() == channel.ChannelID())
-    {
-      iReturn = member.iChannelNumber;
-      break;
-    }
-  }
+  std::map<int, unsigned int>::const_iterator it = m_indexByChannelId.find(channel.ChannelID());
+  if (it != m_indexByChannelId.end())
+    return m_members.at(it->second).iChannelNumber;
 
-  return iReturn;
+  return 0;
 }
 
 CFileItemPtr CPVRChannelGroup::GetByChannelNumber(unsigned int iChannelNumber) const
 {
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int ptr = 0; ptr < m_members.size(); ptr++)
+  std::map<unsigned int, unsigned int>::const_iterator it = m_indexByChannelNumber.find(iChannelNumber);
+  if (it != m_indexByChannelNumber.end())
   {
-    PVRChannelGroupMember groupMember = m_members.at(ptr);
-    if (groupMember.iChannelNumber == iChannelNumber)
-    {
-      CFileItemPtr retVal = CFileItemPtr(new CFileItem(*groupMember.channel));
-      return retVal;
-    }
+    CFileItemPtr retVal = CFileItemPtr(new CFileItem(*m_members.at(it->second).channel));
+    return retVal;
   }
 
   CFileItemPtr retVal = CFileItemPtr(new CFileItem);
@@ -523,19 +539,14 @@ CFileItemPtr CPVRChannelGroup::GetByIndex(unsigned int iIndex) const
 
 int CPVRChannelGroup::GetIndex(const CPVRChannel &channel) const
 {
-  int iIndex(-1);
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
-  {
-    if (*m_members.at(iChannelPtr).channel == channel)
-    {
-      iIndex = iChannelPtr;
-      break;
-    }
-  }
+  std::map<std::pair<int, int>, unsigned int>::const_iterator it = m_indexByUniqueId.find(std::make_pair(channel.UniqueID(), channel.ClientID()));
+  if (it != m_indexByUniqueId.end() && *m_members.at(it->second).channel == channel)
+    return it->second;
 
-  return iIndex;
+  return -1;
 }
 
 int CPVRChannelGroup::GetMembers(CFileItemList &results, bool bGroupMembers /* = true */) const
@@ -572,6 +583,63 @@ CPVRChannelGroupPtr CPVRChannelGroup::GetPreviousGroup(void) const
 
 /********** private methods **********/
 
+void CPVRChannelGroup::AddMember(const PVRChannelGroupMember &member)
+{
+  CSingleLock lock(m_critSection);
+  m_members.push_back(member);
+
+  /* appending doesn't move the other members, so the indexes only need the new one */
+  if (m_bIndexesValid)
+    IndexMember(m_members.size() - 1);
+}
+
+void CPVRChannelGroup::RemoveMember(unsigned int iIndex)
+{
+  CSingleLock lock(m_critSection);
+  m_members.erase(m_members.begin() + iIndex);
+  InvalidateIndexes();
+}
+
+void CPVRChannelGroup::InvalidateIndexes(void)
+{
+  CSingleLock lock(m_critSection);
+  m_bIndexesValid = false;
+}
+
+void CPVRChannelGroup::UpdateIndexes(void) const
+{
+  CSingleLock lock(m_critSection);
+
+  /* read the version first, so ids changed while indexing are picked up the next time */
+  long iVersion = CPVRChannel::IdentityVersion();
+  if (m_bIndexesValid && m_iIndexedVersion == iVersion)
+    return;
+
+  m_indexByUniqueId.clear();
+  m_indexByChannelId.clear();
+  m_indexByEpgId.clear();
+  m_indexByChannelNumber.clear();
+
+  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
+    IndexMember(iChannelPtr);
+
+  m_iIndexedVersion = iVersion;
+  m_bIndexesValid = true;
+}
+
+void CPVRChannelGroup::IndexMember(unsigned int iIndex) const
+{
+  const PVRChannelGroupMember &member = m_members.at(iIndex);
+  if (!member.channel)
+    return;
+
+  /* insert() keeps the entry that's already there, so the first member wins like it did in a scan */
+  m_indexByUniqueId.insert(std::make_pair(std::make_pair(member.channel->UniqueID(), member.channel->ClientID()), iIndex));
+  m_indexByChannelId.insert(std::make_pair(member.channel->ChannelID(), iIndex));
+  m_indexByEpgId.insert(std::make_pair(member.channel->EpgID(), iIndex));
+  m_indexByChannelNumber.insert(std::make_pair(member.iChannelNumber, iIndex));
+}
+
 int CPVRChannelGroup::LoadFromDb(bool bCompress /* = false */)
 {
   CPVRDatabase *database = GetPVRDatabase();
@@ -657,7 +725,7 @@ bool CPVRChannelGroup::RemoveDeletedChannels(const CPVRChannelGroup &channels)
         channel->Delete();
       }
 
-      m_members.erase(m_members.begin() + iChannelPtr);
+      RemoveMember(iChannelPtr);
       m_bChanged = true;
       bReturn = true;
     }
@@ -739,7 +807,7 @@ void CPVRChannelGroup::RemoveInvalidChannels(void)
       }
       else
       {
-        m_members.erase(m_members.begin() + ptr);
+        RemoveMember(ptr);
       }
       m_bChanged = true;
     }
@@ -751,16 +819,13 @@ bool CPVRChannelGroup::RemoveFromGroup(const CPVRChannel &channel)
   bool bReturn(false);
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
+  int iChannelPtr = GetIndex(channel);
+  if (iChannelPtr >= 0)
   {
-    if (channel == *m_members.at(iChannelPtr).channel)
-    {
-      // TODO notify observers
-      m_members.erase(m_members.begin() + iChannelPtr);
-      bReturn = true;
-      m_bChanged = true;
-      break;
-    }
+    // TODO notify observers
+    RemoveMember(iChannelPtr);
+    bReturn = true;
+    m_bChanged = true;
   }
 
   Renumber();
@@ -786,7 +851,7 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
     if (realChannel)
     {
       PVRChannelGroupMember newMember = { realChannel, (unsigned int)iChannelNumber };
-      m_members.push_back(newMember);
+      AddMember(newMember);
       m_bChanged = true;
 
       SortAndRenumber();
@@ -801,36 +866,15 @@ bool CPVRChannelGroup::AddToGroup(CPVRChannel &channel, int iChannelNumber /* =
 
 bool CPVRChannelGroup::IsGroupMember(const CPVRChannel &channel) const
 {
-  bool bReturn(false);
-  CSingleLock lock(m_critSection);
-
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
-  {
-    if (channel == *m_members.at(iChannelPtr).channel)
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return CPVRChannelGroup::GetIndex(channel) >= 0;
 }
 
 bool CPVRChannelGroup::IsGroupMember(int iChannelId) const
 {
-  bool bReturn(false);
   CSingleLock lock(m_critSection);
+  UpdateIndexes();
 
-  for (unsigned int iChannelPtr = 0; iChannelPtr < m_members.size(); iChannelPtr++)
-  {
-    if (iChannelId == m_members.at(iChannelPtr).channel->ChannelID())
-    {
-      bReturn = true;
-      break;
-    }
-  }
-
-  return bReturn;
+  return m_indexByChannelId.find(iChannelId) != m_indexByChannelId.end();
 }
 
 bool CPVRChannelGroup::SetGroupName(const CStdString &strGroupName, bool bSaveInDb /* = false */)
@@ -905,11 +949,13 @@ bool CPVRChannelGroup::Renumber(void)
     {
       bReturn = true;
       m_bChanged = true;
+      m_members.at(iChannelPtr).iChannelNumber = iCurrentChannelNumber;
     }
-
-    m_members.at(iChannelPtr).iChannelNumber = iCurrentChannelNumber;
   }
 
+  if (bReturn)
+    InvalidateIndexes();
+
   SortByChannelNumber();
   ResetChannelNumberCache();
 
@@ -24,6 +24,7 @@
 #include "PVRChannel.h"
 #include "utils/JobManager.h"
 
+#include <map>
 #include <boost/shared_ptr.hpp>
 
 namespace EPG
@@ -475,6 +476,34 @@ namespace PVR
      */
     CPVRChannelPtr GetByChannelID(int iChannelID) const;
 
+    /*!
+     * @brief Add a member at the end of this group and to the indexes.
+     * @param member The member to add.
+     */
+    void AddMember(const PVRChannelGroupMember &member);
+
+    /*!
+     * @brief Remove a member from this group.
+     * @param iIndex The index of the member in this group.
+     */
+    void RemoveMember(unsigned int iIndex);
+
+    /*!
+     * @brief Mark the indexes as out of date after the members were moved or renumbered.
+     */
+    void InvalidateIndexes(void);
+
+    /*!
+     * @brief Rebuild the indexes if members were moved or renumbered, or any channel's ids changed.
+     */
+    void UpdateIndexes(void) const;
+
+    /*!
+     * @brief Add the member at the given index to the indexes.
+     * @param iIndex The index of the member in this group.
+     */
+    void IndexMember(unsigned int iIndex) const;
+
     bool             m_bRadio;                      /*!< true if this container holds radio channels, false if it holds TV channels */
     int              m_iGroupType;                  /*!< The type of this group */
     int              m_iGroupId;                    /*!< The ID of this group in the database */
@@ -487,6 +516,17 @@ namespace PVR
     bool             m_bPreventSortAndRenumber;     /*!< true when sorting and renumbering should not be done after adding/updating channels to the group */
     std::vector<PVRChannelGroupMember> m_members;
     CCriticalSection m_critSection;
+
+    /*! @name Indexes of the members, first member in the group for each key
+     */
+    //@{
+    mutable bool m_bIndexesValid;                                              /*!< false when the indexes have to be rebuilt */
+    mutable long m_iIndexedVersion;                                            /*!< CPVRChannel::IdentityVersion() when the indexes were built */
+    mutable std::map<std::pair<int, int>, unsigned int> m_indexByUniqueId;     /*!< (unique id, client id) to index */
+    mutable std::map<int, unsigned int>                 m_indexByChannelId;    /*!< database id to index */
+    mutable std::map<int, unsigned int>                 m_indexByEpgId;        /*!< EPG id to index */
+    mutable std::map<unsigned int, unsigned int>        m_indexByChannelNumber; /*!< channel number to index */
+    //@}
   };
 
   class CPVRPersistGroupJob : public CJob
@@ -100,7 +100,7 @@ void CPVRChannelGroupInternal::UpdateFromClient(const CPVRChannel &channel, unsi
   else
   {
     PVRChannelGroupMember newMember = { CPVRChannelPtr(new CPVRChannel(channel)), iChannelNumber > 0l ? iChannelNumber : (int)m_members.size() + 1 };
-    m_members.push_back(newMember);
+    AddMember(newMember);
     m_bChanged = true;
 
     SortAndRenumber();
@@ -279,7 +279,7 @@ bool CPVRChannelGroupInternal::UpdateChannel(const CPVRChannel &channel)
   {
     updateChannel = CPVRChannelPtr(new CPVRChannel(channel.IsRadio()));
     PVRChannelGroupMember newMember = { updateChannel, 0 };
-    m_members.push_back(newMember);
+    AddMember(newMember);
     updateChannel->SetUniqueID(channel.UniqueID());
   }
   updateChannel->UpdateFromClient(channel);
@@ -363,6 +363,7 @@ void CPVRChannelGroupInternal::CreateChannelEpg(CPVRChannelPtr channel, bool bFo
       {
         channel->m_iEpgId = epg->EpgID();
         channel->m_bChanged = true;
+        CPVRChannel::IdentityChanged();
       }
     }
   }
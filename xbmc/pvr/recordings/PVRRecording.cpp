@@ -24,6 +24,7 @@
 #include "PVRRecordings.h"
 #include "pvr/addons/PVRClients.h"
 #include "utils/StringUtils.h"
+#include "utils/Crc32.h"
 #include "utils/RegExp.h"
 #include "utils/StringUtils.h"
 #include "video/VideoDatabase.h"
@@ -33,6 +34,18 @@
 using namespace PVR;
 using namespace EPG;
 
+/* the terminator is included, so that moving text from one field to the next changes the checksum */
+static void ComputeString(Crc32 &crc, const char *strValue)
+{
+  crc.Compute(strValue, strlen(strValue) + 1);
+}
+
+template<typename T>
+static void ComputeValue(Crc32 &crc, const T &value)
+{
+  crc.Compute((const char *)&value, sizeof(value));
+}
+
 CPVRRecording::CPVRRecording()
 {
   Reset();
@@ -61,6 +74,31 @@ CPVRRecording::CPVRRecording(const PVR_RECORDING &recording, unsigned int iClien
   m_strIconPath                    = recording.strIconPath;
   m_strThumbnailPath               = recording.strThumbnailPath;
   m_strFanartPath                  = recording.strFanartPath;
+  m_iFingerprint                   = GetFingerprint(recording);
+}
+
+unsigned int CPVRRecording::GetFingerprint(const PVR_RECORDING &recording)
+{
+  Crc32 crc;
+  ComputeString(crc, recording.strRecordingId);
+  ComputeString(crc, recording.strTitle);
+  ComputeString(crc, recording.strStreamURL);
+  ComputeString(crc, recording.strDirectory);
+  ComputeString(crc, recording.strPlotOutline);
+  ComputeString(crc, recording.strPlot);
+  ComputeString(crc, recording.strChannelName);
+  ComputeString(crc, recording.strIconPath);
+  ComputeString(crc, recording.strThumbnailPath);
+  ComputeString(crc, recording.strFanartPath);
+  ComputeValue(crc, recording.recordingTime);
+  ComputeValue(crc, recording.iDuration);
+  ComputeValue(crc, recording.iPriority);
+  ComputeValue(crc, recording.iLifetime);
+  ComputeValue(crc, recording.iGenreType);
+  ComputeValue(crc, recording.iGenreSubType);
+  ComputeValue(crc, recording.iPlayCount);
+  ComputeValue(crc, recording.iLastPlayedPosition);
+  return crc;
 }
 
 bool CPVRRecording::operator ==(const CPVRRecording& right) const
@@ -103,6 +141,7 @@ void CPVRRecording::Reset(void)
   m_strThumbnailPath   = StringUtils::EmptyString;
   m_strFanartPath      = StringUtils::EmptyString;
   m_bGotMetaData       = false;
+  m_iFingerprint       = 0;
 
   m_recordingTime.Reset();
   CVideoInfoTag::Reset();
@@ -251,11 +290,15 @@ void CPVRRecording::Update(const CPVRRecording &tag)
   m_strIconPath       = tag.m_strIconPath;
   m_strThumbnailPath  = tag.m_strThumbnailPath;
   m_strFanartPath     = tag.m_strFanartPath;
+  m_iFingerprint      = tag.m_iFingerprint;
 
-  if (g_PVRClients->SupportsRecordingPlayCount(m_iClientId))
+  if (m_playCount != tag.m_playCount &&
+      g_PVRClients->SupportsRecordingPlayCount(m_iClientId))
     m_playCount       = tag.m_playCount;
 
-  if (g_PVRClients->SupportsLastPlayedPosition(m_iClientId))
+  if ((m_resumePoint.timeInSeconds != tag.m_resumePoint.timeInSeconds ||
+       m_resumePoint.totalTimeInSeconds != tag.m_resumePoint.totalTimeInSeconds) &&
+      g_PVRClients->SupportsLastPlayedPosition(m_iClientId))
   {
     m_resumePoint.timeInSeconds = tag.m_resumePoint.timeInSeconds;
     m_resumePoint.totalTimeInSeconds = tag.m_resumePoint.totalTimeInSeconds;
@@ -55,6 +55,7 @@ namespace PVR
     CStdString    m_strIconPath;      /*!< icon path */
     CStdString    m_strThumbnailPath; /*!< thumbnail path */
     CStdString    m_strFanartPath;    /*!< fanart path */
+    unsigned int  m_iFingerprint;     /*!< checksum of the recording as the client sent it, 0 if unknown */
 
     CPVRRecording(void);
     CPVRRecording(const PVR_RECORDING &recording, unsigned int iClientId);
@@ -131,6 +132,13 @@ namespace PVR
      */
     void Update(const CPVRRecording &tag);
 
+    /*!
+     * @brief Get a checksum of a recording as the client sent it, to tell whether it changed since the last time.
+     * @param recording The recording.
+     * @return The checksum.
+     */
+    static unsigned int GetFingerprint(const PVR_RECORDING &recording);
+
     const CDateTime &RecordingTimeAsUTC(void) const { return m_recordingTime; }
     const CDateTime &RecordingTimeAsLocalTime(void) const;
     void SetRecordingTimeFromUTC(CDateTime &recordingTime) { m_recordingTime = recordingTime; }
@@ -41,11 +41,13 @@ CPVRRecordings::CPVRRecordings(void) :
 
 }
 
-void CPVRRecordings::UpdateFromClients(void)
+bool CPVRRecordings::UpdateFromClients(void)
 {
   CSingleLock lock(m_critSection);
-  Clear();
-  g_PVRClients->GetRecordings(this);
+  CPVRRecordings recordings;
+  std::set<int> unchangedClients;
+  g_PVRClients->GetRecordings(&recordings, m_changeTokens, unchangedClients);
+  return UpdateEntries(recordings, unchangedClients);
 }
 
 CStdString CPVRRecordings::TrimSlashes(const CStdString &strOrig) const
@@ -277,10 +279,12 @@ void CPVRRecordings::Update(void)
   lock.Leave();
 
   CLog::Log(LOGDEBUG, "CPVRRecordings - %s - updating recordings", __FUNCTION__);
-  UpdateFromClients();
+  bool bChanged = UpdateFromClients();
 
   lock.Enter();
   m_bIsUpdating = false;
+  if (!bChanged)
+    return;
   SetChanged();
   lock.Leave();
 
@@ -414,15 +418,9 @@ void CPVRRecordings::SetPlayCount(const CFileItem &item, int iPlayCount)
 
   const CPVRRecording *recording = item.GetPVRRecordingInfoTag();
   CSingleLock lock(m_critSection);
-  for (unsigned int iRecordingPtr = 0; iRecordingPtr < m_recordings.size(); iRecordingPtr++)
-  {
-    CPVRRecording *current = m_recordings.at(iRecordingPtr);
-    if (current->m_iClientId == recording->m_iClientId && current->m_strRecordingId.Equals(recording->m_strRecordingId))
-    {
-      current->SetPlayCount(iPlayCount);
-      break;
-    }
-  }
+  CPVRRecording *current = GetByClient(recording->m_iClientId, recording->m_strRecordingId);
+  if (current)
+    current->SetPlayCount(iPlayCount);
 }
 
 void CPVRRecordings::GetAll(CFileItemList &items)
@@ -474,29 +472,84 @@ void CPVRRecordings::Clear()
   for (unsigned int iRecordingPtr = 0; iRecordingPtr < m_recordings.size(); iRecordingPtr++)
     delete m_recordings.at(iRecordingPtr);
   m_recordings.erase(m_recordings.begin(), m_recordings.end());
+  m_recordingsByClient.clear();
+  m_changeTokens.clear();
+}
+
+std::pair<int, CStdString> CPVRRecordings::GetClientKey(int iClientId, const CStdString &strRecordingId)
+{
+  /* recording ids are compared case insensitive */
+  CStdString strKey(strRecordingId);
+  strKey.ToLower();
+  return std::make_pair(iClientId, strKey);
+}
+
+CPVRRecording *CPVRRecordings::GetByClient(int iClientId, const CStdString &strRecordingId) const
+{
+  std::map<std::pair<int, CStdString>, CPVRRecording *>::const_iterator it = m_recordingsByClient.find(GetClientKey(iClientId, strRecordingId));
+  return it != m_recordingsByClient.end() ? it->second : NULL;
 }
 
 void CPVRRecordings::UpdateEntry(const CPVRRecording &tag)
 {
-  bool bFound = false;
   CSingleLock lock(m_critSection);
 
-  for (unsigned int iRecordingPtr = 0; iRecordingPtr < m_recordings.size(); iRecordingPtr++)
+  CPVRRecording *currentTag = GetByClient(tag.m_iClientId, tag.m_strRecordingId);
+  if (currentTag)
   {
-    CPVRRecording *currentTag = m_recordings.at(iRecordingPtr);
-    if (currentTag->m_iClientId == tag.m_iClientId &&
-        currentTag->m_strRecordingId.Equals(tag.m_strRecordingId))
-    {
-      currentTag->Update(tag);
-      bFound = true;
-      break;
-    }
+    currentTag->Update(tag);
   }
-
-  if (!bFound)
+  else
   {
     CPVRRecording *newTag = new CPVRRecording();
     newTag->Update(tag);
     m_recordings.push_back(newTag);
+    m_recordingsByClient.insert(std::make_pair(GetClientKey(newTag->m_iClientId, newTag->m_strRecordingId), newTag));
   }
 }
+
+bool CPVRRecordings::UpdateEntries(const CPVRRecordings &recordings, const std::set<int> &unchangedClients)
+{
+  bool bChanged(false);
+  CSingleLock lock(m_critSection);
+
+  std::set<const CPVRRecording *> found;
+  for (std::vector<CPVRRecording *>::const_iterator it = recordings.m_recordings.begin(); it != recordings.m_recordings.end(); ++it)
+  {
+    const CPVRRecording *tag = *it;
+    CPVRRecording *currentTag = GetByClient(tag->m_iClientId, tag->m_strRecordingId);
+    if (!currentTag)
+    {
+      currentTag = new CPVRRecording(*tag);
+      m_recordings.push_back(currentTag);
+      m_recordingsByClient.insert(std::make_pair(GetClientKey(currentTag->m_iClientId, currentTag->m_strRecordingId), currentTag));
+      bChanged = true;
+    }
+    else if (tag->m_iFingerprint == 0 || tag->m_iFingerprint != currentTag->m_iFingerprint)
+    {
+      /* only recordings that the client sent differently than the last time are updated */
+      currentTag->Update(*tag);
+      bChanged = true;
+    }
+    found.insert(currentTag);
+  }
+
+  /* remove the recordings that are gone from the clients that were asked */
+  std::vector<CPVRRecording *>::iterator itKeep = m_recordings.begin();
+  for (std::vector<CPVRRecording *>::iterator it = m_recordings.begin(); it != m_recordings.end(); ++it)
+  {
+    CPVRRecording *currentTag = *it;
+    if (found.find(currentTag) == found.end() &&
+        unchangedClients.find(currentTag->m_iClientId) == unchangedClients.end())
+    {
+      m_recordingsByClient.erase(GetClientKey(currentTag->m_iClientId, currentTag->m_strRecordingId));
+      delete currentTag;
+      bChanged = true;
+    }
+    else
+      *itKeep++ = currentTag;
+  }
+  m_recordings.erase(itKeep, m_recordings.end());
+
+  return bChanged;
+}
@@ -27,6 +27,9 @@
 
 #define PVR_ALL_RECORDINGS_PATH_EXTENSION "-1"
 
+#include <map>
+#include <set>
+
 namespace PVR
 {
   class CPVRRecordings : public Observable
@@ -35,8 +38,10 @@ namespace PVR
     CCriticalSection             m_critSection;
     bool                         m_bIsUpdating;
     std::vector<CPVRRecording *> m_recordings;
+    std::map<std::pair<int, CStdString>, CPVRRecording *> m_recordingsByClient; /*!< the recordings by client id and lower case recording id */
+    std::map<int, CStdString>    m_changeTokens;                                /*!< the change token of each client when its recordings were fetched */
 
-    virtual void UpdateFromClients(void);
+    virtual bool UpdateFromClients(void);
     virtual CStdString TrimSlashes(const CStdString &strOrig) const;
     virtual const CStdString GetDirectoryFromPath(const CStdString &strPath, const CStdString &strBase) const;
     virtual bool IsDirectoryMember(const CStdString &strDirectory, const CStdString &strEntryDirectory, bool bDirectMember = true) const;
@@ -46,6 +51,9 @@ namespace PVR
     CStdString AddAllRecordingsPathExtension(const CStdString &strDirectory);
     CStdString RemoveAllRecordingsPathExtension(const CStdString &strDirectory);
 
+    static std::pair<int, CStdString> GetClientKey(int iClientId, const CStdString &strRecordingId);
+    CPVRRecording *GetByClient(int iClientId, const CStdString &strRecordingId) const;
+
   public:
     CPVRRecordings(void);
     virtual ~CPVRRecordings(void) { Clear(); };
@@ -56,6 +64,14 @@ namespace PVR
     void UpdateEntry(const CPVRRecording &tag);
     void UpdateFromClient(const CPVRRecording &tag) { UpdateEntry(tag); }
 
+    /*!
+     * @brief Update this container with the recordings fetched from the clients.
+     * @param recordings The recordings that were fetched.
+     * @param unchangedClients The clients that weren't asked for their recordings, whose recordings are kept as they are.
+     * @return True if a recording was added, changed or removed, false otherwise.
+     */
+    bool UpdateEntries(const CPVRRecordings &recordings, const std::set<int> &unchangedClients);
+
     /**
      * @brief refresh the recordings list from the clients.
      */
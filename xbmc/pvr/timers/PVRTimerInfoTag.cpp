@@ -24,6 +24,7 @@
 #include "dialogs/GUIDialogOK.h"
 #include "dialogs/GUIDialogYesNo.h"
 #include "settings/AdvancedSettings.h"
+#include "utils/Crc32.h"
 #include "utils/log.h"
 #include "utils/StringUtils.h"
 
@@ -40,6 +41,17 @@ using namespace std;
 using namespace PVR;
 using namespace EPG;
 
+static void ComputeString(Crc32 &crc, const char *strValue)
+{
+  crc.Compute(strValue, strlen(strValue) + 1);
+}
+
+template<typename T>
+static void ComputeValue(Crc32 &crc, const T &value)
+{
+  crc.Compute((const char *)&value, sizeof(value));
+}
+
 CPVRTimerInfoTag::CPVRTimerInfoTag(void)
 {
   m_strTitle           = g_localizeStrings.Get(19056); // New Timer
@@ -64,6 +76,7 @@ CPVRTimerInfoTag::CPVRTimerInfoTag(void)
   m_StartTime          = CDateTime::GetUTCDateTime();
   m_StopTime           = m_StartTime;
   m_state              = PVR_TIMER_STATE_SCHEDULED;
+  m_iFingerprint       = 0;
   m_FirstDay.SetValid(false);
 }
 
@@ -94,10 +107,45 @@ CPVRTimerInfoTag::CPVRTimerInfoTag(const PVR_TIMER &timer, CPVRChannelPtr channe
   m_bIsRadio           = channel && channel->IsRadio();
   m_state              = timer.state;
   m_strFileNameAndPath.Format("pvr://client%i/timers/%i", m_iClientId, m_iClientIndex);
+  m_iFingerprint       = GetFingerprint(timer, m_iClientChannelUid, m_iChannelNumber);
 
   UpdateSummary();
 }
 
+unsigned int CPVRTimerInfoTag::GetFingerprint(const PVR_TIMER &timer, int iClientChannelUid, int iChannelNumber)
+{
+  Crc32 crc;
+  ComputeValue(crc, timer.iClientIndex);
+  ComputeValue(crc, timer.iClientChannelUid);
+  ComputeValue(crc, timer.startTime);
+  ComputeValue(crc, timer.endTime);
+  ComputeValue(crc, timer.state);
+  ComputeString(crc, timer.strTitle);
+  ComputeString(crc, timer.strDirectory);
+  ComputeString(crc, timer.strSummary);
+  ComputeValue(crc, timer.iPriority);
+  ComputeValue(crc, timer.iLifetime);
+  ComputeValue(crc, timer.bIsRepeating);
+  ComputeValue(crc, timer.firstDay);
+  ComputeValue(crc, timer.iWeekdays);
+  ComputeValue(crc, timer.iEpgUid);
+  ComputeValue(crc, timer.iMarginStart);
+  ComputeValue(crc, timer.iMarginEnd);
+  ComputeValue(crc, timer.iGenreType);
+  ComputeValue(crc, timer.iGenreSubType);
+  /* the channel is looked up locally and may be renumbered without the timer changing on the client */
+  ComputeValue(crc, iClientChannelUid);
+  ComputeValue(crc, iChannelNumber);
+  return crc;
+}
+
+CPVRTimerInfoTag::CPVRTimerInfoTag(const CPVRTimerInfoTag &tag)
+{
+  m_strFileNameAndPath = tag.m_strFileNameAndPath;
+  m_channel            = tag.m_channel;
+  UpdateEntry(tag);
+}
+
 bool CPVRTimerInfoTag::operator ==(const CPVRTimerInfoTag& right) const
 {
   bool bChannelsMatch = true;
@@ -147,6 +195,7 @@ CPVRTimerInfoTag &CPVRTimerInfoTag::operator=(const CPVRTimerInfoTag &orig)
   m_iMarginEnd         = orig.m_iMarginEnd;
   m_state              = orig.m_state;
   m_iChannelNumber     = orig.m_iChannelNumber;
+  m_iFingerprint       = orig.m_iFingerprint;
 
   return *this;
 }
@@ -331,6 +380,7 @@ bool CPVRTimerInfoTag::UpdateEntry(const CPVRTimerInfoTag &tag)
   m_iGenreType        = tag.m_iGenreType;
   m_iGenreSubType     = tag.m_iGenreSubType;
   m_strSummary        = tag.m_strSummary;
+  m_iFingerprint      = tag.m_iFingerprint;
 
   if (m_strSummary.IsEmpty())
     UpdateSummary();
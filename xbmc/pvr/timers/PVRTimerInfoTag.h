@@ -70,6 +70,7 @@ namespace PVR
   public:
     CPVRTimerInfoTag(void);
     CPVRTimerInfoTag(const PVR_TIMER &timer, CPVRChannelPtr channel, unsigned int iClientId);
+    CPVRTimerInfoTag(const CPVRTimerInfoTag &tag);
     virtual ~CPVRTimerInfoTag(void);
 
     bool operator ==(const CPVRTimerInfoTag& right) const;
@@ -158,6 +159,15 @@ namespace PVR
 
     void UpdateChannel(void);
 
+    /*!
+     * @brief Get a checksum of a timer as the client sent it, to tell whether it changed since the last time.
+     * @param timer The timer.
+     * @param iClientChannelUid The unique id of the channel the timer was matched with.
+     * @param iChannelNumber The number of that channel.
+     * @return The checksum.
+     */
+    static unsigned int GetFingerprint(const PVR_TIMER &timer, int iClientChannelUid, int iChannelNumber);
+
     CStdString            m_strTitle;           /*!< @brief name of this timer */
     CStdString            m_strDirectory;       /*!< @brief directory where the recording must be stored */
     CStdString            m_strSummary;         /*!< @brief summary string with the time to show inside a GUI list */
@@ -179,6 +189,7 @@ namespace PVR
     std::vector<std::string> m_genre;           /*!< @brief genre of the timer */
     int                   m_iGenreType;         /*!< @brief genre type of the timer */
     int                   m_iGenreSubType;      /*!< @brief genre subtype of the timer */
+    unsigned int          m_iFingerprint;       /*!< @brief checksum of the timer as the client sent it, 0 if unknown */
 
   private:
     CCriticalSection      m_critSection;
@@ -69,21 +69,30 @@ void CPVRTimers::Unload()
   // remove all tags
   CSingleLock lock(m_critSection);
   m_tags.clear();
+  m_changeTokens.clear();
 }
 
 bool CPVRTimers::Update(void)
 {
+  map<int, CStdString> changeTokens;
   {
     CSingleLock lock(m_critSection);
     if (m_bIsUpdating)
       return false;
     m_bIsUpdating = true;
+    changeTokens = m_changeTokens;
   }
 
   CLog::Log(LOGDEBUG, "CPVRTimers - %s - updating timers", __FUNCTION__);
   CPVRTimers newTimerList;
-  g_PVRClients->GetTimers(&newTimerList);
-  return UpdateEntries(newTimerList);
+  set<int> unchangedClients;
+  g_PVRClients->GetTimers(&newTimerList, changeTokens, unchangedClients);
+
+  {
+    CSingleLock lock(m_critSection);
+    m_changeTokens = changeTokens;
+  }
+  return UpdateEntries(newTimerList, unchangedClients);
 }
 
 bool CPVRTimers::IsRecording(void) const
@@ -98,7 +107,7 @@ bool CPVRTimers::IsRecording(void) const
   return false;
 }
 
-bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
+bool CPVRTimers::UpdateEntries(const CPVRTimers &timers, const set<int> &unchangedClients)
 {
   bool bChanged(false);
   bool bAddedOrDeleted(false);
@@ -106,15 +115,27 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
 
   CSingleLock lock(m_critSection);
 
+  map<pair<int, int>, CPVRTimerInfoTagPtr> existingTimers, newTimers;
+  GetTimersByClient(existingTimers);
+  timers.GetTimersByClient(newTimers);
+
   /* go through the timer list and check for updated or new timers */
   for (map<CDateTime, vector<CPVRTimerInfoTagPtr>* >::const_iterator it = timers.m_tags.begin(); it != timers.m_tags.end(); it++)
   {
     for (vector<CPVRTimerInfoTagPtr>::const_iterator timerIt = it->second->begin(); timerIt != it->second->end(); timerIt++)
     {
       /* check if this timer is present in this container */
-      CPVRTimerInfoTagPtr existingTimer = GetByClient((*timerIt)->m_iClientId, (*timerIt)->m_iClientIndex);
+      map<pair<int, int>, CPVRTimerInfoTagPtr>::const_iterator existingIt = existingTimers.find(make_pair((*timerIt)->m_iClientId, (*timerIt)->m_iClientIndex));
+      CPVRTimerInfoTagPtr existingTimer = existingIt != existingTimers.end() ? existingIt->second : CPVRTimerInfoTagPtr();
       if (existingTimer)
       {
+        /* the client sent the same timer as the last time, only link it to the epg if that was loaded since */
+        if ((*timerIt)->m_iFingerprint != 0 && existingTimer->m_iFingerprint == (*timerIt)->m_iFingerprint)
+        {
+          UpdateEpgEvent(existingTimer);
+          continue;
+        }
+
         /* if it's present, update the current tag */
         bool bStateChanged(existingTimer->m_state != (*timerIt)->m_state);
         if (existingTimer->UpdateEntry(*(*timerIt)))
@@ -136,8 +157,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
       else
       {
         /* new timer */
-        CPVRTimerInfoTagPtr newTimer = CPVRTimerInfoTagPtr(new CPVRTimerInfoTag);
-        newTimer->UpdateEntry(*(*timerIt));
+        CPVRTimerInfoTagPtr newTimer = CPVRTimerInfoTagPtr(new CPVRTimerInfoTag(*(*timerIt)));
         UpdateEpgEvent(newTimer);
 
         vector<CPVRTimerInfoTagPtr>* addEntry = NULL;
@@ -153,6 +173,7 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
         }
 
         addEntry->push_back(newTimer);
+        existingTimers.insert(make_pair(make_pair(newTimer->m_iClientId, newTimer->m_iClientIndex), newTimer));
         UpdateEpgEvent(newTimer);
         bChanged = true;
         bAddedOrDeleted = true;
@@ -179,7 +200,8 @@ bool CPVRTimers::UpdateEntries(const CPVRTimers &timers)
     for (int iTimerPtr = it->second->size() - 1; iTimerPtr >= 0; iTimerPtr--)
     {
       CPVRTimerInfoTagPtr timer = it->second->at(iTimerPtr);
-      if (!timers.GetByClient(timer->m_iClientId, timer->m_iClientIndex))
+      if (unchangedClients.find(timer->m_iClientId) == unchangedClients.end() &&
+          newTimers.find(make_pair(timer->m_iClientId, timer->m_iClientIndex)) == newTimers.end())
       {
         /* timer was not found */
         CLog::Log(LOGDEBUG,"PVRTimers - %s - deleted timer %d on client %d",
@@ -274,7 +296,7 @@ bool CPVRTimers::UpdateFromClient(const CPVRTimerInfoTag &timer)
   CPVRTimerInfoTagPtr tag = GetByClient(timer.m_iClientId, timer.m_iClientIndex);
   if (!tag)
   {
-    tag = CPVRTimerInfoTagPtr(new CPVRTimerInfoTag());
+    tag = CPVRTimerInfoTagPtr(new CPVRTimerInfoTag(timer));
     vector<CPVRTimerInfoTagPtr>* addEntry = NULL;
     map<CDateTime, vector<CPVRTimerInfoTagPtr>* >::iterator itr = m_tags.find(timer.StartAsUTC());
     if (itr == m_tags.end())
@@ -287,6 +309,7 @@ bool CPVRTimers::UpdateFromClient(const CPVRTimerInfoTag &timer)
       addEntry = itr->second;
     }
     addEntry->push_back(tag);
+    return true;
   }
 
   UpdateEpgEvent(tag);
@@ -585,6 +608,16 @@ bool CPVRTimers::UpdateTimer(CFileItem &item)
   return tag->UpdateOnClient();
 }
 
+void CPVRTimers::GetTimersByClient(map<pair<int, int>, CPVRTimerInfoTagPtr> &timers) const
+{
+  CSingleLock lock(m_critSection);
+
+  /* the first timer found for a client index wins, like in GetByClient() */
+  for (map<CDateTime, vector<CPVRTimerInfoTagPtr>* >::const_iterator it = m_tags.begin(); it != m_tags.end(); it++)
+    for (vector<CPVRTimerInfoTagPtr>::const_iterator timerIt = it->second->begin(); timerIt != it->second->end(); timerIt++)
+      timers.insert(make_pair(make_pair((*timerIt)->m_iClientId, (*timerIt)->m_iClientIndex), *timerIt));
+}
+
 CPVRTimerInfoTagPtr CPVRTimers::GetByClient(int iClientId, int iClientTimerId) const
 {
   CSingleLock lock(m_critSection);
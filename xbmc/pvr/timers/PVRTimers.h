@@ -24,6 +24,8 @@
 #include "addons/include/xbmc_pvr_types.h"
 #include "utils/Observer.h"
 
+#include <set>
+
 class CFileItem;
 namespace EPG
 {
@@ -162,18 +164,22 @@ namespace PVR
     /*!
      * @brief Update the channel pointers.
      */
-    void UpdateChannels(void);
+    virtual void UpdateChannels(void);
 
     void Notify(const Observable &obs, const ObservableMessage msg);
 
+  protected:
+    virtual void UpdateEpgEvent(CPVRTimerInfoTagPtr timer);
+    bool UpdateEntries(const CPVRTimers &timers, const std::set<int> &unchangedClients);
+
   private:
     void Unload(void);
-    void UpdateEpgEvent(CPVRTimerInfoTagPtr timer);
-    bool UpdateEntries(const CPVRTimers &timers);
     CPVRTimerInfoTagPtr GetByClient(int iClientId, int iClientTimerId) const;
+    void GetTimersByClient(std::map<std::pair<int, int>, CPVRTimerInfoTagPtr> &timers) const;
 
     CCriticalSection                                        m_critSection;
     bool                                                    m_bIsUpdating;
     std::map<CDateTime, std::vector<CPVRTimerInfoTagPtr>* > m_tags;
+    std::map<int, CStdString>                               m_changeTokens; /*!< the change token of each client when its timers were fetched */
   };
 }
@@ -247,6 +247,7 @@ class CAdvancedSettings
     bool m_bVideoLibraryExportAutoThumbs;
     bool m_bVideoLibraryImportWatchedState;
     bool m_bVideoLibraryImportResumePoint;
+    int m_iVideoLibraryThumbExtractionJobs;
 
     bool m_bVideoScannerIgnoreErrors;
     int m_iVideoLibraryDateAdded;
@@ -273,6 +274,8 @@ class CAdvancedSettings
     int m_iEpgActiveTagCheckInterval; // seconds
     int m_iEpgRetryInterruptedUpdateInterval; // seconds
     int m_iEpgUpdateEmptyTagsInterval; // seconds
+    int m_iEpgUpdateThreads;        // tables fetched at once
+    int m_iEpgClientUpdateThreads;  // tables of one client fetched at once, only for add-ons known to handle concurrent calls
     bool m_bEpgDisplayUpdatePopup;
     bool m_bEpgDisplayIncrementalUpdatePopup;
 
@@ -290,6 +293,8 @@ class CAdvancedSettings
     int m_curllowspeedtime;
     int m_curlretries;
     bool m_curlDisableIPV6;
+    int m_curlsegments;
+    unsigned int m_curlsegmentsize;
 
     bool m_fullScreen;
     bool m_startFullScreen;
@@ -352,6 +357,7 @@ class CAdvancedSettings
     bool m_guiVisualizeDirtyRegions;
     int  m_guiAlgorithmDirtyRegions;
     int  m_guiDirtyRegionNoFlipTimeout;
+    int  m_guiFontCacheSize;          // KB of glyph textures shared by all fonts before glyphs are evicted, 0 for no limit
     unsigned int m_addonPackageFolderSize;
 
     unsigned int m_cacheMemBufferSize;
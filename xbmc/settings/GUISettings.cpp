@@ -50,6 +50,8 @@
 #include "LangInfo.h"
 #include "pvr/PVRManager.h"
 #include "utils/XMLUtils.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
 #if defined(TARGET_DARWIN)
   #include "osx/DarwinUtils.h"
 #endif
@@ -253,6 +255,7 @@ void CSettingsGroup::GetCategories(vecSettingsCategory &vecCategories)
 // Settings are case sensitive
 CGUISettings::CGUISettings(void)
 {
+  m_version = 0;
 }
 
 void CGUISettings::Initialize()
@@ -1029,6 +1032,9 @@ void CGUISettings::Initialize()
 CGUISettings::~CGUISettings(void)
 {
   Clear();
+  for (map<string, SSettingSlot*>::iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+    delete it->second;
+  m_slots.clear();
 }
 
 void CGUISettings::AddGroup(int groupID, int labelID)
@@ -1068,7 +1074,12 @@ void CGUISettings::AddSetting(CSettingsCategory* cat, CSetting* setting)
 
   if (cat)
     cat->m_settings.push_back(setting);
-  settingsMap.insert(pair<CStdString, CSetting*>(CStdString(setting->GetSetting()).ToLower(), setting));
+  mapIter it = settingsMap.insert(pair<CStdString, CSetting*>(CStdString(setting->GetSetting()).ToLower(), setting)).first;
+
+  CSingleLock lock(m_slotSection);
+  map<string, SSettingSlot*>::iterator slot = m_slots.find(it->first);
+  if (slot != m_slots.end())
+    slot->second->setting = it->second;
 }
 
 void CGUISettings::AddSeparator(CSettingsCategory* cat, const char *strSetting)
@@ -1103,6 +1114,14 @@ bool CGUISettings::GetBool(const char *strSetting) const
   return false;
 }
 
+bool CGUISettings::GetBool(const CSettingHandle &handle) const
+{
+  CSetting *setting = Resolve(handle);
+  if (setting)
+    return ((CSettingBool*)setting)->GetData();
+  return GetBool(handle.GetSetting());
+}
+
 void CGUISettings::SetBool(const char *strSetting, bool bSetting)
 {
   ASSERT(settingsMap.size());
@@ -1157,6 +1176,14 @@ float CGUISettings::GetFloat(const char *strSetting) const
   return 0.0f;
 }
 
+float CGUISettings::GetFloat(const CSettingHandle &handle) const
+{
+  CSetting *setting = Resolve(handle);
+  if (setting)
+    return ((CSettingFloat *)setting)->GetData();
+  return GetFloat(handle.GetSetting());
+}
+
 void CGUISettings::SetFloat(const char *strSetting, float fSetting)
 {
   ASSERT(settingsMap.size());
@@ -1231,6 +1258,14 @@ int CGUISettings::GetInt(const char *strSetting) const
   return 0;
 }
 
+int CGUISettings::GetInt(const CSettingHandle &handle) const
+{
+  CSetting *setting = Resolve(handle);
+  if (setting)
+    return ((CSettingInt *)setting)->GetData();
+  return GetInt(handle.GetSetting());
+}
+
 void CGUISettings::SetInt(const char *strSetting, int iSetting)
 {
   ASSERT(settingsMap.size());
@@ -1305,6 +1340,19 @@ const CStdString &CGUISettings::GetString(const char *strSetting, bool bPrompt /
   return StringUtils::EmptyString;
 }
 
+const CStdString &CGUISettings::GetString(const CSettingHandle &handle, bool bPrompt /* = true */) const
+{
+  CSetting *setting = Resolve(handle);
+  if (setting)
+  {
+    const CStdString &data = ((CSettingString *)setting)->GetData();
+    // folders still to be selected are prompted for the usual way
+    if (data != "select folder" && data != "select writable folder")
+      return data;
+  }
+  return GetString(handle.GetSetting(), bPrompt);
+}
+
 void CGUISettings::SetString(const char *strSetting, const char *strData)
 {
   ASSERT(settingsMap.size());
@@ -1562,6 +1610,12 @@ void CGUISettings::SaveXML(TiXmlNode *pRootNode)
 
 void CGUISettings::Clear()
 {
+  {
+    CSingleLock lock(m_slotSection);
+    for (map<string, SSettingSlot*>::iterator it = m_slots.begin(); it != m_slots.end(); ++it)
+      it->second->setting = NULL;
+  }
+
   for (mapIter it = settingsMap.begin(); it != settingsMap.end(); it++)
     delete (*it).second;
   settingsMap.clear();
@@ -1572,6 +1626,31 @@ void CGUISettings::Clear()
   SetChanged();
 }
 
+void CGUISettings::SetChanged(bool bSetTo /* = true */)
+{
+  if (bSetTo)
+    AtomicIncrement(&m_version);
+  Observable::SetChanged(bSetTo);
+}
+
+CSetting *CGUISettings::Resolve(const CSettingHandle &handle) const
+{
+  if (!handle.m_slot)
+  {
+    // handles for the same setting share its slot, resolving it twice is harmless
+    CSingleLock lock(m_slotSection);
+    SSettingSlot *&slot = m_slots[handle.GetSetting()];
+    if (!slot)
+    {
+      constMapIter it = settingsMap.find(handle.GetSetting());
+      slot = new SSettingSlot;
+      slot->setting = it != settingsMap.end() ? it->second : NULL;
+    }
+    handle.m_slot = slot;
+  }
+  return handle.m_slot->setting;
+}
+
 float square_error(float x, float y)
 {
   float yonx = (x > 0) ? y / x : 0;
@@ -26,6 +26,7 @@
 #include "addons/IAddon.h"
 #include "utils/Observer.h"
 #include "utils/GlobalsHandling.h"
+#include "threads/CriticalSection.h"
 
 class TiXmlNode;
 class TiXmlElement;
@@ -454,6 +455,33 @@ private:
 
 typedef std::vector<CSetting *> vecSettings;
 
+struct SSettingSlot
+{
+  CSetting * volatile setting;
+};
+
+/*!
+ \brief A setting name that is looked up once.
+
+ Reading a setting by name builds a string and searches the settings map, which adds up for
+ settings read per frame or per packet. A handle resolves to a slot on its first read, and the
+ slot follows the setting through Clear() and Initialize(), so handles are meant to be static:
+
+   static CSettingHandle settingUsePBO("videoplayer.usepbo");
+   if (g_guiSettings.GetBool(settingUsePBO))
+ */
+class CSettingHandle
+{
+public:
+  explicit CSettingHandle(const char *strSetting) : m_strSetting(strSetting), m_slot(NULL) {};
+  const char *GetSetting() const { return m_strSetting; };
+
+private:
+  friend class CGUISettings;
+  const char *m_strSetting;
+  mutable SSettingSlot *m_slot;
+};
+
 class CGUISettings : public Observable
 {
 public:
@@ -469,11 +497,13 @@ public:
   void AddSetting(CSettingsCategory* cat, CSetting* setting);
   void AddBool(CSettingsCategory* cat, const char *strSetting, int iLabel, bool bSetting, int iControlType = CHECKMARK_CONTROL);
   bool GetBool(const char *strSetting) const;
+  bool GetBool(const CSettingHandle &handle) const;
   void SetBool(const char *strSetting, bool bSetting);
   void ToggleBool(const char *strSetting);
 
   void AddFloat(CSettingsCategory* cat, const char *strSetting, int iLabel, float fSetting, float fMin, float fStep, float fMax, int iControlType = SPIN_CONTROL_FLOAT);
   float GetFloat(const char *strSetting) const;
+  float GetFloat(const CSettingHandle &handle) const;
   void SetFloat(const char *strSetting, float fSetting);
 
   void AddInt(CSettingsCategory* cat, const char *strSetting, int iLabel, int fSetting, int iMin, int iStep, int iMax, int iControlType, const char *strFormat = NULL);
@@ -481,6 +511,7 @@ public:
   void AddInt(CSettingsCategory* cat, const char *strSetting, int iLabel, int iData, const std::map<int,int>& entries, int iControlType);
   void AddSpin(unsigned int id, int label, int *current, std::vector<std::pair<int, int> > &values);
   int GetInt(const char *strSetting) const;
+  int GetInt(const CSettingHandle &handle) const;
   void SetInt(const char *strSetting, int fSetting);
 
   void AddHex(CSettingsCategory* cat, const char *strSetting, int iLabel, int fSetting, int iMin, int iStep, int iMax, int iControlType, const char *strFormat = NULL);
@@ -491,6 +522,7 @@ public:
   void AddDefaultAddon(CSettingsCategory* cat, const char *strSetting, int iLabel, const char *strData, const ADDON::TYPE type);
 
   const CStdString &GetString(const char *strSetting, bool bPrompt=true) const;
+  const CStdString &GetString(const CSettingHandle &handle, bool bPrompt=true) const;
   void SetString(const char *strSetting, const char *strData);
 
   void AddSeparator(CSettingsCategory* cat, const char *strSetting);
@@ -513,12 +545,28 @@ public:
 
   void Clear();
 
+  /*!
+   \brief Mark the settings changed, bumping the version.
+   */
+  virtual void SetChanged(bool bSetTo = true);
+
+  /*!
+   \brief Changes whenever the settings change, so values derived from settings can be cached
+   until it moves on.
+   */
+  long GetVersion() const { return m_version; };
+
 private:
   typedef std::map<std::string, CSetting*>::iterator mapIter;
   typedef std::map<std::string, CSetting*>::const_iterator constMapIter;
   std::map<std::string, CSetting*> settingsMap;
   std::vector<CSettingsGroup *> settingsGroups;
   void LoadFromXML(TiXmlElement *pRootElement, mapIter &it, bool advanced = false);
+  CSetting *Resolve(const CSettingHandle &handle) const;
+
+  mutable std::map<std::string, SSettingSlot*> m_slots;
+  mutable CCriticalSection m_slotSection;
+  volatile long m_version;
 };
 
 XBMC_GLOBAL_REF(CGUISettings, g_guiSettings);
@@ -32,6 +32,7 @@
 #include "utils/RegExp.h"
 #include "GUIPassword.h"
 #include "GUIInfoManager.h"
+#include "interfaces/info/InfoBool.h"
 #include "filesystem/MultiPathDirectory.h"
 #include "filesystem/SpecialProtocol.h"
 #include "guilib/GUIWindowManager.h"
@@ -1375,6 +1376,7 @@ void CSettings::LoadSkinSettings(const TiXmlElement* pRootElement)
       pChild = pChild->NextSiblingElement("setting");
     }
   }
+  g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
 }
 
 void CSettings::SaveSkinSettings(TiXmlNode *pRootElement) const
@@ -1475,6 +1477,7 @@ void CSettings::SetSkinString(int setting, const CStdString &label)
   if (it != m_skinStrings.end())
   {
     (*it).second.value = label;
+    g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
     return;
   }
   assert(false);
@@ -1491,6 +1494,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = "";
+      g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
       return;
     }
   }
@@ -1500,6 +1504,7 @@ void CSettings::ResetSkinSetting(const CStdString &setting)
     if (settingName.Equals((*it).second.name))
     {
       (*it).second.value = false;
+      g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
       return;
     }
   }
@@ -1540,6 +1545,7 @@ void CSettings::SetSkinBool(int setting, bool set)
   if (it != m_skinBools.end())
   {
     (*it).second.value = set;
+    g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
     return;
   }
   assert(false);
@@ -1568,6 +1574,7 @@ void CSettings::ResetSkinSettings()
 
     it2++;
   }
+  g_infoManager.InvalidateSource(INFO_SOURCE_SKIN);
   g_infoManager.ResetCache();
 }
 
@@ -27,6 +27,7 @@
 #include "network/Network.h"
 #include "utils/URIUtils.h"
 #include "utils/Weather.h"
+#include "video/ThumbExtractionService.h"
 #include "GUIPassword.h"
 #include "windows/GUIWindowLoginScreen.h"
 #include "guilib/GUIWindowManager.h"
@@ -80,6 +81,8 @@ void CGUIWindowSettingsProfile::OnPopupMenu(int iItem)
     g_application.StopPlaying();
     CGUIMessage msg2(GUI_MSG_ITEM_SELECTED, g_windowManager.GetActiveWindow(), iCtrlID);
     g_windowManager.SendMessage(msg2);
+    // thumbs waiting to be extracted are kept with the profile
+    CThumbExtractionService::Get().Stop();
     g_application.getNetwork().NetworkMessage(CNetwork::SERVICES_DOWN,1);
     g_settings.LoadMasterForLogin();
     CGUIWindowLoginScreen::LoadProfile(iItem);
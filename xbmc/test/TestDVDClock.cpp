@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDClock.h"
+#include "test/TestUtils.h"
+#include "threads/SharedSection.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+#include "video/VideoReferenceClock.h"
+
+#include "gtest/gtest.h"
+
+#define CLOCK_A DVD_MSEC_TO_TIME(1000)
+#define CLOCK_B DVD_MSEC_TO_TIME(5000)
+
+// reads the clock until stopped, counting the reads that didn't return either value it's set to
+class CClockReader : public CThread
+{
+public:
+  CClockReader(CDVDClock& clock, bool check) :
+    CThread("ClockReader"), m_clock(clock), m_check(check), m_reads(0), m_torn(0)
+  {
+  }
+
+  virtual void Process()
+  {
+    while(!m_bStop)
+    {
+      double clock = m_clock.GetClock();
+      if(m_check && clock != CLOCK_A && clock != CLOCK_B)
+        m_torn++;
+      m_reads++;
+    }
+  }
+
+  CDVDClock& m_clock;
+  bool       m_check;
+  int64_t    m_reads;
+  int64_t    m_torn;
+};
+
+// reads the clock the way it was read before, under a shared lock
+class CLockedClockReader : public CThread
+{
+public:
+  CLockedClockReader(CSharedSection& section) :
+    CThread("LockedClockReader"), m_section(section), m_reads(0)
+  {
+  }
+
+  virtual void Process()
+  {
+    while(!m_bStop)
+    {
+      CSharedLock lock(m_section);
+      volatile double clock = DVD_TIME_BASE * (double)g_VideoReferenceClock.GetTime() / CDVDClock::GetFrequency();
+      (void)clock;
+      m_reads++;
+    }
+  }
+
+  CSharedSection& m_section;
+  int64_t         m_reads;
+};
+
+TEST(TestDVDClock, Reset)
+{
+  CDVDClock clock;
+  clock.Pause();
+  clock.Discontinuity(CLOCK_B);
+  EXPECT_EQ(CLOCK_B, clock.GetClock());
+
+  // the first read after a reset starts the clock from 0, unpaused
+  clock.Reset();
+  double start = clock.GetClock();
+  EXPECT_GE(start, 0.0);
+  EXPECT_LT(start, DVD_MSEC_TO_TIME(100));
+  XbmcThreads::ThreadSleep(20);
+  EXPECT_GT(clock.GetClock(), start);
+}
+
+TEST(TestDVDClock, ConcurrentReads)
+{
+  // paused, the clock reads exactly what the last discontinuity set it to
+  CDVDClock clock;
+  clock.Pause();
+  clock.Discontinuity(CLOCK_A);
+
+  CClockReader* readers[4];
+  for(int i = 0; i < 4; i++)
+  {
+    readers[i] = new CClockReader(clock, true);
+    readers[i]->Create();
+  }
+
+  for(int i = 0; i < 200000; i++)
+    clock.Discontinuity(i % 2 ? CLOCK_A : CLOCK_B);
+
+  int64_t reads = 0;
+  for(int i = 0; i < 4; i++)
+  {
+    readers[i]->StopThread(true);
+    EXPECT_EQ(0, readers[i]->m_torn);
+    reads += readers[i]->m_reads;
+    delete readers[i];
+  }
+  EXPECT_GT(reads, 0);
+}
+
+TEST(TestDVDClock, ReadLatency)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  const unsigned int duration = 250;
+  CDVDClock clock;
+  clock.Discontinuity();
+
+  // readers while a writer changes the speed every millisecond, as the player does when syncing
+  for(int threads = 1; threads <= 4; threads *= 2)
+  {
+    CClockReader* readers[4];
+    for(int i = 0; i < threads; i++)
+    {
+      readers[i] = new CClockReader(clock, false);
+      readers[i]->Create();
+    }
+
+    int64_t start = CurrentHostCounter();
+    XbmcThreads::EndTime end(duration);
+    for(int speed = 0; !end.IsTimePast(); speed++)
+    {
+      clock.SetSpeed(speed % 2 ? DVD_PLAYSPEED_NORMAL : DVD_PLAYSPEED_NORMAL + 1);
+      XbmcThreads::ThreadSleep(1);
+    }
+    double elapsed = CXBMCTestUtils::ElapsedMs(start);
+
+    int64_t reads = 0;
+    for(int i = 0; i < threads; i++)
+    {
+      readers[i]->StopThread(true);
+      reads += readers[i]->m_reads;
+      delete readers[i];
+    }
+
+    CSharedSection section;
+    CLockedClockReader* locked[4];
+    for(int i = 0; i < threads; i++)
+    {
+      locked[i] = new CLockedClockReader(section);
+      locked[i]->Create();
+    }
+
+    start = CurrentHostCounter();
+    end.Set(duration);
+    while(!end.IsTimePast())
+    {
+      CExclusiveLock lock(section);
+      lock.Leave();
+      XbmcThreads::ThreadSleep(1);
+    }
+    double lockedElapsed = CXBMCTestUtils::ElapsedMs(start);
+
+    int64_t lockedReads = 0;
+    for(int i = 0; i < threads; i++)
+    {
+      locked[i]->StopThread(true);
+      lockedReads += locked[i]->m_reads;
+      delete locked[i];
+    }
+
+    EXPECT_GT(reads, 0);
+    std::cout << threads << " reader thread(s): "
+              << elapsed * 1e6 * threads / reads << " ns per read, "
+              << lockedElapsed * 1e6 * threads / lockedReads << " ns per read under a shared lock" << std::endl;
+  }
+}
@@ -0,0 +1,220 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitleLineCollection.h"
+#include "cores/dvdplayer/DVDSubtitles/DVDFactorySubtitle.h"
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitleParser.h"
+#include "cores/dvdplayer/DVDClock.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+static bool StartsBefore(const CDVDOverlay* pOverlay1, const CDVDOverlay* pOverlay2)
+{
+  return pOverlay1->iPTSStartTime < pOverlay2->iPTSStartTime;
+}
+
+// karaoke style cues: each line is followed by short overlapping syllable cues
+static bool WriteSubtitles(const std::string &path, int cues)
+{
+  std::string srt;
+  srand(7);
+  for (int i = 0; i < cues; i++)
+  {
+    int start = (i / 10) * 4000 + (i % 10) * 300 + rand() % 100;
+    int stop  = start + (i % 10 == 0 ? 4000 : 300 + rand() % 800);
+    srt += StringUtils::Format("%d\n%02d:%02d:%02d,%03d --> %02d:%02d:%02d,%03d\nLine %d {\\k30}syl{\\k30}la{\\k30}ble\n\n", i + 1,
+                               start / 3600000, start / 60000 % 60, start / 1000 % 60, start % 1000,
+                               stop / 3600000, stop / 60000 % 60, stop / 1000 % 60, stop % 1000, i);
+  }
+
+  XFILE::CFile file;
+  if (!file.OpenForWrite(path, true))
+    return false;
+  bool ok = file.Write(srt.c_str(), srt.size()) == (int)srt.size();
+  file.Close();
+  return ok;
+}
+
+TEST(TestDVDSubtitleLineCollection, Timeline)
+{
+  srand(3);
+  for (int round = 0; round < 50; round++)
+  {
+    // lines arrive out of order and are merged in batches, as a background parser adds them
+    CDVDSubtitleLineCollection collection;
+    std::vector<CDVDOverlay*> lines;
+    int count = rand() % 500;
+    for (int i = 0; i < count; i++)
+    {
+      CDVDOverlay* pOverlay = new CDVDOverlay(DVDOVERLAY_TYPE_TEXT);
+      pOverlay->Acquire();
+      pOverlay->iPTSStartTime = rand() % 1000;
+      pOverlay->iPTSStopTime  = pOverlay->iPTSStartTime + rand() % 100;
+      lines.push_back(pOverlay);
+      collection.Add(pOverlay);
+      if (rand() % 50 == 0)
+        collection.Sort();
+    }
+    collection.Sort();
+    EXPECT_EQ(count, collection.GetSize());
+    std::stable_sort(lines.begin(), lines.end(), StartsBefore);
+
+    for (int query = 0; query < 50; query++)
+    {
+      double pts = rand() % 1100;
+
+      std::vector<CDVDOverlay*> active, expected;
+      collection.GetActive(pts, active);
+      for (unsigned int i = 0; i < lines.size(); i++)
+      {
+        if (lines[i]->iPTSStartTime <= pts && lines[i]->iPTSStopTime >= pts)
+          expected.push_back(lines[i]);
+      }
+      ASSERT_TRUE(active == expected) << "round " << round << " pts " << pts;
+
+      // after a seek, Get() returns what walking the lines from the start did
+      collection.Reset();
+      unsigned int current = 0;
+      for (int step = 0; step < 5; step++)
+      {
+        double stepPts = pts + step * 10;
+        while (current < lines.size() && lines[current]->iPTSStopTime < stepPts)
+          current++;
+        CDVDOverlay* pExpected = current < lines.size() ? lines[current++] : NULL;
+        ASSERT_EQ(pExpected, collection.Get(stepPts)) << "round " << round << " pts " << stepPts;
+      }
+    }
+  }
+}
+
+TEST(TestDVDSubtitleLineCollection, ParseInBackground)
+{
+  const int cues = 500;
+  std::string path = "special://temp/testsubtitles.srt";
+  ASSERT_TRUE(WriteSubtitles(path, cues));
+
+  CDVDSubtitleParser* pParser = CDVDFactorySubtitle::CreateParser(path);
+  ASSERT_TRUE(pParser != NULL);
+  CDVDStreamInfo hints;
+  ASSERT_TRUE(pParser->OpenInBackground(hints));
+  while (((CDVDSubtitleParserCollection*)pParser)->IsParsing())
+    XbmcThreads::ThreadSleep(1);
+
+  // the lines near the end of the file are there once parsing finished, and again after a seek back
+  const double pts = (cues / 10 - 1) * 4.0 * DVD_TIME_BASE;
+  for (int seek = 0; seek < 2; seek++)
+  {
+    pParser->Reset();
+    CDVDOverlay* pOverlay = pParser->Parse(pts);
+    ASSERT_TRUE(pOverlay != NULL);
+    EXPECT_LE(pOverlay->iPTSStartTime, pts + 4.0 * DVD_TIME_BASE);
+    pOverlay->Release();
+  }
+
+  pParser->Dispose();
+  delete pParser;
+  XFILE::CFile::Delete(path);
+}
+
+TEST(TestDVDSubtitleLineCollection, StopWhileParsing)
+{
+  const int cues = 100000;
+  std::string path = "special://temp/testsubtitles.srt";
+  ASSERT_TRUE(WriteSubtitles(path, cues));
+  CDVDStreamInfo hints;
+
+  CDVDSubtitleParser* pParser = CDVDFactorySubtitle::CreateParser(path);
+  ASSERT_TRUE(pParser != NULL);
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(pParser->OpenInBackground(hints));
+  while (((CDVDSubtitleParserCollection*)pParser)->IsParsing())
+    XbmcThreads::ThreadSleep(1);
+  double parsed = CXBMCTestUtils::ElapsedMs(start);
+  pParser->Dispose();
+  delete pParser;
+
+  // closing the file while it's parsed stops between lines rather than waiting for the rest
+  pParser = CDVDFactorySubtitle::CreateParser(path);
+  ASSERT_TRUE(pParser != NULL);
+  start = CurrentHostCounter();
+  ASSERT_TRUE(pParser->OpenInBackground(hints));
+  pParser->Dispose();
+  double stopped = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_FALSE(((CDVDSubtitleParserCollection*)pParser)->IsParsing());
+  EXPECT_LT(stopped, parsed / 2);
+  delete pParser;
+
+  XFILE::CFile::Delete(path);
+}
+
+TEST(TestDVDSubtitleLineCollection, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  const int cues = 50000;
+  std::string path = "special://temp/testsubtitles.srt";
+  ASSERT_TRUE(WriteSubtitles(path, cues));
+
+  CDVDSubtitleParser* pParser = CDVDFactorySubtitle::CreateParser(path);
+  ASSERT_TRUE(pParser != NULL);
+  CDVDStreamInfo hints;
+  int64_t start = CurrentHostCounter();
+  ASSERT_TRUE(pParser->OpenInBackground(hints));
+  double firstLines = CXBMCTestUtils::ElapsedMs(start);
+  while (((CDVDSubtitleParserCollection*)pParser)->IsParsing())
+    XbmcThreads::ThreadSleep(1);
+  double parsed = CXBMCTestUtils::ElapsedMs(start);
+
+  // seek around the file the way the player does: reset and read the lines from the new position
+  const int seeks = 2000;
+  const double length = (cues / 10) * 4.0 * DVD_TIME_BASE;
+  unsigned int overlays = 0;
+  start = CurrentHostCounter();
+  for (int i = 0; i < seeks; i++)
+  {
+    double pts = length * (seeks - i) / seeks; // backwards through the file
+    pParser->Reset();
+    for (int read = 0; read < 5; read++)
+    {
+      CDVDOverlay* pOverlay = pParser->Parse(pts);
+      if (!pOverlay)
+        break;
+      overlays++;
+      pOverlay->Release();
+    }
+  }
+  double seeked = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_GT(overlays, 0u);
+
+  pParser->Dispose();
+  delete pParser;
+  XFILE::CFile::Delete(path);
+
+  std::cout << cues << " cues: first lines after " << firstLines << " ms, parsed in " << parsed << " ms, "
+            << seeks << " backward seeks in " << seeked << " ms" << std::endl;
+}
@@ -0,0 +1,246 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "epg/EpgInfoTag.h"
+#include "epg/EpgGridIndex.h"
+#include "epg/GUIEPGGridContainer.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace EPG;
+
+#define GUIDE_CHANNELS 600
+#define GUIDE_DAYS     2
+
+typedef std::vector<std::pair<unsigned long, unsigned long> > GuideRanges;
+
+// a guide of back to back programmes of irregular length, some shorter than a block and some with gaps between them
+static void CreateGuide(const CDateTime &gridStart, std::vector<CGUIListItemPtr> &items, GuideRanges &ranges)
+{
+  static const int lengths[] = { 2, 3, 7, 10, 15, 25, 30, 45, 60, 90, 120, 185 };
+  unsigned int seed = 1;
+  CDateTime gridEnd = gridStart + CDateTimeSpan(GUIDE_DAYS, 0, 0, 0);
+  for (unsigned int channel = 0; channel < GUIDE_CHANNELS; channel++)
+  {
+    unsigned long first = items.size();
+    CDateTime start = gridStart - CDateTimeSpan(0, 0, channel % 50, 0);
+    while (start < gridEnd + CDateTimeSpan(0, 1, 0, 0))
+    {
+      seed = seed * 1103515245 + 12345;
+      CDateTime end = start + CDateTimeSpan(0, 0, lengths[(seed >> 16) % (sizeof(lengths) / sizeof(lengths[0]))], 0);
+      CEpgInfoTag tag;
+      tag.SetStartFromUTC(start);
+      tag.SetEndFromUTC(end);
+      items.push_back(CGUIListItemPtr(new CFileItem(tag)));
+      start = ((seed >> 8) % 13) == 0 ? end + CDateTimeSpan(0, 0, 4, 0) : end;
+    }
+    ranges.push_back(std::make_pair(first, (unsigned long)items.size() - 1));
+  }
+}
+
+// the dense channels x MAXBLOCKS grid the container used to fill
+static CGUIListItemPtr **CreateDenseGrid(const std::vector<CGUIListItemPtr> &items, const GuideRanges &ranges,
+                                         const CDateTime &gridStart, const CDateTime &gridEnd, int blocks)
+{
+  CGUIListItemPtr **grid = new CGUIListItemPtr*[ranges.size()];
+  CDateTimeSpan blockDuration(0, 0, MINSPERBLOCK, 0);
+  for (unsigned int row = 0; row < ranges.size(); row++)
+  {
+    grid[row] = new CGUIListItemPtr[MAXBLOCKS];
+    CDateTime gridCursor = gridStart;
+    unsigned long progIdx = ranges[row].first;
+    for (int block = 0; block < blocks; block++)
+    {
+      while (progIdx <= ranges[row].second)
+      {
+        const CEpgInfoTag *tag = ((CFileItem *)items[progIdx].get())->GetEPGInfoTag();
+        if (gridEnd <= tag->StartAsUTC())
+          break;
+        else if (gridCursor >= tag->EndAsUTC())
+          progIdx++;
+        else
+        {
+          grid[row][block] = items[progIdx];
+          break;
+        }
+      }
+      gridCursor += blockDuration;
+    }
+  }
+  return grid;
+}
+
+static void FreeDenseGrid(CGUIListItemPtr **grid, unsigned int rows)
+{
+  for (unsigned int row = 0; row < rows; row++)
+    delete[] grid[row];
+  delete[] grid;
+}
+
+class TestEpgGridIndex : public testing::Test
+{
+protected:
+  TestEpgGridIndex() :
+    gridStart(2013, 5, 1, 0, 0, 0),
+    gridEnd(gridStart + CDateTimeSpan(GUIDE_DAYS, 0, 0, 0)),
+    blocks(GUIDE_DAYS * 24 * 60 / MINSPERBLOCK)
+  {
+    CreateGuide(gridStart, items, ranges);
+  }
+
+  CDateTime gridStart;
+  CDateTime gridEnd;
+  int blocks;
+  std::vector<CGUIListItemPtr> items;
+  GuideRanges ranges;
+};
+
+TEST_F(TestEpgGridIndex, MatchesDenseGrid)
+{
+  CGUIListItemPtr **dense = CreateDenseGrid(items, ranges, gridStart, gridEnd, blocks);
+  CEpgGridIndex index;
+  index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true);
+  ASSERT_EQ((int)ranges.size(), index.GetNumRows());
+
+  for (int row = 0; row < index.GetNumRows(); row++)
+  {
+    for (int block = 0; block < blocks; block++)
+    {
+      GridItemsPtr *span = index.GetItem(row, block);
+      ASSERT_TRUE(dense[row][block] == span->item) << "channel " << row << " block " << block;
+      if (!span->item)
+        continue;
+
+      int start = block, end = block;
+      while (start > 0 && dense[row][start - 1] == span->item)
+        start--;
+      while (end < blocks && dense[row][end] == span->item)
+        end++;
+      ASSERT_EQ(start, span->start);
+      ASSERT_EQ(end, span->end);
+      EXPECT_FLOAT_EQ((end - start) * 10.0f, span->width);
+      EXPECT_EQ(start, index.GetBlock(row, span->item));
+    }
+    EXPECT_FALSE(index.GetItem(row, blocks)->item);
+  }
+  EXPECT_FALSE(index.GetItem(-1, 0)->item);
+  EXPECT_FALSE(index.GetItem(index.GetNumRows(), 0)->item);
+  FreeDenseGrid(dense, ranges.size());
+}
+
+TEST_F(TestEpgGridIndex, KeepsUnchangedRows)
+{
+  CEpgGridIndex index;
+  EXPECT_EQ(ranges.size(), index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true));
+  for (int row = 0; row < index.GetNumRows(); row++)
+    index.GetRow(row);
+
+  // a refresh where nothing changed
+  EXPECT_EQ(0u, index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true));
+
+  // the guide window copies every programme on each refresh, the rows are kept and show the copies
+  std::vector<CGUIListItemPtr> copies;
+  for (unsigned int i = 0; i < items.size(); i++)
+    copies.push_back(CGUIListItemPtr(new CFileItem(*((CFileItem *)items[i].get())->GetEPGInfoTag())));
+  EXPECT_EQ(0u, index.Update(copies, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true));
+  const std::vector<GridItemsPtr> &row = index.GetRow(7);
+  ASSERT_FALSE(row.empty());
+  std::vector<CGUIListItemPtr>::const_iterator rowStart = copies.begin() + ranges[7].first;
+  std::vector<CGUIListItemPtr>::const_iterator rowEnd = copies.begin() + ranges[7].second + 1;
+  for (unsigned int i = 0; i < row.size(); i++)
+  {
+    EXPECT_TRUE(std::find(rowStart, rowEnd, row[i].item) != rowEnd);
+    EXPECT_TRUE(row[i].item->HasProperty("GenreType"));
+  }
+
+  // a single programme changes
+  std::vector<CGUIListItemPtr> updated(copies);
+  unsigned long changed = ranges[7].first + 3;
+  CEpgInfoTag tag(*((CFileItem *)copies[changed].get())->GetEPGInfoTag());
+  tag.SetEndFromUTC(tag.EndAsUTC() - CDateTimeSpan(0, 0, 1, 0));
+  updated[changed] = CGUIListItemPtr(new CFileItem(tag));
+
+  unsigned int built = index.GetNumRowsBuilt();
+  EXPECT_EQ(1u, index.Update(updated, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true));
+  for (int row = 0; row < index.GetNumRows(); row++)
+    index.GetRow(row);
+  EXPECT_EQ(built + 1, index.GetNumRowsBuilt());
+  EXPECT_TRUE(index.GetBlock(7, updated[changed]) < blocks);
+
+  // resizing the grid rebuilds every row
+  EXPECT_EQ(ranges.size(), index.Update(updated, ranges, gridStart, gridEnd, blocks, 12.0f, 30.0f, true));
+}
+
+TEST_F(TestEpgGridIndex, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  int64_t start = CurrentHostCounter();
+  CGUIListItemPtr **dense = CreateDenseGrid(items, ranges, gridStart, gridEnd, blocks);
+  double denseTime = CXBMCTestUtils::ElapsedMs(start);
+  size_t denseMemory = ranges.size() * (sizeof(CGUIListItemPtr *) + MAXBLOCKS * sizeof(GridItemsPtr));
+  FreeDenseGrid(dense, ranges.size());
+
+  CEpgGridIndex index;
+  start = CurrentHostCounter();
+  index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true);
+  for (int row = 0; row < index.GetNumRows(); row++)
+    index.GetRow(row);
+  double sparseTime = CXBMCTestUtils::ElapsedMs(start);
+  size_t sparseMemory = index.GetMemoryUsage();
+
+  // what the grid materialises to show a page of channels
+  index.Clear();
+  start = CurrentHostCounter();
+  index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true);
+  for (int row = 0; row < 30; row++)
+    index.GetRow(row);
+  double viewportTime = CXBMCTestUtils::ElapsedMs(start);
+  size_t viewportMemory = index.GetMemoryUsage();
+
+  // a refresh where nothing changed
+  for (int row = 0; row < index.GetNumRows(); row++)
+    index.GetRow(row);
+  start = CurrentHostCounter();
+  index.Update(items, ranges, gridStart, gridEnd, blocks, 10.0f, 30.0f, true);
+  double refreshTime = CXBMCTestUtils::ElapsedMs(start);
+
+  unsigned int lookups = 0;
+  start = CurrentHostCounter();
+  for (int row = 0; row < index.GetNumRows(); row++)
+  {
+    for (int block = 0; block < blocks; block++)
+      lookups += index.GetItem(row, block)->item ? 1 : 0;
+  }
+  double lookupTime = CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << GUIDE_CHANNELS << " channels, " << items.size() << " programmes, " << blocks << " blocks: "
+            << "dense grid " << denseMemory / 1024 << " kB in " << denseTime << " ms, "
+            << "sparse grid " << sparseMemory / 1024 << " kB in " << sparseTime << " ms, "
+            << "one page " << viewportMemory / 1024 << " kB in " << viewportTime << " ms, "
+            << "unchanged refresh in " << refreshTime << " ms, "
+            << lookups << " block lookups in " << lookupTime << " ms" << std::endl;
+}
@@ -0,0 +1,196 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "epg/Epg.h"
+#include "epg/EpgInfoTag.h"
+#include "epg/EpgUpdateQueue.h"
+#include "settings/AdvancedSettings.h"
+#include "test/TestUtils.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace EPG;
+
+// stands in for the pvr clients: serves a synthetic guide for each table after a delay, like a backend on the network
+class CTestPVRClients : public IEpgSource
+{
+public:
+  CTestPVRClients(int iClients, unsigned int iLatencyMs, int iEntries) :
+    m_iClients(iClients), m_iLatencyMs(iLatencyMs), m_iEntries(iEntries), m_iMaxClientActive(0)
+  {
+  }
+
+  virtual int GetEpgClientID(const CEpg &epg) const
+  {
+    return epg.EpgID() % m_iClients;
+  }
+
+  virtual bool FetchEpg(CEpg &epg, time_t start, time_t end)
+  {
+    int iClientId = GetEpgClientID(epg);
+    {
+      CSingleLock lock(m_critSection);
+      if (++m_clientActive[iClientId] > m_iMaxClientActive)
+        m_iMaxClientActive = m_clientActive[iClientId];
+    }
+
+    XbmcThreads::ThreadSleep(m_iLatencyMs);
+
+    CDateTime entryStart((time_t)start);
+    for (int iEntry = 0; iEntry < m_iEntries; iEntry++)
+    {
+      CDateTime entryEnd = entryStart + CDateTimeSpan(0, 0, 15 + (iEntry * 7) % 60, 0);
+      CEpgInfoTag tag;
+      tag.SetUniqueBroadcastID(iEntry + 1);
+      tag.SetStartFromUTC(entryStart);
+      tag.SetEndFromUTC(entryEnd);
+      tag.SetTitle(StringUtils::Format("Programme %d", iEntry));
+      epg.UpdateEntry(tag, true);
+      entryStart = entryEnd;
+    }
+
+    CSingleLock lock(m_critSection);
+    m_clientActive[iClientId]--;
+    return epg.EpgID() % 97 != 0;
+  }
+
+  unsigned int GetMaxClientActive(void) const
+  {
+    CSingleLock lock(m_critSection);
+    return m_iMaxClientActive;
+  }
+
+private:
+  int m_iClients;
+  unsigned int m_iLatencyMs;
+  int m_iEntries;
+  std::map<int, unsigned int> m_clientActive;
+  unsigned int m_iMaxClientActive;
+  mutable CCriticalSection m_critSection;
+};
+
+static void CreateTables(std::vector<CEpg *> &tables, int iTables)
+{
+  for (int iTable = 1; iTable <= iTables; iTable++)
+    tables.push_back(new CEpg(iTable, StringUtils::Format("Channel %d", iTable), "client"));
+}
+
+static void DeleteTables(std::vector<CEpg *> &tables)
+{
+  for (std::vector<CEpg *>::iterator it = tables.begin(); it != tables.end(); it++)
+    delete *it;
+  tables.clear();
+}
+
+// fetches the tables and returns the time it took in milliseconds
+static double FetchTables(CEpgUpdateQueue &queue, const std::vector<CEpg *> &tables)
+{
+  int64_t iStart = CurrentHostCounter();
+  for (std::vector<CEpg *>::const_iterator it = tables.begin(); it != tables.end(); it++)
+    queue.Add(*it);
+  queue.Start();
+  while (!queue.Wait(1000)) {}
+  return CXBMCTestUtils::ElapsedMs(iStart);
+}
+
+TEST(TestEpgUpdateQueue, ClientLimit)
+{
+  std::vector<CEpg *> tables;
+  CreateTables(tables, 200);
+  CTestPVRClients clients(3, 5, 20);
+  CEpgUpdateQueue queue(clients, 1367366400, 1367452800, 8, 2);
+  FetchTables(queue, tables);
+
+  std::vector<CEpg *> updated, failed;
+  queue.GetResults(updated, failed);
+  EXPECT_EQ(198u, updated.size());
+  EXPECT_EQ(2u, failed.size());
+  EXPECT_LE(clients.GetMaxClientActive(), 2u);
+  EXPECT_LE(queue.GetMaxConcurrentFetches(), 6u);
+  for (std::vector<CEpg *>::iterator it = tables.begin(); it != tables.end(); it++)
+    EXPECT_EQ(20u, (*it)->Size());
+
+  CStdString strLastTable;
+  EXPECT_EQ(200u, queue.GetProgress(strLastTable));
+  EXPECT_FALSE(strLastTable.IsEmpty());
+  DeleteTables(tables);
+}
+
+TEST(TestEpgUpdateQueue, OneFetchPerClientByDefault)
+{
+  std::vector<CEpg *> tables;
+  CreateTables(tables, 60);
+  CTestPVRClients clients(3, 5, 20);
+  CEpgUpdateQueue queue(clients, 1367366400, 1367452800, g_advancedSettings.m_iEpgUpdateThreads, g_advancedSettings.m_iEpgClientUpdateThreads);
+  FetchTables(queue, tables);
+
+  // add-ons aren't called for two tables at once unless advancedsettings allow it
+  EXPECT_EQ(1u, clients.GetMaxClientActive());
+  EXPECT_LE(queue.GetMaxConcurrentFetches(), 3u);
+  DeleteTables(tables);
+}
+
+TEST(TestEpgUpdateQueue, Cancel)
+{
+  std::vector<CEpg *> tables;
+  CreateTables(tables, 100);
+  CTestPVRClients clients(2, 20, 1);
+  CEpgUpdateQueue queue(clients, 1367366400, 1367452800, 2, 1);
+  for (std::vector<CEpg *>::iterator it = tables.begin(); it != tables.end(); it++)
+    queue.Add(*it);
+  queue.Start();
+  queue.Cancel();
+  EXPECT_TRUE(queue.Wait(5000));
+
+  CStdString strLastTable;
+  EXPECT_LT(queue.GetProgress(strLastTable), 100u);
+  DeleteTables(tables);
+}
+
+TEST(TestEpgUpdateQueue, Throughput)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  // 500 channels on 4 backends, each answering after 10 ms
+  const int iChannels = 500, iClients = 4;
+  const unsigned int iLatencyMs = 10;
+
+  std::vector<CEpg *> tables;
+  CreateTables(tables, iChannels);
+  CTestPVRClients sequentialClients(iClients, iLatencyMs, 50);
+  CEpgUpdateQueue sequential(sequentialClients, 1367366400, 1367452800, 1, 1);
+  double fSequentialMs = FetchTables(sequential, tables);
+  DeleteTables(tables);
+
+  CreateTables(tables, iChannels);
+  CTestPVRClients parallelClients(iClients, iLatencyMs, 50);
+  CEpgUpdateQueue parallel(parallelClients, 1367366400, 1367452800, 8, 2);
+  double fParallelMs = FetchTables(parallel, tables);
+  DeleteTables(tables);
+
+  EXPECT_LE(parallelClients.GetMaxClientActive(), 2u);
+  std::cout << iChannels << " channels on " << iClients << " clients with " << iLatencyMs << " ms latency: "
+            << fSequentialMs << " ms one table at a time, "
+            << fParallelMs << " ms with " << parallel.GetMaxConcurrentFetches() << " tables at once" << std::endl;
+}
@@ -0,0 +1,369 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "interfaces/info/InfoBool.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+
+typedef std::vector<std::pair<CStdString, int> > ConditionList;
+
+/* Collects the conditions the control factory would register for a window:
+ * visibility and state tags plus conditional attributes */
+static void GetConditions(const TiXmlElement *element, int context, ConditionList &conditions)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    const CStdString tag(element->Value());
+    if (tag == "visible" || tag == "enable" || tag == "selected" || tag == "usealttexture")
+    {
+      if (element->FirstChild())
+        conditions.push_back(std::make_pair(CStdString(element->FirstChild()->Value()), context));
+    }
+    const char *condition = element->Attribute("condition");
+    if (condition)
+      conditions.push_back(std::make_pair(CStdString(condition), context));
+
+    GetConditions(element->FirstChildElement(), context, conditions);
+  }
+}
+
+/* Collects the conditions of every confluence window, each in its own context */
+static bool GetSkinConditions(ConditionList &conditions)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.confluence/720p/"), items, ".xml"))
+    return false;
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (doc.LoadFile(items[i]->GetPath()))
+      GetConditions(doc.RootElement(), i + 1, conditions);
+  }
+  return !conditions.empty();
+}
+
+/* Splits a condition into the single infos it is made of */
+static void GetInfos(const CStdString &condition, std::vector<CStdString> &infos)
+{
+  int parentheses = 0;
+  CStdString info;
+  for (size_t i = 0; i <= condition.size(); i++)
+  {
+    char c = i < condition.size() ? condition[i] : '|';
+    if (c == '(')
+      parentheses++;
+    else if (c == ')')
+      parentheses--;
+    else if (!parentheses && strchr("|+![]", c))
+    {
+      info.Trim();
+      if (!info.IsEmpty())
+        infos.push_back(info);
+      info.clear();
+      continue;
+    }
+    info += c;
+  }
+}
+
+/* Collects the info labels used as $INFO[info] or $INFO[info,prefix,postfix] */
+static void GetLabels(const TiXmlElement *element, std::vector<CStdString> &infos)
+{
+  for (; element; element = element->NextSiblingElement())
+  {
+    for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+    {
+      if (child->Type() != TiXmlNode::TINYXML_TEXT)
+        continue;
+      const CStdString text(child->Value());
+      for (size_t pos = text.find("$INFO["); pos != CStdString::npos; pos = text.find("$INFO[", pos))
+      {
+        pos += 6;
+        size_t end = text.find_first_of(",]", pos);
+        if (end == CStdString::npos)
+          break;
+        infos.push_back(text.substr(pos, end - pos));
+      }
+    }
+    GetLabels(element->FirstChildElement(), infos);
+  }
+}
+
+/* Collects the infos used in the conditions and labels of every confluence window */
+static bool GetSkinInfos(std::vector<CStdString> &infos)
+{
+  CFileItemList items;
+  if (!XFILE::CDirectory::GetDirectory(XBMC_REF_FILE_PATH("addons/skin.confluence/720p/"), items, ".xml"))
+    return false;
+
+  for (int i = 0; i < items.Size(); i++)
+  {
+    CXBMCTinyXML doc;
+    if (!doc.LoadFile(items[i]->GetPath()))
+      continue;
+    ConditionList conditions;
+    GetConditions(doc.RootElement(), 0, conditions);
+    for (ConditionList::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+      GetInfos(it->first, infos);
+    GetLabels(doc.RootElement(), infos);
+  }
+  return !infos.empty();
+}
+
+TEST(TestGUIInfoManager, RegisterSkinConditions)
+{
+  ConditionList conditions;
+  ASSERT_TRUE(GetSkinConditions(conditions));
+
+  g_infoManager.Clear();
+
+  std::vector<unsigned int> ids;
+  for (ConditionList::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+    ids.push_back(g_infoManager.Register(it->first, it->second));
+
+  // reloading the skin finds every condition registered already
+  for (unsigned int i = 0; i < conditions.size(); i++)
+    EXPECT_EQ(ids[i], g_infoManager.Register(conditions[i].first, conditions[i].second));
+
+  // matching is case insensitive and per context
+  CStdString upper(conditions[0].first);
+  upper.ToUpper();
+  EXPECT_EQ(ids[0], g_infoManager.Register(upper, conditions[0].second));
+  EXPECT_NE(ids[0], g_infoManager.Register(conditions[0].first, -1));
+
+  g_infoManager.Clear();
+}
+
+TEST(TestGUIInfoManager, TranslateString)
+{
+  EXPECT_EQ(PLAYER_HAS_VIDEO, g_infoManager.TranslateString("Player.HasVideo"));
+  EXPECT_EQ(PLAYER_HAS_VIDEO, g_infoManager.TranslateString(" player.hasvideo\t"));
+  EXPECT_EQ(LISTITEM_LABEL, g_infoManager.TranslateString("ListItem.Label"));
+  EXPECT_EQ(SYSTEM_PLATFORM_LINUX, g_infoManager.TranslateString("System.Platform.Linux"));
+  EXPECT_EQ(SYSTEM_ALWAYS_TRUE, g_infoManager.TranslateString("true"));
+  EXPECT_LE(MULTI_INFO_START, g_infoManager.TranslateString("Container(50).ListItem(1).Label"));
+  EXPECT_LE(MULTI_INFO_START, g_infoManager.TranslateString("Player.Time(hh:mm)"));
+  EXPECT_EQ(0, g_infoManager.TranslateString("Player.NoSuchInfo"));
+  EXPECT_EQ(0, g_infoManager.TranslateString("Container(50).ListItem(1).Label.Foo"));
+  EXPECT_EQ(0, g_infoManager.TranslateString(" "));
+}
+
+TEST(TestGUIInfoManager, TranslateParameters)
+{
+  // parameters are split the same however they are spaced, quoted or nested
+  int setting = g_infoManager.TranslateString("Skin.HasSetting(infomanagertest)");
+  EXPECT_LE(MULTI_INFO_START, setting);
+  EXPECT_EQ(setting, g_infoManager.TranslateString("skin.hassetting( infomanagertest )"));
+  EXPECT_EQ(setting, g_infoManager.TranslateString("Skin.HasSetting(\"infomanagertest\")"));
+  int compare = g_infoManager.TranslateString("StringCompare(Skin.String(infomanagertest),Foo)");
+  EXPECT_LE(MULTI_INFO_START, compare);
+  EXPECT_EQ(compare, g_infoManager.TranslateString("StringCompare( Skin.String(infomanagertest) , foo )"));
+
+  // several parameter lists run together
+  EXPECT_EQ(g_infoManager.TranslateString("Skin.HasSetting(infomanagertest)"),
+            g_infoManager.TranslateString("Skin.HasSetting(infomanager)(test)"));
+}
+
+TEST(TestGUIInfoManager, TranslateSkinInfos)
+{
+  std::vector<CStdString> infos;
+  ASSERT_TRUE(GetSkinInfos(infos));
+
+  unsigned int translated = 0;
+  for (unsigned int i = 0; i < infos.size(); i++)
+  {
+    if (g_infoManager.TranslateString(infos[i]))
+      translated++;
+  }
+
+  // nearly everything a skin uses should be known
+  EXPECT_GT(translated, infos.size() * 9 / 10);
+}
+
+TEST(TestGUIInfoManager, SourceInvalidation)
+{
+  g_infoManager.Clear();
+  unsigned int constant = g_infoManager.Register("true | System.Platform.Linux");
+  unsigned int skin = g_infoManager.Register("Skin.HasSetting(infomanagertest) + !false");
+  unsigned int polled = g_infoManager.Register("Player.HasVideo");
+  EXPECT_EQ((unsigned int)INFO_SOURCE_CONSTANT, g_infoManager.GetBoolSources(constant));
+  EXPECT_EQ((unsigned int)INFO_SOURCE_SKIN, g_infoManager.GetBoolSources(skin));
+  EXPECT_EQ((unsigned int)INFO_SOURCE_POLLED, g_infoManager.GetBoolSources(polled));
+
+  int setting = g_settings.TranslateSkinBool("infomanagertest");
+  g_settings.SetSkinBool(setting, false);
+
+  unsigned int requests, updates;
+  g_infoManager.UpdateFPS();
+
+  EXPECT_TRUE(g_infoManager.GetBoolValue(constant));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(skin));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(polled));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+
+  // once evaluated only the polled condition is evaluated every frame
+  EXPECT_TRUE(g_infoManager.GetBoolValue(constant));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(skin));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(polled));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  g_infoManager.GetBoolCounters(requests, updates);
+  EXPECT_EQ(3u, requests);
+  EXPECT_EQ(1u, updates);
+
+  // until a skin setting changes, which updates the expression and the operand depending on it
+  g_settings.SetSkinBool(setting, true);
+  EXPECT_TRUE(g_infoManager.GetBoolValue(constant));
+  EXPECT_TRUE(g_infoManager.GetBoolValue(skin));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(polled));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  g_infoManager.GetBoolCounters(requests, updates);
+  EXPECT_EQ(5u, requests);
+  EXPECT_EQ(3u, updates);
+
+  g_settings.SetSkinBool(setting, false);
+  g_infoManager.Clear();
+}
+
+TEST(TestGUIInfoManager, SkinThemeFollowsSettings)
+{
+  g_infoManager.Clear();
+  CStdString theme = g_guiSettings.GetString("lookandfeel.skintheme");
+  unsigned int foo = g_infoManager.Register("Skin.HasTheme(foo)");
+  unsigned int bar = g_infoManager.Register("Skin.HasTheme(bar)");
+
+  g_guiSettings.SetString("lookandfeel.skintheme", "Foo.xbt");
+  g_infoManager.UpdateFPS();
+  EXPECT_TRUE(g_infoManager.GetBoolValue(foo));
+  EXPECT_FALSE(g_infoManager.GetBoolValue(bar));
+  g_infoManager.ResetCache();
+
+  // the theme name is kept between frames, but not past a change of theme
+  g_guiSettings.SetString("lookandfeel.skintheme", "Bar.xbt");
+  g_infoManager.UpdateFPS();
+  EXPECT_FALSE(g_infoManager.GetBoolValue(foo));
+  EXPECT_TRUE(g_infoManager.GetBoolValue(bar));
+  g_infoManager.ResetCache();
+
+  g_guiSettings.SetString("lookandfeel.skintheme", theme);
+  g_infoManager.Clear();
+}
+
+TEST(TestGUIInfoManager, LibraryWithoutDatabase)
+{
+  // the music database can't be opened without its folder
+  if (XFILE::CDirectory::Exists(g_settings.GetDatabaseFolder()))
+  {
+    std::cout << "Skipped, the database folder exists" << std::endl;
+    return;
+  }
+
+  g_infoManager.Clear();
+  g_infoManager.ResetLibraryBools();
+  unsigned int library = g_infoManager.Register("Library.HasContent(Music)");
+  EXPECT_EQ((unsigned int)INFO_SOURCE_LIBRARY, g_infoManager.GetBoolSources(library));
+
+  unsigned int requests, updates;
+  g_infoManager.UpdateFPS();
+
+  // a failed query isn't cached, it's tried again the next frame
+  EXPECT_FALSE(g_infoManager.GetBoolValue(library));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  EXPECT_FALSE(g_infoManager.GetBoolValue(library));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  g_infoManager.GetBoolCounters(requests, updates);
+  EXPECT_EQ(1u, requests);
+  EXPECT_EQ(1u, updates);
+
+  // an answer is
+  g_infoManager.SetLibraryBool(LIBRARY_HAS_MUSIC, true);
+  EXPECT_TRUE(g_infoManager.GetBoolValue(library));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  EXPECT_TRUE(g_infoManager.GetBoolValue(library));
+  g_infoManager.ResetCache();
+  g_infoManager.UpdateFPS();
+  g_infoManager.GetBoolCounters(requests, updates);
+  EXPECT_EQ(1u, requests);
+  EXPECT_EQ(0u, updates);
+
+  g_infoManager.ResetLibraryBools();
+  g_infoManager.Clear();
+}
+
+TEST(TestGUIInfoManager, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  ConditionList conditions;
+  ASSERT_TRUE(GetSkinConditions(conditions));
+  g_infoManager.Clear();
+
+  std::set<unsigned int> unique;
+  int64_t start = CurrentHostCounter();
+  for (ConditionList::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+    unique.insert(g_infoManager.Register(it->first, it->second));
+  double registerTime = CXBMCTestUtils::ElapsedMs(start);
+  unique.erase(0);
+
+  start = CurrentHostCounter();
+  for (ConditionList::const_iterator it = conditions.begin(); it != conditions.end(); ++it)
+    g_infoManager.Register(it->first, it->second);
+  double reloadTime = CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << "Registered " << conditions.size() << " conditions (" << unique.size() << " unique) in "
+            << registerTime << "ms, re-registering took " << reloadTime << "ms" << std::endl;
+
+  g_infoManager.Clear();
+
+  std::vector<CStdString> infos;
+  ASSERT_TRUE(GetSkinInfos(infos));
+
+  // the first pass also fills the multi info and string parameter tables
+  for (unsigned int i = 0; i < infos.size(); i++)
+    g_infoManager.TranslateString(infos[i]);
+
+  const int passes = 10;
+  start = CurrentHostCounter();
+  for (int pass = 0; pass < passes; pass++)
+  {
+    for (unsigned int i = 0; i < infos.size(); i++)
+      g_infoManager.TranslateString(infos[i]);
+  }
+  double elapsed = CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << "Translated " << infos.size() << " infos in " << elapsed / passes << "ms, "
+            << elapsed * 1e6 / passes / infos.size() << "ns per info" << std::endl;
+}
@@ -0,0 +1,84 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "settings/GUISettings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+static CSettingHandle settingErrorInAspect("videoplayer.errorinaspect");
+static CSettingHandle settingUsePBO("videoplayer.usepbo");
+static CSettingHandle settingMaxSpeedAdjust("videoplayer.maxspeedadjust");
+static CSettingHandle settingSubtitleFont("subtitles.font");
+static CSettingHandle settingMissing("videoplayer.nosuchsetting");
+static CSettingHandle settingVSync("videoscreen.vsync");
+static CSettingHandle settingEnableRSS("lookandfeel.enablerssfeeds");
+
+TEST(TestGUISettings, Handles)
+{
+  EXPECT_EQ(g_guiSettings.GetInt("videoplayer.errorinaspect"), g_guiSettings.GetInt(settingErrorInAspect));
+  EXPECT_EQ(g_guiSettings.GetBool("videoplayer.usepbo"), g_guiSettings.GetBool(settingUsePBO));
+  EXPECT_EQ(g_guiSettings.GetFloat("videoplayer.maxspeedadjust"), g_guiSettings.GetFloat(settingMaxSpeedAdjust));
+  EXPECT_EQ(g_guiSettings.GetString("subtitles.font"), g_guiSettings.GetString(settingSubtitleFont));
+  EXPECT_EQ(0, g_guiSettings.GetInt(settingMissing));
+  EXPECT_EQ(g_guiSettings.GetInt("videoscreen.vsync"), g_guiSettings.GetInt(settingVSync));
+  EXPECT_EQ(g_guiSettings.GetBool("lookandfeel.enablerssfeeds"), g_guiSettings.GetBool(settingEnableRSS));
+
+  // changes show through the handles and move the version on
+  int errorInAspect = g_guiSettings.GetInt("videoplayer.errorinaspect");
+  long version = g_guiSettings.GetVersion();
+  g_guiSettings.SetInt("videoplayer.errorinaspect", errorInAspect + 5);
+  EXPECT_EQ(errorInAspect + 5, g_guiSettings.GetInt(settingErrorInAspect));
+  EXPECT_NE(version, g_guiSettings.GetVersion());
+
+  // handles follow the settings when they are created again
+  g_guiSettings.Clear();
+  g_guiSettings.Initialize();
+  EXPECT_EQ(errorInAspect, g_guiSettings.GetInt(settingErrorInAspect));
+
+  CSettingHandle another("videoplayer.errorinaspect");
+  g_guiSettings.SetInt("videoplayer.errorinaspect", errorInAspect + 1);
+  EXPECT_EQ(errorInAspect + 1, g_guiSettings.GetInt(another));
+  g_guiSettings.SetInt("videoplayer.errorinaspect", errorInAspect);
+}
+
+TEST(TestGUISettings, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  // the way the renderer reads the allowed aspect error on every frame
+  const int reads = 1000000;
+  int64_t sum = 0;
+
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < reads; i++)
+    sum += g_guiSettings.GetInt("videoplayer.errorinaspect");
+  double byName = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < reads; i++)
+    sum -= g_guiSettings.GetInt(settingErrorInAspect);
+  double byHandle = CXBMCTestUtils::ElapsedMs(start);
+
+  EXPECT_EQ(0, sum);
+  std::cout << reads << " reads: " << byName * 1e6 / reads << " ns per read by name, "
+            << byHandle * 1e6 / reads << " ns per read by handle" << std::endl;
+}
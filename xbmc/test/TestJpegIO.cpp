@@ -0,0 +1,220 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "guilib/JpegIO.h"
+#include "guilib/JpegService.h"
+#include "guilib/XBTF.h"
+#include "guilib/imagefactory.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <stdio.h>
+
+static unsigned char *CreateSurface(unsigned int width, unsigned int height)
+{
+  unsigned char *pixels = new unsigned char[width * height * 4];
+  for (unsigned int i = 0; i < width * height * 4; i++)
+    pixels[i] = (unsigned char)((i * 2654435761u) >> 24);
+  return pixels;
+}
+
+// the peak resident size of the process in kB, where the platform tells us
+static unsigned int PeakMemory()
+{
+  unsigned int peak = 0;
+#if defined(TARGET_LINUX)
+  FILE *status = fopen("/proc/self/status", "r");
+  if (status)
+  {
+    char line[256];
+    while (fgets(line, sizeof(line), status))
+    {
+      if (sscanf(line, "VmHWM: %u kB", &peak) == 1)
+        break;
+    }
+    fclose(status);
+  }
+#endif
+  return peak;
+}
+
+// decodes a jpeg to a surface and encodes it again, as the texture cache does
+static bool Recode(CJpegIO &jpeg, const std::vector<unsigned char> &file, std::vector<unsigned char> &surface)
+{
+  if (!jpeg.LoadImageFromMemory((unsigned char *)&file[0], file.size(), 0, 0))
+    return false;
+  surface.resize(jpeg.Width() * jpeg.Height() * 4);
+  if (!jpeg.Decode(&surface[0], jpeg.Width() * 4, XB_FMT_A8R8G8B8))
+    return false;
+  unsigned char *thumb = NULL;
+  unsigned int thumbSize = 0;
+  return jpeg.CreateThumbnailFromSurface(&surface[0], jpeg.Width(), jpeg.Height(), XB_FMT_A8R8G8B8, jpeg.Width() * 4, "", thumb, thumbSize);
+}
+
+TEST(TestJpegIO, DecodeFormats)
+{
+  CJpegIO jpeg;
+  // odd sizes leave pixels over at the end of each swizzled row, and each image is bigger than the last
+  const unsigned int sizes[][2] = { { 1, 1 }, { 37, 23 }, { 64, 33 }, { 1023, 769 } };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    unsigned int width = sizes[s][0], height = sizes[s][1];
+    unsigned char *surface = CreateSurface(width, height);
+    unsigned char *thumb = NULL;
+    unsigned int thumbSize = 0;
+    ASSERT_TRUE(jpeg.CreateThumbnailFromSurface(surface, width, height, XB_FMT_A8R8G8B8, width * 4, "", thumb, thumbSize));
+    std::vector<unsigned char> file(thumb, thumb + thumbSize);
+
+    // a broken image mustn't spoil the decoder for the next one
+    std::vector<unsigned char> broken(file.begin(), file.begin() + file.size() / 2);
+    broken[0] = 0;
+    unsigned char *rgb = new unsigned char[width * height * 3];
+    EXPECT_FALSE(jpeg.LoadImageFromMemory(&broken[0], broken.size(), width, height) &&
+                 jpeg.Decode(rgb, width * 3, XB_FMT_RGB8));
+
+    ASSERT_TRUE(jpeg.LoadImageFromMemory(&file[0], file.size(), width, height));
+    ASSERT_EQ(width, jpeg.Width());
+    ASSERT_EQ(height, jpeg.Height());
+    ASSERT_TRUE(jpeg.Decode(rgb, width * 3, XB_FMT_RGB8));
+    ASSERT_TRUE(jpeg.LoadImageFromMemory(&file[0], file.size(), width, height));
+    ASSERT_TRUE(jpeg.Decode(surface, width * 4, XB_FMT_A8R8G8B8));
+
+    unsigned int mismatches = 0;
+    for (unsigned int i = 0; i < width * height; i++)
+    {
+      if (surface[i * 4] != rgb[i * 3 + 2] || surface[i * 4 + 1] != rgb[i * 3 + 1] ||
+          surface[i * 4 + 2] != rgb[i * 3] || surface[i * 4 + 3] != 0xff)
+        mismatches++;
+    }
+    EXPECT_EQ(0u, mismatches) << width << "x" << height;
+    delete[] rgb;
+    delete[] surface;
+  }
+}
+
+TEST(TestJpegIO, PooledLoader)
+{
+  unsigned char *surface = CreateSurface(16, 16);
+  unsigned char *thumb = NULL;
+  unsigned int thumbSize = 0;
+  CJpegIO encoder;
+  ASSERT_TRUE(encoder.CreateThumbnailFromSurface(surface, 16, 16, XB_FMT_A8R8G8B8, 16 * 4, "", thumb, thumbSize));
+  std::vector<unsigned char> plain(thumb, thumb + thumbSize);
+  delete[] surface;
+
+  // the same image with an exif block after the SOI marker saying it is rotated (orientation 6)
+  const unsigned char exif[] = { 0xff, 0xe1, 0x00, 0x22, 'E', 'x', 'i', 'f', 0, 0,
+                                 'I', 'I', 0x2a, 0x00, 0x08, 0x00, 0x00, 0x00,
+                                 0x01, 0x00, 0x12, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x00, 0x00, 0x00,
+                                 0x00, 0x00, 0x00, 0x00 };
+  std::vector<unsigned char> rotated(plain.begin(), plain.begin() + 2);
+  rotated.insert(rotated.end(), exif, exif + sizeof(exif));
+  rotated.insert(rotated.end(), plain.begin() + 2, plain.end());
+
+  IImage *image = ImageFactory::CreateLoaderFromMimeType("image/jpeg");
+  ASSERT_TRUE(image != NULL);
+  ASSERT_TRUE(image->LoadImageFromMemory(&rotated[0], rotated.size(), 16, 16));
+  EXPECT_EQ(6u, image->Orientation());
+  ImageFactory::Release(image);
+
+  // the loader comes back from the pool, and doesn't keep the last image's orientation
+  IImage *reused = ImageFactory::CreateLoaderFromMimeType("image/jpeg");
+  EXPECT_EQ(image, reused);
+  ASSERT_TRUE(reused->LoadImageFromMemory(&plain[0], plain.size(), 16, 16));
+  EXPECT_EQ(0u, reused->Orientation());
+  ImageFactory::Release(reused);
+}
+
+TEST(TestJpegIO, Throughput)
+{
+  const CStdString &folder = CXBMCTestUtils::Instance().getTestJpegIOFolder();
+  if (folder.IsEmpty())
+  {
+    std::cout << "No sample folder given, set one with --set-testjpegio-folder" << std::endl;
+    return;
+  }
+  CFileItemList items;
+  ASSERT_TRUE(XFILE::CDirectory::GetDirectory(folder, items, ".jpg|.jpeg|.tbn"));
+
+  // read the files up front, so the timings are of libjpeg and not of the disk
+  std::vector<std::vector<unsigned char> > files;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    XFILE::CFile file;
+    if (items[i]->m_bIsFolder || !file.Open(items[i]->GetPath()))
+      continue;
+    files.push_back(std::vector<unsigned char>((size_t)file.GetLength()));
+    if (files.back().empty() || file.Read(&files.back()[0], files.back().size()) != files.back().size())
+      files.pop_back();
+  }
+  ASSERT_FALSE(files.empty());
+
+  // a fresh CJpegIO for each image, as the texture cache used to
+  std::vector<unsigned char> surface;
+  unsigned int recoded = 0;
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    CJpegIO jpeg;
+    if (Recode(jpeg, files[i], surface))
+      recoded++;
+  }
+  double fresh = files.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+  unsigned int freshPeak = PeakMemory();
+
+  unsigned int reused = 0;
+  CJpegIO jpeg;
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    if (Recode(jpeg, files[i], surface))
+      reused++;
+  }
+  double shared = files.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+  unsigned int sharedPeak = PeakMemory();
+  EXPECT_EQ(recoded, reused);
+
+  // and as a batch of thumbnails over all the cores
+  std::vector<std::pair<CStdString, CStdString> > thumbs;
+  for (int i = 0; i < items.Size(); i++)
+  {
+    if (!items[i]->m_bIsFolder)
+      thumbs.push_back(std::make_pair(items[i]->GetPath(), StringUtils::Format("special://temp/testjpegio%i.jpg", i)));
+  }
+  start = CurrentHostCounter();
+  unsigned int created = CJpegService::Get().CreateThumbnails(thumbs, 320, 180);
+  double batch = thumbs.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+  unsigned int batchPeak = PeakMemory();
+  EXPECT_EQ(thumbs.size(), created);
+  EXPECT_LE(CJpegService::Get().GetNumCreated(), CJpegService::GetJobsAtOnce());
+  for (unsigned int i = 0; i < thumbs.size(); i++)
+    XFILE::CFile::Delete(thumbs[i].second);
+
+  std::cout << "Recoded " << files.size() << " jpegs at " << fresh << " images/s one context each (peak " << freshPeak << " kB), "
+            << shared << " images/s with a shared context (peak " << sharedPeak << " kB); "
+            << "thumbnailed at " << batch << " images/s with " << CJpegService::GetJobsAtOnce() << " jobs (peak " << batchPeak << " kB)" << std::endl;
+}
@@ -0,0 +1,202 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/VideoRenderers/OverlayRendererUtil.h"
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "cores/dvdplayer/DVDClock.h"
+#include "filesystem/File.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <string.h>
+
+using namespace OVERLAY;
+
+// a bitmap of the given size filled with a pattern, placed at x, y
+static void FillImage(ASS_Image& img, std::vector<unsigned char>& bitmap, int w, int h, int pattern, int x, int y)
+{
+  bitmap.resize((w + 3) * h);
+  for(unsigned int i = 0; i < bitmap.size(); i++)
+    bitmap[i] = (unsigned char)(i * pattern + pattern);
+
+  memset(&img, 0, sizeof(img));
+  img.w      = w;
+  img.h      = h;
+  img.stride = w + 3;
+  img.bitmap = &bitmap[0];
+  img.color  = 0xFF800000;
+  img.dst_x  = x;
+  img.dst_y  = y;
+}
+
+// the bitmap of img is where quad points in the atlas
+static bool InAtlas(const CGlyphAtlas& atlas, const SQuad& quad, const ASS_Image& img)
+{
+  for(int y = 0; y < img.h; y++)
+  {
+    if(memcmp(atlas.m_data + atlas.m_size * (quad.v + y) + quad.u, img.bitmap + img.stride * y, img.w) != 0)
+      return false;
+  }
+  return quad.w == img.w && quad.h == img.h && quad.x == img.dst_x && quad.y == img.dst_y;
+}
+
+TEST(TestOverlayGlyphAtlas, Convert)
+{
+  CGlyphAtlas* atlas = new CGlyphAtlas(256);
+  std::vector<unsigned char> bitmaps[3];
+  ASS_Image images[3];
+  FillImage(images[0], bitmaps[0], 40, 30, 3, 10, 20);
+  FillImage(images[1], bitmaps[1], 40, 30, 5, 60, 20);
+  FillImage(images[2], bitmaps[2], 100, 50, 7, 10, 100);
+  images[0].next = &images[1];
+  images[1].next = &images[2];
+
+  SQuads quads;
+  EXPECT_TRUE(atlas->Convert(images, 2, quads));
+  EXPECT_EQ(3, quads.count);
+  EXPECT_EQ(40 * 30 * 2 + 100 * 50, atlas->m_copied);
+  for(int i = 0; i < 3; i++)
+    EXPECT_TRUE(InAtlas(*atlas, quads.quad[i], images[i]));
+
+  // positions changed only: nothing is copied, the quads move
+  for(int i = 0; i < 3; i++)
+    images[i].dst_x += 5;
+  EXPECT_TRUE(atlas->Convert(images, 1, quads));
+  EXPECT_EQ(0, atlas->m_copied);
+  for(int i = 0; i < 3; i++)
+    EXPECT_TRUE(InAtlas(*atlas, quads.quad[i], images[i]));
+
+  // bitmaps shown before are found by their pixels, new ones are packed
+  std::vector<unsigned char> bitmap;
+  ASS_Image image;
+  FillImage(image, bitmap, 40, 30, 11, 0, 0);
+  images[0].next = &image;
+  image.next     = &images[2];
+  images[2].next = NULL;
+  images[2].color |= 0xff; // fully transparent, not shown
+  EXPECT_TRUE(atlas->Convert(images, 2, quads));
+  EXPECT_EQ(2, quads.count);
+  EXPECT_EQ(40 * 30, atlas->m_copied);
+  EXPECT_TRUE(InAtlas(*atlas, quads.quad[0], images[0]));
+  EXPECT_TRUE(InAtlas(*atlas, quads.quad[1], image));
+
+  // once the atlas is full the bitmaps that fit are still converted
+  std::vector<unsigned char> large;
+  ASS_Image full;
+  FillImage(full, large, 200, 220, 13, 0, 0);
+  images[0].next = &full;
+  full.next      = NULL;
+  EXPECT_FALSE(atlas->Convert(images, 2, quads));
+  EXPECT_EQ(1, quads.count);
+  EXPECT_TRUE(InAtlas(*atlas, quads.quad[0], images[0]));
+
+  atlas->Release();
+}
+
+struct STypesetStats
+{
+  int     converted; ///< frames whose subtitles changed
+  int     moved;     ///< of those, frames where the subtitles only moved
+  int     atlases;   ///< atlases filled up
+  int64_t packed;    ///< bytes that used to be packed into a new texture each frame
+  int64_t copied;    ///< bytes copied into the atlas
+};
+
+// renders 20 seconds at 25 fps on a 720p video of the sample script, converting the frames the
+// way the overlay renderer does
+static bool TypesetFile(STypesetStats& stats)
+{
+  CStdString path = XBMC_REF_FILE_PATH("xbmc/test/typeset.ass");
+  XFILE::CFile file;
+  if(!file.Open(path))
+    return false;
+  std::vector<char> script((size_t)file.GetLength() + 1, 0);
+  if(file.Read(&script[0], script.size() - 1) != script.size() - 1)
+    return false;
+  file.Close();
+
+  CDVDSubtitlesLibass* libass = new CDVDSubtitlesLibass();
+  if(!libass->CreateTrack(&script[0]))
+  {
+    libass->Release();
+    return false;
+  }
+
+  const int width = 1280, height = 720, frames = 500;
+  CGlyphAtlas* atlas = new CGlyphAtlas(1024);
+  memset(&stats, 0, sizeof(stats));
+  stats.atlases = 1;
+  bool success = true;
+
+  for(int frame = 0; frame < frames; frame++)
+  {
+    int changes = 0;
+    ASS_Image* images = libass->RenderImage(width, height, frame * DVD_TIME_BASE / 25, &changes);
+    if(changes == 0)
+      continue;
+
+    stats.converted++;
+    if(changes == 1)
+      stats.moved++;
+
+    // every visible bitmap used to be packed into a new texture
+    for(ASS_Image* img = images; img; img = img->next)
+    {
+      if((img->color & 0xff) != 0xff)
+        stats.packed += img->w * img->h;
+    }
+
+    SQuads quads;
+    if(!atlas->Convert(images, changes, quads))
+    {
+      atlas->Release();
+      atlas = new CGlyphAtlas(1024);
+      stats.atlases++;
+      if(!atlas->Convert(images, 2, quads))
+        success = false;
+    }
+    stats.copied += atlas->m_copied;
+  }
+
+  atlas->Release();
+  libass->Release();
+  return success;
+}
+
+TEST(TestOverlayGlyphAtlas, TypesetFile)
+{
+  STypesetStats stats;
+  ASSERT_TRUE(TypesetFile(stats));
+  ASSERT_GT(stats.converted, 0);
+  EXPECT_LT(stats.copied, stats.packed);
+}
+
+TEST(TestOverlayGlyphAtlas, TypesetFileBenchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  STypesetStats stats;
+  ASSERT_TRUE(TypesetFile(stats));
+  ASSERT_GT(stats.converted, 0);
+  std::cout << stats.converted << " changed frames (" << stats.moved << " moved only): "
+            << stats.packed / stats.converted << " bytes packed per frame, "
+            << stats.copied / stats.converted << " bytes copied per frame into " << stats.atlases << " atlas(es)" << std::endl;
+}
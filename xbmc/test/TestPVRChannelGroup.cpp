@@ -0,0 +1,248 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pvr/channels/PVRChannelGroup.h"
+#include "pvr/PVRDatabase.h"
+#include "filesystem/Directory.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+using namespace PVR;
+
+#define CLIENTS 3
+#define EPG_ID_OFFSET 100000
+
+class CTestChannelGroup : public CPVRChannelGroup
+{
+public:
+  CTestChannelGroup(int iChannels) : CPVRChannelGroup(false, 100, "test")
+  {
+    SetSelectedGroup(false);
+    for (int i = 0; i < iChannels; i++)
+    {
+      CPVRChannelPtr channel(new CPVRChannel());
+      channel->SetUniqueID(i);
+      channel->SetClientID(i % CLIENTS + 1);
+      channel->SetChannelID(i + 1);
+      channel->SetEpgID(i + EPG_ID_OFFSET);
+      channel->SetClientChannelNumber(i + 1);
+      m_channels.push_back(channel);
+
+      PVRChannelGroupMember member = { channel, (unsigned int)i + 1 };
+      AddMember(member);
+    }
+  }
+
+  void AddChannel(CPVRChannelPtr channel)
+  {
+    m_channels.push_back(channel);
+    PVRChannelGroupMember member = { channel, (unsigned int)m_channels.size() };
+    AddMember(member);
+  }
+
+  using CPVRChannelGroup::GetByChannelID;
+  using CPVRChannelGroup::GetByUniqueID;
+
+  bool IndexesUpToDate(void) const
+  {
+    return m_bIndexesValid && m_iIndexedVersion == CPVRChannel::IdentityVersion();
+  }
+
+  /* the way channels were looked up before the indexes */
+  CPVRChannelPtr ScanByClient(int iUniqueChannelId, int iClientID) const
+  {
+    for (unsigned int ptr = 0; ptr < m_channels.size(); ptr++)
+    {
+      CPVRChannelPtr channel = m_channels.at(ptr);
+      if (channel->UniqueID() == iUniqueChannelId && channel->ClientID() == iClientID)
+        return channel;
+    }
+
+    return CPVRChannelPtr();
+  }
+
+  std::vector<CPVRChannelPtr> m_channels;
+};
+
+TEST(TestPVRChannelGroup, Lookups)
+{
+  const int channels = 200;
+  CTestChannelGroup group(channels);
+  ASSERT_EQ(channels, group.Size());
+
+  for (int i = 0; i < channels; i++)
+  {
+    CPVRChannelPtr channel = group.m_channels.at(i);
+    EXPECT_EQ(channel, group.GetByClient(i, i % CLIENTS + 1));
+    EXPECT_EQ(channel, group.GetByChannelID(i + 1));
+    EXPECT_EQ(channel, group.GetByChannelEpgID(i + EPG_ID_OFFSET));
+    EXPECT_EQ(channel, group.GetByUniqueID(i));
+    EXPECT_EQ(i, group.GetIndex(*channel));
+    EXPECT_EQ((unsigned int)i + 1, group.GetChannelNumber(*channel));
+    EXPECT_TRUE(group.IsGroupMember(*channel));
+    EXPECT_TRUE(group.IsGroupMember(i + 1));
+
+    CFileItemPtr item = group.GetByChannelNumber(i + 1);
+    ASSERT_TRUE(item->HasPVRChannelInfoTag());
+    EXPECT_EQ(i, item->GetPVRChannelInfoTag()->UniqueID());
+  }
+
+  EXPECT_FALSE(group.GetByClient(0, 2));
+  EXPECT_FALSE(group.GetByChannelID(channels + 1));
+  EXPECT_FALSE(group.GetByChannelEpgID(-1));
+  EXPECT_FALSE(group.GetByChannelNumber(channels + 1)->HasPVRChannelInfoTag());
+}
+
+TEST(TestPVRChannelGroup, Changes)
+{
+  CTestChannelGroup group(20);
+  CPVRChannelPtr channel = group.m_channels.at(5);
+
+  /* ids changed on the channel itself */
+  channel->SetEpgID(7);
+  EXPECT_EQ(channel, group.GetByChannelEpgID(7));
+  EXPECT_FALSE(group.GetByChannelEpgID(5 + EPG_ID_OFFSET));
+
+  channel->SetChannelID(500);
+  EXPECT_EQ(channel, group.GetByChannelID(500));
+  EXPECT_FALSE(group.IsGroupMember(6));
+
+  /* removing moves the members behind it and renumbers them */
+  EXPECT_TRUE(group.RemoveFromGroup(*group.m_channels.at(2)));
+  EXPECT_EQ(19, group.Size());
+  EXPECT_EQ(-1, group.GetIndex(*group.m_channels.at(2)));
+  EXPECT_EQ(4, group.GetIndex(*channel));
+  EXPECT_EQ(5u, group.GetChannelNumber(*channel));
+  EXPECT_EQ(5, group.GetByChannelNumber(5)->GetPVRChannelInfoTag()->UniqueID());
+
+  /* moving */
+  EXPECT_TRUE(group.MoveChannel(5, 10, false));
+  EXPECT_EQ(9, group.GetIndex(*channel));
+  EXPECT_EQ(10u, group.GetChannelNumber(*channel));
+  EXPECT_EQ(channel->UniqueID(), group.GetByChannelNumber(10)->GetPVRChannelInfoTag()->UniqueID());
+  EXPECT_EQ(6, group.GetByChannelNumber(5)->GetPVRChannelInfoTag()->UniqueID());
+
+  /* a new number, sorted back in */
+  EXPECT_TRUE(group.SetChannelNumber(*channel, 0));
+  EXPECT_EQ(0u, group.GetChannelNumber(*channel));
+  group.SortAndRenumber();
+  EXPECT_EQ(0, group.GetIndex(*channel));
+  EXPECT_EQ(1u, group.GetChannelNumber(*channel));
+  EXPECT_EQ(0, group.GetByChannelNumber(2)->GetPVRChannelInfoTag()->UniqueID());
+}
+
+TEST(TestPVRChannelGroup, LookupsKeepIndexes)
+{
+  CTestChannelGroup group(20);
+  CFileItemPtr item = group.GetByChannelNumber(5);
+  ASSERT_TRUE(item->HasPVRChannelInfoTag());
+  EXPECT_TRUE(group.IndexesUpToDate());
+
+  /* the file items copy the channel, which doesn't make the groups index their members again */
+  long iVersion = CPVRChannel::IdentityVersion();
+  item = group.GetByChannelNumber(5);
+  EXPECT_EQ(4, item->GetPVRChannelInfoTag()->UniqueID());
+  CFileItemList members;
+  group.GetMembers(members);
+  EXPECT_EQ(iVersion, CPVRChannel::IdentityVersion());
+  EXPECT_TRUE(group.IndexesUpToDate());
+}
+
+TEST(TestPVRChannelGroup, NewChannelSaved)
+{
+  if (!XFILE::CDirectory::Exists(g_settings.GetDatabaseFolder()))
+    XFILE::CDirectory::Create(g_settings.GetDatabaseFolder());
+  CPVRDatabase database;
+  ASSERT_TRUE(database.Open());
+
+  CTestChannelGroup group(0);
+  CPVRChannelPtr channel(new CPVRChannel());
+  channel->SetUniqueID(1000);
+  channel->SetClientID(1);
+  group.AddChannel(channel);
+  EXPECT_FALSE(group.GetByChannelID(1));
+
+  /* the database gives the channel its id when it's saved the first time */
+  ASSERT_TRUE(database.Persist(*channel));
+  ASSERT_GT(channel->ChannelID(), 0);
+  EXPECT_EQ(channel, group.GetByChannelID(channel->ChannelID()));
+  EXPECT_TRUE(group.IsGroupMember(channel->ChannelID()));
+  EXPECT_EQ(1u, group.GetChannelNumber(*channel));
+
+  database.Close();
+  XFILE::CDirectory::Remove(g_settings.GetDatabaseFolder());
+}
+
+TEST(TestPVRChannelGroup, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  const int channels = 5000, lookups = 100000;
+  CTestChannelGroup group(channels);
+
+  int64_t start = CurrentHostCounter();
+  int found = 0;
+  for (int i = 0; i < lookups; i++)
+  {
+    int iUniqueId = (i * 7919) % channels;
+    if (group.ScanByClient(iUniqueId, iUniqueId % CLIENTS + 1))
+      found++;
+  }
+  double scanned = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(lookups, found);
+
+  start = CurrentHostCounter();
+  found = 0;
+  for (int i = 0; i < lookups; i++)
+  {
+    int iUniqueId = (i * 7919) % channels;
+    if (group.GetByClient(iUniqueId, iUniqueId % CLIENTS + 1))
+      found++;
+  }
+  double indexed = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(lookups, found);
+
+  /* zapping: a channel by number, then its neighbour */
+  start = CurrentHostCounter();
+  for (int i = 0; i < lookups; i++)
+  {
+    CFileItemPtr item = group.GetByChannelNumber((i * 7919) % channels + 1);
+    group.GetByChannelUp(*item);
+  }
+  double zapped = CXBMCTestUtils::ElapsedMs(start);
+
+  /* renumbering a group that's in order after a change */
+  const int renumbers = 100;
+  start = CurrentHostCounter();
+  for (int i = 0; i < renumbers; i++)
+  {
+    group.RemoveFromGroup(*group.m_channels.at(i));
+    group.GetByChannelEpgID(channels - 1 + EPG_ID_OFFSET);
+  }
+  double renumbered = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(channels - renumbers, group.Size());
+
+  std::cout << channels << " channels: " << scanned * 1e6 / lookups << " ns per lookup scanning, "
+            << indexed * 1e6 / lookups << " ns per indexed lookup, "
+            << zapped * 1e3 / lookups << " us per zap, "
+            << renumbered / renumbers << " ms per removal with renumbering and lookup" << std::endl;
+}
@@ -0,0 +1,308 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FileItem.h"
+#include "pvr/addons/PVRClients.h"
+#include "pvr/recordings/PVRRecordings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <map>
+#include <set>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+using namespace PVR;
+
+// a backend with a large set of recordings, sent the way an add-on transfers them
+class CTestRecordingsClient
+{
+public:
+  CTestRecordingsClient(int iClientId, int iRecordings, bool bSupportsChangeToken) :
+    m_iClientId(iClientId),
+    m_iRevision(1),
+    m_bSupportsChangeToken(bSupportsChangeToken),
+    m_bAvailable(true),
+    m_iNextId(0)
+  {
+    for (int i = 0; i < iRecordings; i++)
+      Add();
+  }
+
+  void Add(void)
+  {
+    m_titles[m_iNextId] = 0;
+    m_iNextId++;
+    m_iRevision++;
+  }
+
+  void Rename(int iId)
+  {
+    m_titles[iId]++;
+    m_iRevision++;
+  }
+
+  void Remove(int iId)
+  {
+    m_titles.erase(iId);
+    m_iRevision++;
+  }
+
+  CStdString GetChangeToken(void) const
+  {
+    return m_bSupportsChangeToken ? StringUtils::Format("rev%d", m_iRevision) : "";
+  }
+
+  void Transfer(CPVRRecordings &results) const
+  {
+    PVR_RECORDING recording;
+    for (std::map<int, int>::const_iterator it = m_titles.begin(); it != m_titles.end(); ++it)
+    {
+      // the play count and position are left at 0, so nothing asks the clients whether they keep them
+      memset(&recording, 0, sizeof(recording));
+      snprintf(recording.strRecordingId, sizeof(recording.strRecordingId), "rec%d", it->first);
+      snprintf(recording.strTitle, sizeof(recording.strTitle), "%s", GetTitle(it->first, it->second).c_str());
+      snprintf(recording.strDirectory, sizeof(recording.strDirectory), "client%d/%d", m_iClientId, it->first % 50);
+      snprintf(recording.strPlot, sizeof(recording.strPlot), "The plot of recording %d", it->first);
+      snprintf(recording.strChannelName, sizeof(recording.strChannelName), "Channel %d", it->first % 30);
+      recording.recordingTime = 1350000000 + it->first * 3600;
+      recording.iPriority = 50;
+      recording.iLifetime = 99;
+
+      results.UpdateFromClient(CPVRRecording(recording, m_iClientId));
+    }
+  }
+
+  static CStdString GetTitle(int iId, int iRenamed)
+  {
+    return StringUtils::Format("Recording %d (%d)", iId, iRenamed);
+  }
+
+  int  m_iClientId;
+  int  m_iRevision;
+  bool m_bSupportsChangeToken;
+  bool m_bAvailable;
+
+private:
+  int                m_iNextId;
+  std::map<int, int> m_titles; // the times each recording was renamed, by id
+};
+
+// CPVRClients::GetRecordings() and CPVRRecordings::UpdateFromClients() with the test clients in place of add-ons
+static bool Update(CPVRRecordings &recordings, const std::vector<CTestRecordingsClient *> &clients, std::map<int, CStdString> &changeTokens)
+{
+  // only the ids of the connected clients are looked at
+  PVR_CLIENTMAP connected;
+  for (std::vector<CTestRecordingsClient *>::const_iterator it = clients.begin(); it != clients.end(); ++it)
+  {
+    if ((*it)->m_bAvailable)
+      connected[(*it)->m_iClientId] = PVR_CLIENT();
+  }
+  CPVRClients::RemoveDisconnectedTokens(connected, changeTokens);
+
+  CPVRRecordings fetched;
+  std::set<int> unchangedClients;
+  for (std::vector<CTestRecordingsClient *>::const_iterator it = clients.begin(); it != clients.end(); ++it)
+  {
+    if (!(*it)->m_bAvailable)
+      continue;
+
+    CStdString strToken = (*it)->GetChangeToken();
+    if (CPVRClients::IsUnchanged((*it)->m_iClientId, strToken, changeTokens))
+    {
+      unchangedClients.insert((*it)->m_iClientId);
+      continue;
+    }
+
+    (*it)->Transfer(fetched);
+    CPVRClients::StoreChangeToken((*it)->m_iClientId, strToken, PVR_ERROR_NO_ERROR, changeTokens);
+  }
+
+  return recordings.UpdateEntries(fetched, unchangedClients);
+}
+
+static std::map<CStdString, CStdString> GetTitles(CPVRRecordings &recordings)
+{
+  std::map<CStdString, CStdString> titles;
+  CFileItemList items;
+  recordings.GetRecordings(&items);
+  for (int i = 0; i < items.Size(); i++)
+  {
+    const CPVRRecording *recording = items[i]->GetPVRRecordingInfoTag();
+    titles[StringUtils::Format("%d/%s", recording->m_iClientId, recording->m_strRecordingId.c_str())] = recording->m_strTitle;
+  }
+  return titles;
+}
+
+TEST(TestPVRRecordings, Fingerprint)
+{
+  PVR_RECORDING recording;
+  memset(&recording, 0, sizeof(recording));
+  strcpy(recording.strRecordingId, "1");
+  strcpy(recording.strTitle, "ab");
+  unsigned int iFingerprint = CPVRRecording::GetFingerprint(recording);
+  EXPECT_EQ(iFingerprint, CPVRRecording(recording, 1).m_iFingerprint);
+
+  // what's left after the end of a string doesn't count
+  recording.strTitle[5] = 'x';
+  EXPECT_EQ(iFingerprint, CPVRRecording::GetFingerprint(recording));
+
+  // text moved from one field into the next does
+  strcpy(recording.strTitle, "a");
+  strcpy(recording.strStreamURL, "b");
+  EXPECT_NE(iFingerprint, CPVRRecording::GetFingerprint(recording));
+
+  recording.strStreamURL[0] = 0;
+  strcpy(recording.strTitle, "ab");
+  recording.iLifetime = 1;
+  EXPECT_NE(iFingerprint, CPVRRecording::GetFingerprint(recording));
+}
+
+TEST(TestPVRRecordings, ChangeTokens)
+{
+  std::map<int, CStdString> changeTokens;
+
+  // a client is asked the first time, and whenever its token moves on
+  EXPECT_FALSE(CPVRClients::IsUnchanged(1, "rev1", changeTokens));
+  EXPECT_TRUE(CPVRClients::StoreChangeToken(1, "rev1", PVR_ERROR_NO_ERROR, changeTokens));
+  EXPECT_TRUE(CPVRClients::IsUnchanged(1, "rev1", changeTokens));
+  EXPECT_FALSE(CPVRClients::IsUnchanged(1, "rev2", changeTokens));
+
+  // a client without tokens is always asked
+  EXPECT_TRUE(CPVRClients::StoreChangeToken(2, "", PVR_ERROR_NOT_IMPLEMENTED, changeTokens));
+  EXPECT_FALSE(CPVRClients::IsUnchanged(2, "", changeTokens));
+
+  // a failed fetch is tried again next time, even though the token is the same
+  EXPECT_FALSE(CPVRClients::StoreChangeToken(1, "rev2", PVR_ERROR_SERVER_ERROR, changeTokens));
+  EXPECT_TRUE(changeTokens.find(1) == changeTokens.end());
+  EXPECT_FALSE(CPVRClients::IsUnchanged(1, "rev1", changeTokens));
+
+  // the tokens of clients that disconnected are forgotten
+  EXPECT_TRUE(CPVRClients::StoreChangeToken(1, "rev2", PVR_ERROR_NO_ERROR, changeTokens));
+  PVR_CLIENTMAP connected;
+  connected[2] = PVR_CLIENT();
+  CPVRClients::RemoveDisconnectedTokens(connected, changeTokens);
+  EXPECT_EQ(1u, changeTokens.size());
+  EXPECT_FALSE(CPVRClients::IsUnchanged(1, "rev2", changeTokens));
+}
+
+TEST(TestPVRRecordings, Update)
+{
+  CTestRecordingsClient withToken(1, 500, true);
+  CTestRecordingsClient withoutToken(2, 500, false);
+  std::vector<CTestRecordingsClient *> clients;
+  clients.push_back(&withToken);
+  clients.push_back(&withoutToken);
+
+  CPVRRecordings recordings;
+  std::map<int, CStdString> changeTokens;
+  EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(1000, recordings.GetNumRecordings());
+
+  // nothing changed, either by the token or by the recordings sent
+  EXPECT_FALSE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(1000, recordings.GetNumRecordings());
+
+  // changes on the client without a token
+  withoutToken.Rename(7);
+  withoutToken.Remove(8);
+  withoutToken.Add();
+  EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(1000, recordings.GetNumRecordings());
+  std::map<CStdString, CStdString> titles = GetTitles(recordings);
+  EXPECT_EQ(CTestRecordingsClient::GetTitle(7, 1), titles["2/rec7"]);
+  EXPECT_EQ(CTestRecordingsClient::GetTitle(6, 0), titles["2/rec6"]);
+  EXPECT_TRUE(titles.find("2/rec8") == titles.end());
+  EXPECT_EQ(CTestRecordingsClient::GetTitle(500, 0), titles["2/rec500"]);
+
+  // changes on the client with a token
+  withToken.Rename(3);
+  withToken.Remove(4);
+  EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(999, recordings.GetNumRecordings());
+  titles = GetTitles(recordings);
+  EXPECT_EQ(CTestRecordingsClient::GetTitle(3, 1), titles["1/rec3"]);
+  EXPECT_TRUE(titles.find("1/rec4") == titles.end());
+
+  // the recordings of a client that wasn't asked because its token is the same are kept
+  CStdString strToken = changeTokens[1];
+  EXPECT_FALSE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(strToken, changeTokens[1]);
+  EXPECT_EQ(999, recordings.GetNumRecordings());
+
+  // a client that's gone takes its recordings with it, and is asked again once it's back
+  withToken.m_bAvailable = false;
+  EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(500, recordings.GetNumRecordings());
+  withToken.m_bAvailable = true;
+  EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  EXPECT_EQ(999, recordings.GetNumRecordings());
+}
+
+TEST(TestPVRRecordings, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  const int iRecordings = 10000, iUpdates = 10;
+  CTestRecordingsClient withoutToken(1, iRecordings, false);
+  CTestRecordingsClient withToken(2, iRecordings, true);
+  std::vector<CTestRecordingsClient *> clients;
+  clients.push_back(&withoutToken);
+
+  CPVRRecordings recordings;
+  std::map<int, CStdString> changeTokens;
+  ASSERT_TRUE(Update(recordings, clients, changeTokens));
+
+  // the way the recordings were refreshed before: all thrown away and taken again
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < iUpdates; i++)
+  {
+    recordings.Clear();
+    EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  }
+  double full = CXBMCTestUtils::ElapsedMs(start);
+
+  // a few recordings changed, the others are skipped by their fingerprints
+  start = CurrentHostCounter();
+  for (int i = 0; i < iUpdates; i++)
+  {
+    withoutToken.Rename(i * 97);
+    EXPECT_TRUE(Update(recordings, clients, changeTokens));
+  }
+  double fingerprints = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(iRecordings, recordings.GetNumRecordings());
+
+  // the client tells that nothing changed
+  clients.clear();
+  clients.push_back(&withToken);
+  ASSERT_TRUE(Update(recordings, clients, changeTokens));
+  start = CurrentHostCounter();
+  for (int i = 0; i < iUpdates; i++)
+    EXPECT_FALSE(Update(recordings, clients, changeTokens));
+  double tokens = CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_EQ(iRecordings, recordings.GetNumRecordings());
+
+  std::cout << iRecordings << " recordings: " << full / iUpdates << " ms per full refresh, "
+            << fingerprints / iUpdates << " ms per refresh skipping unchanged recordings, "
+            << tokens * 1e3 / iUpdates << " us per refresh with an unchanged change token" << std::endl;
+}
@@ -0,0 +1,109 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "epg/EpgInfoTag.h"
+#include "pvr/timers/PVRTimers.h"
+
+#include "gtest/gtest.h"
+
+#include <set>
+#include <stdio.h>
+#include <string.h>
+
+using namespace PVR;
+using namespace EPG;
+
+// there are no channels or guide in the tests, timers get an event of their own once the guide is said to be loaded
+class CTestTimers : public CPVRTimers
+{
+public:
+  CTestTimers(void) : m_bEpgLoaded(false), m_iLinked(0) {}
+
+  using CPVRTimers::UpdateEntries;
+
+  virtual void UpdateChannels(void) {}
+
+  bool m_bEpgLoaded;
+  int  m_iLinked;
+
+protected:
+  virtual void UpdateEpgEvent(CPVRTimerInfoTagPtr timer)
+  {
+    if (!m_bEpgLoaded || timer->GetEpgInfoTag())
+      return;
+
+    timer->SetEpgInfoTag(CEpgInfoTagPtr(new CEpgInfoTag()));
+    m_iLinked++;
+  }
+};
+
+static void AddTimer(CTestTimers &timers, int iClientId, unsigned int iClientIndex, const char *strTitle)
+{
+  PVR_TIMER timer;
+  memset(&timer, 0, sizeof(timer));
+  timer.iClientIndex = iClientIndex;
+  timer.iClientChannelUid = iClientIndex % 5;
+  timer.startTime = 1350000000 + iClientIndex * 3600;
+  timer.endTime = timer.startTime + 1800;
+  timer.state = PVR_TIMER_STATE_SCHEDULED;
+  snprintf(timer.strTitle, sizeof(timer.strTitle), "%s", strTitle);
+
+  timers.UpdateFromClient(CPVRTimerInfoTag(timer, CPVRChannelPtr(), iClientId));
+}
+
+TEST(TestPVRTimers, UpdateEntries)
+{
+  CTestTimers fetched;
+  for (unsigned int i = 1; i <= 3; i++)
+    AddTimer(fetched, 1, i, "Timer");
+
+  CTestTimers timers;
+  std::set<int> unchangedClients;
+  EXPECT_TRUE(timers.UpdateEntries(fetched, unchangedClients));
+  EXPECT_EQ(3, timers.AmountActiveTimers());
+  EXPECT_EQ(0, timers.m_iLinked);
+
+  // the same timers again, but the guide was loaded since
+  timers.m_bEpgLoaded = true;
+  EXPECT_FALSE(timers.UpdateEntries(fetched, unchangedClients));
+  EXPECT_EQ(3, timers.m_iLinked);
+
+  // linked timers stay linked
+  EXPECT_FALSE(timers.UpdateEntries(fetched, unchangedClients));
+  EXPECT_EQ(3, timers.m_iLinked);
+
+  // a changed timer
+  AddTimer(fetched, 1, 2, "Renamed");
+  EXPECT_TRUE(timers.UpdateEntries(fetched, unchangedClients));
+  EXPECT_EQ(3, timers.AmountActiveTimers());
+
+  // the timers of a client that wasn't asked are kept, the ones gone from a client that was are removed
+  CTestTimers fetchedAgain;
+  AddTimer(fetchedAgain, 2, 1, "Timer");
+  EXPECT_TRUE(timers.UpdateEntries(fetchedAgain, unchangedClients));
+  EXPECT_EQ(1, timers.AmountActiveTimers());
+
+  AddTimer(fetched, 2, 1, "Timer");
+  EXPECT_TRUE(timers.UpdateEntries(fetched, unchangedClients));
+  EXPECT_EQ(4, timers.AmountActiveTimers());
+  unchangedClients.insert(1);
+  EXPECT_FALSE(timers.UpdateEntries(fetchedAgain, unchangedClients));
+  EXPECT_EQ(4, timers.AmountActiveTimers());
+}
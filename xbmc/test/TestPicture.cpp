@@ -0,0 +1,130 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "pictures/Picture.h"
+#include "test/TestUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#define PICTURE_TEST_4K_WIDTH   3840
+#define PICTURE_TEST_4K_HEIGHT  2160
+
+// the source pixel that ends up at column x, row y of the oriented image, one pixel at a time
+static uint32_t OrientedPixel(const uint32_t *pixels, unsigned int width, unsigned int height, int orientation, unsigned int x, unsigned int y)
+{
+  switch (orientation)
+  {
+    case 1: return pixels[y * width + width - 1 - x];
+    case 2: return pixels[(height - 1 - y) * width + width - 1 - x];
+    case 3: return pixels[(height - 1 - y) * width + x];
+    case 4: return pixels[x * width + y];
+    case 5: return pixels[(height - 1 - x) * width + y];
+    case 6: return pixels[(height - 1 - x) * width + width - 1 - y];
+    case 7: return pixels[x * width + width - 1 - y];
+  }
+  return 0;
+}
+
+static uint32_t *CreateImage(unsigned int width, unsigned int height)
+{
+  uint32_t *pixels = new uint32_t[width * height];
+  for (unsigned int i = 0; i < width * height; i++)
+    pixels[i] = i * 2654435761u;
+  return pixels;
+}
+
+TEST(TestPicture, OrientateImage)
+{
+  // odd sizes leave pixels over at the edges of the tiles
+  const unsigned int sizes[][2] = { { 1, 1 }, { 3, 5 }, { 4, 4 }, { 37, 23 }, { 64, 33 }, { 1023, 769 }, { 1920, 1080 } };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    for (int orientation = 1; orientation <= 7; orientation++)
+    {
+      unsigned int width = sizes[s][0], height = sizes[s][1];
+      uint32_t *source = CreateImage(width, height);
+      uint32_t *pixels = CreateImage(width, height);
+      ASSERT_TRUE(CPicture::OrientateImage(pixels, width, height, orientation));
+      EXPECT_EQ(orientation < 4 ? sizes[s][0] : sizes[s][1], width);
+      EXPECT_EQ(orientation < 4 ? sizes[s][1] : sizes[s][0], height);
+
+      unsigned int mismatches = 0;
+      for (unsigned int y = 0; y < height; y++)
+      {
+        for (unsigned int x = 0; x < width; x++)
+        {
+          if (pixels[y * width + x] != OrientedPixel(source, sizes[s][0], sizes[s][1], orientation, x, y))
+            mismatches++;
+        }
+      }
+      EXPECT_EQ(0u, mismatches) << sizes[s][0] << "x" << sizes[s][1] << " orientation " << orientation;
+      delete[] source;
+      delete[] pixels;
+    }
+  }
+}
+
+TEST(TestPicture, Throughput4K)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  const unsigned int pixels4K = PICTURE_TEST_4K_WIDTH * PICTURE_TEST_4K_HEIGHT;
+  uint32_t *source = CreateImage(PICTURE_TEST_4K_WIDTH, PICTURE_TEST_4K_HEIGHT);
+
+  // a quarter turn one pixel at a time, as OrientateImage used to
+  int64_t start = CurrentHostCounter();
+  uint32_t *rotated = new uint32_t[pixels4K];
+  for (unsigned int y = 0; y < PICTURE_TEST_4K_WIDTH; y++)
+  {
+    for (unsigned int x = 0; x < PICTURE_TEST_4K_HEIGHT; x++)
+      rotated[y * PICTURE_TEST_4K_HEIGHT + x] = OrientedPixel(source, PICTURE_TEST_4K_WIDTH, PICTURE_TEST_4K_HEIGHT, 7, x, y);
+  }
+  double reference = pixels4K / CXBMCTestUtils::ElapsedMs(start) / 1000;
+
+  double oriented[8] = { 0 };
+  for (int orientation = 1; orientation <= 7; orientation++)
+  {
+    uint32_t *pixels = CreateImage(PICTURE_TEST_4K_WIDTH, PICTURE_TEST_4K_HEIGHT);
+    unsigned int width = PICTURE_TEST_4K_WIDTH, height = PICTURE_TEST_4K_HEIGHT;
+    start = CurrentHostCounter();
+    EXPECT_TRUE(CPicture::OrientateImage(pixels, width, height, orientation));
+    oriented[orientation] = pixels4K / CXBMCTestUtils::ElapsedMs(start) / 1000;
+    if (orientation == 7)
+      EXPECT_EQ(0, memcmp(rotated, pixels, pixels4K * 4));
+    delete[] pixels;
+  }
+
+  // down to fanart size
+  uint32_t *scaled = new uint32_t[1920 * 1080];
+  start = CurrentHostCounter();
+  EXPECT_TRUE(CPicture::ScaleImage((uint8_t *)source, PICTURE_TEST_4K_WIDTH, PICTURE_TEST_4K_HEIGHT, PICTURE_TEST_4K_WIDTH * 4,
+                                   (uint8_t *)scaled, 1920, 1080, 1920 * 4));
+  double scaling = pixels4K / CXBMCTestUtils::ElapsedMs(start) / 1000;
+
+  std::cout << "4K images at " << reference << " MP/s rotated a pixel at a time; oriented at";
+  for (int orientation = 1; orientation <= 7; orientation++)
+    std::cout << " " << oriented[orientation] << (orientation < 7 ? "," : "");
+  std::cout << " MP/s for orientations 1-7; scaled to 1080p at " << scaling << " MP/s" << std::endl;
+
+  delete[] scaled;
+  delete[] rotated;
+  delete[] source;
+}
@@ -0,0 +1,212 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "playlists/SmartPlayList.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "music/MusicDatabase.h"
+#include "settings/GUISettings.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "Util.h"
+
+#include "gtest/gtest.h"
+
+#define PLAYLISTS_PATH "special://temp/smartplaylists/"
+#define MUSIC_PLAYLISTS_PATH PLAYLISTS_PATH "music/"
+#define SMARTPLAYLIST_TEST_NESTED 20
+
+// each playlist takes the songs of the one before it with a higher rating
+static CStdString WritePlaylist(int index, int rating)
+{
+  CStdString rules;
+  if (index > 0)
+    rules = StringUtils::Format("<rule field=\"playlist\" operator=\"is\"><value>Nested %02d</value></rule>", index - 1);
+  rules += StringUtils::Format("<rule field=\"rating\" operator=\"greaterthan\"><value>%d</value></rule>", rating);
+
+  CStdString xml = StringUtils::Format("<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                                       "<smartplaylist type=\"songs\"><name>Nested %02d</name><match>all</match>%s</smartplaylist>\n",
+                                       index, rules.c_str());
+
+  CStdString path = StringUtils::Format(MUSIC_PLAYLISTS_PATH "nested%02d.xsp", index);
+  XFILE::CFile file;
+  if (file.OpenForWrite(path, true))
+  {
+    file.Write(xml.c_str(), xml.size());
+    file.Close();
+  }
+  return path;
+}
+
+class TestSmartPlaylist : public testing::Test
+{
+protected:
+  TestSmartPlaylist()
+  {
+    m_playlistsPath = g_guiSettings.GetString("system.playlistspath");
+    g_guiSettings.SetString("system.playlistspath", PLAYLISTS_PATH);
+    CUtil::CreateDirectoryEx(MUSIC_PLAYLISTS_PATH);
+
+    for (int i = 0; i < SMARTPLAYLIST_TEST_NESTED; i++)
+      m_top = WritePlaylist(i, i);
+
+    if (!XFILE::CDirectory::Exists(g_settings.GetDatabaseFolder()))
+      XFILE::CDirectory::Create(g_settings.GetDatabaseFolder());
+    m_database.Open();
+  }
+
+  ~TestSmartPlaylist()
+  {
+    m_database.Close();
+    XFILE::CDirectory::Remove(g_settings.GetDatabaseFolder());
+    for (int i = 0; i < SMARTPLAYLIST_TEST_NESTED; i++)
+      XFILE::CFile::Delete(StringUtils::Format(MUSIC_PLAYLISTS_PATH "nested%02d.xsp", i));
+    XFILE::CDirectory::Remove(MUSIC_PLAYLISTS_PATH);
+    XFILE::CDirectory::Remove(PLAYLISTS_PATH);
+    g_guiSettings.SetString("system.playlistspath", m_playlistsPath);
+  }
+
+  CStdString GetWhereClause(const CStdString &path, std::set<CStdString> &referenced)
+  {
+    CSmartPlaylist playlist;
+    EXPECT_TRUE(playlist.Load(path));
+    referenced.clear();
+    return playlist.GetWhereClause(m_database, referenced);
+  }
+
+  CStdString m_playlistsPath;
+  CStdString m_top;
+  CMusicDatabase m_database;
+};
+
+TEST_F(TestSmartPlaylist, NestedPlaylists)
+{
+  // the first query reads every playlist, as looking one up by name opens them all
+  std::set<CStdString> referenced;
+  CStdString where = GetWhereClause(m_top, referenced);
+  EXPECT_EQ((unsigned int)(SMARTPLAYLIST_TEST_NESTED - 1), referenced.size());
+
+  // later ones take them from the cache
+  EXPECT_EQ(where, GetWhereClause(m_top, referenced));
+  EXPECT_EQ((unsigned int)(SMARTPLAYLIST_TEST_NESTED - 1), referenced.size());
+
+  // a nested playlist changed on disk is read again
+  WritePlaylist(5, 1000);
+  CStdString changedWhere = GetWhereClause(m_top, referenced);
+  EXPECT_NE(where, changedWhere);
+  EXPECT_NE(CStdString::npos, changedWhere.find("1000"));
+
+  // as is one saved through the playlist
+  CSmartPlaylist saved;
+  ASSERT_TRUE(saved.Load(m_top));
+  saved.SetMatchAllRules(false);
+  ASSERT_TRUE(saved.Save(m_top));
+  CSmartPlaylist reloaded;
+  ASSERT_TRUE(reloaded.Load(m_top));
+  EXPECT_FALSE(reloaded.GetMatchAllRules());
+}
+
+static unsigned int CountOf(const CStdString &text, const CStdString &part)
+{
+  unsigned int count = 0;
+  for (size_t pos = text.find(part); pos != CStdString::npos; pos = text.find(part, pos + part.size()))
+    count++;
+  return count;
+}
+
+TEST_F(TestSmartPlaylist, NestedWhereClauses)
+{
+  // the nested playlists are laid out once, and then taken as they are
+  std::set<CStdString> referenced;
+  CStdString where = GetWhereClause(m_top, referenced);
+  EXPECT_EQ(where, GetWhereClause(m_top, referenced));
+  EXPECT_EQ((unsigned int)(SMARTPLAYLIST_TEST_NESTED - 1), referenced.size());
+
+  // a playlist taking one of them twice, directly and through another, still takes it once
+  CStdString nested3 = GetWhereClause(StringUtils::Format(MUSIC_PLAYLISTS_PATH "nested%02d.xsp", 3), referenced);
+  CStdString diamond = MUSIC_PLAYLISTS_PATH "diamond.xsp";
+  CStdString xml = "<?xml version=\"1.0\" encoding=\"UTF-8\" standalone=\"yes\" ?>\n"
+                   "<smartplaylist type=\"songs\"><name>Diamond</name><match>all</match>"
+                   "<rule field=\"playlist\" operator=\"is\"><value>Nested 03</value></rule>"
+                   "<rule field=\"playlist\" operator=\"is\"><value>Nested 05</value></rule></smartplaylist>\n";
+  XFILE::CFile file;
+  ASSERT_TRUE(file.OpenForWrite(diamond, true));
+  file.Write(xml.c_str(), xml.size());
+  file.Close();
+  CStdString diamondWhere = GetWhereClause(diamond, referenced);
+  EXPECT_EQ(1u, CountOf(diamondWhere, nested3));
+  EXPECT_EQ(6u, referenced.size());
+
+  // a playlist saved under another name is no longer found by its old one
+  CStdString nested10 = StringUtils::Format(MUSIC_PLAYLISTS_PATH "nested%02d.xsp", 10);
+  CSmartPlaylist renamed;
+  ASSERT_TRUE(renamed.Load(nested10));
+  renamed.SetName("Renamed 10");
+  ASSERT_TRUE(renamed.Save(nested10));
+  CStdString renamedWhere = GetWhereClause(m_top, referenced);
+  EXPECT_NE(where, renamedWhere);
+  EXPECT_EQ((unsigned int)(SMARTPLAYLIST_TEST_NESTED - 1 - 10), referenced.size());
+
+  XFILE::CFile::Delete(diamond);
+}
+
+TEST_F(TestSmartPlaylist, CacheSize)
+{
+  // the nested playlists are loaded first and dropped as the others come in
+  std::set<CStdString> referenced;
+  CStdString where = GetWhereClause(m_top, referenced);
+
+  std::vector<CStdString> paths;
+  for (int i = SMARTPLAYLIST_TEST_NESTED; i < SMARTPLAYLIST_TEST_NESTED + SMARTPLAYLIST_CACHE_SIZE; i++)
+  {
+    paths.push_back(WritePlaylist(i, 0));
+    CSmartPlaylist playlist;
+    EXPECT_TRUE(playlist.Load(paths.back()));
+  }
+  EXPECT_EQ((unsigned int)SMARTPLAYLIST_CACHE_SIZE, CSmartPlaylist::GetNumCached());
+
+  // those are read again, and still give the same query
+  EXPECT_EQ(where, GetWhereClause(m_top, referenced));
+  EXPECT_EQ((unsigned int)SMARTPLAYLIST_CACHE_SIZE, CSmartPlaylist::GetNumCached());
+
+  for (std::vector<CStdString>::const_iterator it = paths.begin(); it != paths.end(); ++it)
+    XFILE::CFile::Delete(*it);
+}
+
+TEST_F(TestSmartPlaylist, Benchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+  const int queries = 50;
+
+  std::set<CStdString> referenced;
+  int64_t start = CurrentHostCounter();
+  GetWhereClause(m_top, referenced);
+  double cold = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < queries; i++)
+    GetWhereClause(m_top, referenced);
+  double warm = CXBMCTestUtils::ElapsedMs(start) / queries;
+
+  std::cout << SMARTPLAYLIST_TEST_NESTED << " nested playlists: " << cold << " ms for the first query, "
+            << warm << " ms per query once the playlists are cached" << std::endl;
+}
@@ -0,0 +1,149 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/dvdplayer/DVDFileInfo.h"
+#include "cores/dvdplayer/DVDThumbContext.h"
+#include "video/ThumbExtractionService.h"
+#include "video/VideoInfoTag.h"
+#include "filesystem/File.h"
+#include "FileItem.h"
+#include "TextureCache.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+#include "test/TestUtils.h"
+
+#include "gtest/gtest.h"
+
+// extracts thumbs from the sample files on its own context until none are left
+class CTestThumbExtractionThread : public CThread
+{
+public:
+  CTestThumbExtractionThread(const std::vector<CStdString> &files, unsigned int &next, CCriticalSection &section) :
+    CThread("CTestThumbExtractionThread"), m_files(files), m_next(next), m_section(section) {}
+
+  virtual void Process()
+  {
+    CDVDThumbContext context;
+    while (true)
+    {
+      unsigned int file;
+      {
+        CSingleLock lock(m_section);
+        if (m_next >= m_files.size())
+          return;
+        file = m_next++;
+      }
+      CTextureDetails details;
+      details.file = CTextureCache::GetCacheFile(m_files[file]) + ".jpg";
+      CDVDFileInfo::ExtractThumb(m_files[file], details, NULL, &context);
+    }
+  }
+
+private:
+  const std::vector<CStdString> &m_files;
+  unsigned int &m_next;
+  CCriticalSection &m_section;
+};
+
+TEST(TestThumbExtraction, ScalerCache)
+{
+  CDVDThumbContext context;
+  struct SwsContext *scaler = context.GetScaler(1920, 1080, 320, 180);
+  ASSERT_TRUE(scaler != NULL);
+  EXPECT_EQ(scaler, context.GetScaler(1920, 1080, 320, 180));
+  EXPECT_EQ(1u, context.GetNumScalersCreated());
+
+  EXPECT_NE(scaler, context.GetScaler(1280, 720, 320, 180));
+  EXPECT_EQ(2u, context.GetNumScalersCreated());
+}
+
+TEST(TestThumbExtraction, StopForgetsPending)
+{
+  CFileItem item("special://temp/thumbextractiontest.mkv", false);
+  item.GetVideoInfoTag()->m_iDbId = 1;
+  item.GetVideoInfoTag()->m_type = "movie";
+
+  // items queued before the service starts wait for it
+  CThumbExtractionService &service = CThumbExtractionService::Get();
+  service.QueueItem(item);
+  EXPECT_EQ(1u, service.GetNumPending());
+
+  // and are saved with the profile when it stops, not carried over to the next one
+  service.Start();
+  service.Stop();
+  EXPECT_EQ(0u, service.GetNumPending());
+  XFILE::CFile::Delete("special://profile/thumbextraction.xml");
+}
+
+TEST(TestThumbExtraction, Throughput)
+{
+  const std::vector<CStdString> &files = CXBMCTestUtils::Instance().getTestThumbExtractionFiles();
+  if (files.empty())
+  {
+    std::cout << "No sample files given, add some with --add-testthumbextraction-files" << std::endl;
+    return;
+  }
+
+  // a file at a time as CThumbExtractor used to, setting up the decoder and scaler each time
+  int64_t start = CurrentHostCounter();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    CTextureDetails details;
+    details.file = CTextureCache::GetCacheFile(files[i]) + ".jpg";
+    CDVDFileInfo::ExtractThumb(files[i], details, NULL);
+  }
+  double fresh = files.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  CDVDThumbContext context;
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < files.size(); i++)
+  {
+    CTextureDetails details;
+    details.file = CTextureCache::GetCacheFile(files[i]) + ".jpg";
+    CDVDFileInfo::ExtractThumb(files[i], details, NULL, &context);
+  }
+  double shared = files.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+  EXPECT_LE(context.GetNumCodecsOpened(), files.size());
+
+  // and as many at once as the service runs
+  unsigned int jobs = CThumbExtractionService::GetJobsAtOnce();
+  unsigned int next = 0;
+  CCriticalSection section;
+  std::vector<CTestThumbExtractionThread *> threads;
+  start = CurrentHostCounter();
+  for (unsigned int i = 0; i < jobs; i++)
+  {
+    threads.push_back(new CTestThumbExtractionThread(files, next, section));
+    threads.back()->Create();
+  }
+  // the threads finish once the files run out
+  for (unsigned int i = 0; i < threads.size(); i++)
+  {
+    threads[i]->StopThread(true);
+    delete threads[i];
+  }
+  double parallel = files.size() * 1000.0 / CXBMCTestUtils::ElapsedMs(start);
+
+  std::cout << "Extracted " << files.size() << " thumbs at " << fresh << " files/s one at a time, "
+            << shared << " files/s with a shared context (" << context.GetNumCodecsReused()
+            << " decoders reused, " << context.GetNumScalersCreated() << " scalers), "
+            << parallel << " files/s with " << jobs << " jobs" << std::endl;
+}
@@ -23,6 +23,7 @@
 #include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
 #include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
 
 #ifndef _LINUX
 #include <windows.h>
@@ -92,6 +93,7 @@ private:
 CXBMCTestUtils::CXBMCTestUtils()
 {
   probability = 0.01;
+  RunBenchmarks = false;
 }
 
 CXBMCTestUtils &CXBMCTestUtils::Instance()
@@ -211,6 +213,26 @@ void CXBMCTestUtils::setTestFileFactoryWriteInputFile(CStdString const& file)
   TestFileFactoryWriteInputFile = file;
 }
 
+std::vector<CStdString> &CXBMCTestUtils::getTestThumbExtractionFiles()
+{
+  return TestThumbExtractionFiles;
+}
+
+CStdString &CXBMCTestUtils::getTestJpegIOFolder()
+{
+  return TestJpegIOFolder;
+}
+
+bool CXBMCTestUtils::getRunBenchmarks() const
+{
+  return RunBenchmarks;
+}
+
+double CXBMCTestUtils::ElapsedMs(int64_t start)
+{
+  return (double)(CurrentHostCounter() - start) * 1000.0 / CurrentHostFrequency();
+}
+
 std::vector<CStdString> &CXBMCTestUtils::getAdvancedSettingsFiles()
 {
   return AdvancedSettingsFiles;
@@ -251,6 +273,19 @@ static const char usage[] =
 "  --set-testfilefactory-writeinputfile [FILE]\n"
 "    Set the path to the input file used in the TestFileFactory write tests.\n"
 "\n"
+"  --add-testthumbextraction-file [FILE]\n"
+"    Add a video file to be used in the TestThumbExtraction tests.\n"
+"\n"
+"  --add-testthumbextraction-files [FILES]\n"
+"    Add multiple video files from a ',' delimited string of files to be\n"
+"    used in the TestThumbExtraction tests.\n"
+"\n"
+"  --set-testjpegio-folder [FOLDER]\n"
+"    Set the folder of sample jpegs used in the TestJpegIO tests.\n"
+"\n"
+"  --run-benchmarks\n"
+"    Run the benchmarks, which only print timings and are skipped otherwise.\n"
+"\n"
 "  --add-advancedsettings-file [FILE]\n"
 "    Add an advanced settings file to be loaded in test cases that use them.\n"
 "\n"
@@ -319,6 +354,26 @@ void CXBMCTestUtils::ParseArgs(int argc, char **argv)
     {
       TestFileFactoryWriteInputFile = argv[++i];
     }
+    else if (arg == "--add-testthumbextraction-file")
+    {
+      TestThumbExtractionFiles.push_back(argv[++i]);
+    }
+    else if (arg == "--add-testthumbextraction-files")
+    {
+      arg = argv[++i];
+      std::vector<std::string> urls = StringUtils::Split(arg, ",");
+      std::vector<std::string>::iterator it;
+      for (it = urls.begin(); it < urls.end(); it++)
+        TestThumbExtractionFiles.push_back(*it);
+    }
+    else if (arg == "--set-testjpegio-folder")
+    {
+      TestJpegIOFolder = argv[++i];
+    }
+    else if (arg == "--run-benchmarks")
+    {
+      RunBenchmarks = true;
+    }
     else if (arg == "--add-advancedsettings-file")
     {
       AdvancedSettingsFiles.push_back(argv[++i]);
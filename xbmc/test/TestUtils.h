@@ -21,6 +21,8 @@
 
 #include "utils/StdString.h"
 
+#include <stdint.h>
+
 namespace XFILE
 {
   class CFile;
@@ -69,6 +71,23 @@ public:
   /* Function to set the input file used in the TestFileFactory.Write tests */
   void setTestFileFactoryWriteInputFile(CStdString const& file);
 
+  /* Function to get the video files used in the TestThumbExtraction tests. */
+  std::vector<CStdString> &getTestThumbExtractionFiles();
+
+  /* Function to get the folder of sample jpegs used in the TestJpegIO tests. */
+  CStdString &getTestJpegIOFolder();
+
+  /* Function to tell whether the benchmarks were asked for. They print
+   * timings only and take a while, so they are skipped unless run with
+   * --run-benchmarks.
+   */
+  bool getRunBenchmarks() const;
+
+  /* Function to get the milliseconds passed since a CurrentHostCounter()
+   * value, used to time the benchmarks.
+   */
+  static double ElapsedMs(int64_t start);
+
   /* Function to get advanced settings files. */
   std::vector<CStdString> &getAdvancedSettingsFiles();
 
@@ -99,6 +118,9 @@ private:
   std::vector<CStdString> TestFileFactoryWriteUrls;
   CStdString TestFileFactoryWriteInputFile;
 
+  std::vector<CStdString> TestThumbExtractionFiles;
+  CStdString TestJpegIOFolder;
+  bool RunBenchmarks;
   std::vector<CStdString> AdvancedSettingsFiles;
   std::vector<CStdString> GUISettingsFiles;
 
@@ -111,3 +133,9 @@ private:
 #define XBMC_TEMPFILEPATH(a) CXBMCTestUtils::Instance().TempFilePath(a)
 #define XBMC_CREATECORRUPTEDFILE(a, b) \
   CXBMCTestUtils::Instance().CreateCorruptedFile(a, b)
+#define XBMC_SKIP_UNLESS_BENCHMARKS() \
+  if (!CXBMCTestUtils::Instance().getRunBenchmarks()) \
+  { \
+    std::cout << "Benchmark skipped, run with --run-benchmarks" << std::endl; \
+    return; \
+  }
@@ -455,6 +455,37 @@ long AtomicSubtract(volatile long* pAddr, long amount)
 #endif
 }
 
+///////////////////////////////////////////////////////////////////////////
+// Full memory barrier
+// No memory access is moved across it by the compiler or the cpu
+///////////////////////////////////////////////////////////////////////////
+void AtomicFence()
+{
+#if defined(HAS_BUILTIN_SYNC_ADD_AND_FETCH)
+  __sync_synchronize();
+
+#elif defined(__ppc__) || defined(__powerpc__) // PowerPC
+  __asm__ __volatile__ ("sync" : : : "memory");
+
+#elif defined(__arm__) && !defined(__ARM_ARCH_5__)
+  asm volatile ("dmb      ish" : : : "memory");
+
+#elif defined(__mips__)
+// TODO:
+  #error AtomicFence undefined for mips
+
+#elif defined(WIN32)
+  MemoryBarrier();
+
+#elif defined(__x86_64__)
+  __asm__ __volatile__ ("lock/addl $0, (%%rsp)" : : : "memory");
+
+#else // Linux / OSX86 (GCC)
+  __asm__ __volatile__ ("lock/addl $0, (%%esp)" : : : "memory");
+
+#endif
+}
+
 ///////////////////////////////////////////////////////////////////////////
 // Fast spinlock implmentation. No backoff when busy
 ///////////////////////////////////////////////////////////////////////////
@@ -30,6 +30,7 @@ long AtomicIncrement(volatile long* pAddr);
 long AtomicDecrement(volatile long* pAddr);
 long AtomicAdd(volatile long* pAddr, long amount);
 long AtomicSubtract(volatile long* pAddr, long amount);
+void AtomicFence();
 
 class CAtomicSpinLock
 {
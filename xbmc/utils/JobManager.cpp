@@ -137,6 +137,14 @@ void CJobQueue::AddJob(CJob *job)
   QueueNextJob();
 }
 
+void CJobQueue::SetJobsAtOnce(unsigned int jobsAtOnce)
+{
+  CSingleLock lock(m_section);
+  m_jobsAtOnce = jobsAtOnce;
+  while (m_jobQueue.size() && m_processing.size() < m_jobsAtOnce)
+    QueueNextJob();
+}
+
 void CJobQueue::QueueNextJob()
 {
   CSingleLock lock(m_section);
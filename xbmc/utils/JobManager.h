@@ -120,6 +120,13 @@ public:
    */
   void CancelJobs();
 
+  /*!
+   \brief Change the number of jobs processed at once
+   Jobs already being processed are left to complete if the number is lowered.
+   \param jobsAtOnce number of jobs at once to process.
+   */
+  void SetJobsAtOnce(unsigned int jobsAtOnce);
+
   /*!
    \brief The callback used when a job completes.
 
@@ -0,0 +1,169 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ShuffleSampler.h"
+
+#include <algorithm>
+#include <stdlib.h>
+
+using namespace std;
+
+// rand() may only give 15 bits, which doesn't cover a large library
+static unsigned int Random(unsigned int range)
+{
+  unsigned int value = rand();
+  if (range > RAND_MAX)
+    value = value * ((unsigned int)RAND_MAX + 1) + rand();
+  return value % range;
+}
+
+CShuffleSampler::CShuffleSampler(unsigned int historySize /* = 0 */)
+{
+  m_available = 0;
+  m_historySize = historySize;
+}
+
+void CShuffleSampler::Reset(const vector<int> &ids)
+{
+  m_pool.clear();
+  m_position.clear();
+  m_history.clear();
+
+  m_pool.reserve(ids.size());
+  for (vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+  {
+    if (*it < 0 || Contains(*it))
+      continue;
+    if (*it >= (int)m_position.size())
+      m_position.resize(*it + 1, -1);
+    m_position[*it] = m_pool.size();
+    m_pool.push_back(*it);
+  }
+  m_available = m_pool.size();
+}
+
+void CShuffleSampler::Refresh(const vector<int> &ids)
+{
+  vector<bool> present(m_position.size(), false);
+  for (vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+  {
+    if (*it < 0)
+      continue;
+    if (*it >= (int)present.size())
+      present.resize(*it + 1, false);
+    present[*it] = true;
+  }
+
+  vector<int> removed;
+  for (vector<int>::const_iterator it = m_pool.begin(); it != m_pool.end(); ++it)
+  {
+    if (!present[*it])
+      removed.push_back(*it);
+  }
+  for (vector<int>::const_iterator it = removed.begin(); it != removed.end(); ++it)
+    Remove(*it);
+
+  // new ids join the ids that may be drawn
+  if (present.size() > m_position.size())
+    m_position.resize(present.size(), -1);
+  for (vector<int>::const_iterator it = ids.begin(); it != ids.end(); ++it)
+    Add(*it);
+}
+
+void CShuffleSampler::Add(int id)
+{
+  if (id < 0 || Contains(id))
+    return;
+  if (id >= (int)m_position.size())
+    m_position.resize(id + 1, -1);
+  m_position[id] = m_pool.size();
+  m_pool.push_back(id);
+  Swap(m_pool.size() - 1, m_available++);
+}
+
+bool CShuffleSampler::Draw(int &id)
+{
+  if (m_pool.empty())
+    return false;
+
+  if (m_available == 0)
+    ReleaseHistory();
+
+  Swap(Random(m_available), m_available - 1);
+  id = m_pool[--m_available];
+
+  m_history.push_back(id);
+  while (m_history.size() > m_historySize)
+    ReleaseHistory();
+  return true;
+}
+
+void CShuffleSampler::SetHistorySize(unsigned int historySize)
+{
+  m_historySize = historySize;
+  while (m_history.size() > m_historySize)
+    ReleaseHistory();
+}
+
+bool CShuffleSampler::Contains(int id) const
+{
+  return id >= 0 && id < (int)m_position.size() && m_position[id] >= 0;
+}
+
+bool CShuffleSampler::InHistory(int id) const
+{
+  return Contains(id) && m_position[id] >= (int)m_available;
+}
+
+void CShuffleSampler::Swap(unsigned int i, unsigned int j)
+{
+  if (i == j)
+    return;
+  swap(m_pool[i], m_pool[j]);
+  m_position[m_pool[i]] = i;
+  m_position[m_pool[j]] = j;
+}
+
+void CShuffleSampler::Remove(int id)
+{
+  if (!Contains(id))
+    return;
+
+  unsigned int position = m_position[id];
+  if (position < m_available)
+  {
+    // move it to the boundary, so it can leave the pool the way history does
+    Swap(position, --m_available);
+    position = m_available;
+  }
+  else
+    m_history.erase(find(m_history.begin(), m_history.end(), id));
+
+  Swap(position, m_pool.size() - 1);
+  m_pool.pop_back();
+  m_position[id] = -1;
+}
+
+void CShuffleSampler::ReleaseHistory()
+{
+  int id = m_history.front();
+  m_history.pop_front();
+  Swap(m_position[id], m_available++);
+}
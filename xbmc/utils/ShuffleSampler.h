@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <vector>
+
+/*! \brief Draws random ids from a set, keeping the most recently drawn ones out of the draw.
+
+ The ids are kept in a pool whose front holds the ids that may be drawn and whose back holds
+ the history. A draw swaps a random id from the front to the back, and once the history is
+ full its oldest id is swapped back to the front, so each draw takes constant time. Ids are
+ expected to be database ids: small, non-negative and dense, as positions are looked up by id.
+ */
+class CShuffleSampler
+{
+public:
+  CShuffleSampler(unsigned int historySize = 0);
+
+  /*! \brief Replace the ids to draw from, clearing the history.
+   */
+  void Reset(const std::vector<int> &ids);
+
+  /*! \brief Update the ids to draw from after they changed.
+   Ids no longer in the set are dropped, new ids can be drawn straight away and the history of
+   the remaining ids is kept.
+   */
+  void Refresh(const std::vector<int> &ids);
+
+  /*! \brief Add an id to draw from, it can be drawn straight away.
+   Does nothing if the id is in the set already.
+   */
+  void Add(int id);
+
+  /*! \brief Drop an id from the set, and from the history should it be there.
+   Does nothing if the id isn't in the set.
+   */
+  void Remove(int id);
+
+  /*! \brief Draw an id at random from the ids not in the history.
+   With an empty history ids are drawn with replacement. Should the history hold all ids, its
+   oldest id is drawn again.
+   \param id the id drawn.
+   \return false if there are no ids to draw from.
+   */
+  bool Draw(int &id);
+
+  void SetHistorySize(unsigned int historySize);
+  unsigned int GetHistorySize() const { return m_historySize; };
+
+  bool Contains(int id) const;
+  bool InHistory(int id) const;
+  unsigned int Size() const { return m_pool.size(); };
+  unsigned int Available() const { return m_available; };
+
+private:
+  void Swap(unsigned int i, unsigned int j);
+  void ReleaseHistory();
+
+  std::vector<int> m_pool;      ///< ids that may be drawn, followed by the history
+  std::vector<int> m_position;  ///< position in the pool by id, -1 for ids not in the set
+  std::deque<int>  m_history;   ///< ids in the history, oldest first
+  unsigned int     m_available; ///< number of ids at the front of the pool that may be drawn
+  unsigned int     m_historySize;
+};
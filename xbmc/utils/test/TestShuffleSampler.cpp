@@ -0,0 +1,277 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/ShuffleSampler.h"
+#include "FileItem.h"
+#include "filesystem/Directory.h"
+#include "music/MusicDatabase.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <deque>
+#include <set>
+#include <stdlib.h>
+
+using namespace std;
+
+static vector<int> Range(int first, int last)
+{
+  vector<int> ids;
+  for (int id = first; id < last; id++)
+    ids.push_back(id);
+  return ids;
+}
+
+TEST(TestShuffleSampler, NoRepeatsWithinHistory)
+{
+  srand(1);
+  CShuffleSampler sampler(30);
+  sampler.Reset(Range(0, 100));
+  EXPECT_EQ(100u, sampler.Size());
+
+  deque<int> recent;
+  set<int> drawn;
+  for (int i = 0; i < 10000; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    ASSERT_TRUE(find(recent.begin(), recent.end(), id) == recent.end()) << "draw " << i;
+    recent.push_back(id);
+    if (recent.size() > 30)
+      recent.pop_front();
+    EXPECT_TRUE(sampler.InHistory(id));
+    drawn.insert(id);
+  }
+  EXPECT_EQ(70u, sampler.Available());
+  EXPECT_EQ(100u, drawn.size());
+}
+
+TEST(TestShuffleSampler, WithReplacement)
+{
+  srand(2);
+  CShuffleSampler sampler;
+  sampler.Reset(Range(5, 8));
+
+  int counts[3] = { 0, 0, 0 };
+  for (int i = 0; i < 3000; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    ASSERT_TRUE(id >= 5 && id < 8);
+    counts[id - 5]++;
+  }
+  for (int i = 0; i < 3; i++)
+    EXPECT_GT(counts[i], 800);
+
+  CShuffleSampler empty(10);
+  int id;
+  EXPECT_FALSE(empty.Draw(id));
+}
+
+TEST(TestShuffleSampler, HistoryHoldsAll)
+{
+  // once every id was drawn, the oldest one comes back
+  srand(3);
+  CShuffleSampler sampler(10);
+  sampler.Reset(Range(0, 5));
+
+  vector<int> draws;
+  for (int i = 0; i < 20; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    draws.push_back(id);
+  }
+  vector<int> first(draws.begin(), draws.begin() + 5);
+  sort(first.begin(), first.end());
+  EXPECT_TRUE(first == Range(0, 5));
+  for (int i = 5; i < 20; i++)
+    EXPECT_EQ(draws[i - 5], draws[i]);
+}
+
+TEST(TestShuffleSampler, Refresh)
+{
+  srand(4);
+  CShuffleSampler sampler(20);
+  sampler.Reset(Range(0, 100));
+
+  deque<int> history;
+  for (int i = 0; i < 50; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    history.push_back(id);
+    if (history.size() > 20)
+      history.pop_front();
+  }
+
+  // the even ids are removed and new ones are added
+  vector<int> ids;
+  for (int id = 0; id < 150; id++)
+  {
+    if (id >= 100 || id % 2 == 1)
+      ids.push_back(id);
+  }
+  sampler.Refresh(ids);
+  EXPECT_EQ(ids.size(), sampler.Size());
+
+  int kept = 0;
+  for (int id = 0; id < 150; id++)
+  {
+    bool present = id >= 100 || id % 2 == 1;
+    EXPECT_EQ(present, sampler.Contains(id)) << id;
+    bool inHistory = present && find(history.begin(), history.end(), id) != history.end();
+    EXPECT_EQ(inHistory, sampler.InHistory(id)) << id;
+    if (inHistory)
+      kept++;
+  }
+
+  // the history left is kept out of the draws until the history fills up again, new ids may be drawn
+  set<int> drawn;
+  for (int i = 0; i < 2000; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    ASSERT_TRUE(sampler.Contains(id));
+    if (i < 20 - kept)
+      ASSERT_TRUE(find(history.begin(), history.end(), id) == history.end());
+    drawn.insert(id);
+  }
+  EXPECT_EQ(ids.size(), drawn.size());
+
+  // dropping everything
+  sampler.Refresh(vector<int>());
+  EXPECT_EQ(0u, sampler.Size());
+  int id;
+  EXPECT_FALSE(sampler.Draw(id));
+}
+
+TEST(TestShuffleSampler, AddRemove)
+{
+  srand(5);
+  CShuffleSampler sampler(5);
+  sampler.Reset(Range(0, 10));
+
+  int drawn;
+  ASSERT_TRUE(sampler.Draw(drawn));
+  ASSERT_TRUE(sampler.InHistory(drawn));
+
+  // one song at a time, as the library announces them
+  sampler.Add(20);
+  sampler.Add(20);
+  EXPECT_EQ(11u, sampler.Size());
+  EXPECT_TRUE(sampler.Contains(20));
+  EXPECT_FALSE(sampler.InHistory(20));
+
+  sampler.Remove(drawn);
+  sampler.Remove(drawn);
+  sampler.Remove(15);
+  EXPECT_EQ(10u, sampler.Size());
+  EXPECT_FALSE(sampler.Contains(drawn));
+  EXPECT_EQ(10u, sampler.Available());
+
+  set<int> seen;
+  for (int i = 0; i < 1000; i++)
+  {
+    int id;
+    ASSERT_TRUE(sampler.Draw(id));
+    ASSERT_NE(drawn, id);
+    seen.insert(id);
+  }
+  EXPECT_EQ(10u, seen.size());
+  EXPECT_TRUE(seen.count(20) > 0);
+}
+
+TEST(TestShuffleSampler, PartyModeBenchmark)
+{
+  XBMC_SKIP_UNLESS_BENCHMARKS();
+
+  // a library of 200k songs, picking the way party mode does: one song at a time with the
+  // last 200 songs kept out of the picks
+  const int songs = 200000, picks = 20, historySize = 200;
+
+  if (!XFILE::CDirectory::Exists(g_settings.GetDatabaseFolder()))
+    XFILE::CDirectory::Create(g_settings.GetDatabaseFolder());
+
+  CMusicDatabase database;
+  ASSERT_TRUE(database.Open());
+  database.BeginTransaction();
+  database.ExecuteQuery("insert into path (idPath, strPath) values (1, '/music/')");
+  database.ExecuteQuery("insert into album (idAlbum, strAlbum) values (1, 'Album')");
+  for (int i = 1; i <= songs; i++)
+    database.ExecuteQuery(StringUtils::Format("insert into song (idSong, idAlbum, idPath, strTitle, strFileName, iTimesPlayed) "
+                                              "values (%d, 1, 1, 'Song %d', 'song%d.mp3', %d)", i, i, i, i % 5));
+  ASSERT_TRUE(database.CommitTransaction());
+
+  deque<int> history;
+  for (int i = 1; i <= historySize; i++)
+    history.push_back(i * 7);
+
+  // a random song matching the filter and not in the history, as it was picked
+  CStdString filter = "iTimesPlayed < 4";
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < picks; i++)
+  {
+    CStdString where = filter + " and songview.idSong not in (";
+    for (deque<int>::const_iterator it = history.begin(); it != history.end(); ++it)
+      where += StringUtils::Format("%d,", *it);
+    where[where.size() - 1] = ')';
+
+    CFileItem item;
+    int idSong;
+    ASSERT_TRUE(database.GetRandomSong(&item, idSong, where));
+    history.push_back(idSong);
+    history.pop_front();
+  }
+  double queried = CXBMCTestUtils::ElapsedMs(start);
+
+  // the matching ids are fetched once, each pick only fetches the song drawn
+  start = CurrentHostCounter();
+  vector< pair<int,int> > songIDs;
+  ASSERT_EQ((unsigned int)(songs / 5 * 4), database.GetSongIDs(filter, songIDs));
+  vector<int> ids;
+  for (vector< pair<int,int> >::const_iterator it = songIDs.begin(); it != songIDs.end(); ++it)
+    ids.push_back(it->second);
+  CShuffleSampler sampler(historySize);
+  sampler.Reset(ids);
+  double fetched = CXBMCTestUtils::ElapsedMs(start);
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < picks; i++)
+  {
+    int idSong;
+    ASSERT_TRUE(sampler.Draw(idSong));
+    CFileItemList items;
+    ASSERT_TRUE(database.GetSongsByWhere("musicdb://4/", StringUtils::Format("songview.idSong IN (%d)", idSong), items));
+    ASSERT_EQ(1, items.Size());
+  }
+  double sampled = CXBMCTestUtils::ElapsedMs(start);
+
+  database.Close();
+  XFILE::CDirectory::Remove(g_settings.GetDatabaseFolder());
+
+  std::cout << songs << " songs, " << picks << " picks: " << queried / picks << " ms per pick by ORDER BY RANDOM(), "
+            << sampled / picks << " ms per pick from the sampler after fetching the ids in " << fetched << " ms" << std::endl;
+}
@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "ThumbExtractionService.h"
+#include "FileItem.h"
+#include "TextureCache.h"
+#include "VideoThumbLoader.h"
+#include "VideoDatabase.h"
+#include "VideoInfoTag.h"
+#include "cores/dvdplayer/DVDFileInfo.h"
+#include "cores/dvdplayer/DVDThumbContext.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "utils/CPUInfo.h"
+#include "utils/log.h"
+#include "utils/XBMCTinyXML.h"
+
+#define THUMB_EXTRACTION_XML            "special://profile/thumbextraction.xml"
+#define THUMB_EXTRACTION_SAVE_INTERVAL  100
+
+using namespace std;
+
+CThumbExtractionService &CThumbExtractionService::Get()
+{
+  static CThumbExtractionService s_service;
+  return s_service;
+}
+
+CThumbExtractionService::CThumbExtractionService() : CJobQueue(false, 1, CJob::PRIORITY_LOW)
+{
+  m_completed = 0;
+  m_started = false;
+}
+
+CThumbExtractionService::~CThumbExtractionService()
+{
+  CancelJobs();
+  for (vector<CDVDThumbContext *>::iterator i = m_contexts.begin(); i != m_contexts.end(); ++i)
+    delete *i;
+}
+
+unsigned int CThumbExtractionService::GetJobsAtOnce()
+{
+  if (g_advancedSettings.m_iVideoLibraryThumbExtractionJobs > 0)
+    return g_advancedSettings.m_iVideoLibraryThumbExtractionJobs;
+  return std::max(1, g_cpuInfo.getCPUCount() / 2);
+}
+
+void CThumbExtractionService::Start()
+{
+  {
+    CSingleLock lock(m_section);
+    if (m_started)
+      return;
+    m_started = true;
+    m_completed = 0;
+  }
+  SetJobsAtOnce(GetJobsAtOnce());
+  Load();
+
+  PendingMap pending;
+  {
+    CSingleLock lock(m_section);
+    pending = m_pending;
+  }
+  if (!pending.empty())
+    CLog::Log(LOGNOTICE, "%s - resuming thumb extraction of %u items", __FUNCTION__, (unsigned int)pending.size());
+  for (PendingMap::const_iterator i = pending.begin(); i != pending.end(); ++i)
+    QueueJob(i->first, i->second);
+}
+
+void CThumbExtractionService::Stop()
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_started)
+      return;
+    m_started = false;
+  }
+  CancelJobs();
+  Save();
+
+  // the items belong to the profile being left, jobs that were already running find
+  // their item gone and don't touch the next profile's database
+  CSingleLock lock(m_section);
+  m_pending.clear();
+  m_completed = 0;
+  for (vector<CDVDThumbContext *>::iterator i = m_contexts.begin(); i != m_contexts.end(); ++i)
+    delete *i;
+  m_contexts.clear();
+}
+
+void CThumbExtractionService::QueueItem(const CFileItem &item)
+{
+  if (!item.HasVideoInfoTag() || item.GetVideoInfoTag()->m_iDbId <= 0 || item.GetVideoInfoTag()->m_type.empty())
+    return;
+
+  Pending pending;
+  pending.m_target = CVideoThumbLoader::GetEmbeddedThumbURL(item);
+  pending.m_dbId = item.GetVideoInfoTag()->m_iDbId;
+  pending.m_type = item.GetVideoInfoTag()->m_type;
+  if (CTextureCache::Get().HasCachedImage(pending.m_target))
+    return;
+
+  CStdString path = item.GetVideoInfoTag()->m_strFileNameAndPath;
+  if (path.IsEmpty())
+    path = item.GetPath();
+  {
+    CSingleLock lock(m_section);
+    m_pending[path] = pending;
+    if (!m_started)
+      return;
+  }
+  QueueJob(path, pending);
+}
+
+void CThumbExtractionService::QueueJob(const CStdString &path, const Pending &pending)
+{
+  CFileItem item(path, false);
+  CVideoInfoTag *tag = item.GetVideoInfoTag();
+  tag->m_strFileNameAndPath = path;
+  tag->m_iDbId = pending.m_dbId;
+  tag->m_type = pending.m_type;
+  AddJob(new CThumbExtractor(item, path, true, pending.m_target));
+}
+
+bool CThumbExtractionService::ExtractThumb(const CStdString &path, CTextureDetails &details, CStreamDetails *streamDetails)
+{
+  CDVDThumbContext *context = AcquireContext();
+  bool result = CDVDFileInfo::ExtractThumb(path, details, streamDetails, context);
+  ReleaseContext(context);
+  return result;
+}
+
+unsigned int CThumbExtractionService::GetNumPending() const
+{
+  CSingleLock lock(m_section);
+  return m_pending.size();
+}
+
+void CThumbExtractionService::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CThumbExtractor *extractor = (CThumbExtractor *)job;
+  CVideoInfoTag *info = extractor->m_item.GetVideoInfoTag();
+  bool pending;
+  {
+    CSingleLock lock(m_section);
+    PendingMap::const_iterator i = m_pending.find(extractor->m_listpath);
+    pending = m_started && i != m_pending.end() &&
+              i->second.m_dbId == info->m_iDbId && i->second.m_type == info->m_type;
+  }
+  if (success && pending)
+  {
+    CVideoDatabase db;
+    if (db.Open())
+    {
+      db.SetArtForItem(info->m_iDbId, info->m_type, "thumb", extractor->m_target);
+      db.Close();
+    }
+  }
+
+  // items that fail are not retried, as CDVDFileInfo::ExtractThumb caches an empty thumb for them
+  bool save = false;
+  {
+    CSingleLock lock(m_section);
+    m_pending.erase(extractor->m_listpath);
+    if (++m_completed >= THUMB_EXTRACTION_SAVE_INTERVAL)
+    {
+      m_completed = 0;
+      save = true;
+    }
+  }
+  if (save)
+    Save();
+
+  CJobQueue::OnJobComplete(jobID, success, job);
+}
+
+CDVDThumbContext *CThumbExtractionService::AcquireContext()
+{
+  {
+    CSingleLock lock(m_section);
+    if (!m_contexts.empty())
+    {
+      CDVDThumbContext *context = m_contexts.back();
+      m_contexts.pop_back();
+      return context;
+    }
+  }
+  return new CDVDThumbContext();
+}
+
+void CThumbExtractionService::ReleaseContext(CDVDThumbContext *context)
+{
+  CSingleLock lock(m_section);
+  m_contexts.push_back(context);
+}
+
+bool CThumbExtractionService::Load()
+{
+  CXBMCTinyXML xmlDoc;
+  if (!xmlDoc.LoadFile(THUMB_EXTRACTION_XML))
+    return false;
+
+  TiXmlElement *pRootElement = xmlDoc.RootElement();
+  if (!pRootElement || strcmpi(pRootElement->Value(), "thumbextraction") != 0)
+  {
+    CLog::Log(LOGERROR, "Error loading %s, Line %d (%s)", THUMB_EXTRACTION_XML, xmlDoc.ErrorRow(), xmlDoc.ErrorDesc());
+    return false;
+  }
+
+  CSingleLock lock(m_section);
+  for (TiXmlElement *pItem = pRootElement->FirstChildElement("item"); pItem; pItem = pItem->NextSiblingElement("item"))
+  {
+    const char *path = pItem->Attribute("path");
+    const char *target = pItem->Attribute("target");
+    const char *type = pItem->Attribute("type");
+    Pending pending;
+    if (!path || !target || !type || !pItem->Attribute("dbid", &pending.m_dbId))
+      continue;
+    pending.m_target = target;
+    pending.m_type = type;
+    m_pending.insert(make_pair(CStdString(path), pending));
+  }
+  return true;
+}
+
+bool CThumbExtractionService::Save()
+{
+  CXBMCTinyXML xmlDoc;
+  TiXmlElement xmlRootElement("thumbextraction");
+  TiXmlNode *pRoot = xmlDoc.InsertEndChild(xmlRootElement);
+  if (!pRoot)
+    return false;
+
+  // held while writing as well, so saves from different threads don't interleave
+  CSingleLock lock(m_section);
+  for (PendingMap::const_iterator i = m_pending.begin(); i != m_pending.end(); ++i)
+  {
+    TiXmlElement itemNode("item");
+    itemNode.SetAttribute("path", i->first.c_str());
+    itemNode.SetAttribute("target", i->second.m_target.c_str());
+    itemNode.SetAttribute("dbid", i->second.m_dbId);
+    itemNode.SetAttribute("type", i->second.m_type.c_str());
+    pRoot->InsertEndChild(itemNode);
+  }
+  return xmlDoc.SaveFile(THUMB_EXTRACTION_XML);
+}
@@ -0,0 +1,100 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://www.xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <vector>
+#include "utils/JobManager.h"
+#include "utils/StdString.h"
+#include "threads/CriticalSection.h"
+
+class CFileItem;
+class CStreamDetails;
+class CTextureDetails;
+class CDVDThumbContext;
+
+/*!
+ \ingroup thumbs,jobs
+ \brief Extracts the thumbs of video library items in the background
+
+ Items are queued as they are added to the library and extracted a few at a time, each job
+ borrowing a CDVDThumbContext so decoders and scalers carry over from one file to the next.
+ Items still waiting are saved to the profile, so the work carries on after a restart.
+
+ \sa CThumbExtractor, CDVDThumbContext
+ */
+class CThumbExtractionService : public CJobQueue
+{
+public:
+  static CThumbExtractionService &Get();
+
+  /*! \brief Start extracting, picking up the items left over from the last run */
+  void Start();
+
+  /*! \brief Stop extracting, saving the items still waiting to the current profile
+   Must be called before the profile changes, the items are forgotten until the next Start()
+   */
+  void Stop();
+
+  /*! \brief Queue the thumb of a video library item for extraction
+   \param item a video library item with a database id and media type
+   */
+  void QueueItem(const CFileItem &item);
+
+  /*! \brief Extract a thumb with one of the pooled contexts
+   \sa CDVDFileInfo::ExtractThumb
+   */
+  bool ExtractThumb(const CStdString &path, CTextureDetails &details, CStreamDetails *streamDetails);
+
+  unsigned int GetNumPending() const;
+
+  /*! \brief Number of jobs run at once, half the cpu cores unless set in advancedsettings.xml */
+  static unsigned int GetJobsAtOnce();
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  // private construction, and no assignements; use the provided singleton methods
+  CThumbExtractionService();
+  CThumbExtractionService(const CThumbExtractionService&);
+  CThumbExtractionService const& operator=(CThumbExtractionService const&);
+  virtual ~CThumbExtractionService();
+
+  class Pending
+  {
+  public:
+    CStdString m_target;
+    int m_dbId;
+    CStdString m_type;
+  };
+  typedef std::map<CStdString, Pending> PendingMap;
+
+  void QueueJob(const CStdString &path, const Pending &pending);
+  CDVDThumbContext *AcquireContext();
+  void ReleaseContext(CDVDThumbContext *context);
+  bool Load();
+  bool Save();
+
+  PendingMap m_pending;          // keyed by file path
+  std::vector<CDVDThumbContext *> m_contexts;
+  unsigned int m_completed;      // since the pending items were last saved
+  bool m_started;
+  mutable CCriticalSection m_section;
+};
@@ -47,6 +47,7 @@
 #include "utils/URIUtils.h"
 #include "utils/Variant.h"
 #include "video/VideoThumbLoader.h"
+#include "video/ThumbExtractionService.h"
 #include "TextureCache.h"
 #include "GUIUserMessages.h"
 #include "URL.h"
@@ -1150,6 +1151,11 @@ namespace VIDEO
         movieDetails.m_resumePoint.IsSet())
       m_database.AddBookMarkToFile(pItem->GetPath(), movieDetails.m_resumePoint, CBookmark::RESUME);
 
+    // files without a thumb get one extracted in the background
+    if (lResult > 0 && !pItem->m_bIsFolder && !pItem->HasArt("thumb") &&
+        g_guiSettings.GetBool("myvideos.extractthumb") && g_guiSettings.GetBool("myvideos.extractflags"))
+      CThumbExtractionService::Get().QueueItem(*pItem);
+
     m_database.Close();
 
     CFileItemPtr itemCopy = CFileItemPtr(new CFileItem(*pItem));
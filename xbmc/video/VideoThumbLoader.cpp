@@ -34,6 +34,7 @@
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
 #include "video/VideoInfoScanner.h"
+#include "video/ThumbExtractionService.h"
 #include "music/MusicDatabase.h"
 
 using namespace XFILE;
@@ -92,7 +93,7 @@ bool CThumbExtractor::DoWork()
     // construct the thumb cache file
     CTextureDetails details;
     details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item.GetPath(), details, &m_item.GetVideoInfoTag()->m_streamDetails);
+    result = CThumbExtractionService::Get().ExtractThumb(m_item.GetPath(), details, &m_item.GetVideoInfoTag()->m_streamDetails);
     if(result)
     {
       CTextureCache::Get().AddCachedTexture(m_target, details);
@@ -144,6 +144,9 @@ void CGUIWindowDebugInfo::Process(unsigned int currentTime, CDirtyRegionList &di
       if (control)
         info.AppendFormat("Focused: %i (%s)", control->GetID(), CGUIControlFactory::TranslateControlType(control->GetControlType()).c_str());
     }
+    unsigned int requests, updates;
+    g_infoManager.GetBoolCounters(requests, updates);
+    info.AppendFormat("\nConditions: %u evaluated of %u requested", updates, requests);
   }
 
   float w, h;
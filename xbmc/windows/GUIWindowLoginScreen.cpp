@@ -47,6 +47,7 @@
 #include "guilib/Key.h"
 #include "guilib/LocalizeStrings.h"
 #include "addons/AddonManager.h"
+#include "video/ThumbExtractionService.h"
 
 #define CONTROL_BIG_LIST               52
 #define CONTROL_LABEL_HEADER            2
@@ -278,6 +279,9 @@ void CGUIWindowLoginScreen::LoadProfile(unsigned int profile)
   // stop PVR related services
   g_application.StopPVRManager();
 
+  // thumbs waiting to be extracted are kept with the profile
+  CThumbExtractionService::Get().Stop();
+
   if (profile != 0 || !g_settings.IsMasterUser())
   {
     g_application.getNetwork().NetworkMessage(CNetwork::SERVICES_DOWN,1);
@@ -321,5 +325,6 @@ void CGUIWindowLoginScreen::LoadProfile(unsigned int profile)
 
   g_windowManager.ChangeActiveWindow(g_SkinInfo->GetFirstWindow());
 
+  CThumbExtractionService::Get().Start();
   g_application.UpdateLibraries();
 }